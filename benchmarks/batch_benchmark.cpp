@@ -0,0 +1,74 @@
+/**
+ * @file batch_benchmark.cpp
+ * @brief Compares logging bursts of related lines one at a time against logging them as batches.
+ * 
+ * Usage: rk_logger_batch_benchmark [bursts per producer] [lines per burst] [producers]
+ * 
+ * The time covers logging every line and stopping the logger, so it includes draining the queues.
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include <rk_logger/batch.h>
+
+#include "benchmark_utils.h"
+
+namespace {
+
+double runBenchmark(const bool isBatched, const size_t burstsPerProducer, const size_t linesPerBurst, const size_t producerCount) {
+    rk_logger_benchmarks::QuietCout quietCout;
+    auto sink = std::make_shared<rk_logger_benchmarks::CountingSink>();
+    auto logger = rk_logger_benchmarks::createBenchmarkLogger("bench", sink);
+    std::thread logThread = logger->start(std::filesystem::path());
+
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> producers;
+    for (size_t producer = 0; producer < producerCount; producer++) {
+        producers.emplace_back([&logger, isBatched, burstsPerProducer, linesPerBurst, producer] () {
+            for (size_t burst = 0; burst < burstsPerProducer; burst++) {
+                if (isBatched) {
+                    rk::log::Batch batch(*logger);
+                    for (size_t i = 0; i < linesPerBurst; i++) {
+                        RK_LOG_BATCH(batch, "Level ", i, " of burst ", burst, " from producer ", producer, "\n");
+                    }
+                }
+                else {
+                    for (size_t i = 0; i < linesPerBurst; i++) {
+                        RK_LOG_TO(*logger, "Level ", i, " of burst ", burst, " from producer ", producer, "\n");
+                    }
+                }
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    logger->stop(std::move(logThread));
+    const double seconds = rk_logger_benchmarks::secondsSince(start);
+
+    const size_t expected = burstsPerProducer * linesPerBurst * producerCount;
+    if (sink->messageCount != expected) {
+        std::fprintf(stderr, "Expected %zu messages but the sink received %zu\n", expected, sink->messageCount.load());
+        std::exit(1);
+    }
+    return static_cast<double>(sink->messageCount) / seconds;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t burstsPerProducer = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000;
+    const size_t linesPerBurst = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 200;
+    const size_t producerCount = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 4;
+    std::printf("Producers: %zu, bursts per producer: %zu, lines per burst: %zu\n", producerCount, burstsPerProducer, linesPerBurst);
+
+    std::printf("\n%-12s %16s\n", "Mode", "Messages/s");
+    const double single = runBenchmark(false, burstsPerProducer, linesPerBurst, producerCount);
+    std::printf("%-12s %16.0f\n", "RK_LOG_TO", single);
+    const double batched = runBenchmark(true, burstsPerProducer, linesPerBurst, producerCount);
+    std::printf("%-12s %16.0f  (%.2fx)\n", "RK_LOG_BATCH", batched, batched / single);
+
+    return 0;
+}
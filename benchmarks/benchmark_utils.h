@@ -0,0 +1,71 @@
+/**
+ * @file benchmark_utils.h
+ * @brief Helpers shared by the benchmarks.
+ */
+#ifndef BENCHMARK_UTILS_H
+#define BENCHMARK_UTILS_H
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <iostream>
+#include <streambuf>
+
+#include <rk_logger/logger.h>
+
+namespace rk_logger_benchmarks {
+
+/**
+ * A sink that only counts what it receives, so the benchmarks measure the logger rather than the console or disk.
+ */
+class CountingSink : public rk::log::Sink {
+public:
+    void write(const std::string& message) override {
+        messageCount.fetch_add(1, std::memory_order_relaxed);
+        byteCount.fetch_add(message.size(), std::memory_order_relaxed);
+    }
+
+    std::atomic<size_t> messageCount{0};
+    std::atomic<size_t> byteCount{0};
+};
+
+/**
+ * @brief Creates a logger that only writes to a counting sink.
+ * 
+ * @param name The name of the logger.
+ * @param sink The sink to write to.
+ * @return The logger. Set any other config values before starting it.
+ */
+inline std::unique_ptr<rk::log::Logger> createBenchmarkLogger(const std::string& name, std::shared_ptr<rk::log::Sink> sink) {
+    auto logger = std::make_unique<rk::log::Logger>(name);
+    logger->getConfig().setConfigValue(rk::config::write_to_log_file::KEY, rk::config::write_to_log_file::DISABLE);
+    logger->getConfig().setConfigValue(rk::config::write_to_console::KEY, rk::config::write_to_console::DISABLE);
+    logger->addSink(std::move(sink));
+    return logger;
+}
+
+/**
+ * Discards the logger's internal messages to std::cout (e.g., "Starting RK Logger") while it is in scope, so they
+ * don't get mixed into the benchmark results.
+ */
+class QuietCout {
+public:
+    QuietCout() : original(std::cout.rdbuf(&discard)) {}
+    ~QuietCout() { std::cout.rdbuf(original); }
+private:
+    class DiscardBuffer : public std::streambuf {
+    protected:
+        int overflow(int c) override { return c; }
+    };
+
+    DiscardBuffer discard;
+    std::streambuf* original;
+};
+
+inline double secondsSince(const std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace rk_logger_benchmarks
+
+#endif // #ifndef BENCHMARK_UTILS_H
@@ -0,0 +1,69 @@
+/**
+ * @file clock_benchmark.cpp
+ * @brief Measures the cost of reading each clock source and of logging with each one.
+ * 
+ * Usage: rk_logger_clock_benchmark [reads] [messages]
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+#include <rk_logger/tick_clock.h>
+
+#include "benchmark_utils.h"
+
+namespace {
+
+template<typename ReadFunc>
+double nsPerRead(const size_t reads, ReadFunc read) {
+    uint64_t sum = 0; // Keeps the reads from being optimized out
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < reads; i++) {
+        sum += read();
+    }
+    const double seconds = rk_logger_benchmarks::secondsSince(start);
+    if (sum == 1) {
+        std::printf(" ");
+    }
+    return seconds * 1e9 / static_cast<double>(reads);
+}
+
+double nsPerMessage(const rk::config::ConfigValue& clockSource, const size_t messages) {
+    rk_logger_benchmarks::QuietCout quietCout;
+    auto sink = std::make_shared<rk_logger_benchmarks::CountingSink>();
+    auto logger = rk_logger_benchmarks::createBenchmarkLogger("bench", sink);
+    logger->getConfig().setConfigValue(rk::config::clock_source::KEY, clockSource);
+    std::thread logThread = logger->start(std::filesystem::path());
+
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < messages; i++) {
+        RK_LOG_TO(*logger, "Benchmark message ", i, "\n");
+    }
+    const double seconds = rk_logger_benchmarks::secondsSince(start);
+    logger->stop(std::move(logThread));
+    return seconds * 1e9 / static_cast<double>(messages);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t reads = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000000;
+    const size_t messages = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1000000;
+    std::printf("Invariant TSC: %s\n", rk::time_internal::isInvariantTscAvailable() ? "yes" : "no");
+
+    std::printf("\n%-24s %10s\n", "Clock read", "ns/read");
+    std::printf("%-24s %10.2f\n", "system_clock::now()", nsPerRead(reads, [] () {
+        return static_cast<uint64_t>(rk::time_internal::system_clock::now().time_since_epoch().count());
+    }));
+    std::printf("%-24s %10.2f\n", "steady_clock::now()", nsPerRead(reads, rk::time_internal::readSteadyNs));
+    if (rk::time_internal::isInvariantTscAvailable()) {
+        std::printf("%-24s %10.2f\n", "rdtsc", nsPerRead(reads, rk::time_internal::readTsc));
+    }
+
+    std::printf("\n%-24s %10s\n", "Clock source", "ns/message");
+    for (const auto& clockSource : { rk::config::clock_source::SYSTEM, rk::config::clock_source::STEADY, rk::config::clock_source::TSC }) {
+        std::printf("%-24s %10.2f\n", clockSource.c_str(), nsPerMessage(clockSource, messages));
+    }
+
+    return 0;
+}
@@ -0,0 +1,135 @@
+/**
+ * @file compression_benchmark.cpp
+ * @brief Measures how fast log files are compressed at each level, and how much disk they save.
+ *
+ * Usage: rk_logger_compression_benchmark [message count]
+ *
+ * The first table compresses and decodes log text directly, one BLOCK_SIZE block at a time like the file sink does.
+ * The second one logs through a logger that writes its log file to the current directory, and reports how long it
+ * takes to log and stop, and how big the file ends up. The log files are removed afterwards.
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+
+#include <rk_logger/lz4.h>
+#include "benchmark_utils.h"
+
+namespace {
+
+const std::string BENCHMARK_LOGGER_NAME = "compression_bench";
+const char* const PATHS[] = { "/api/v1/items", "/api/v1/users", "/api/v1/orders", "/health", "/api/v2/search" };
+
+/**
+ * @brief Writes a message that looks like the ones services log, with a few fields that change from one to the next.
+ */
+template<typename LogFunc>
+void logMessages(const size_t count, LogFunc log) {
+    std::mt19937 generator(1);
+    for (size_t i = 0; i < count; i++) {
+        const uint32_t random = generator();
+        log(i, PATHS[random % 5], random % 100000, (random >> 8) % 5000, (random >> 20) % 50 == 0 ? 500 : 200);
+    }
+}
+
+std::string makeLogText(const size_t count) {
+    std::string text;
+    logMessages(count, [&text] (const size_t i, const char* path, const uint32_t user, const uint32_t latencyUs, const int status) {
+        char line[256];
+        const int size = std::snprintf(line, sizeof(line), "10/19/2026 10:42:%02zu.%03zu [140213%zu][handleRequest]Request %zu for %s from user %u took %u us, status %d\n",
+            i / 1000 % 60, i % 1000, i % 7, i, path, user, latencyUs, status);
+        text.append(line, static_cast<size_t>(size));
+    });
+    return text;
+}
+
+struct CodecResult {
+    double compressMbPerSecond;
+    double decodeMbPerSecond;
+    size_t compressedSize;
+};
+
+CodecResult runCodec(const std::string& text, const int level) {
+    const auto compressStart = std::chrono::steady_clock::now();
+    rk::lz4_internal::FrameEncoder encoder(level);
+    std::string compressed;
+    encoder.write(text, compressed);
+    encoder.finishFrame(compressed);
+    const double compressSeconds = rk_logger_benchmarks::secondsSince(compressStart);
+
+    const auto decodeStart = std::chrono::steady_clock::now();
+    rk::lz4_internal::FrameDecoder decoder;
+    std::string decoded;
+    decoded.reserve(text.size());
+    const bool isValid = decoder.decode(compressed.data(), compressed.size(), decoded) && decoded == text;
+    const double decodeSeconds = rk_logger_benchmarks::secondsSince(decodeStart);
+    if (!isValid) {
+        std::fprintf(stderr, "Level %d didn't decode to the original text\n", level);
+        std::exit(1);
+    }
+
+    const double megabytes = static_cast<double>(text.size()) / (1024.0 * 1024.0);
+    return { megabytes / compressSeconds, megabytes / decodeSeconds, compressed.size() };
+}
+
+struct LoggerResult {
+    double seconds;
+    uintmax_t fileSize;
+};
+
+LoggerResult runLogger(const size_t count, const std::string& compression, const std::string& level) {
+    rk_logger_benchmarks::QuietCout quietCout;
+    rk::log::Logger logger(BENCHMARK_LOGGER_NAME);
+    logger.getConfig().setConfigValue(rk::config::write_to_console::KEY, rk::config::write_to_console::DISABLE);
+    logger.getConfig().setConfigValue(rk::config::log_file_compression::KEY, compression);
+    logger.getConfig().setConfigValue(rk::config::log_file_compression_level::KEY, level);
+
+    const auto start = std::chrono::steady_clock::now();
+    logger.startOwned(std::filesystem::path());
+    logMessages(count, [&logger] (const size_t i, const char* path, const uint32_t user, const uint32_t latencyUs, const int status) {
+        RK_LOG_TO(logger, "Request ", i, " for ", path, " from user ", user, " took ", latencyUs, " us, status ", status, "\n");
+    });
+    logger.stop();
+    const double seconds = rk_logger_benchmarks::secondsSince(start);
+
+    uintmax_t fileSize = 0;
+    const std::string prefix = "logs_" + BENCHMARK_LOGGER_NAME + "_";
+    for (const auto& entry : std::filesystem::directory_iterator(std::filesystem::current_path())) {
+        if (entry.path().filename().string().rfind(prefix, 0) == 0) {
+            fileSize += entry.file_size();
+            std::filesystem::remove(entry.path());
+        }
+    }
+    return { seconds, fileSize };
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t messageCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    const std::string text = makeLogText(messageCount);
+    std::printf("Messages: %zu, log text: %.1f MB\n", messageCount, static_cast<double>(text.size()) / (1024.0 * 1024.0));
+
+    std::printf("\n%-8s %14s %14s %14s %8s\n", "Level", "Compress MB/s", "Decode MB/s", "Size", "Ratio");
+    for (int level = rk::lz4_internal::MIN_LEVEL; level <= rk::lz4_internal::MAX_LEVEL; level++) {
+        const CodecResult result = runCodec(text, level);
+        std::printf("%-8d %14.0f %14.0f %14zu %7.2fx\n", level, result.compressMbPerSecond, result.decodeMbPerSecond,
+            result.compressedSize, static_cast<double>(text.size()) / static_cast<double>(result.compressedSize));
+    }
+
+    std::printf("\n%-12s %12s %14s %14s\n", "Log file", "Seconds", "Messages/s", "File size");
+    const std::pair<std::string, std::string> settings[] = {
+        { rk::config::log_file_compression::NONE, "1" },
+        { rk::config::log_file_compression::LZ4, "1" },
+        { rk::config::log_file_compression::LZ4, "4" },
+        { rk::config::log_file_compression::LZ4, "9" },
+    };
+    for (const auto& setting : settings) {
+        const LoggerResult result = runLogger(messageCount, setting.first, setting.second);
+        const std::string name = setting.first == rk::config::log_file_compression::NONE ? setting.first : setting.first + " " + setting.second;
+        std::printf("%-12s %12.3f %14.0f %14ju\n", name.c_str(), result.seconds, static_cast<double>(messageCount) / result.seconds, result.fileSize);
+    }
+
+    return 0;
+}
@@ -0,0 +1,104 @@
+/**
+ * @file formatter_benchmark.cpp
+ * @brief Measures writing a user type into a record with its operator<<, with an rk::log::formatter, and with a
+ * deferred rk::log::formatter.
+ *
+ * Usage: rk_logger_formatter_benchmark [iterations]
+ */
+#include <charconv>
+#include <cstdio>
+#include <cstdlib>
+#include <ostream>
+
+#include <rk_logger/format.h>
+
+#include "benchmark_utils.h"
+
+namespace {
+
+/**
+ * The same IPv4 address, written three ways.
+ */
+template<int Kind>
+struct Address {
+    uint8_t octets[4];
+};
+
+using StreamedAddress = Address<0>;
+using FormattedAddress = Address<1>;
+using DeferredAddress = Address<2>;
+
+std::ostream& operator<<(std::ostream& os, const StreamedAddress& address) {
+    return os << static_cast<int>(address.octets[0]) << '.' << static_cast<int>(address.octets[1]) << '.'
+        << static_cast<int>(address.octets[2]) << '.' << static_cast<int>(address.octets[3]);
+}
+
+size_t formatAddress(char* out, const uint8_t (&octets)[4]) {
+    char* end = out;
+    for (size_t i = 0; i < 4; i++) {
+        if (i > 0) {
+            *end++ = '.';
+        }
+        end = std::to_chars(end, out + 15, octets[i]).ptr;
+    }
+    return static_cast<size_t>(end - out);
+}
+
+template<typename Func>
+double nsPerOp(const size_t iterations, Func func) {
+    size_t sum = 0; // Keeps the work from being optimized out
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++) {
+        sum += func(i);
+    }
+    const double seconds = rk_logger_benchmarks::secondsSince(start);
+    if (sum == 1) {
+        std::printf(" ");
+    }
+    return seconds * 1e9 / static_cast<double>(iterations);
+}
+
+} // namespace
+
+template<>
+struct rk::log::formatter<FormattedAddress> {
+    static constexpr size_t max_size = 15;
+    static size_t format_to(char* out, const FormattedAddress& address) { return formatAddress(out, address.octets); }
+};
+
+template<>
+struct rk::log::formatter<DeferredAddress> {
+    static constexpr size_t max_size = 15;
+    static constexpr bool is_deferred = true;
+    static size_t format_to(char* out, const DeferredAddress& address) { return formatAddress(out, address.octets); }
+};
+
+int main(int argc, char** argv) {
+    const size_t iterations = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000000;
+
+    auto logAddress = [] (auto address, const size_t i) {
+        address.octets[3] = static_cast<uint8_t>(i);
+        rk::log::Record record;
+        rk::log_internal::appendArg(record, "Connection from ");
+        rk::log_internal::appendArg(record, address);
+        return record.message.size() + record.spliced.size();
+    };
+    std::string out;
+    auto logAndFormatAddress = [&out] (DeferredAddress address, const size_t i) {
+        address.octets[3] = static_cast<uint8_t>(i);
+        rk::log::Record record;
+        rk::log_internal::appendArg(record, "Connection from ");
+        rk::log_internal::appendArg(record, address);
+        out.clear();
+        record.spliced[0].format(record.spliced[0].text, out);
+        return out.size();
+    };
+
+    std::printf("%-40s %10s\n", "ns/op", "address");
+    std::printf("%-40s %10.2f\n", "operator<<", nsPerOp(iterations, [&] (const size_t i) { return logAddress(StreamedAddress{ { 10, 0, 0, 0 } }, i); }));
+    std::printf("%-40s %10.2f\n", "formatter", nsPerOp(iterations, [&] (const size_t i) { return logAddress(FormattedAddress{ { 10, 0, 0, 0 } }, i); }));
+    std::printf("%-40s %10.2f\n", "deferred formatter, logging thread", nsPerOp(iterations, [&] (const size_t i) { return logAddress(DeferredAddress{ { 10, 0, 0, 0 } }, i); }));
+    std::printf("%-40s %10.2f\n", "deferred formatter, both threads", nsPerOp(iterations, [&] (const size_t i) { return logAndFormatAddress(DeferredAddress{ { 10, 0, 0, 0 } }, i); }));
+
+    return 0;
+}
@@ -0,0 +1,83 @@
+/**
+ * @file grep_benchmark.cpp
+ * @brief Measures how fast a log is searched with one thread and with more, for a filter on the prefix and for a
+ * pattern in the messages.
+ *
+ * Usage: rk_logger_grep_benchmark [log size in MB]
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <regex>
+#include <thread>
+
+#include <rk_logger/log_grep.h>
+
+#include "benchmark_utils.h"
+
+namespace {
+
+constexpr size_t BYTES_PER_MB = 1024 * 1024;
+
+/**
+ * @brief Writes a log like one from a busy service, with a few threads and functions and some messages that have
+ * several lines.
+ */
+std::string createLog(const rk::time_internal::TimeStampFormatter& formatter, const size_t size) {
+    std::string log;
+    log.reserve(size + 256);
+    const rk::time_internal::time_point start = rk::time_internal::system_clock::now();
+    static const char* const FUNCS[] = { "handleRequest", "flushCache", "pollSocket" };
+    for (size_t i = 0; log.size() < size; i++) {
+        formatter.appendTimeStamp(start + std::chrono::microseconds(i * 10), log);
+        log += "[14021344556677" + std::to_string(i % 8) + "][" + FUNCS[i % 3] + "]Request " + std::to_string(i) +
+            " finished with status " + std::to_string(200 + i % 7 * 100) + "\n";
+        if (i % 100 == 0) {
+            log += "  at frame 1\n  at frame 2\n";
+        }
+    }
+    return log;
+}
+
+double mbPerSecond(const rk::grep_internal::LogGrep& logGrep, const std::string& log, const size_t threadCount, size_t& matchCount) {
+    size_t outputSize = 0;
+    const auto start = std::chrono::steady_clock::now();
+    matchCount = logGrep.grep(log, threadCount, [&outputSize] (const std::string_view messages) { outputSize += messages.size(); });
+    return static_cast<double>(log.size()) / BYTES_PER_MB / rk_logger_benchmarks::secondsSince(start);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t logSize = (argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 256) * BYTES_PER_MB;
+    const size_t maxThreadCount = std::max(1u, std::thread::hardware_concurrency());
+
+    rk_logger_benchmarks::QuietCout quietCout;
+    std::unique_ptr<rk::config::Config> config = rk::config::createInstance();
+    rk::time_internal::TimeStampFormatter formatter;
+    formatter.updateTimeStampFuncs(*config);
+    const std::string log = createLog(formatter, logSize);
+
+    rk::grep_internal::GrepFilter threadFilter;
+    threadFilter.threadId = "140213445566773";
+    threadFilter.funcName = "pollSocket";
+    rk::grep_internal::GrepFilter patternFilter;
+    patternFilter.pattern = std::make_shared<const std::regex>("status [5-9]00", std::regex::ECMAScript | std::regex::optimize);
+    const rk::grep_internal::LogGrep threadGrep(formatter, threadFilter);
+    const rk::grep_internal::LogGrep patternGrep(formatter, patternFilter);
+
+    std::printf("Searching %zu MB on up to %zu threads\n", log.size() / BYTES_PER_MB, maxThreadCount);
+    std::printf("\n%-8s %16s %16s\n", "MB/s", "thread+function", "regex");
+    for (size_t threadCount = 1; threadCount <= maxThreadCount; threadCount *= 2) {
+        size_t threadMatches = 0;
+        size_t patternMatches = 0;
+        const double threadRate = mbPerSecond(threadGrep, log, threadCount, threadMatches);
+        const double patternRate = mbPerSecond(patternGrep, log, threadCount, patternMatches);
+        std::printf("%-8zu %16.1f %16.1f\n", threadCount, threadRate, patternRate);
+        if (threadMatches == 0 || patternMatches == 0) {
+            std::printf("No messages matched\n");
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,69 @@
+/**
+ * @file shard_benchmark.cpp
+ * @brief Measures how the throughput of a logger scales with the number of shards.
+ * 
+ * Usage: rk_logger_shard_benchmark [messages per producer] [producers]
+ * 
+ * The time covers logging every message and stopping the logger, so it includes draining the queues. Scaling depends
+ * on having at least as many free cores as shards plus producers.
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "benchmark_utils.h"
+
+namespace {
+
+double runBenchmark(const size_t shardCount, const rk::config::ConfigValue& ordering, const size_t messagesPerProducer, const size_t producerCount) {
+    rk_logger_benchmarks::QuietCout quietCout;
+    auto sink = std::make_shared<rk_logger_benchmarks::CountingSink>();
+    auto logger = rk_logger_benchmarks::createBenchmarkLogger("bench", sink);
+    logger->getConfig().setConfigValue(rk::config::log_shards::KEY, std::to_string(shardCount));
+    logger->getConfig().setConfigValue(rk::config::log_shard_ordering::KEY, ordering);
+    std::thread logThread = logger->start(std::filesystem::path());
+
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> producers;
+    for (size_t producer = 0; producer < producerCount; producer++) {
+        producers.emplace_back([&logger, messagesPerProducer, producer] () {
+            for (size_t i = 0; i < messagesPerProducer; i++) {
+                RK_LOG_TO(*logger, "Benchmark message from producer ", producer, " with sequence number ", i, "\n");
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    logger->stop(std::move(logThread));
+    const double seconds = rk_logger_benchmarks::secondsSince(start);
+
+    if (sink->messageCount != messagesPerProducer * producerCount) {
+        std::fprintf(stderr, "Expected %zu messages but the sink received %zu\n", messagesPerProducer * producerCount, sink->messageCount.load());
+        std::exit(1);
+    }
+    return static_cast<double>(sink->messageCount) / seconds;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t messagesPerProducer = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    const size_t producerCount = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 8;
+    std::printf("Producers: %zu, messages per producer: %zu, hardware threads: %u\n", producerCount, messagesPerProducer, std::thread::hardware_concurrency());
+
+    for (const auto& ordering : { rk::config::log_shard_ordering::PER_THREAD, rk::config::log_shard_ordering::GLOBAL }) {
+        std::printf("\nOrdering: %s\n%-8s %16s %10s\n", ordering.c_str(), "Shards", "Messages/s", "Speedup");
+        double baseline = 0;
+        for (const size_t shardCount : { 1, 2, 4, 8 }) {
+            const double throughput = runBenchmark(shardCount, ordering, messagesPerProducer, producerCount);
+            if (shardCount == 1) {
+                baseline = throughput;
+            }
+            std::printf("%-8zu %16.0f %9.2fx\n", shardCount, throughput, throughput / baseline);
+        }
+    }
+
+    return 0;
+}
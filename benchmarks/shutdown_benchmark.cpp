@@ -0,0 +1,100 @@
+/**
+ * @file shutdown_benchmark.cpp
+ * @brief Measures how long stopping a logger takes when a backlog is still queued, with and without a drain time.
+ * 
+ * Usage: rk_logger_shutdown_benchmark [backlog size] [microseconds per write] [drain ms]
+ * 
+ * The sink blocks until the logger is stopping, so the whole backlog is still queued when the drain starts. Each
+ * write after that takes the given time, like a slow disk or network sink would.
+ */
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+#include "benchmark_utils.h"
+
+namespace {
+
+/**
+ * A counting sink that holds its first write until it is opened, and then spends a fixed time on each write.
+ */
+class SlowGateSink : public rk_logger_benchmarks::CountingSink {
+public:
+    explicit SlowGateSink(const std::chrono::microseconds writeTime) : writeTime(writeTime) {}
+
+    void write(const std::string& message) override {
+        {
+            std::unique_lock<std::mutex> lock(gateMutex);
+            isEntered = true;
+            gateCv.notify_all();
+            gateCv.wait(lock, [this] () { return isOpen; });
+        }
+        const auto end = std::chrono::steady_clock::now() + writeTime;
+        while (std::chrono::steady_clock::now() < end) {}
+        CountingSink::write(message);
+    }
+
+    void waitUntilEntered() {
+        std::unique_lock<std::mutex> lock(gateMutex);
+        gateCv.wait(lock, [this] () { return isEntered; });
+    }
+
+    void open() {
+        std::lock_guard<std::mutex> lock(gateMutex);
+        isOpen = true;
+        gateCv.notify_all();
+    }
+private:
+    const std::chrono::microseconds writeTime;
+    std::mutex gateMutex;
+    std::condition_variable gateCv;
+    bool isEntered = false;
+    bool isOpen = false;
+};
+
+struct Result {
+    double stopMs;
+    size_t writtenCount;
+};
+
+Result runBenchmark(const std::string& drainMs, const size_t backlogSize, const std::chrono::microseconds writeTime) {
+    rk_logger_benchmarks::QuietCout quietCout;
+    auto sink = std::make_shared<SlowGateSink>(writeTime);
+    auto logger = rk_logger_benchmarks::createBenchmarkLogger("bench", sink);
+    logger->getConfig().setConfigValue(rk::config::shutdown_drain_ms::KEY, drainMs);
+    logger->startOwned(std::filesystem::path());
+
+    RK_LOG_TO(*logger, "Holding the log thread\n");
+    sink->waitUntilEntered();
+    for (size_t i = 0; i < backlogSize; i++) {
+        RK_LOG_TO(*logger, "Queued message ", i, " of the backlog\n");
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    std::thread stopper([&logger] () { logger->stop(); });
+    sink->open();
+    stopper.join();
+    const double stopMs = rk_logger_benchmarks::secondsSince(start) * 1000.0;
+
+    // One message is the one that held the log thread, and one may be the notice about the dropped messages
+    return { stopMs, sink->messageCount.load() };
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t backlogSize = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    const std::chrono::microseconds writeTime(argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1);
+    const std::string drainMs = argc > 3 ? argv[3] : "50";
+    std::printf("Backlog: %zu messages, write time: %lld us, drain time: %s ms\n", backlogSize, static_cast<long long>(writeTime.count()), drainMs.c_str());
+
+    std::printf("\n%-14s %12s %12s\n", "Drain time", "Stop ms", "Written");
+    const Result unlimited = runBenchmark(rk::config::shutdown_drain_ms::UNLIMITED, backlogSize, writeTime);
+    std::printf("%-14s %12.1f %12zu\n", "UNLIMITED", unlimited.stopMs, unlimited.writtenCount);
+    const Result limited = runBenchmark(drainMs, backlogSize, writeTime);
+    std::printf("%-14s %12.1f %12zu\n", (drainMs + " ms").c_str(), limited.stopMs, limited.writtenCount);
+
+    return 0;
+}
@@ -0,0 +1,117 @@
+/**
+ * @file simd_benchmark.cpp
+ * @brief Measures the digit rendering and text scanning kernels at each SIMD level that the CPU supports, against
+ * the scalar versions and the standard library.
+ * 
+ * Usage: rk_logger_simd_benchmark [iterations]
+ */
+#include <charconv>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include <rk_logger/log_time.h>
+#include <rk_logger/simd.h>
+
+#include "benchmark_utils.h"
+
+namespace {
+
+constexpr size_t INTEGER_COUNT = 1024;
+constexpr size_t SCAN_BUFFER_SIZE = 4096;
+
+template<typename Func>
+double nsPerOp(const size_t iterations, Func func) {
+    size_t sum = 0; // Keeps the work from being optimized out
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++) {
+        sum += func(i);
+    }
+    const double seconds = rk_logger_benchmarks::secondsSince(start);
+    if (sum == 1) {
+        std::printf(" ");
+    }
+    return seconds * 1e9 / static_cast<double>(iterations);
+}
+
+/**
+ * @brief Integers of every size, as they show up in log arguments.
+ */
+std::vector<uint64_t> createIntegers() {
+    std::vector<uint64_t> integers(INTEGER_COUNT);
+    uint64_t state = 0x9e3779b97f4a7c15;
+    for (size_t i = 0; i < integers.size(); i++) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        integers[i] = state >> (state % 64);
+    }
+    return integers;
+}
+
+/**
+ * @brief Converts a timestamp for a file name the way it was done before it was vectorized, for comparing against.
+ */
+std::string convertWithErase(std::string timeStamp) {
+    for (auto iter = timeStamp.begin(); iter != timeStamp.end(); ) {
+        if (*iter == '[' || *iter == ']' || *iter == ' ') {
+            iter = timeStamp.erase(iter);
+        }
+        else {
+            if (*iter == '|') {
+                *iter = '_';
+            }
+            else if (*iter == ':') {
+                *iter = '-';
+            }
+            iter++;
+        }
+    }
+    return timeStamp;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t iterations = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000000;
+    const rk::simd_internal::SimdLevel supported = rk::simd_internal::getSupportedSimdLevel();
+    std::printf("Supported SIMD level: %s\n", rk::simd_internal::simdLevelToString(supported));
+
+    rk_logger_benchmarks::QuietCout quietCout;
+    std::unique_ptr<rk::config::Config> config = rk::config::createInstance();
+    config->setConfigValue(rk::config::timestamp_precision::KEY, rk::config::timestamp_precision::NS);
+    rk::time_internal::TimeStampFormatter formatter;
+    formatter.updateTimeStampFuncs(*config);
+    const rk::time_internal::time_point now = rk::time_internal::system_clock::now();
+
+    const std::vector<uint64_t> integers = createIntegers();
+    const std::string timeStamp = formatter.generateTimeStamp(now);
+    std::string scanBuffer(SCAN_BUFFER_SIZE, 'x');
+    scanBuffer.back() = ':';
+    std::string out;
+
+    std::printf("\n%-28s %10s %10s %10s %10s\n", "ns/op", "timestamp", "integer", "file name", "scan 4KB");
+    std::printf("%-28s %10s %10.2f %10.2f %10s\n", "std::to_chars / erase loop", "-",
+        nsPerOp(iterations, [&] (const size_t i) {
+            char digits[24];
+            return static_cast<size_t>(std::to_chars(digits, digits + sizeof(digits), integers[i % INTEGER_COUNT]).ptr - digits);
+        }),
+        nsPerOp(iterations / 10, [&] (size_t) { return convertWithErase(timeStamp).size(); }),
+        "-");
+    for (int level = 0; level <= static_cast<int>(supported); level++) {
+        rk::simd_internal::setSimdLevel(static_cast<rk::simd_internal::SimdLevel>(level));
+        std::printf("%-28s %10.2f %10.2f %10.2f %10.2f\n", rk::simd_internal::simdLevelToString(rk::simd_internal::getSimdLevel()),
+            nsPerOp(iterations, [&] (const size_t i) {
+                out.clear();
+                formatter.appendTimeStamp(now + std::chrono::microseconds(i), out);
+                return out.size();
+            }),
+            nsPerOp(iterations, [&] (const size_t i) {
+                char digits[rk::simd_internal::MAX_UNSIGNED_DIGITS];
+                return rk::simd_internal::renderUnsigned(integers[i % INTEGER_COUNT], digits);
+            }),
+            nsPerOp(iterations / 10, [&] (size_t) { return rk::time_internal::convertTimeStampForFileName(timeStamp).size(); }),
+            nsPerOp(iterations / 100, [&] (size_t) { return rk::simd_internal::findAnyOf(scanBuffer, "[]|: "); }));
+    }
+    rk::simd_internal::setSimdLevel(supported);
+
+    return 0;
+}
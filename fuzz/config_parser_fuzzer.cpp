@@ -0,0 +1,27 @@
+/**
+ * @file config_parser_fuzzer.cpp
+ * @brief libFuzzer target for the config file parser.
+ * 
+ * Build with -DRK_LOGGER_BUILD_FUZZERS=ON using Clang, then run, e.g., "rk_logger_config_parser_fuzzer -max_len=4096".
+ * The parser is given the raw input and every entry is checked to be well formed. Address and undefined behavior
+ * sanitizer errors are reported by the fuzzer.
+ */
+#include <cstdint>
+#include <cstdlib>
+#include <string_view>
+
+#include <rk_logger/config_parser.h>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    const std::string_view text(reinterpret_cast<const char*>(data), size);
+    rk::config_internal::ConfigParser parser(text);
+    rk::config_internal::ConfigEntry entry;
+    size_t lastLine = 0;
+    while (parser.next(entry)) {
+        if (entry.line <= lastLine || (entry.error == nullptr && entry.key.empty()) || entry.value.find('\n') != std::string_view::npos) {
+            std::abort();
+        }
+        lastLine = entry.line;
+    }
+    return 0;
+}
@@ -0,0 +1,122 @@
+/**
+ * @file batch.h
+ * @brief Header file for logging several related messages as one batch.
+ *
+ * Every RK_LOG call takes the queue lock and wakes the log thread. A batch collects its messages first and hands
+ * them to the queue all at once when it is committed, so a burst of related lines (e.g., a dump of a data structure)
+ * pays for that once. The lines of a batch are written together, without lines from other threads between them.
+ */
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <vector>
+
+#include <rk_logger/logger.h>
+
+/**
+ * @brief Adds a message at the given level to a batch. Like RK_LOG_TO_AT, the arguments are only evaluated if the
+ * batch's logger is enabled for the level at this call site.
+ */
+#define RK_LOG_BATCH_AT(batch, level, ...) \
+    do { \
+        const rk::log::Level rkLogLevel = (level); \
+        if (rk::log_internal::isCompiledIn(rkLogLevel)) { \
+            static rk::log_internal::CallSite rkLogCallSite(RK_LOG_MODULE, __FILE__); \
+            rk::log::Batch& rkLogBatch = (batch); \
+            if (rkLogBatch.getLogger().isEnabled(rkLogLevel, rkLogCallSite)) { \
+                rkLogBatch.add(rkLogLevel, rkLogCallSite, __func__, __VA_ARGS__); \
+            } \
+        } \
+    } while (0)
+
+/**
+ * @brief Adds a message to a batch at the INFO level.
+ */
+#define RK_LOG_BATCH(batch, ...) RK_LOG_BATCH_AT(batch, rk::log::Level::Info, __VA_ARGS__)
+
+namespace rk {
+namespace log {
+
+/**
+ * Collects messages for a logger and adds them to its queue in one step. A batch belongs to the thread that created
+ * it. Its buffer is reused by the next batch on the same thread, so batches don't allocate once they have warmed up.
+ */
+class Batch {
+public:
+    /**
+     * How the messages of a batch are timestamped.
+     */
+    enum class Timestamp {
+        PerMessage, /**< Each message has the time it was added */
+        Shared /**< Every message has the time the batch was committed */
+    };
+
+    /**
+     * @brief Creates an empty batch.
+     * 
+     * @param logger The logger that the messages are logged to.
+     * @param timestamp How the messages are timestamped.
+     */
+    explicit Batch(Logger& logger, Timestamp timestamp = Timestamp::PerMessage);
+
+    /**
+     * @brief Commits the messages that haven't been committed yet.
+     */
+    ~Batch();
+
+    Batch(const Batch&) = delete;
+    Batch& operator=(const Batch&) = delete;
+
+    /**
+     * @brief Adds a message to the batch.
+     * 
+     * This function should not be called by itself. Call it via the RK_LOG_BATCH macros.
+     * 
+     * @param level The level of the message.
+     * @param site The call site of the message.
+     * @param funcName The function that this is being called from.
+     * @param args The values to construct the message from.
+     */
+    template<typename... Args>
+    void add(const Level level, const rk::log_internal::CallSite& site, const char* funcName, Args&&... args) {
+        Record& record = records.emplace_back();
+        if (timestamp == Timestamp::PerMessage) {
+            logger.stampTime(record);
+        }
+        record.threadId = std::this_thread::get_id();
+        record.funcName = funcName;
+        record.level = level;
+        record.isForSinks = logger.isForSinks(level, site);
+        rk::log_internal::appendThreadContext(record);
+        (rk::log_internal::appendArg(record, std::forward<Args>(args)), ...);
+    }
+
+    /**
+     * @brief Adds the messages to the logger's queue. The batch is empty afterwards and can be used again.
+     */
+    void commit();
+
+    /**
+     * @brief Gets the number of messages that haven't been committed yet.
+     * 
+     * @return The number of messages.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Gets the logger that the messages are logged to.
+     * 
+     * @return The logger.
+     */
+    Logger& getLogger();
+
+private:
+    Logger& logger;
+    const Timestamp timestamp;
+    std::vector<Record> records;
+};
+
+} // namespace log
+} // namespace rk
+
+#endif // #ifndef BATCH_H
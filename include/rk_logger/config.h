@@ -11,6 +11,9 @@
 #include <cstdint>
 #include <filesystem>
 #include <sstream>
+#include <vector>
+#include <memory>
+#include <iostream>
 
 namespace rk {
 namespace config {
@@ -20,6 +23,8 @@ using ConfigValue = std::string;
 using ConfigMap = std::unordered_map<ConfigKey, ConfigValue>;
 using ValidValuesSet = std::unordered_set<ConfigValue>;
 using ValidKeyValuesMap = const std::unordered_map<ConfigKey, const ValidValuesSet>;
+using ValueValidator = bool (*)(const ConfigValue&);
+using ValidKeyValidatorsMap = const std::unordered_map<ConfigKey, const ValueValidator>;
 
 extern const std::string CONFIG_FILE_EXTENSION;
 extern const std::string CONFIG_FILE_NAME;
@@ -45,12 +50,202 @@ namespace hour_format {
     extern const std::string TWENTY_FOUR_HOUR; // 24-hour clock format, e.g., 8:30PM becomes "20:30:00.000"
 }
 
+namespace timestamp_precision {
+    extern const std::string KEY;
+    extern const std::string MS; // e.g., "08:30:00.123"
+    extern const std::string US; // e.g., "08:30:00.123456"
+    extern const std::string NS; // e.g., "08:30:00.123456789"
+    extern const std::string EPOCH_NS; // The whole timestamp is nanoseconds since the epoch, e.g., "[1738704600123456789]"
+}
+
+namespace time_zone {
+    extern const std::string KEY;
+    extern const std::string LOCAL; // The local time zone, including DST
+    extern const std::string UTC;
+}
+
 namespace write_to_log_file {
     extern const std::string KEY;
     extern const std::string ENABLE;
     extern const std::string DISABLE;
 }
 
+namespace write_to_console {
+    extern const std::string KEY;
+    extern const std::string ENABLE;
+    extern const std::string DISABLE;
+}
+
+namespace console_color {
+    extern const std::string KEY;
+    extern const std::string AUTO; // Colors messages by level if the console is a terminal
+    extern const std::string ENABLE;
+    extern const std::string DISABLE;
+}
+
+namespace write_to_syslog {
+    extern const std::string KEY;
+    extern const std::string DISABLE;
+    extern const std::string RFC5424; // RFC 5424 messages to the syslog socket, /dev/log by default
+    extern const std::string JOURNALD; // Native journald messages to the journal socket, /run/systemd/journal/socket by default
+}
+
+namespace syslog_socket_path {
+    extern const std::string KEY;
+    extern const std::string DEFAULT; // Otherwise an absolute path of up to 107 characters to a Unix datagram socket
+}
+
+namespace clock_source {
+    extern const std::string KEY;
+    extern const std::string SYSTEM; // Reads system_clock for every message
+    extern const std::string TSC; // Reads the CPU timestamp counter and converts it on the log thread. Falls back to STEADY without an invariant TSC
+    extern const std::string STEADY; // Reads steady_clock and converts it on the log thread
+}
+
+namespace log_level {
+    extern const std::string KEY;
+    extern const std::string DEFAULT_LEVEL; // One of TRACE, DEBUG, INFO, WARN, ERROR, FATAL, or OFF. See rk::log::Level
+}
+
+namespace module_level {
+    extern const std::string KEY_PREFIX; // Followed by a module tag or source file name, e.g., "level.net" or "level.order_book.cpp". Takes the same values as log_level
+}
+
+namespace flight_recorder_size_kb {
+    extern const std::string KEY;
+    extern const std::string DISABLED; // Any size from 0 to 1048576 KB. 0 turns the flight recorder off
+}
+
+namespace flight_recorder_level {
+    extern const std::string KEY;
+    extern const std::string DEFAULT_LEVEL; // Messages at or above this level are kept by the flight recorder, even if they are below log_level
+}
+
+namespace flight_recorder_trigger {
+    extern const std::string KEY;
+    extern const std::string DEFAULT_LEVEL; // A message at or above this level dumps the flight recorder. OFF only dumps it on request
+}
+
+namespace flight_recorder_signal {
+    extern const std::string KEY;
+    extern const std::string DISABLE;
+    extern const std::string ENABLE; // SIGUSR1 dumps the flight recorder. Only supported on POSIX systems
+}
+
+namespace log_transport {
+    extern const std::string KEY;
+    extern const std::string THREAD; // Messages are formatted and written by the logger's own threads
+    extern const std::string SHARED_MEMORY; // Messages are put in a shared-memory ring and written by the rk_log_agent process
+}
+
+namespace shm_name {
+    extern const std::string KEY;
+    extern const std::string DEFAULT; // "/rk_log_<logger name>". Otherwise a name of up to 255 characters that starts with '/' and has no other '/'
+}
+
+namespace shm_size_kb {
+    extern const std::string KEY;
+    extern const std::string DEFAULT_SIZE; // Any size from 64 to 1048576 KB
+}
+
+namespace log_shards {
+    extern const std::string KEY;
+    extern const std::string DEFAULT_COUNT; // Any number of shards from 1 to 64
+    extern const size_t MAX_COUNT;
+}
+
+namespace log_shard_ordering {
+    extern const std::string KEY;
+    extern const std::string GLOBAL; // Messages are written in the order they were logged across all threads
+    extern const std::string PER_THREAD; // Messages are only in order relative to other messages from the same thread
+}
+
+namespace log_shard_files {
+    extern const std::string KEY;
+    extern const std::string SHARED; // All shards write to one log file
+    extern const std::string PER_SHARD; // Each shard writes to its own log file. Only used with PER_THREAD ordering
+}
+
+namespace log_thread_name {
+    extern const std::string KEY;
+    extern const std::string DEFAULT_NAME; // Any name of 1-15 characters made of letters, digits, '_' or '-'
+}
+
+namespace log_thread_cpu_affinity {
+    extern const std::string KEY;
+    extern const std::string NONE; // Otherwise a CPU list, e.g., "2" or "0,2-3"
+}
+
+namespace log_thread_sched_policy {
+    extern const std::string KEY;
+    extern const std::string DEFAULT; // Leave the scheduling policy inherited from the creating thread
+    extern const std::string OTHER;
+    extern const std::string BATCH;
+    extern const std::string IDLE;
+    extern const std::string FIFO;
+    extern const std::string RR;
+}
+
+namespace log_thread_priority {
+    extern const std::string KEY;
+    extern const std::string DEFAULT; // Otherwise an integer. Nice value for OTHER/BATCH/IDLE, real-time priority for FIFO/RR
+}
+
+namespace log_thread_numa_local {
+    extern const std::string KEY;
+    extern const std::string ENABLE;
+    extern const std::string DISABLE;
+}
+
+namespace shutdown_drain_ms {
+    extern const std::string KEY;
+    extern const std::string UNLIMITED; // Otherwise the most time in ms from 0 to 3600000 that stopping the logger spends writing the messages that are still queued
+}
+
+namespace shutdown_leftovers {
+    extern const std::string KEY;
+    extern const std::string DROP; // Messages that are still queued when the drain time runs out are dropped and counted in the log
+    extern const std::string SPILL; // Messages that are still queued when the drain time runs out are written to a separate file in one write
+}
+
+namespace fork_log_file {
+    extern const std::string KEY;
+    extern const std::string SHARED; // A child process keeps writing to the log file of its parent
+    extern const std::string PER_PID; // A child process writes to its own log file, named with its process id
+}
+
+namespace log_file_compression {
+    extern const std::string KEY;
+    extern const std::string NONE; // The log file is plain text
+    extern const std::string LZ4; // The log file is compressed into LZ4 frames and named "<log file>.txt.lz4"
+}
+
+namespace log_file_compression_level {
+    extern const std::string KEY;
+    extern const std::string DEFAULT_LEVEL; // Any level from 1 (fastest) to 9 (smallest)
+}
+
+namespace log_file_frame_ms {
+    extern const std::string KEY;
+    extern const std::string DEFAULT_MS; // Any time in ms from 0 to 60000 that a compressed frame stays open for before it is finished and can be decoded. 0 finishes a frame on every batch
+}
+
+namespace log_file_index {
+    extern const std::string KEY;
+    extern const std::string ENABLE; // An index of times and offsets is written next to the log file, to "<log file>.txt.idx", for rk_log_query. Ignored for compressed log files
+    extern const std::string DISABLE;
+}
+
+namespace log_file_index_records {
+    extern const std::string KEY;
+    extern const std::string DEFAULT_RECORDS; // Any count from 1 to 1000000 of messages that an index entry covers at most
+}
+
+namespace log_file_index_kb {
+    extern const std::string KEY;
+    extern const std::string DEFAULT_KB; // Any size in KB from 1 to 65536 of the log file that an index entry covers at most
+}
+
 /**
  * Represents the configuration used by the logger. Settings are set to default values on startup and can be changed by providing a config file or changing
  * settings at runtime.
@@ -61,6 +256,7 @@ public:
     Config(const Config&) = delete;
     Config& operator=(const Config&) = delete;
     friend Config& getInstance();
+    friend std::unique_ptr<Config> createInstance();
 
     /**
      * @brief Sets a value for a key/value pair in the Config.
@@ -68,7 +264,7 @@ public:
      * @param ConfigKey The key to change the value for.
      * @param ConfigValue The value to change it to.
      */
-    void setConfigValue(const ConfigKey, const ConfigValue);
+    void setConfigValue(const ConfigKey&, const ConfigValue&);
 
     /**
      * @brief Gets the current config's value for a given key.
@@ -76,7 +272,7 @@ public:
      * @param ConfigKey The key.
      * @return The corresponding value.
      */
-    ConfigValue getConfigValueByKey(const ConfigKey) const;
+    ConfigValue getConfigValueByKey(const ConfigKey&) const;
 
     /**
      * @brief Parses the logging config file and updates the settings based on the contents.
@@ -91,7 +287,7 @@ public:
      * @param ConfigKey The key to check.
      * @return True if key is valid, false otherwise.
      */
-    bool isKeyValid(const ConfigKey) const;
+    bool isKeyValid(const ConfigKey&) const;
 
     /**
      * @brief Checks if both a key and value are valid.
@@ -100,7 +296,7 @@ public:
      * @param ConfigValue The corresponding value to check.
      * @return True if both key and value are valid, false otherwise.
      */
-    bool isKeyAndValueValid(const ConfigKey, const ConfigValue) const;
+    bool isKeyAndValueValid(const ConfigKey&, const ConfigValue&) const;
 
     /**
      * @brief Returns valid key/value pairs for the config.
@@ -108,11 +304,36 @@ public:
      * @return ValidKeyValuesMap The map containing valid key/value pairs for the config.
      */
     const ValidKeyValuesMap& getValidKeyValues() const;
+
+    /**
+     * @brief Returns the validators for keys whose values are not from a fixed set, e.g., numbers or CPU lists.
+     * 
+     * @return ValidKeyValidatorsMap The map containing the validator for each free-form key.
+     */
+    const ValidKeyValidatorsMap& getValidKeyValidators() const;
+
+    /**
+     * @brief Gets the keys that start with a prefix and their values, e.g., all the module levels.
+     * 
+     * @param prefix The prefix of the keys.
+     * @return The matching keys and their values.
+     */
+    ConfigMap getConfigValuesWithPrefix(const std::string& prefix) const;
 private:
-    Config(ConfigMap defaultConfig, ValidKeyValuesMap keyValues) : config(defaultConfig), validKeyValues(keyValues) {};
+    /**
+     * @brief Checks if a value is valid for a key that is already known to be valid.
+     * 
+     * @param ConfigKey The key, which must be valid.
+     * @param ConfigValue The value to check.
+     * @return True if the value is valid for the key, false otherwise.
+     */
+    bool isValueValid(const ConfigKey&, const ConfigValue&) const;
+
+    Config(ConfigMap defaultConfig, ValidKeyValuesMap keyValues, ValidKeyValidatorsMap keyValidators) : config(defaultConfig), validKeyValues(keyValues), validKeyValidators(keyValidators) {};
 
     ConfigMap config;
     ValidKeyValuesMap validKeyValues;
+    ValidKeyValidatorsMap validKeyValidators;
 };
 
 /**
@@ -122,6 +343,15 @@ private:
  */
 Config& getInstance();
 
+/**
+ * @brief Creates a new config with the default settings, separate from the one returned by getInstance().
+ * 
+ * Used by loggers that need their own settings.
+ * 
+ * @return The new config.
+ */
+std::unique_ptr<Config> createInstance();
+
 } // namespace config
 } // namespace rk
 
@@ -132,10 +362,70 @@ namespace config_internal {
 extern const rk::config::ValidValuesSet dateFormat;
 extern const rk::config::ValidValuesSet monthFormat;
 extern const rk::config::ValidValuesSet hourFormat;
+extern const rk::config::ValidValuesSet timestampPrecision;
+extern const rk::config::ValidValuesSet timeZone;
 extern const rk::config::ValidValuesSet writeToLogFile;
+extern const rk::config::ValidValuesSet writeToConsole;
+extern const rk::config::ValidValuesSet writeToSyslog;
+extern const rk::config::ValidValuesSet logLevel;
+extern const rk::config::ValidValuesSet clockSource;
+extern const rk::config::ValidValuesSet flightRecorderSignal;
+extern const rk::config::ValidValuesSet logTransport;
+extern const rk::config::ValidValuesSet consoleColor;
+extern const rk::config::ValidValuesSet logShardOrdering;
+extern const rk::config::ValidValuesSet logShardFiles;
+extern const rk::config::ValidValuesSet logThreadSchedPolicy;
+extern const rk::config::ValidValuesSet logThreadNumaLocal;
+extern const rk::config::ValidValuesSet shutdownLeftovers;
+extern const rk::config::ValidValuesSet forkLogFile;
+extern const rk::config::ValidValuesSet logFileCompression;
+extern const rk::config::ValidValuesSet logFileIndex;
 extern rk::config::ValidKeyValuesMap validKeyValues;
+extern rk::config::ValidKeyValidatorsMap validKeyValidators;
 extern const rk::config::ConfigMap defaultConfig;
 
+/**
+ * @brief Parses a CPU list such as "2" or "0,2-3" into the individual CPU numbers.
+ * 
+ * @param value The CPU list to parse.
+ * @param cpus Output for the CPU numbers in the order they appear.
+ * @return True if the whole value was a valid CPU list, false otherwise.
+ */
+bool parseCpuList(const rk::config::ConfigValue& value, std::vector<int>& cpus);
+
+/**
+ * @brief Parses a signed base-10 integer that makes up the entire value.
+ * 
+ * @param value The value to parse.
+ * @param number Output for the parsed number.
+ * @return True if the whole value was a valid integer, false otherwise.
+ */
+bool parseInteger(const rk::config::ConfigValue& value, int& number);
+
+/**
+ * @brief Checks if a key is a module level key, i.e., the module_level prefix followed by a module tag or file name
+ * made of letters, digits, '_', '-', or '.'.
+ * 
+ * @param key The key to check.
+ * @return True if it is a module level key, false otherwise.
+ */
+bool isModuleLevelKey(const rk::config::ConfigKey& key);
+
+// Validators for the free-form keys
+bool isValidSyslogSocketPath(const rk::config::ConfigValue&);
+bool isValidFlightRecorderSize(const rk::config::ConfigValue&);
+bool isValidShmName(const rk::config::ConfigValue&);
+bool isValidShmSize(const rk::config::ConfigValue&);
+bool isValidShardCount(const rk::config::ConfigValue&);
+bool isValidThreadName(const rk::config::ConfigValue&);
+bool isValidCpuAffinity(const rk::config::ConfigValue&);
+bool isValidThreadPriority(const rk::config::ConfigValue&);
+bool isValidDrainTime(const rk::config::ConfigValue&);
+bool isValidCompressionLevel(const rk::config::ConfigValue&);
+bool isValidFrameTime(const rk::config::ConfigValue&);
+bool isValidIndexRecordCount(const rk::config::ConfigValue&);
+bool isValidIndexSize(const rk::config::ConfigValue&);
+
 /**
  * @brief Prints an internal log message for the config module.
  * 
@@ -0,0 +1,122 @@
+/**
+ * @file config_parser.h
+ * @brief Header file for reading the config file.
+ *
+ * The parser supports the subset of YAML that the config file uses: "key: value" lines, comments, quoted values,
+ * and nested sections. Keys inside a section are flattened into dotted names, e.g., "value" under "section:" becomes
+ * "section.value". The parser works on a view of the whole file and returns views into it, so reading a config
+ * doesn't copy or allocate per line.
+ */
+#ifndef CONFIG_PARSER_H
+#define CONFIG_PARSER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <filesystem>
+
+namespace rk {
+namespace config_internal {
+
+/**
+ * One key/value pair, or one syntax error, from the config file.
+ */
+struct ConfigEntry {
+    size_t line = 0; /**< Starts at 1 */
+    std::string_view key; /**< The full dotted key. Valid until the next call to ConfigParser::next() */
+    std::string_view value; /**< Without quotes or comments. Valid until the next call to ConfigParser::next() */
+    const char* error = nullptr; /**< Set if the line could not be parsed, in which case the key and value are empty */
+};
+
+/**
+ * Reads the entries of a config file one at a time.
+ *
+ * Lines are parsed as follows:
+ * - Blank lines and lines that start with '#' are skipped.
+ * - A '#' that follows a space or tab starts a comment. A '#' anywhere else is part of the value, e.g., "a#b".
+ * - Values can be quoted with '"' or '\''. Double quotes support the escapes \" and \\. In single quotes, '' is a
+ *   single quote. Quoted values can contain '#' and keep their leading and trailing whitespace.
+ * - A key with no value starts a section. The lines under it that are indented further belong to it.
+ * - Tabs can't be used for indentation and lines without a ':' are errors. Errors are reported with their line
+ *   number and the parser continues with the next line.
+ */
+class ConfigParser {
+public:
+    /**
+     * @brief Creates a parser for the text of a config file.
+     *
+     * @param text The text. It must outlive the parser and the entries it returns.
+     */
+    explicit ConfigParser(std::string_view text);
+
+    /**
+     * @brief Reads the next key/value pair or error.
+     *
+     * @param entry Output for the entry.
+     * @return True if an entry was read, false at the end of the text.
+     */
+    bool next(ConfigEntry& entry);
+
+private:
+    struct Section {
+        size_t indent;
+        size_t keySize; /**< The size of the section's full dotted key in keyBuffer */
+    };
+
+    /**
+     * @brief Parses a quoted value that starts at the current position of the line.
+     *
+     * @param line The rest of the line, starting at the opening quote.
+     * @param entry Output for the value, or the error.
+     */
+    void parseQuotedValue(std::string_view line, ConfigEntry& entry);
+
+    std::string_view text;
+    size_t pos = 0;
+    size_t lineNumber = 0;
+    std::vector<Section> sections;
+    std::string keyBuffer; /**< Only used for keys inside a section, which have to be joined with their section */
+    std::string valueBuffer; /**< Only used for quoted values with escapes */
+};
+
+/**
+ * A read-only view of a whole file. The file is memory-mapped where that is supported, and read into memory otherwise.
+ */
+class FileView {
+public:
+    /**
+     * @brief Opens a file. Check isOpen() afterwards.
+     *
+     * @param path The path to the file.
+     */
+    explicit FileView(const std::filesystem::path& path);
+    ~FileView();
+
+    FileView(const FileView&) = delete;
+    FileView& operator=(const FileView&) = delete;
+
+    /**
+     * @brief Checks if the file was opened.
+     *
+     * @return True if it was opened, false otherwise.
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Gets the contents of the file.
+     *
+     * @return The contents. Valid as long as the FileView is.
+     */
+    std::string_view getText() const;
+
+private:
+    bool isFileOpen = false;
+    void* mapping = nullptr; /**< Only set if the file is memory-mapped */
+    size_t mappingSize = 0;
+    std::string contents; /**< Only used if the file is not memory-mapped */
+};
+
+} // namespace config_internal
+} // namespace rk
+
+#endif // #ifndef CONFIG_PARSER_H
@@ -0,0 +1,112 @@
+/**
+ * @file flight_recorder.h
+ * @brief Header file for the flight recorder, which keeps the most recent log messages in memory.
+ */
+#ifndef FLIGHT_RECORDER_H
+#define FLIGHT_RECORDER_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <rk_logger/level.h>
+#include <rk_logger/log_time.h>
+
+namespace rk {
+namespace log {
+
+/**
+ * A message as the flight recorder keeps it, i.e., the parts of a record without the timestamp, thread id, and
+ * function name prefix, which is only formatted if the recorder is dumped.
+ */
+struct RecordedMessage {
+    rk::time_internal::time_point time; /**< Only set if ticks is 0 */
+    uint64_t ticks = 0; /**< Raw ticks from the logger's TickClock. Converted to the time when the recorder is dumped */
+    std::thread::id threadId;
+    const char* funcName = ""; /**< Points to __func__, which has static storage */
+    Level level = Level::Info;
+    std::string_view message; /**< The message with its owned and deferred arguments spliced in */
+};
+
+/**
+ * A fixed-size circular buffer of the most recent log messages. When a new message doesn't fit, the oldest messages
+ * are dropped to make room, so the buffer never allocates after it is created. Nothing is formatted or written out
+ * until the recorder is dumped.
+ *
+ * A logger only uses its flight recorder from the thread that writes to its sinks, the same as a sink, so the
+ * logging threads never touch it.
+ */
+class FlightRecorder {
+public:
+    /**
+     * @brief Creates an empty flight recorder.
+     *
+     * @param capacity The size of the buffer in bytes. Each message takes ENTRY_OVERHEAD bytes more than its length.
+     */
+    explicit FlightRecorder(size_t capacity);
+
+    /**
+     * @brief Adds a message, dropping the oldest messages if there isn't room for it. A message that is larger than
+     * the whole buffer is cut down to fit.
+     *
+     * @param message The message.
+     */
+    void write(const RecordedMessage& message);
+
+    /**
+     * @brief Passes every message that is in the buffer to a function, from oldest to newest.
+     *
+     * @param func The function. The message text that it is given is only valid during the call.
+     */
+    void forEach(const std::function<void(const RecordedMessage&)>& func) const;
+
+    /**
+     * @brief Drops every message.
+     */
+    void clear();
+
+    /**
+     * @brief Gets the number of messages in the buffer.
+     *
+     * @return The number of messages.
+     */
+    size_t getMessageCount() const;
+
+    /**
+     * The fields of a message that are stored in front of its text.
+     */
+    struct EntryHeader {
+        uint32_t size; /**< The length of the text */
+        Level level;
+        bool isTicks; /**< Whether stamp holds ticks rather than nanoseconds since the epoch */
+        uint64_t stamp;
+        std::thread::id threadId;
+        const char* funcName;
+    };
+
+    static constexpr size_t ENTRY_OVERHEAD = sizeof(EntryHeader); /**< The bytes that each message takes besides its text */
+
+private:
+    /**
+     * @brief Copies bytes into the buffer at a position, wrapping around the end.
+     */
+    void copyIn(size_t position, const char* data, size_t size);
+
+    /**
+     * @brief Copies bytes out of the buffer from a position, wrapping around the end.
+     */
+    void copyOut(size_t position, char* data, size_t size) const;
+
+    std::vector<char> buffer;
+    size_t oldest = 0; /**< Where the oldest message starts */
+    size_t used = 0; /**< Bytes in use, including the headers */
+    size_t messageCount = 0;
+};
+
+} // namespace log
+} // namespace rk
+
+#endif // #ifndef FLIGHT_RECORDER_H
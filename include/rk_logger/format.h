@@ -0,0 +1,293 @@
+/**
+ * @file format.h
+ * @brief Header file for writing log arguments into a record, and for the wrappers that change how an argument is written.
+ * 
+ * Strings and numbers are written straight into the record's message. Types with an rk::log::formatter are written
+ * with it, and other types go through their operator<<.
+ */
+#ifndef FORMAT_H
+#define FORMAT_H
+
+#include <charconv>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include <rk_logger/record.h>
+#include <rk_logger/simd.h>
+
+namespace rk {
+namespace log {
+
+/**
+ * A log argument that wraps a callable. The callable is not called by the logging thread. It is stored in the record
+ * and called by the log thread when the record is formatted, and what it returns is written in its place.
+ */
+template<typename Func>
+struct Deferred {
+    Func func;
+};
+
+/**
+ * @brief Wraps a callable so that it is only called on the log thread, e.g., for expensive debug dumps.
+ * 
+ * The callable must return something that can be written to a std::ostream. It runs after the logging thread has
+ * moved on, so it should capture what it needs by value.
+ * 
+ * Example: RK_LOG_DEBUG("State: ", rk::log::defer([snapshot] () { return snapshot.dump(); }), "\n");
+ * 
+ * @param func The callable.
+ * @return The wrapped callable.
+ */
+template<typename Func>
+Deferred<std::decay_t<Func>> defer(Func&& func) {
+    return Deferred<std::decay_t<Func>>{ std::forward<Func>(func) };
+}
+
+/**
+ * A log argument that borrows characters that aren't null terminated, or that the caller only has a view of.
+ */
+struct View {
+    std::string_view text;
+};
+
+/**
+ * @brief Wraps characters that are written into the message right away, without making a std::string first.
+ * 
+ * @param data The characters. They only need to be valid during the RK_LOG call.
+ * @param size The number of characters.
+ * @return The wrapped characters.
+ */
+inline View view(const char* data, const size_t size) {
+    return View{ std::string_view(data, size) };
+}
+
+/**
+ * @brief Wraps a string view that is written into the message right away.
+ * 
+ * @param text The characters. They only need to be valid during the RK_LOG call.
+ * @return The wrapped characters.
+ */
+inline View view(const std::string_view text) {
+    return View{ text };
+}
+
+/**
+ * A log argument that gives its string to the record instead of having it copied into the message.
+ */
+struct Owned {
+    std::string text;
+};
+
+/**
+ * @brief Moves a string into the record. The logging thread doesn't copy it; the log thread writes it into the log
+ * line when the record is formatted. Meant for large payloads.
+ * 
+ * @param text The string to move.
+ * @return The wrapped string.
+ */
+inline Owned owned(std::string&& text) {
+    return Owned{ std::move(text) };
+}
+
+/**
+ * A log argument for binary data that is written as hex bytes, e.g., "de ad be ef".
+ */
+struct Hex {
+    const uint8_t* data;
+    size_t size;
+};
+
+/**
+ * @brief Wraps binary data that is written into the message as hex bytes right away.
+ * 
+ * @param data The data. It only needs to be valid during the RK_LOG call.
+ * @param size The number of bytes.
+ * @return The wrapped data.
+ */
+inline Hex hex(const void* data, const size_t size) {
+    return Hex{ static_cast<const uint8_t*>(data), size };
+}
+
+/**
+ * Writes a type into the message without its operator<< and a std::ostringstream. A type with a formatter is written
+ * with it even if it has an operator<<. Specialize it with:
+ * 
+ * - static constexpr size_t max_size: The most characters that format_to() writes.
+ * - static size_t format_to(char* out, const T& value): Writes the value to out and returns how many characters it wrote.
+ * - static constexpr bool is_deferred = true (optional): Copies the value's bytes into the record and calls
+ *   format_to() on the log thread instead, so the logging thread doesn't format it at all. T must be trivially
+ *   copyable, and must not point to anything that could be gone by the time the record is formatted.
+ * 
+ * The second parameter allows partial specializations for families of types, e.g., with std::enable_if_t.
+ * 
+ * Example:
+ * template<>
+ * struct rk::log::formatter<OrderId> {
+ *     static constexpr size_t max_size = 20;
+ *     static size_t format_to(char* out, const OrderId& id) { return std::to_chars(out, out + max_size, id.value).ptr - out; }
+ * };
+ */
+template<typename T, typename Enable = void>
+struct formatter {};
+
+} // namespace log
+} // namespace rk
+
+namespace rk {
+namespace log_internal {
+
+template<typename T, typename = void>
+struct HasFormatter : std::false_type {};
+
+template<typename T>
+struct HasFormatter<T, std::void_t<decltype(rk::log::formatter<T>::max_size),
+    decltype(rk::log::formatter<T>::format_to(std::declval<char*>(), std::declval<const T&>()))>> : std::true_type {};
+
+template<typename T, typename = void>
+struct IsFormatterDeferred : std::false_type {};
+
+template<typename T>
+struct IsFormatterDeferred<T, std::enable_if_t<rk::log::formatter<T>::is_deferred>> : std::true_type {};
+
+/**
+ * @brief Writes a value with its formatter.
+ * 
+ * @param out The string to append to.
+ * @param value The value.
+ */
+template<typename T>
+void appendFormatted(std::string& out, const T& value) {
+    const size_t size = out.size();
+    out.resize(size + rk::log::formatter<T>::max_size);
+    out.resize(size + rk::log::formatter<T>::format_to(&out[size], value));
+}
+
+/**
+ * @brief Writes a value whose bytes were copied into a record, for arguments with a deferred formatter.
+ * 
+ * @param bytes The bytes of the value.
+ * @param out The string to append to.
+ */
+template<typename T>
+void appendFormattedBytes(const std::string& bytes, std::string& out) {
+    alignas(T) unsigned char storage[sizeof(T)];
+    std::memcpy(storage, bytes.data(), sizeof(T));
+    appendFormatted(out, *std::launder(reinterpret_cast<const T*>(storage)));
+}
+
+template<typename T>
+struct IsDeferred : std::false_type {};
+
+template<typename Func>
+struct IsDeferred<rk::log::Deferred<Func>> : std::true_type {};
+
+template<typename T>
+constexpr bool isCharType = std::is_same_v<T, char> || std::is_same_v<T, signed char> || std::is_same_v<T, unsigned char>;
+
+/**
+ * @brief Writes binary data as hex bytes separated by spaces.
+ * 
+ * @param out The string to append to.
+ * @param hex The data.
+ */
+void appendHex(std::string& out, const rk::log::Hex& hex);
+
+/**
+ * @brief Writes a floating-point number the same way a std::ostream does by default.
+ * 
+ * @param out The string to append to.
+ * @param number The number.
+ */
+void appendFloat(std::string& out, long double number);
+
+/**
+ * @brief Writes a log argument into the message of a record.
+ * 
+ * Strings, characters, and numbers are appended directly. An rvalue std::string that starts the message is moved into
+ * it rather than copied. A type with an rk::log::formatter is written with it, or only copied if the formatter is
+ * deferred. Anything else is written with its operator<<, the same as before the arguments were written directly,
+ * so the output doesn't change.
+ * 
+ * @param record The record that the message is for.
+ * @param arg The argument.
+ */
+template<typename T>
+void appendArg(rk::log::Record& record, T&& arg) {
+    using Type = std::decay_t<T>;
+    std::string& out = record.message;
+    if constexpr (std::is_same_v<Type, std::string>) {
+        if constexpr (std::is_rvalue_reference_v<T&&> && !std::is_const_v<std::remove_reference_t<T>>) {
+            if (out.empty()) {
+                out = std::move(arg);
+                return;
+            }
+        }
+        out += arg;
+    }
+    else if constexpr (std::is_same_v<Type, rk::log::View>) {
+        out += arg.text;
+    }
+    else if constexpr (std::is_same_v<Type, rk::log::Owned>) {
+        record.spliced.push_back({ out.size(), std::move(arg.text), nullptr });
+    }
+    else if constexpr (std::is_same_v<Type, rk::log::Hex>) {
+        appendHex(out, arg);
+    }
+    else if constexpr (IsDeferred<Type>::value) {
+        record.spliced.push_back({ out.size(), std::string(), [func = arg.func] (std::ostream& stream) { stream << func(); } });
+    }
+    else if constexpr (std::is_array_v<std::remove_reference_t<T>> && std::is_same_v<std::remove_cv_t<std::remove_extent_t<std::remove_reference_t<T>>>, char>) {
+        out += arg; // A string literal or char buffer can't be null
+    }
+    else if constexpr (std::is_same_v<Type, const char*> || std::is_same_v<Type, char*>) {
+        if (arg != nullptr) {
+            out += arg;
+        }
+    }
+    else if constexpr (std::is_same_v<Type, std::string_view>) {
+        out += arg;
+    }
+    else if constexpr (isCharType<Type>) {
+        out += static_cast<char>(arg);
+    }
+    else if constexpr (std::is_same_v<Type, bool>) {
+        out += arg ? '1' : '0';
+    }
+    else if constexpr (std::is_integral_v<Type> && sizeof(Type) <= sizeof(uint64_t)) {
+        rk::simd_internal::appendInteger(out, arg);
+    }
+    else if constexpr (std::is_integral_v<Type>) {
+        char digits[48];
+        const std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), arg);
+        out.append(digits, result.ptr);
+    }
+    else if constexpr (std::is_floating_point_v<Type>) {
+        appendFloat(out, arg);
+    }
+    else if constexpr (HasFormatter<Type>::value && IsFormatterDeferred<Type>::value) {
+        static_assert(std::is_trivially_copyable_v<Type>, "A deferred rk::log::formatter needs a trivially copyable type");
+        record.spliced.push_back({ out.size(), std::string(reinterpret_cast<const char*>(&arg), sizeof(Type)), nullptr, &appendFormattedBytes<Type> });
+    }
+    else if constexpr (HasFormatter<Type>::value) {
+        appendFormatted(out, arg);
+    }
+    else {
+        std::ostringstream oss;
+        oss << arg;
+        out += oss.str();
+    }
+}
+
+} // namespace log_internal
+} // namespace rk
+
+#endif // #ifndef FORMAT_H
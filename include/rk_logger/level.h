@@ -0,0 +1,82 @@
+/**
+ * @file level.h
+ * @brief Header file for the log levels.
+ */
+#ifndef LEVEL_H
+#define LEVEL_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace rk {
+namespace log {
+
+/**
+ * The severity of a log message. A logger only logs messages at or above its level. Off is only used as a logger's
+ * level, to log nothing.
+ * 
+ * The names aren't in all caps because names like ERROR and DEBUG are commonly defined as macros.
+ */
+enum class Level : uint8_t {
+    Trace,
+    Debug,
+    Info,
+    Warn,
+    Error,
+    Fatal,
+    Off,
+};
+
+/**
+ * @brief Gets the name of a level as it is written in the config, e.g., "DEBUG".
+ * 
+ * @param level The level.
+ * @return The name.
+ */
+const char* levelToString(Level level);
+
+/**
+ * @brief Parses a level name as it is written in the config, e.g., "DEBUG".
+ * 
+ * @param value The name to parse.
+ * @param level Output for the level.
+ * @return True if the name was a valid level, false otherwise.
+ */
+bool parseLevel(const std::string& value, Level& level);
+
+} // namespace log
+} // namespace rk
+
+namespace rk {
+namespace log_internal {
+
+/**
+ * The state of one log statement. The macros create one per call site as a static, which is constant initialized,
+ * so it costs nothing until the statement first runs.
+ *
+ * The first time the statement runs, the logger works out the effective level for it, i.e., the level for its
+ * module or file if one is configured and the logger's level otherwise. That result is cached here with the id of
+ * the logger, so later checks are a single load. Two thresholds are cached: the one for writing to the sinks and the
+ * one for logging at all, which is lower when the logger's flight recorder keeps messages below the sink level. The
+ * logger clears the cache of its call sites whenever a level changes. A call site is only cached for the first
+ * logger it logs to. Checks against any other logger take the slow path.
+ */
+struct CallSite {
+    constexpr CallSite(const char* module, const char* file) : module(module), file(file) {}
+
+    static constexpr uint32_t LOGGER_ID_SHIFT = 16;
+    static constexpr uint32_t SINK_THRESHOLD_SHIFT = 8;
+    static constexpr uint64_t THRESHOLD_MASK = 0xFF;
+
+    const char* const module; /**< Set with RK_LOG_MODULE, or null */
+    const char* const file; /**< __FILE__ of the call site */
+    std::atomic<uint64_t> cached{0}; /**< The logger id above LOGGER_ID_SHIFT, the sink threshold in the second byte, and the threshold in the low byte. 0 means not cached */
+    uint32_t ownerId = 0; /**< The logger that caches this call site. Guarded by the call site mutex of the logger module */
+    CallSite* next = nullptr; /**< The next call site of the owner. Guarded by the logger's call site mutex */
+};
+
+} // namespace log_internal
+} // namespace rk
+
+#endif // #ifndef LEVEL_H
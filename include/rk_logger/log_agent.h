@@ -0,0 +1,113 @@
+/**
+ * @file log_agent.h
+ * @brief Header file for the agent that writes the log of another process from its shared-memory ring.
+ *
+ * An application that is started with "log_transport: SHARED_MEMORY" only copies its records into a shared-memory
+ * ring. The agent, usually run as rk_log_agent, formats them and writes them to the console, log file, syslog, and
+ * any added sinks, so none of that work is done on the application's cores. Records that were committed to the ring
+ * are written even if the application crashes.
+ */
+#ifndef LOG_AGENT_H
+#define LOG_AGENT_H
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <rk_logger/config.h>
+#include <rk_logger/log_time.h>
+#include <rk_logger/shm_ring.h>
+#include <rk_logger/sink.h>
+#include <rk_logger/tick_clock.h>
+
+namespace rk {
+namespace log {
+
+/**
+ * Reads the ring of one application and writes its records. Only one agent may be attached to a ring.
+ */
+class LogAgent {
+public:
+    /**
+     * @brief Creates an agent for a ring. Call attach() and then run().
+     *
+     * @param shmName The name of the ring's shared-memory object, e.g., "/rk_log_default".
+     * @param config The config for the output, e.g., write_to_console and the timestamp format. It must outlive the agent.
+     */
+    LogAgent(const std::string& shmName, rk::config::Config& config);
+
+    /**
+     * @brief Adds a sink that records are written to, in addition to the ones from the config.
+     *
+     * @param sink The sink to add.
+     */
+    void addSink(std::shared_ptr<Sink> sink);
+
+    /**
+     * @brief Attaches to the ring, waiting for the application to create it if it doesn't exist yet.
+     *
+     * @param timeout How long to wait for the ring.
+     * @return True if the agent is attached, false if the ring didn't show up in time.
+     */
+    bool attach(std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Writes the records from the ring until the application stops its logger or exits and the ring is empty.
+     * The ring is removed afterwards. Does nothing if the agent isn't attached.
+     */
+    void run();
+
+    /**
+     * @brief Gets the number of records that were written.
+     *
+     * @return The number of records.
+     */
+    uint64_t getWrittenCount() const;
+
+    /**
+     * @brief Gets the number of records that were dropped, as of the end of run(). That is the records that didn't fit
+     * in the ring, and the ones that the application was still writing when it crashed.
+     *
+     * @return The number of records.
+     */
+    uint64_t getDroppedCount() const;
+
+private:
+    /**
+     * @brief Creates the console, log file, and syslog sinks from the config.
+     */
+    void openConfiguredSinks();
+
+    /**
+     * @brief Writes the records that are in the ring to the sinks and flushes them.
+     *
+     * @param isProducerDone Whether the application was done before the records were read.
+     * @return The number of records that were written.
+     */
+    size_t writeAvailable(bool isProducerDone);
+
+    /**
+     * @brief Formats a record into a complete log line, the same way as the logger would.
+     *
+     * @param record The record to format.
+     * @param calibration Converts the record's ticks to its time, if it has ticks.
+     * @param out The string to write the line to. Its contents are replaced.
+     * @return The level, time, and thread of the record. The thread id points into out.
+     */
+    MessageInfo formatRecord(const rk::shm_internal::RecordView& record, const rk::time_internal::TickCalibration& calibration, std::string& out) const;
+
+    const std::string shmName;
+    rk::config::Config& config;
+    rk::time_internal::TimeStampFormatter timeStampFormatter;
+    rk::time_internal::TickClock tickClock;
+    std::unique_ptr<rk::shm_internal::RingReader> reader;
+    std::vector<std::shared_ptr<Sink>> sinks;
+    uint64_t writtenCount = 0;
+    uint64_t droppedCount = 0;
+};
+
+} // namespace log
+} // namespace rk
+
+#endif // #ifndef LOG_AGENT_H
@@ -0,0 +1,122 @@
+/**
+ * @file log_grep.h
+ * @brief Header file for searching log files for messages, which rk_log_grep uses to search huge logs on every core.
+ *
+ * A log is split into messages at the lines that start with a timestamp in the format of the log's config, so a
+ * message with several lines is kept together. A large log is split into chunks at message boundaries, and the
+ * chunks are searched in parallel and written out in order.
+ */
+#ifndef LOG_GREP_H
+#define LOG_GREP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <regex>
+#include <string>
+#include <string_view>
+
+#include <rk_logger/log_time.h>
+
+namespace rk {
+namespace grep_internal {
+
+constexpr size_t DEFAULT_CHUNK_SIZE = 4 * 1024 * 1024; /**< Large enough that splitting is cheap, small enough to spread a file over the cores */
+
+/**
+ * What a message has to match. Every filter that is set has to match.
+ */
+struct GrepFilter {
+    int64_t fromNs = INT64_MIN; /**< The earliest time, in nanoseconds since the epoch */
+    int64_t toNs = INT64_MAX; /**< The latest time, inclusive */
+    std::string threadId; /**< The thread id as it is printed in the log. Empty for every thread */
+    std::string funcName; /**< The function name as it is printed in the log. Empty for every function */
+    std::string text; /**< Text that the message has to contain, after the prefix. Empty for any message */
+    std::shared_ptr<const std::regex> pattern; /**< A pattern that has to be found in the message, after the prefix */
+};
+
+/**
+ * The parts of the prefix of a message, i.e., "[<timestamp>][<thread id>][<function>]".
+ */
+struct MessagePrefix {
+    int64_t timeNs = 0;
+    std::string_view threadId;
+    std::string_view funcName;
+    size_t size = 0; /**< Where the message itself starts */
+};
+
+/**
+ * Searches a log for the messages that match a filter. It only reads from the log and the filter, so one searcher can
+ * be used by several threads at once.
+ */
+class LogGrep {
+public:
+    /**
+     * @brief Creates a searcher for logs with the timestamps of a formatter.
+     *
+     * @param formatter The formatter that the log's timestamps were written with, i.e., one that follows the log's config.
+     * @param filter What the messages have to match.
+     */
+    LogGrep(const rk::time_internal::TimeStampFormatter& formatter, GrepFilter filter);
+
+    /**
+     * @brief Reads the prefix at the start of a line.
+     *
+     * @param line The line, or the rest of the log from the start of the line.
+     * @param prefix Set to the parts of the prefix.
+     * @return False if the line doesn't start a message, e.g., the second line of a message that has several.
+     */
+    bool parsePrefix(std::string_view line, MessagePrefix& prefix) const;
+
+    /**
+     * @brief Finds the start of the first message that starts at or after a position.
+     *
+     * @param log The log.
+     * @param pos The position.
+     * @return Where the message starts, or the size of the log if no message starts after the position.
+     */
+    size_t findMessageStart(std::string_view log, size_t pos) const;
+
+    /**
+     * @brief Appends the messages of a chunk of a log that match the filter. Lines at the start of the chunk that
+     * don't belong to a message only match if nothing but their text is filtered.
+     *
+     * @param chunk The chunk. It should start at a message boundary.
+     * @param out The string to append the messages to.
+     * @return The number of messages that matched.
+     */
+    size_t grepChunk(std::string_view chunk, std::string& out) const;
+
+    /**
+     * @brief Searches a whole log with several threads. The log is split into chunks of about chunkSize bytes at
+     * message boundaries, and the matching messages of each chunk are passed to write in the order of the log. Only a
+     * few chunks are searched ahead of the one that is being written, so the output that is held in memory is bounded.
+     *
+     * @param log The log.
+     * @param threadCount The number of threads that search chunks. 1 searches on the calling thread only.
+     * @param write Called on the calling thread with the matching messages of each chunk, in order.
+     * @param chunkSize About how much of the log is searched at a time.
+     * @return The number of messages that matched.
+     */
+    size_t grep(std::string_view log, size_t threadCount, const std::function<void(std::string_view)>& write, size_t chunkSize = DEFAULT_CHUNK_SIZE) const;
+
+private:
+    /**
+     * @brief Checks whether a message matches the filter.
+     *
+     * @param prefix The prefix of the message, or nullptr if it doesn't have one.
+     * @param message The message, after the prefix.
+     * @return True if it matches, false otherwise.
+     */
+    bool isMatch(const MessagePrefix* prefix, std::string_view message) const;
+
+    const rk::time_internal::TimeStampFormatter& formatter;
+    const GrepFilter filter;
+    const bool isPrefixFiltered;
+};
+
+} // namespace grep_internal
+} // namespace rk
+
+#endif // #ifndef LOG_GREP_H
@@ -0,0 +1,178 @@
+/**
+ * @file log_index.h
+ * @brief Header file for the sidecar index of a log file, which rk_log_query uses to find a time range without
+ * reading the whole file.
+ *
+ * The index is written next to the log file, to "<log file>.idx". After a short header, it is an array of
+ * fixed-size entries. Each entry covers the next run of messages in the log file, i.e., the bytes from the end of the
+ * previous entry to its own end, and holds the earliest time in that run, the latest time up to the end of that run,
+ * and which threads logged in it. The latest times never decrease, so the first entry of a range is found with a
+ * binary search.
+ */
+#ifndef LOG_INDEX_H
+#define LOG_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace rk {
+namespace index_internal {
+
+constexpr char INDEX_MAGIC[8] = { 'R', 'K', 'L', 'O', 'G', 'I', 'D', 'X' };
+constexpr uint32_t INDEX_VERSION = 1;
+inline const std::string INDEX_FILE_SUFFIX = ".idx";
+
+/**
+ * The start of the index file. Entries follow right after it. Both are written in the byte order of the machine that
+ * writes the log, since the index is read on the same machine.
+ */
+struct IndexHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t entrySize;
+};
+
+struct IndexEntry {
+    uint64_t endOffset; /**< Where the run of messages ends in the log file. It starts at the end of the previous entry */
+    int64_t minTimeNs; /**< The earliest time of a message in the run, in nanoseconds since the epoch */
+    int64_t maxTimeNs; /**< The latest time of a message in the run or in any run before it */
+    uint64_t threadMask; /**< The bits from getThreadBit() of the threads that logged in the run */
+};
+
+static_assert(sizeof(IndexHeader) == 16, "The index header is read from the file as is");
+static_assert(sizeof(IndexEntry) == 32, "Index entries are read from the file as is");
+
+/**
+ * A range of bytes in the log file.
+ */
+struct ByteRange {
+    uint64_t begin;
+    uint64_t end; /**< Exclusive */
+};
+
+/**
+ * @brief Gets the bit of a thread in IndexEntry::threadMask. Threads are told apart by the id that is printed in the
+ * log, so the query tool can look one up by what it reads there.
+ *
+ * @param threadId The thread id as it is printed, e.g., "140213445566778".
+ * @return A mask with one bit set.
+ */
+uint64_t getThreadBit(std::string_view threadId);
+
+/**
+ * Writes the index of a log file as messages are written to it. A run of messages gets an entry once it has
+ * recordInterval messages or byteInterval bytes, and when finishEntry() is called.
+ */
+class IndexWriter {
+public:
+    /**
+     * @brief Creates the index file and writes its header.
+     *
+     * @param path The path of the index file.
+     * @param recordInterval The most messages in an entry.
+     * @param byteInterval The most bytes of the log file in an entry. An entry can end up larger by one message.
+     */
+    IndexWriter(const std::filesystem::path& path, size_t recordInterval, size_t byteInterval);
+
+    /**
+     * @brief Writes the entry of the last run of messages.
+     */
+    ~IndexWriter();
+
+    IndexWriter(const IndexWriter&) = delete;
+    IndexWriter& operator=(const IndexWriter&) = delete;
+
+    /**
+     * @brief Adds a message that was just written to the end of the log file.
+     *
+     * @param logSize The size of the log file with the message.
+     * @param timeNs When the message was logged, in nanoseconds since the epoch.
+     * @param threadId The id of the thread that logged it, as it is printed.
+     */
+    void add(uint64_t logSize, int64_t timeNs, std::string_view threadId);
+
+    /**
+     * @brief Writes the entry of the messages that were added since the last one, if there are any.
+     */
+    void finishEntry();
+
+    void flush();
+
+    /**
+     * @brief Checks whether the file was created and opened.
+     *
+     * @return True if the file is open, false otherwise.
+     */
+    bool isOpen() const;
+private:
+    std::ofstream file;
+    const size_t recordInterval;
+    const size_t byteInterval;
+    IndexEntry entry{};
+    uint64_t entryStart = 0;
+    size_t entryRecordCount = 0;
+    int64_t maxTimeNs = INT64_MIN;
+};
+
+/**
+ * @brief Gets the entries of an index file that was read or mapped into memory. An entry that was only partly
+ * written, e.g., because the process crashed, is left out.
+ *
+ * @param data The contents of the index file.
+ * @param size The size of the index file.
+ * @param entries Set to the first entry.
+ * @param count Set to the number of entries.
+ * @return False if it isn't an index file, or has a version or entry size that isn't supported.
+ */
+bool readIndex(const void* data, size_t size, const IndexEntry*& entries, size_t& count);
+
+/**
+ * @brief Finds the parts of a log file that can have messages from a time range, and from a thread.
+ *
+ * The search starts at the first entry whose latest time reaches the start of the range, which is found with a binary
+ * search. From there, the entries whose earliest time is after the end of the range are skipped, and so are the ones
+ * that the thread didn't log in. The earliest times aren't in order, e.g., when several shards write to one file, so
+ * the search doesn't stop at the first entry that starts after the range, but it only reads the index. The part
+ * of the log file after the last entry, which hasn't been indexed yet, is included if the range reaches past the
+ * latest indexed time.
+ *
+ * @param entries The entries of the index.
+ * @param count The number of entries.
+ * @param logSize The size of the log file. Entries that are past its end are cut off.
+ * @param fromNs The start of the range, in nanoseconds since the epoch.
+ * @param toNs The end of the range, inclusive.
+ * @param threadBit The bit of the thread from getThreadBit(), or 0 for every thread.
+ * @return The parts of the file, in order. Adjacent parts are merged.
+ */
+std::vector<ByteRange> findRanges(const IndexEntry* entries, size_t count, uint64_t logSize, int64_t fromNs, int64_t toNs, uint64_t threadBit);
+
+/**
+ * @brief Gets the thread id of a line of the log, i.e., what is between the second pair of brackets in
+ * "[<timestamp>][<thread id>][<function>]<message>".
+ *
+ * @param line The line.
+ * @return The thread id, or an empty view if the line doesn't start a message, e.g., the second line of a message
+ * that has several.
+ */
+std::string_view getLineThreadId(std::string_view line);
+
+/**
+ * @brief Parses a time for a query, which is either nanoseconds since the epoch, e.g., "1792406520000000000", or a
+ * date and time in local time, e.g., "2026-10-19 10:42:00" or "2026-10-19T10:42:00.250". A time that ends with "Z" is
+ * in UTC. Seconds and their fraction are optional.
+ *
+ * @param text The time.
+ * @param timeNs Set to the time in nanoseconds since the epoch.
+ * @return False if it isn't a valid time.
+ */
+bool parseQueryTime(std::string_view text, int64_t& timeNs);
+
+} // namespace index_internal
+} // namespace rk
+
+#endif // #ifndef LOG_INDEX_H
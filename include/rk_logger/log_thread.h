@@ -0,0 +1,66 @@
+/**
+ * @file log_thread.h
+ * @brief Header file for configuring the threads that are started by the logger.
+ */
+#ifndef LOG_THREAD_H
+#define LOG_THREAD_H
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include <iostream>
+
+#include <rk_logger/config.h>
+
+namespace rk {
+namespace thread_internal {
+
+/**
+ * Placement and scheduling settings for a logger thread. These are read from the config before the thread is started.
+ */
+struct ThreadSettings {
+    std::string name;
+    std::vector<int> cpus; /**< Empty means no affinity is set */
+    rk::config::ConfigValue schedPolicy;
+    bool hasPriority = false;
+    int priority = 0;
+    bool numaLocal = false;
+};
+
+/**
+ * @brief Reads the log thread settings from a config.
+ *
+ * @param config The config to read from.
+ * @return The settings.
+ */
+ThreadSettings getThreadSettings(const rk::config::Config& config);
+
+/**
+ * @brief Applies the settings to the calling thread.
+ *
+ * This should be called from the thread itself, before it allocates its buffers, so that memory it touches first
+ * ends up on the NUMA node it was pinned to. Settings that fail to apply (e.g., no permission for a real-time policy)
+ * are reported and skipped rather than stopping the thread.
+ *
+ * @param settings The settings to apply.
+ * @param nameSuffix Appended to the configured name, e.g., to tell sink threads apart. The name is truncated to 15 characters.
+ */
+void applyThreadSettings(const ThreadSettings& settings, const std::string& nameSuffix = "");
+
+/**
+ * @brief Prints an internal log message for the thread module.
+ *
+ * @param args The message to print.
+ */
+template<typename... Args>
+void threadLog(const Args&... args) {
+    std::ostringstream oss;
+    oss << "[RKLogger Thread]";
+    (oss << ... << args);
+    std::cout << oss.str();
+}
+
+} // namespace thread_internal
+} // namespace rk
+
+#endif // #ifndef LOG_THREAD_H
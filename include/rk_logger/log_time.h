@@ -7,9 +7,14 @@
 
 #include <chrono>
 #include <string>
-#include <functional>
+#include <string_view>
+#include <cstdint>
 #include <mutex>
 #include <sstream>
+#include <iostream>
+
+#include <rk_logger/config.h>
+#include <rk_logger/time_zone.h>
 
 namespace rk {
 namespace time_internal {
@@ -17,8 +22,6 @@ namespace time_internal {
 typedef std::chrono::system_clock system_clock;
 typedef std::chrono::system_clock::time_point time_point;
 
-extern std::mutex tmMutex; /**< tm meaning std::tm */
-
 constexpr const char* months[12] = {
     "Jan",
     "Feb",
@@ -35,7 +38,118 @@ constexpr const char* months[12] = {
 };
 
 /**
- * @brief Generates a timestamp from a time_point.
+ * The order of the date's parts.
+ */
+enum class DateOrder : uint8_t {
+    MonthDayYear,
+    DayMonthYear,
+    YearMonthDay,
+};
+
+/**
+ * The precision of the time in a timestamp. EpochNanoseconds replaces the whole timestamp with the number of
+ * nanoseconds since the epoch, which is easy to sort and merge across processes.
+ */
+enum class TimeStampPrecision : uint8_t {
+    Milliseconds,
+    Microseconds,
+    Nanoseconds,
+    EpochNanoseconds,
+};
+
+/**
+ * Generates timestamps in the format specified by a config. Each logger owns one, so loggers with different configs
+ * can format their timestamps differently.
+ * 
+ * The numeric fields of a timestamp are rendered together by a vectorized kernel and the timestamp is appended to the
+ * output string in one piece, so formatting doesn't allocate beyond growing the output.
+ */
+class TimeStampFormatter {
+public:
+    /**
+     * @brief Generates a timestamp from a time_point.
+     * 
+     * @param time_point The time_point to convert.
+     */
+    std::string generateTimeStamp(time_point) const;
+
+    /**
+     * @brief Appends a timestamp for a time_point to a string.
+     * 
+     * @param time_point The time_point to convert.
+     * @param out The string to append to.
+     */
+    void appendTimeStamp(time_point, std::string& out) const;
+
+    /**
+     * @brief Reads a timestamp in this formatter's format from the start of some text, i.e., the inverse of
+     * appendTimeStamp(). The date and time are read in the formatter's time zone.
+     * 
+     * @param text The text, e.g., a line of a log.
+     * @param epochNs Set to the time in nanoseconds since the epoch, cut off at the precision of the format.
+     * @return The size of the timestamp, or 0 if the text doesn't start with one.
+     */
+    size_t parseTimeStamp(std::string_view text, int64_t& epochNs) const;
+
+    /**
+     * @brief Updates how the month is formatted, i.e., as a number or a name.
+     * 
+     * @param config The config to read the month format from.
+     */
+    void updateMonthFormat(const rk::config::Config& config);
+
+    /**
+     * @brief Updates the order of the date's parts.
+     * 
+     * @param config The config to read the date format from.
+     */
+    void updateDateFormat(const rk::config::Config& config);
+
+    /**
+     * @brief Updates the hour format, i.e., 12-hour or 24-hour.
+     * 
+     * @param config The config to read the hour format from.
+     */
+    void updateHourFormat(const rk::config::Config& config);
+
+    /**
+     * @brief Updates the precision of the time.
+     * 
+     * @param config The config to read the timestamp precision from.
+     */
+    void updatePrecision(const rk::config::Config& config);
+
+    /**
+     * @brief Updates whether times are in the local time zone or UTC, and drops the cached time zone offset.
+     * 
+     * @param config The config to read the time zone from.
+     */
+    void updateTimeZone(const rk::config::Config& config);
+
+    /**
+     * @brief Calls all the format updater functions.
+     * 
+     * @param config The config to read the formats from.
+     */
+    void updateTimeStampFuncs(const rk::config::Config& config);
+
+private:
+    bool isMonthName = false;
+    DateOrder dateOrder = DateOrder::MonthDayYear;
+    bool isTwelveHour = true;
+    TimeStampPrecision precision = TimeStampPrecision::Milliseconds;
+    mutable TimeZoneCache timeZone; /**< Mutable because looking up the offset updates the cache */
+};
+
+/**
+ * @brief Gets the formatter that follows the config from rk::config::getInstance().
+ * 
+ * @return The formatter.
+ */
+TimeStampFormatter& getDefaultFormatter();
+
+/**
+ * @brief Generates a timestamp from a time_point with the default formatter.
  * 
  * @param time_point The time_point to convert.
  */
@@ -70,57 +184,7 @@ void padWithZeros(std::string&, const int);
 std::string convertTimeStampForFileName(std::string);
 
 /**
- * @brief Converts a month to the format specified by the config.
- * 
- * This function is determined at runtime.
- * 
- * @param int The month as a number starting at 1 and going up, so January = 1, February = 2, etc.
- * @return The formatted month.
- */
-extern std::function<std::string(const int)> monthFunc;
-
-/**
- * @brief Converts a date to the format specified by the config.
- * 
- * This function is determined at runtime.
- * 
- * @param std::string The year.
- * @param std::string The month.
- * @param std::string The day.
- * @return The formatted date.
- */
-extern std::function<std::string(const std::string, const std::string, const std::string)> dateFunc;
-
-/**
- * @brief Generates a formatted time that is specified by the config, with the given sub-units.
- * 
- * This function is determined at runtime. The sub-units should be in the same format as std::tm, i.e., hour is 0-23 hours since midnight, etc.
- * 
- * @param std::string The hour.
- * @param std::string The minute.
- * @param std::string The second.
- * @param std::string The millisecond.
- * @return The formatted time.
- */
-extern std::function<std::string(std::string, const std::string, const std::string, const std::string)> timeFunc;
-
-/**
- * @brief Updates the month function. This function itself does not "update the month", but rather updates the function that formats the month.
- */
-void updateMonthFunc();
-
-/**
- * @brief Updates the date function. This function itself does not "update the date", but rather updates the function that formats the date.
- */
-void updateDateFunc();
-
-/**
- * @brief Updates the time function. This function itself does not "update the time", but rather updates the function that formats the time.
- */
-void updateTimeFunc();
-
-/**
- * @brief Calls all the function updater functions.
+ * @brief Updates the default formatter from the config returned by rk::config::getInstance().
  */
 void updateTimeStampFuncs();
 
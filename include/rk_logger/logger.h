@@ -12,126 +12,857 @@
 #include <string>
 #include <mutex>
 #include <sstream>
-#include <queue>
 #include <thread>
 #include <fstream>
 #include <condition_variable>
 #include <chrono>
+#include <memory>
+#include <vector>
+#include <atomic>
+#include <cstdint>
+#include <unordered_map>
 
 #include <rk_logger/config.h>
 #include <rk_logger/log_time.h>
+#include <rk_logger/tick_clock.h>
+#include <rk_logger/sink.h>
+#include <rk_logger/record.h>
+#include <rk_logger/level.h>
+#include <rk_logger/format.h>
+#include <rk_logger/scope.h>
+#include <rk_logger/log_thread.h>
+#include <rk_logger/sampling.h>
+#include <rk_logger/flight_recorder.h>
+#include <rk_logger/shm_ring.h>
 
 /**
- * @brief Adds a message to the log queue.
- * 
- * This is the primary macro that should be used to log messages. It uses an internal function to add the message to the
- * log queue. It can take any number of arguments for logging. See the demonstration directory for an example.
+ * @brief The lowest level that is compiled in. Log statements below it are removed at compile time, e.g., build with
+ * -DRK_LOG_COMPILED_MIN_LEVEL=2 to remove the trace and debug statements. See rk::log::Level for the values.
  */
-#define RK_LOG(...) rk::log_internal::logMessage(rk::time_internal::system_clock::now(), __func__, __VA_ARGS__)
+#ifndef RK_LOG_COMPILED_MIN_LEVEL
+#define RK_LOG_COMPILED_MIN_LEVEL 0
+#endif
 
 namespace rk {
-namespace log {
+namespace log_internal {
 
 /**
- * @brief The main function that starts the logger. Sets up various things like configs, logging threads, etc.
- * Call this first, before logging any messages.
- * 
- * @param configPath The path to the config file.
- * @return The thread that is running the log loop.
+ * @brief Checks if log statements at a level are compiled in. With the default minimum of 0, nothing is compared, so
+ * the macros don't make the compiler warn about a comparison that is always true.
+ *
+ * @param level The level of the statement.
+ * @return True if the statement is kept, false if the compiler can remove it.
  */
-std::thread startLogger(const std::filesystem::path& configPath = std::filesystem::current_path()/rk::config::CONFIG_FILE_NAME);
+constexpr bool isCompiledIn([[maybe_unused]] const rk::log::Level level) {
+#if RK_LOG_COMPILED_MIN_LEVEL > 0
+    return static_cast<int>(level) >= RK_LOG_COMPILED_MIN_LEVEL;
+#else
+    return true;
+#endif
+}
+
+} // namespace log_internal
+} // namespace rk
 
 /**
- * @brief Ends the logger. Call this at the end before the program ends.
- * 
- * @param std::thread The thread that was running the log loop.
+ * @brief The module tag of the log statements that follow, e.g., "#define RK_LOG_MODULE "net"" at the top of a
+ * source file, before including this header. Module levels in the config ("level.net: DEBUG") apply to the
+ * statements with that tag. Statements without a tag are matched by their file name instead.
  */
-void stopLogger(std::thread);
-
-} // namespace log
-} // namespace rk
+#ifndef RK_LOG_MODULE
+#define RK_LOG_MODULE nullptr
+#endif
 
-namespace rk {
-namespace log_internal {
+/**
+ * @brief Adds a message at the given level to the log queue of a specific logger.
+ * 
+ * The arguments are only evaluated if the logger is enabled for the level at this call site. Each call site caches
+ * its effective level, i.e., the level of its module or file if there is one and the logger's level otherwise, so a
+ * disabled log statement costs one load and one branch. When the level is a constant below
+ * RK_LOG_COMPILED_MIN_LEVEL, the compiler removes the statement. Arguments wrapped with rk::log::defer() are
+ * evaluated later, on the log thread.
+ */
+#define RK_LOG_TO_AT(logger, level, ...) \
+    do { \
+        const rk::log::Level rkLogLevel = (level); \
+        if (rk::log_internal::isCompiledIn(rkLogLevel)) { \
+            static rk::log_internal::CallSite rkLogCallSite(RK_LOG_MODULE, __FILE__); \
+            rk::log::Logger& rkLogLogger = (logger); \
+            if (rkLogLogger.isEnabled(rkLogLevel, rkLogCallSite)) { \
+                rkLogLogger.logMessage(rkLogLevel, rkLogCallSite, __func__, __VA_ARGS__); \
+            } \
+        } \
+    } while (0)
 
-extern std::mutex logQueueMutex;
-extern std::queue<std::string> logQueue; /**< Main queue for holding log messages */
-extern std::mutex endLoopMtx;
-extern bool endLogLoop;
-extern std::ofstream logFile;
-extern std::condition_variable logQueueCv;
+/**
+ * @brief Adds a message at the given level to the log queue of the default logger.
+ */
+#define RK_LOG_AT(level, ...) RK_LOG_TO_AT(rk::log::getDefaultLogger(), level, __VA_ARGS__)
 
 /**
  * @brief Adds a message to the log queue.
  * 
- * This function should not be called by itself. Call it via the RK_LOG macro.
- * 
- * @param time The time that the message was logged.
- * @param funcName The function that this is being called from.
- * @param args The values to construct the message from.
+ * This is the primary macro that should be used to log messages. It adds the message to the queue of the default
+ * logger at the INFO level. It can take any number of arguments for logging. See the demonstration directory for an example.
  */
-template<typename... Args>
-void logMessage(const rk::time_internal::time_point time, const std::string funcName, const Args&... args) {
-    std::ostringstream oss;
-    oss << rk::time_internal::generateTimeStamp(time); // Prefix the timestamp
-    oss << "[" << std::this_thread::get_id() << "][" << funcName << "]"; // Prefix the thread id and function name
-    (oss << ... << args);
-    std::lock_guard<std::mutex> lock(logQueueMutex);
-    logQueue.push(oss.str());
-    logQueueCv.notify_one();
-}
+#define RK_LOG(...) RK_LOG_AT(rk::log::Level::Info, __VA_ARGS__)
 
 /**
- * @brief Predicate used by the condition variable in the log loop to determine whether to continue waiting or not.
+ * @brief Adds a message to the log queue of a specific logger.
  * 
- * @return Whether or not to resume the log loop.
+ * Same as RK_LOG, but the first argument is the rk::log::Logger to log to, e.g., one returned by rk::log::getLogger().
  */
-bool condVarPredicate();
+#define RK_LOG_TO(logger, ...) RK_LOG_TO_AT(logger, rk::log::Level::Info, __VA_ARGS__)
 
 /**
- * @brief Checks the log queue for messages and prints them.
+ * @brief Same as RK_LOG, but at a specific level.
  */
-void logQueueLoop();
+#define RK_LOG_TRACE(...) RK_LOG_AT(rk::log::Level::Trace, __VA_ARGS__)
+#define RK_LOG_DEBUG(...) RK_LOG_AT(rk::log::Level::Debug, __VA_ARGS__)
+#define RK_LOG_INFO(...) RK_LOG_AT(rk::log::Level::Info, __VA_ARGS__)
+#define RK_LOG_WARN(...) RK_LOG_AT(rk::log::Level::Warn, __VA_ARGS__)
+#define RK_LOG_ERROR(...) RK_LOG_AT(rk::log::Level::Error, __VA_ARGS__)
+#define RK_LOG_FATAL(...) RK_LOG_AT(rk::log::Level::Fatal, __VA_ARGS__)
 
 /**
- * @brief Starts the log thread. This should be called before doing any logging.
+ * @brief Adds a message at the given level to the log queue of a specific logger if a static sampler of samplerType at
+ * this call site lets it through.
+ *
+ * Used to build the sampling macros below. The level is checked first, so a message that is below the level doesn't
+ * touch the sampler and doesn't count toward its N. The arguments are not evaluated when the message is dropped.
+ */
+#define RK_LOG_SAMPLED_IMPL(samplerType, samplerArgs, logger, level, ...) \
+    do { \
+        const rk::log::Level rkLogLevel = (level); \
+        if (rk::log_internal::isCompiledIn(rkLogLevel)) { \
+            static rk::log_internal::CallSite rkLogCallSite(RK_LOG_MODULE, __FILE__); \
+            static samplerType rkLogSampler; \
+            rk::log::Logger& rkLogLogger = (logger); \
+            if (rkLogLogger.isEnabled(rkLogLevel, rkLogCallSite) && rkLogSampler.shouldLog samplerArgs) { \
+                rkLogLogger.logMessage(rkLogLevel, rkLogCallSite, __func__, __VA_ARGS__); \
+            } \
+        } \
+    } while (0)
+
+/**
+ * @brief Logs only the 1st, (n + 1)th, (2n + 1)th, etc. time this line is reached.
  * 
- * @return The thread that was started for the log loop.
+ * This and the other sampling macros keep their state per call site. When a message is dropped, its arguments are
+ * not evaluated.
+ */
+#define RK_LOG_EVERY_N(n, ...) RK_LOG_SAMPLED_IMPL(rk::log_internal::EveryNSampler, (n), rk::log::getDefaultLogger(), rk::log::Level::Info, __VA_ARGS__)
+
+/**
+ * @brief Logs only the first n times this line is reached.
  */
-std::thread startLogThread();
+#define RK_LOG_FIRST_N(n, ...) RK_LOG_SAMPLED_IMPL(rk::log_internal::FirstNSampler, (n), rk::log::getDefaultLogger(), rk::log::Level::Info, __VA_ARGS__)
 
 /**
- * @brief Ends the log thread.
+ * @brief Logs at most once every ms milliseconds from this line.
+ */
+#define RK_LOG_EVERY_MS(ms, ...) RK_LOG_SAMPLED_IMPL(rk::log_internal::EveryMsSampler, (ms), rk::log::getDefaultLogger(), rk::log::Level::Info, __VA_ARGS__)
+
+/**
+ * @brief Logs from this line at a rate of at most perSecond messages per second, with bursts of up to burst messages.
+ */
+#define RK_LOG_RATE_LIMITED(perSecond, burst, ...) RK_LOG_SAMPLED_IMPL(rk::log_internal::RateLimiter, ((perSecond), (burst)), rk::log::getDefaultLogger(), rk::log::Level::Info, __VA_ARGS__)
+
+/**
+ * @brief Same as the sampling macros above, but logs to a specific logger like RK_LOG_TO.
+ */
+#define RK_LOG_TO_EVERY_N(logger, n, ...) RK_LOG_SAMPLED_IMPL(rk::log_internal::EveryNSampler, (n), logger, rk::log::Level::Info, __VA_ARGS__)
+#define RK_LOG_TO_FIRST_N(logger, n, ...) RK_LOG_SAMPLED_IMPL(rk::log_internal::FirstNSampler, (n), logger, rk::log::Level::Info, __VA_ARGS__)
+#define RK_LOG_TO_EVERY_MS(logger, ms, ...) RK_LOG_SAMPLED_IMPL(rk::log_internal::EveryMsSampler, (ms), logger, rk::log::Level::Info, __VA_ARGS__)
+#define RK_LOG_TO_RATE_LIMITED(logger, perSecond, burst, ...) RK_LOG_SAMPLED_IMPL(rk::log_internal::RateLimiter, ((perSecond), (burst)), logger, rk::log::Level::Info, __VA_ARGS__)
+
+namespace rk {
+namespace log {
+
+extern const std::string DEFAULT_LOGGER_NAME;
+
+/**
+ * A logger with its own config, queue, timestamp formatter, sinks, and log thread. Loggers are independent of each
+ * other, so subsystems can log through separate queues and threads.
+ */
+class Logger {
+public:
+    /**
+     * @brief Creates a logger with its own config, starting from the default settings.
+     * 
+     * @param name The name of the logger. It is used in the name of the log file.
+     */
+    explicit Logger(const std::string& name);
+
+    /**
+     * @brief Creates a logger that uses an existing config and timestamp formatter, e.g., the default logger uses the
+     * ones that are shared with the rest of the library.
+     * 
+     * @param name The name of the logger. It is used in the name of the log file.
+     * @param config The config to use. It must outlive the logger.
+     * @param formatter The timestamp formatter to use. It must outlive the logger.
+     */
+    Logger(const std::string& name, rk::config::Config& config, rk::time_internal::TimeStampFormatter& formatter);
+
+    /**
+     * @brief Stops the logger if it is still running, and detaches the call sites that cached their level for this
+     * logger, so they can be used with another one.
+     */
+    ~Logger();
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    /**
+     * @brief Starts the logger. Sets up the config, sinks, and log thread. Call this before logging any messages.
+     * 
+     * If the program exits without stopping the logger, e.g., it calls exit() early, the logger is still stopped at
+     * exit. The thread must still be joined or passed back to stop(), though.
+     * 
+     * If the process forks while the logger is running, the child gets a new log thread of its own, and the logger
+     * keeps it like with startOwned(). Passing the thread from the parent to stop() in the child stops the new one.
+     * 
+     * @param configPath The path to the config file.
+     * @return The thread that is running the log loop, or an empty thread if the logger is already started.
+     */
+    std::thread start(const std::filesystem::path& configPath = std::filesystem::current_path()/rk::config::CONFIG_FILE_NAME);
+
+    /**
+     * @brief Same as start(), but the logger keeps the log thread itself. It is stopped by stop(), the destructor,
+     * or the exit of the program, whichever comes first. See ScopedLogger.
+     * 
+     * @param configPath The path to the config file.
+     */
+    void startOwned(const std::filesystem::path& configPath = std::filesystem::current_path()/rk::config::CONFIG_FILE_NAME);
+
+    /**
+     * @brief Stops the logger. Messages that are still in the queue are written before the log thread ends, for up
+     * to shutdown_drain_ms. The ones that are left after that are handled according to shutdown_leftovers.
+     * 
+     * @param std::thread The thread that was returned from start().
+     */
+    void stop(std::thread);
+
+    /**
+     * @brief Same as stop(std::thread), for a logger that was started with startOwned(). If it was started with
+     * start() instead, this waits for the log thread to finish without joining it. Does nothing if the logger
+     * isn't running.
+     */
+    void stop();
+
+    /**
+     * @brief Checks if the logger was started and hasn't been stopped since.
+     * 
+     * @return True if the logger is running, false otherwise.
+     */
+    bool isRunning() const;
+
+    /**
+     * @brief Checks if a message at the given level would be logged, ignoring the module levels. A message counts as
+     * logged if it would be written to the sinks or kept by the flight recorder.
+     * 
+     * @param level The level of the message.
+     * @return True if the message would be logged, false otherwise.
+     */
+    bool isEnabled(const Level level) const {
+        return static_cast<uint8_t>(level) >= threshold.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Checks if a message at the given level would be logged from a call site, taking its module level into
+     * account. This is checked by the macros before the arguments are evaluated.
+     * 
+     * @param level The level of the message.
+     * @param site The call site of the message.
+     * @return True if the message would be logged, false otherwise.
+     */
+    bool isEnabled(const Level level, rk::log_internal::CallSite& site) {
+        const uint64_t cached = site.cached.load(std::memory_order_relaxed);
+        if ((cached >> rk::log_internal::CallSite::LOGGER_ID_SHIFT) == id) {
+            return static_cast<uint8_t>(level) >= (cached & rk::log_internal::CallSite::THRESHOLD_MASK);
+        }
+        if (cached != 0 && !hasModuleLevels.load(std::memory_order_relaxed)) {
+            return isEnabled(level); // Cached for another logger, but this one has no module levels to look up
+        }
+        return isEnabledSlow(level, site);
+    }
+
+    /**
+     * @brief Sets the minimum level of the messages that are logged. Overrides the level from the config until the
+     * logger is started again.
+     * 
+     * @param level The level.
+     */
+    void setLevel(Level level);
+
+    /**
+     * @brief Gets the minimum level of the messages that are logged.
+     * 
+     * @return The level.
+     */
+    Level getLevel() const;
+
+    /**
+     * @brief Sets the level of a module or source file, e.g., "net" or "order_book.cpp". It applies to the log
+     * statements with that RK_LOG_MODULE tag, or in a file with that name, instead of the logger's level. Overrides
+     * the module levels from the config until the logger is started again.
+     * 
+     * @param module The module tag or file name.
+     * @param level The level.
+     */
+    void setModuleLevel(const std::string& module, Level level);
+
+    /**
+     * @brief Turns all logging through this logger on or off at runtime, regardless of the level.
+     * 
+     * @param enabled False to drop every message, true to log by level again.
+     */
+    void setEnabled(bool enabled);
+
+    /**
+     * @brief Writes the messages in the flight recorder to a file, e.g., "flight_recorder_<timestamp>_0.txt", and
+     * clears it. The request is queued like a message, so the dump includes everything that the calling thread
+     * logged before it, and this returns right away.
+     */
+    void dumpFlightRecorder();
+
+    /**
+     * @brief Adds a message to the log queue.
+     * 
+     * This function should not be called by itself. Call it via the RK_LOG or RK_LOG_TO macros.
+     * 
+     * @param level The level of the message.
+     * @param site The call site of the message.
+     * @param funcName The function that this is being called from.
+     * @param args The values to construct the message from.
+     */
+    template<typename... Args>
+    void logMessage(const Level level, const rk::log_internal::CallSite& site, const char* funcName, Args&&... args) {
+        Record record;
+        stampTime(record);
+        record.threadId = std::this_thread::get_id();
+        record.funcName = funcName;
+        record.level = level;
+        record.isForSinks = isForSinks(level, site);
+        rk::log_internal::appendThreadContext(record);
+        (rk::log_internal::appendArg(record, std::forward<Args>(args)), ...);
+        enqueue(std::move(record));
+    }
+
+    /**
+     * @brief Adds a sink that messages are written to, in addition to the console and log file.
+     * 
+     * @param sink The sink to add.
+     */
+    void addSink(std::shared_ptr<Sink> sink);
+
+    /**
+     * @brief Gets the config used by this logger.
+     * 
+     * @return The config.
+     */
+    rk::config::Config& getConfig();
+
+    /**
+     * @brief Gets the name of this logger.
+     * 
+     * @return The name.
+     */
+    const std::string& getName() const;
+
+private:
+    friend class Batch;
+
+    /**
+     * A queue with its own consumer thread. Each logging thread always uses the same shard, so messages from one
+     * thread stay in order no matter how many shards there are.
+     */
+    struct Shard {
+        std::mutex queueMutex;
+        std::vector<Record> queue; /**< Swapped out as a whole by the consumer, so it is a vector rather than a queue */
+        std::condition_variable queueCv;
+        std::mutex fileMutex; /**< Guards file, which the shard's thread writes without sinksMutex */
+        std::shared_ptr<Sink> file; /**< Only set when each shard writes to its own log file */
+    };
+
+    /**
+     * A record that has been formatted by a shard and is waiting to be written in the global order.
+     */
+    struct FormattedRecord {
+        uint64_t sequence;
+        bool isForSinks;
+        bool isFlightRecorderDump;
+        std::string text; /**< The complete line if isForSinks, otherwise only the message for the flight recorder */
+        size_t messageOffset; /**< Where the message starts in text */
+        int64_t timeNs;
+        std::string threadId;
+        RecordedMessage recorded; /**< Without its message, which is in text */
+    };
+
+    /**
+     * A record that a shard has formatted into the text of its batch, so the whole batch is formatted before the sinks
+     * are locked. The views in info and recorded point into the text.
+     */
+    struct BatchLine {
+        size_t offset; /**< Where the line starts in the text */
+        size_t size;
+        size_t messageOffset; /**< Where the message starts in the line */
+        size_t threadIdOffset; /**< Where the thread id starts in the line */
+        bool isForSinks;
+        bool isFlightRecorderDump;
+        MessageInfo info;
+        RecordedMessage recorded;
+    };
+
+    /**
+     * Receives formatted messages from the shards and writes them in the global order, i.e., by sequence number.
+     */
+    struct OrderedWriter {
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::vector<FormattedRecord> incoming;
+        size_t activeShards = 0;
+    };
+
+    /**
+     * @brief Adds a record to the queue of the shard for the calling thread.
+     * 
+     * @param record The record to add.
+     */
+    void enqueue(Record&& record);
+
+    /**
+     * @brief Adds records to the queue of the shard for the calling thread in one step, so they stay together in the output.
+     * 
+     * @param records The records to add. It is left empty, but may hold a different buffer afterwards.
+     */
+    void enqueueBatch(std::vector<Record>& records);
+
+    /**
+     * @brief Sets the time of a record from the configured clock source.
+     * 
+     * @param record The record to set the time of.
+     */
+    void stampTime(Record& record) const {
+        if (tickClock.getSource() == rk::time_internal::TickSource::System) {
+            record.time = rk::time_internal::system_clock::now();
+        }
+        else {
+            record.ticks = tickClock.now();
+        }
+    }
+
+    /**
+     * @brief Checks if a message that is logged from a call site goes to the sinks, rather than only to the flight
+     * recorder. Always true without a flight recorder.
+     * 
+     * @param level The level of the message.
+     * @param site The call site of the message.
+     * @return True if the message goes to the sinks, false otherwise.
+     */
+    bool isForSinks(const Level level, const rk::log_internal::CallSite& site) {
+        if (!hasFlightRecorder.load(std::memory_order_relaxed)) {
+            return true;
+        }
+        const uint64_t cached = site.cached.load(std::memory_order_relaxed);
+        if ((cached >> rk::log_internal::CallSite::LOGGER_ID_SHIFT) == id) {
+            const uint64_t siteSinkThreshold = (cached >> rk::log_internal::CallSite::SINK_THRESHOLD_SHIFT) & rk::log_internal::CallSite::THRESHOLD_MASK;
+            return static_cast<uint8_t>(level) >= siteSinkThreshold;
+        }
+        if (!hasModuleLevels.load(std::memory_order_relaxed)) {
+            return static_cast<uint8_t>(level) >= sinkThreshold.load(std::memory_order_relaxed);
+        }
+        return isForSinksSlow(level, site);
+    }
+
+    /**
+     * @brief Formats a record into a complete log line, i.e., the timestamp, thread id, and function name prefix followed by the message.
+     * 
+     * @param record The record to format.
+     * @param calibration Converts the record's ticks to its time, if it has ticks.
+     * @param out The string to write the line to. Its contents are replaced.
+     * @param messageOffset Set to where the message starts in out, if it isn't null.
+     * @return The level, time, and thread of the record. The thread id points into out.
+     */
+    MessageInfo formatRecord(const Record& record, const rk::time_internal::TickCalibration& calibration, std::string& out,
+        size_t* messageOffset = nullptr) const;
+
+    /**
+     * @brief Appends the timestamp, thread id, and function name prefix of a message to a string.
+     *
+     * @param time When the message was logged.
+     * @param threadId The thread that logged it.
+     * @param funcName The function that logged it.
+     * @param out The string to append to.
+     * @param threadIdOffset Set to where the thread id starts in out.
+     * @return The thread id as it was written, which is only valid until the formatting thread formats another id.
+     */
+    const std::string& appendPrefix(rk::time_internal::time_point time, std::thread::id threadId, const char* funcName, std::string& out,
+        size_t& threadIdOffset) const;
+
+    /**
+     * @brief Runs the log thread. It starts a consumer thread for each additional shard and, if messages are
+     * globally ordered across several shards, merges their output.
+     * 
+     * @param settings The settings for the log thread and the shard threads.
+     */
+    void logThreadMain(const rk::thread_internal::ThreadSettings& settings);
+
+    /**
+     * @brief Checks the queue of a shard for records and formats them. Records are either written to the sinks
+     * directly or passed to the ordered writer.
+     * 
+     * @param shardIndex The shard to consume.
+     * @param isOrdered Whether the records go to the ordered writer.
+     */
+    void logQueueLoop(size_t shardIndex, bool isOrdered);
+
+    /**
+     * @brief Writes the messages from the shards in the global order until all the shards are done.
+     */
+    void orderedWriterLoop();
+
+    /**
+     * @brief Same as start(). The caller must hold lifecycleMutex.
+     * 
+     * @param configPath The path to the config file.
+     * @return The thread that is running the log loop.
+     */
+    std::thread startLocked(const std::filesystem::path& configPath);
+
+    /**
+     * @brief Same as stop(std::thread). The caller must hold lifecycleMutex.
+     * 
+     * @param std::thread The thread that is running the log loop, or an empty thread to wait for it without joining it.
+     */
+    void stopLocked(std::thread);
+
+    /**
+     * @brief Starts the log thread.
+     * 
+     * @return The thread that was started for the log loop.
+     */
+    std::thread startLogThread();
+
+    /**
+     * @brief Ends the log thread, giving it until the drain deadline to write what is still queued.
+     * 
+     * @param std::thread The thread that is running the log loop, or an empty thread to wait for it without joining it.
+     */
+    void endLogThread(std::thread);
+
+    /**
+     * @brief Checks if the logger is stopping and its drain time has run out.
+     * 
+     * @return True if the remaining records should be handled as leftovers, false otherwise.
+     */
+    bool isDrainTimeUp() const;
+
+    /**
+     * @brief Drops or spills the records that weren't written before the drain time ran out, according to shutdown_leftovers.
+     * 
+     * @param records The records.
+     * @param first The index of the first record that wasn't written.
+     */
+    void handleLeftovers(const std::vector<Record>& records, size_t first);
+
+    /**
+     * @brief Writes a message from the logger itself to the sinks, formatted like any other message.
+     * 
+     * @param message The message.
+     * @param messageLevel The level of the message.
+     */
+    void writeNotice(const std::string& message, Level messageLevel);
+
+    /**
+     * @brief Opens the log file(s) and adds them as sinks. Throws if a file could not be opened.
+     * 
+     * @param nameSuffix Added to the name of each file before the extension, e.g., "_pid1234".
+     */
+    void openLogFile(const std::string& nameSuffix = "");
+
+    /**
+     * @brief Registers the fork handlers, once per process. Does nothing on platforms without pthread_atfork().
+     */
+    static void installForkHandlers();
+
+    /**
+     * @brief Runs in the parent right before it forks. Locks every running logger with lockForFork().
+     */
+    static void prepareForFork();
+
+    /**
+     * @brief Runs in the parent right after it forks. Unlocks what prepareForFork() locked.
+     */
+    static void resumeParentAfterFork();
+
+    /**
+     * @brief Runs in the child right after the fork. Unlocks what prepareForFork() locked and restarts every logger
+     * that was running.
+     */
+    static void resumeChildAfterFork();
+
+    /**
+     * @brief Takes every lock that a logging thread or the log thread can hold, and flushes the sinks, so the child
+     * gets the queues and sinks in a consistent state and unlocked. With the shared-memory transport, it also claims a
+     * slot in the ring for the child.
+     */
+    void lockForFork();
+
+    /**
+     * @brief Releases the locks that were taken by lockForFork().
+     */
+    void unlockAfterFork();
+
+    /**
+     * @brief Runs in the child. Drops the records that were queued in the parent, and starts a new log thread if the
+     * logger was running, since the child doesn't have the threads of the parent.
+     */
+    void restartAfterFork();
+
+    /**
+     * @brief Creates the shared-memory ring that the messages are written to for rk_log_agent. If it can't be
+     * created, the messages are written by this process as usual.
+     */
+    void openSharedMemoryRing();
+
+    /**
+     * @brief Writes a message to every shared sink. The caller must hold sinksMutex.
+     * 
+     * @param message The message to write.
+     * @param info The level, time, and thread of the message.
+     */
+    void writeToSinks(const std::string& message, const MessageInfo& info);
+
+    /**
+     * @brief Gets how long a log thread waits for new messages before it wakes up anyway.
+     * 
+     * @param isPollingSignal Whether the thread checks for the flight recorder signal.
+     * @param isFlushingWhenIdle Whether the thread flushes the sinks when nothing was logged.
+     * @return The interval. Only meaningful if one of them is true.
+     */
+    std::chrono::milliseconds getPollInterval(bool isPollingSignal, bool isFlushingWhenIdle) const;
+
+    /**
+     * @brief Flushes every shared sink. The caller must hold sinksMutex.
+     */
+    void flushSinks();
+
+    /**
+     * @brief Adds a message to the flight recorder if it is at or above the recorder's level, and dumps the recorder
+     * if the message is at or above its trigger level. Called for every message after it was written to the sinks,
+     * if it was for them. The caller must hold sinksMutex.
+     * 
+     * @param message The message, without its prefix.
+     */
+    void recordMessage(const RecordedMessage& message);
+
+    /**
+     * @brief Checks if SIGUSR1 was received since the flight recorder was last dumped for it. Only called by the
+     * thread that dumps the flight recorder on the signal.
+     * 
+     * @return True if a dump is pending, false otherwise.
+     */
+    bool hasPendingSignal() const;
+
+    /**
+     * @brief Same as hasPendingSignal(), but also marks the signal as handled.
+     * 
+     * @return True if a dump was pending, false otherwise.
+     */
+    bool takePendingSignal();
+
+    /**
+     * @brief Writes the messages in the flight recorder to a new file and clears it. The caller must hold sinksMutex.
+     */
+    void writeFlightRecorderDump();
+
+    /**
+     * @brief Recalculates the thresholds from the level, the flight recorder level, and whether logging is enabled, and clears the levels that
+     * the call sites have cached. The caller must hold levelMutex.
+     */
+    void updateThreshold();
+
+    /**
+     * @brief Works out the thresholds for a call site, caches them if the call site belongs to this logger, and
+     * checks the message level against them.
+     * 
+     * @param level The level of the message.
+     * @param site The call site of the message.
+     * @return True if the message would be logged, false otherwise.
+     */
+    bool isEnabledSlow(Level level, rk::log_internal::CallSite& site);
+
+    /**
+     * @brief Same as isForSinks() when the call site's thresholds aren't cached for this logger.
+     * 
+     * @param level The level of the message.
+     * @param site The call site of the message.
+     * @return True if the message goes to the sinks, false otherwise.
+     */
+    bool isForSinksSlow(Level level, const rk::log_internal::CallSite& site) const;
+
+    /**
+     * @brief Gets the sink threshold for a call site from its module level or the logger's level. The caller must hold levelMutex.
+     * 
+     * @param site The call site.
+     * @return The threshold.
+     */
+    uint8_t resolveThreshold(const rk::log_internal::CallSite& site) const;
+
+    /**
+     * @brief Lowers a sink threshold to the flight recorder's level, so that the messages it keeps are logged too.
+     * The caller must hold levelMutex.
+     * 
+     * @param sinkThreshold The sink threshold.
+     * @return The threshold for logging at all.
+     */
+    uint8_t addFlightRecorderLevel(uint8_t sinkThreshold) const;
+
+    const std::string name;
+    std::unique_ptr<rk::config::Config> ownedConfig; /**< Only set if the logger has its own config */
+    rk::config::Config& config;
+    std::unique_ptr<rk::time_internal::TimeStampFormatter> ownedTimeStampFormatter; /**< Only set if the logger has its own formatter */
+    rk::time_internal::TimeStampFormatter& timeStampFormatter;
+    rk::time_internal::TickClock tickClock;
+
+    mutable std::mutex levelMutex;
+    Level level = Level::Info;
+    bool isLoggingEnabled = true;
+    std::atomic<uint8_t> threshold{static_cast<uint8_t>(Level::Info)}; /**< The level, flight recorder level, and kill-switch combined, so checking takes one load */
+    std::atomic<uint8_t> sinkThreshold{static_cast<uint8_t>(Level::Info)}; /**< Same as threshold, without the flight recorder level */
+    uint8_t flightRecorderThreshold = UINT8_MAX; /**< Above every level while the flight recorder is off. Guarded by levelMutex */
+    std::unordered_map<std::string, Level> moduleLevels; /**< By module tag or file name. Guarded by levelMutex */
+    std::atomic<bool> hasModuleLevels{false};
+    const uint32_t id; /**< Identifies this logger in the cache of a call site */
+    rk::log_internal::CallSite* callSites = nullptr; /**< The call sites that cache their level for this logger */
+
+    std::unique_ptr<Shard[]> shards; /**< Always holds the max number of shards, so logging never races with start() */
+    std::atomic<size_t> shardCount{1};
+    std::atomic<bool> isGloballyOrdered{false};
+    std::atomic<uint64_t> nextSequence{0};
+    std::atomic<bool> endLogLoop{false};
+    OrderedWriter orderedWriter;
+
+    std::mutex sinksMutex;
+    std::vector<std::shared_ptr<Sink>> configuredSinks; /**< Sinks created from the config on start, e.g., the console and log file */
+    std::vector<std::shared_ptr<Sink>> addedSinks; /**< Sinks added through addSink() */
+
+    std::unique_ptr<FlightRecorder> flightRecorder; /**< Only set if it is enabled in the config. Guarded by sinksMutex */
+    std::atomic<bool> hasFlightRecorder{false};
+    Level flightRecorderLevel = Level::Trace; /**< Set by start() */
+    Level flightRecorderTrigger = Level::Error; /**< Set by start() */
+    bool isSignalDumpEnabled = false; /**< Set by start() */
+    std::chrono::milliseconds idleFlushInterval{0}; /**< How often an idle log thread flushes the sinks, so a compressed log file finishes its frame. 0 if it doesn't need to. Set by start() */
+    uint64_t handledSignalCount = 0; /**< Only used by the thread that dumps the flight recorder on the signal */
+    size_t dumpCount = 0; /**< Guarded by sinksMutex */
+
+    std::atomic<rk::shm_internal::RingWriter*> ringWriter{nullptr}; /**< Only set while the logger is started with the shared-memory transport */
+    std::vector<std::unique_ptr<rk::shm_internal::RingWriter>> ringWriters; /**< Kept until the logger is destroyed, so logging never races with start() or stop() */
+
+    mutable std::mutex lifecycleMutex; /**< Serializes starting and stopping, including at exit */
+    bool isStarted = false; /**< Guarded by lifecycleMutex */
+    std::thread ownedLogThread; /**< Only set if the logger was started with startOwned(). Guarded by lifecycleMutex */
+    std::mutex logThreadDoneMutex;
+    std::condition_variable logThreadDoneCv;
+    bool isLogThreadDone = true; /**< Set by the log thread when it ends. Guarded by logThreadDoneMutex */
+    std::atomic<int64_t> drainDeadlineNs{INT64_MAX}; /**< In steady_clock time. Set when the logger is stopping */
+    std::atomic<bool> isSpillingLeftovers{false}; /**< Set when the logger is stopping */
+    std::atomic<uint64_t> droppedLeftoverCount{0};
+    std::atomic<uint64_t> spilledLeftoverCount{0};
+    std::shared_ptr<Sink> spillFile; /**< Only opened once there is something to spill. Guarded by sinksMutex */
+    std::string spillFileName; /**< Guarded by sinksMutex */
+    std::shared_ptr<Sink> sharedLogFile; /**< The log file that every shard writes to, if there is one. Also in configuredSinks. Guarded by sinksMutex */
+    bool isRestartedAfterFork = false; /**< Set in a child process, where the logger owns the log thread that it restarted. Guarded by lifecycleMutex */
+    bool isRingInherited = false; /**< Set in a child process, which writes to the ring of its parent. Guarded by lifecycleMutex */
+    bool isLogFileCompressed = false; /**< Guarded by lifecycleMutex */
+    bool isLogFileIndexed = false; /**< Guarded by lifecycleMutex */
+};
+
+/**
+ * Starts a logger with startOwned() when it is created and stops it when it goes out of scope, e.g., at the top of
+ * main(), so the queued messages are written however main() returns.
+ */
+class ScopedLogger {
+public:
+    /**
+     * @brief Starts the logger.
+     * 
+     * @param logger The logger to start. It must outlive this object.
+     * @param configPath The path to the config file.
+     */
+    explicit ScopedLogger(Logger& logger, const std::filesystem::path& configPath = std::filesystem::current_path()/rk::config::CONFIG_FILE_NAME);
+
+    /**
+     * @brief Starts the default logger.
+     * 
+     * @param configPath The path to the config file.
+     */
+    explicit ScopedLogger(const std::filesystem::path& configPath = std::filesystem::current_path()/rk::config::CONFIG_FILE_NAME);
+
+    /**
+     * @brief Stops the logger.
+     */
+    ~ScopedLogger();
+
+    ScopedLogger(const ScopedLogger&) = delete;
+    ScopedLogger& operator=(const ScopedLogger&) = delete;
+
+private:
+    Logger& logger;
+};
+
+/**
+ * @brief Gets the default logger, which is the one that RK_LOG logs to. It uses the config from rk::config::getInstance().
  * 
- * @param std::thread The thread that is running the log loop. Most likely one would pass in the
- * thread that was created in startLogThread().
+ * @return The default logger.
  */
-void endLogThread(std::thread);
+Logger& getDefaultLogger();
 
 /**
- * @brief Opens the log file.
+ * @brief Gets the logger with the given name, creating it if it doesn't exist yet.
+ * 
+ * Looking up a logger by name takes a lock, so save the reference instead of calling this for every message.
+ * 
+ * @param name The name of the logger. DEFAULT_LOGGER_NAME returns the default logger.
+ * @return The logger.
  */
-void openLogFile();
+Logger& getLogger(const std::string& name);
 
 /**
- * @brief Closes the log file.
+ * @brief The main function that starts the default logger. Sets up various things like configs, logging threads, etc.
+ * Call this first, before logging any messages.
+ * 
+ * @param configPath The path to the config file.
+ * @return The thread that is running the log loop.
  */
-void closeLogFile();
+std::thread startLogger(const std::filesystem::path& configPath = std::filesystem::current_path()/rk::config::CONFIG_FILE_NAME);
 
 /**
- * @brief Verifies whether the log file was created and opened.
+ * @brief Dumps the flight recorder of the default logger. See Logger::dumpFlightRecorder().
  */
-void verifyLogFile();
+void dumpFlightRecorder();
 
 /**
- * @brief Enables automatic flushing of the std::cout output stream.
+ * @brief Ends the default logger. Call this at the end before the program ends.
+ * 
+ * @param std::thread The thread that was running the log loop.
  */
-void enableAutoFlush();
+void stopLogger(std::thread);
 
 /**
- * @brief Disables automatic flushing of the std::cout output stream.
+ * @brief Stops every logger that is still running, in the order they were started. It is registered with
+ * std::atexit when the first logger is started, so it only needs to be called before leaving the program in other
+ * ways, e.g., before std::quick_exit().
  */
-void disableAutoFlush();
+void stopAllLoggers();
+
+} // namespace log
+} // namespace rk
+
+namespace rk {
+namespace log_internal {
+
+constexpr size_t MESSAGE_BUFFER_RESERVE = 4096; /**< Initial size of the log loop's message buffer */
 
 /**
  * @brief Prints an internal log message for the main logging module.
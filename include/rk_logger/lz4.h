@@ -0,0 +1,257 @@
+/**
+ * @file lz4.h
+ * @brief Header file for the LZ4 compressor and decompressor that compressed log files are written and read with.
+ *
+ * Log files are written in the standard LZ4 frame format, so they can also be read with the lz4 command line tool.
+ * The writer starts a new frame at every flush point. Each frame can be decoded on its own, so a file that is still
+ * being written can be decoded up to its last finished frame.
+ */
+#ifndef LZ4_H
+#define LZ4_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace rk {
+namespace lz4_internal {
+
+constexpr uint32_t FRAME_MAGIC = 0x184D2204;
+constexpr uint32_t SKIPPABLE_FRAME_MAGIC = 0x184D2A50; /**< The lowest of the 16 magic numbers of skippable frames */
+constexpr size_t BLOCK_SIZE = 256 * 1024; /**< The most uncompressed data in a block that FrameEncoder writes */
+constexpr size_t MAX_DISTANCE = 65535; /**< The farthest back that a match can be */
+constexpr int MIN_LEVEL = 1; /**< The fastest level. Only looks at one earlier position per match */
+constexpr int MAX_LEVEL = 9; /**< The smallest level. Looks at up to 256 earlier positions per match */
+
+/**
+ * @brief Gets the most space that compressing a block can take, e.g., for data that doesn't compress at all.
+ *
+ * @param size The size of the block.
+ * @return The size of the largest compressed block.
+ */
+constexpr size_t getMaxCompressedSize(const size_t size) {
+    return size + size / 255 + 16;
+}
+
+/**
+ * Computes the XXH32 hash that LZ4 frames use for their checksums, over data that can come in pieces.
+ */
+class Xxh32 {
+public:
+    explicit Xxh32(uint32_t seed = 0);
+
+    /**
+     * @brief Adds data to the hash.
+     *
+     * @param data The data.
+     * @param size The size of the data.
+     */
+    void update(const void* data, size_t size);
+
+    /**
+     * @brief Gets the hash of the data that was added so far.
+     *
+     * @return The hash.
+     */
+    uint32_t digest() const;
+private:
+    uint32_t accumulators[4];
+    uint32_t seed;
+    uint64_t totalSize = 0;
+    unsigned char buffer[16]; /**< Data that doesn't fill a whole stripe yet */
+    size_t bufferSize = 0;
+};
+
+/**
+ * @brief Computes the XXH32 hash of data in one piece.
+ *
+ * @param data The data.
+ * @param size The size of the data.
+ * @param seed The seed.
+ * @return The hash.
+ */
+uint32_t xxh32(const void* data, size_t size, uint32_t seed = 0);
+
+/**
+ * Compresses blocks in the LZ4 block format. Each block is compressed on its own, but the hash tables are kept
+ * between blocks so they aren't cleared for every block.
+ */
+class BlockCompressor {
+public:
+    /**
+     * @brief Creates a compressor.
+     *
+     * @param level From MIN_LEVEL to MAX_LEVEL. Levels out of range are clamped.
+     */
+    explicit BlockCompressor(int level = MIN_LEVEL);
+
+    /**
+     * @brief Compresses a block.
+     *
+     * @param data The block.
+     * @param size The size of the block. At most 2 GB.
+     * @param out Output for the compressed block. Must have room for getMaxCompressedSize(size) bytes.
+     * @return The size of the compressed block.
+     */
+    size_t compress(const char* data, size_t size, char* out);
+
+    /**
+     * @brief Gets the level.
+     *
+     * @return The level.
+     */
+    int getLevel() const;
+private:
+    size_t compressFast(const unsigned char* data, size_t size, unsigned char* out);
+    size_t compressChained(const unsigned char* data, size_t size, unsigned char* out);
+
+    /**
+     * @brief Gives the positions in the next block numbers above the ones in earlier blocks, so entries in the tables
+     * from earlier blocks can be told apart without clearing them. The tables are only cleared once the numbers run out.
+     *
+     * @param size The size of the next block.
+     */
+    void startBlock(size_t size);
+
+    const int level;
+    std::vector<uint32_t> hashTable; /**< The last position with each hash. 0 for none */
+    std::vector<uint16_t> chainTable; /**< How far back the previous position with the same hash is, by position. 0 for none */
+    uint32_t blockStart = 1; /**< The number of the first position of the current block */
+};
+
+/**
+ * @brief Decompresses a block in the LZ4 block format. Corrupt blocks are detected and never read or write out of
+ * bounds.
+ *
+ * @param data The compressed block.
+ * @param size The size of the compressed block.
+ * @param maxSize The most data that the block can decompress to.
+ * @param out The decompressed data is appended to this.
+ * @param historySize How many bytes at the end of out, from before the block, matches can refer to. 0 for blocks that
+ * were compressed on their own.
+ * @return True if the block was decompressed, false if it is corrupt. On failure, out is left as it was.
+ */
+bool decompressBlock(const char* data, size_t size, size_t maxSize, std::string& out, size_t historySize);
+
+/**
+ * Writes LZ4 frames made of independent blocks of up to BLOCK_SIZE. Data is collected until a block is full, and
+ * whatever is left is written when the frame is finished.
+ */
+class FrameEncoder {
+public:
+    /**
+     * @brief Creates an encoder.
+     *
+     * @param level From MIN_LEVEL to MAX_LEVEL.
+     */
+    explicit FrameEncoder(int level = MIN_LEVEL);
+
+    /**
+     * @brief Adds data to the current frame, starting one if none is open. Blocks that fill up are compressed.
+     *
+     * @param data The data.
+     * @param out Compressed output is appended to this.
+     */
+    void write(std::string_view data, std::string& out);
+
+    /**
+     * @brief Compresses whatever is collected and ends the frame, so everything written so far can be decoded. Does
+     * nothing if no frame is open.
+     *
+     * @param out Compressed output is appended to this.
+     */
+    void finishFrame(std::string& out);
+
+    /**
+     * @brief Checks whether a frame was started and not finished yet.
+     *
+     * @return True if a frame is open, false otherwise.
+     */
+    bool isFrameOpen() const;
+private:
+    void writeBlock(const char* data, size_t size, std::string& out);
+
+    BlockCompressor compressor;
+    std::string pending; /**< Data for the next block */
+    bool isOpen = false;
+};
+
+/**
+ * Decodes a stream of LZ4 frames that arrives in pieces of any size, e.g., a file that is still being written. Frames
+ * written by other LZ4 encoders are supported too, including linked blocks, checksums, and skippable frames.
+ * Frames that need a dictionary are not.
+ */
+class FrameDecoder {
+public:
+    /**
+     * @brief Decodes the next piece of the stream. Data that doesn't complete a block is kept for the next call.
+     *
+     * @param data The piece.
+     * @param size The size of the piece.
+     * @param out The decoded data is appended to this.
+     * @return True if the stream is valid so far, false if it is corrupt. Once it fails, every later call fails too.
+     */
+    bool decode(const char* data, size_t size, std::string& out);
+
+    /**
+     * @brief Checks whether everything that was passed in ended at the end of a frame, i.e., nothing is missing.
+     *
+     * @return True if the stream ended between frames, false if it ended inside a frame.
+     */
+    bool isAtFrameBoundary() const;
+
+    /**
+     * @brief Gets why decoding failed.
+     *
+     * @return The reason, or an empty string if it didn't fail.
+     */
+    const std::string& getError() const;
+private:
+    enum class Stage : uint8_t {
+        Magic,
+        SkippableSize,
+        Skip,
+        Header,
+        BlockSize,
+        Block,
+        ContentChecksum,
+    };
+
+    /**
+     * @brief Decodes the next part of the stream for the current stage.
+     *
+     * @param data The data that is available.
+     * @param size The size of the data.
+     * @param out The decoded data is appended to this.
+     * @return How much of the data was used. 0 if more data is needed or on failure.
+     */
+    size_t step(const unsigned char* data, size_t size, std::string& out);
+
+    size_t parseHeader(const unsigned char* data, size_t size);
+    size_t decodeBlock(const unsigned char* data, size_t size, std::string& out);
+    bool finishFrame();
+    size_t fail(const char* reason);
+
+    Stage stage = Stage::Magic;
+    std::string input; /**< Data that was passed in and not used yet */
+    std::string window; /**< The most recent output, which linked blocks can refer to */
+    std::string error;
+    Xxh32 contentHash;
+    uint64_t skipRemaining = 0;
+    uint32_t blockSize = 0;
+    bool isBlockCompressed = false;
+    size_t maxBlockSize = 0;
+    bool areBlocksLinked = false;
+    bool hasBlockChecksum = false;
+    bool hasContentChecksum = false;
+    bool hasContentSize = false;
+    uint64_t contentSize = 0;
+    uint64_t decodedSize = 0;
+};
+
+} // namespace lz4_internal
+} // namespace rk
+
+#endif // #ifndef LZ4_H
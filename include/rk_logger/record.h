@@ -0,0 +1,52 @@
+/**
+ * @file record.h
+ * @brief Header file for the log records that are passed from the logging threads to the log thread.
+ */
+#ifndef RECORD_H
+#define RECORD_H
+
+#include <string>
+#include <thread>
+#include <cstdint>
+#include <vector>
+#include <functional>
+#include <ostream>
+
+#include <rk_logger/log_time.h>
+#include <rk_logger/level.h>
+
+namespace rk {
+namespace log {
+
+/**
+ * An argument that is written into the message by the log thread rather than when the message is logged, i.e., a
+ * string given to rk::log::owned(), a callable given to rk::log::defer(), or a value with a deferred rk::log::formatter.
+ */
+struct SplicedArg {
+    size_t offset; /**< Where the argument goes in the message */
+    std::string text; /**< Written as is if write and format are empty */
+    std::function<void(std::ostream&)> write;
+    void (*format)(const std::string& bytes, std::string& out) = nullptr; /**< Formats text, which holds the bytes of a value, if set */
+};
+
+/**
+ * A log message as it is queued by RK_LOG. The timestamp, thread id, and function name prefix is added by the log
+ * thread when the record is formatted, so the logging thread only has to build the message itself.
+ */
+struct Record {
+    rk::time_internal::time_point time; /**< Only set if ticks is 0 */
+    uint64_t ticks = 0; /**< Raw ticks from the logger's TickClock. Converted to the time by the log thread */
+    std::thread::id threadId;
+    const char* funcName = ""; /**< Points to __func__, which has static storage */
+    Level level = Level::Info;
+    std::string message;
+    std::vector<SplicedArg> spliced; /**< Ordered by offset. Usually empty */
+    uint64_t sequence = 0; /**< Position in the global order. Only used when shards are globally ordered */
+    bool isForSinks = true; /**< False if the message is below the level of the sinks and only kept by the flight recorder */
+    bool isFlightRecorderDump = false; /**< Set if this is a request from dumpFlightRecorder() rather than a message */
+};
+
+} // namespace log
+} // namespace rk
+
+#endif // #ifndef RECORD_H
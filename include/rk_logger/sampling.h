@@ -0,0 +1,107 @@
+/**
+ * @file sampling.h
+ * @brief Header file for the samplers and rate limiters used by the RK_LOG_EVERY_N family of macros.
+ *
+ * Each macro call site has its own static sampler, so the decision to log is made with one atomic operation on
+ * state that only that call site uses. The macros only evaluate the message arguments when the sampler lets the
+ * message through.
+ */
+#ifndef SAMPLING_H
+#define SAMPLING_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace rk {
+namespace log_internal {
+
+/**
+ * @brief Gets the current time of the monotonic clock that the samplers use.
+ *
+ * @return Nanoseconds since an unspecified point in time.
+ */
+inline int64_t samplerNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * Lets through the 1st, (n + 1)th, (2n + 1)th, etc. messages.
+ */
+class EveryNSampler {
+public:
+    bool shouldLog(const uint64_t n) {
+        return n <= 1 || count.fetch_add(1, std::memory_order_relaxed) % n == 0;
+    }
+private:
+    std::atomic<uint64_t> count{0};
+};
+
+/**
+ * Lets through the first n messages. After that, checking is a single load.
+ */
+class FirstNSampler {
+public:
+    bool shouldLog(const uint64_t n) {
+        return count.load(std::memory_order_relaxed) < n && count.fetch_add(1, std::memory_order_relaxed) < n;
+    }
+private:
+    std::atomic<uint64_t> count{0};
+};
+
+/**
+ * Lets through at most one message per interval. Messages that come in before the interval has passed are dropped.
+ */
+class EveryMsSampler {
+public:
+    bool shouldLog(const int64_t intervalMs) {
+        const int64_t now = samplerNowNs();
+        int64_t next = nextAllowedNs.load(std::memory_order_relaxed);
+        if (now < next) {
+            return false;
+        }
+        // If another thread got here first, it logs and this one doesn't
+        return nextAllowedNs.compare_exchange_strong(next, now + intervalMs * NS_PER_MS, std::memory_order_relaxed);
+    }
+private:
+    static constexpr int64_t NS_PER_MS = 1000000;
+    std::atomic<int64_t> nextAllowedNs{0};
+};
+
+/**
+ * A token bucket that refills at a steady rate and holds up to "burst" tokens. Each message takes a token, and
+ * messages are dropped while the bucket is empty.
+ *
+ * The bucket is kept as a single "theoretical arrival time" (the generic cell rate algorithm), so taking a token is
+ * one compare-and-swap instead of separate updates to a token count and a refill time.
+ */
+class RateLimiter {
+public:
+    bool shouldLog(const double messagesPerSecond, const uint64_t burst) {
+        if (messagesPerSecond <= 0) {
+            return false;
+        }
+        const int64_t intervalNs = static_cast<int64_t>(NS_PER_S / messagesPerSecond);
+        const int64_t toleranceNs = intervalNs * static_cast<int64_t>(burst > 0 ? burst - 1 : 0);
+        const int64_t now = samplerNowNs();
+
+        int64_t arrival = theoreticalArrivalNs.load(std::memory_order_relaxed);
+        while (true) {
+            const int64_t start = arrival > now ? arrival : now;
+            if (start - now > toleranceNs) {
+                return false;
+            }
+            if (theoreticalArrivalNs.compare_exchange_weak(arrival, start + intervalNs, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+    }
+private:
+    static constexpr double NS_PER_S = 1e9;
+    std::atomic<int64_t> theoreticalArrivalNs{0};
+};
+
+} // namespace log_internal
+} // namespace rk
+
+#endif // #ifndef SAMPLING_H
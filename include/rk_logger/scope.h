@@ -0,0 +1,108 @@
+/**
+ * @file scope.h
+ * @brief Header file for scoped context fields, e.g., a request id that every message logged while handling the
+ * request is tagged with.
+ *
+ * The fields of the scopes that are open on a thread are kept rendered in a thread-local string, e.g.,
+ * "[req=42][session=abc]", so a message only has to copy them. They are written after the function name, e.g.,
+ * "[<timestamp>][<thread id>][handleRequest][req=42][session=abc]Done".
+ */
+#ifndef SCOPE_H
+#define SCOPE_H
+
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <rk_logger/format.h>
+#include <rk_logger/record.h>
+
+namespace rk {
+namespace log_internal {
+
+/**
+ * @brief Gets the fields of the scopes that are open on the calling thread, already rendered.
+ *
+ * @return The fields, or an empty string outside of any scope.
+ */
+inline std::string& getThreadContext() {
+    thread_local std::string context;
+    return context;
+}
+
+/**
+ * @brief Starts the message of a record with the fields of the calling thread's scopes.
+ *
+ * @param record The record, whose message is still empty.
+ */
+inline void appendThreadContext(rk::log::Record& record) {
+    const std::string& context = getThreadContext();
+    if (!context.empty()) {
+        record.message = context;
+    }
+}
+
+} // namespace log_internal
+
+namespace log {
+
+/**
+ * A field of a scope, rendered as "[key=value]". The value is written the same way as an argument to RK_LOG, when the
+ * field is created. That includes a value with a deferred rk::log::formatter, which is formatted then too.
+ */
+struct ScopeField {
+    template<typename T>
+    ScopeField(const std::string_view key, T&& value) {
+        static_assert(!rk::log_internal::IsDeferred<std::decay_t<T>>::value && !std::is_same_v<std::decay_t<T>, Owned>,
+            "Scope fields are rendered when the scope is created, so they can't be deferred or owned");
+        Record record;
+        record.message.reserve(key.size() + 16);
+        record.message += '[';
+        record.message += key;
+        record.message += '=';
+        if constexpr (rk::log_internal::HasFormatter<std::decay_t<T>>::value) {
+            // A deferred formatter would only copy the value into the record, so the field formats it right away
+            rk::log_internal::appendFormatted(record.message, value);
+        }
+        else {
+            rk::log_internal::appendArg(record, std::forward<T>(value));
+        }
+        record.message += ']';
+        text = std::move(record.message);
+    }
+
+    std::string text;
+};
+
+/**
+ * Tags every message that the calling thread logs while it is alive with some fields, e.g.,
+ * rk::log::Scope scope{{"req", requestId}, {"session", sessionId}}. Scopes can be nested, and the fields of the outer
+ * ones come first. A scope only affects the thread that created it, and has to be destroyed on that thread, in the
+ * reverse order of creation, which is what happens to local variables.
+ */
+class Scope {
+public:
+    /**
+     * @brief Adds fields to the calling thread's messages.
+     *
+     * @param fields The fields.
+     */
+    Scope(std::initializer_list<ScopeField> fields);
+
+    /**
+     * @brief Removes the fields that this scope added.
+     */
+    ~Scope();
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    const size_t previousSize; /**< The size of the thread's context before this scope */
+};
+
+} // namespace log
+} // namespace rk
+
+#endif // #ifndef SCOPE_H
@@ -0,0 +1,227 @@
+/**
+ * @file shm_ring.h
+ * @brief Header file for the shared-memory ring that carries log records from an application to the rk_log_agent process.
+ *
+ * The ring lives in a POSIX shared-memory object, so the records that the application has committed to it are still
+ * there for the agent to write if the application crashes. Any number of threads in the application write to the ring
+ * and one agent reads from it.
+ */
+#ifndef SHM_RING_H
+#define SHM_RING_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include <rk_logger/record.h>
+#include <rk_logger/tick_clock.h>
+
+namespace rk {
+namespace shm_internal {
+
+constexpr uint64_t RING_MAGIC = 0x524b4c4f4752494e; /**< "RKLOGRIN". Written last when the ring is created */
+constexpr uint32_t RING_VERSION = 2;
+constexpr size_t MAX_RING_LOGGER_NAME_SIZE = 63;
+constexpr size_t MAX_RING_PRODUCERS = 256; /**< The process that created the ring and the children that it forked */
+
+/**
+ * The start of the shared-memory object. The data area of the ring follows it.
+ *
+ * reserved and consumed are byte positions that only grow. The position of a byte in the data area is its position
+ * modulo the capacity.
+ *
+ * A child that an application forks keeps writing to the ring, so every process that writes to it has a slot with its
+ * PID. A process clears its slot when its logger stops, and the agent is done once every slot is clear or belongs to a
+ * process that has exited.
+ */
+struct RingHeader {
+    std::atomic<uint64_t> magic;
+    uint32_t version;
+    uint64_t capacity; /**< The size of the data area in bytes. A multiple of 8 */
+    rk::time_internal::TickSource tickSource; /**< How the timestamps of the records were taken */
+    char loggerName[MAX_RING_LOGGER_NAME_SIZE + 1];
+    alignas(64) std::atomic<uint64_t> reserved; /**< Advanced by the producers when they reserve an entry */
+    alignas(64) std::atomic<uint64_t> consumed; /**< Advanced by the agent after it has written an entry */
+    alignas(64) std::atomic<uint64_t> droppedCount; /**< Records that didn't fit in the ring */
+    alignas(64) std::atomic<uint32_t> producerPids[MAX_RING_PRODUCERS]; /**< 0 for a slot that isn't in use */
+};
+
+/**
+ * A record as read from the ring. The views point into the ring and are valid until the next call to RingReader::read().
+ */
+struct RecordView {
+    uint64_t stamp; /**< Raw ticks if isTicks is set, nanoseconds since the epoch of system_clock otherwise */
+    bool isTicks;
+    rk::log::Level level;
+    std::string_view threadId;
+    std::string_view funcName;
+    std::string_view message; /**< With the owned and deferred arguments already spliced in */
+};
+
+/**
+ * The application's side of the ring. Threads reserve space with a compare-and-swap and then copy their record in
+ * without any lock, so a thread that is slow to copy only delays the agent, never the other threads.
+ */
+class RingWriter {
+public:
+    /**
+     * @brief Creates the shared-memory object and the ring in it. An object left behind with the same name is
+     * replaced.
+     *
+     * @param name The name of the object, e.g., "/rk_log_default".
+     * @param capacity The size of the data area in bytes. Rounded down to a multiple of 8.
+     * @param loggerName The name of the logger, which the agent uses in the name of the log file.
+     * @param tickSource How the timestamps of the records are taken.
+     * @return The writer, or nullptr if the object could not be created.
+     */
+    static std::unique_ptr<RingWriter> create(const std::string& name, size_t capacity, const std::string& loggerName,
+        rk::time_internal::TickSource tickSource);
+
+    /**
+     * @brief Unmaps the ring. The shared-memory object is left for the agent, which removes it when it is done.
+     */
+    ~RingWriter();
+
+    RingWriter(const RingWriter&) = delete;
+    RingWriter& operator=(const RingWriter&) = delete;
+
+    /**
+     * @brief Copies a record into the ring. The record is dropped if the ring is full.
+     *
+     * @param record The record. Its owned and deferred arguments are spliced into the message by the calling thread.
+     * @return True if the record was written, false if it was dropped.
+     */
+    bool write(const rk::log::Record& record);
+
+    /**
+     * @brief Marks this process as done with the ring, so the agent stops once every process that writes to it is
+     * done and it has written everything in it.
+     */
+    void close();
+
+    /**
+     * @brief Claims a slot for the child of a fork that is about to happen. Until the child takes the slot over, it
+     * holds the PID of this process, so the agent can't finish in between. If the fork fails, the slot is only freed
+     * once this process exits.
+     */
+    void prepareForFork();
+
+    /**
+     * @brief Takes over the slot that was claimed for this process before the fork. Only called in the child.
+     *
+     * @return True if the child has a slot, false if every slot was in use, in which case the agent may finish while
+     * the child is still writing.
+     */
+    bool restartAfterFork();
+
+    /**
+     * @brief Gets the number of records that were dropped because the ring was full.
+     *
+     * @return The number of records.
+     */
+    uint64_t getDroppedCount() const;
+
+private:
+    RingWriter(RingHeader* header, size_t mappingSize);
+
+    RingHeader* header;
+    char* data;
+    size_t mappingSize;
+    size_t producerSlot = 0; /**< The slot of this process */
+    size_t forkSlot = 0; /**< The slot that was claimed for the child of the last fork */
+};
+
+/**
+ * The agent's side of the ring. Only one reader may be attached to a ring.
+ */
+class RingReader {
+public:
+    /**
+     * @brief Attaches to a ring that was created by RingWriter::create().
+     *
+     * @param name The name of the shared-memory object.
+     * @return The reader, or nullptr if the object doesn't exist or isn't a ring yet.
+     */
+    static std::unique_ptr<RingReader> open(const std::string& name);
+
+    ~RingReader();
+
+    RingReader(const RingReader&) = delete;
+    RingReader& operator=(const RingReader&) = delete;
+
+    /**
+     * @brief Reads the next record, and gives the space of the previous one back to the producers.
+     *
+     * @param record Output for the record.
+     * @param isProducerDone Whether isProducerDone() was true before the read. If so, nothing will commit the entries
+     * that are still reserved, e.g., because the application crashed while writing them, so they are skipped and
+     * counted as lost instead of stopping the read.
+     * @return True if a record was read, false if there is no committed record to read yet.
+     */
+    bool read(RecordView& record, bool isProducerDone = false);
+
+    /**
+     * @brief Checks if the application won't write any more records, i.e., in every process that writes to the ring,
+     * the logger was stopped or the process has exited.
+     *
+     * @return True if the application is done, false otherwise.
+     */
+    bool isProducerDone() const;
+
+    /**
+     * @brief Gets the name of the application's logger.
+     *
+     * @return The name.
+     */
+    std::string getLoggerName() const;
+
+    /**
+     * @brief Gets how the timestamps of the records were taken.
+     *
+     * @return The tick source.
+     */
+    rk::time_internal::TickSource getTickSource() const;
+
+    /**
+     * @brief Gets the number of records that the application dropped because the ring was full.
+     *
+     * @return The number of records.
+     */
+    uint64_t getDroppedCount() const;
+
+    /**
+     * @brief Gets the number of entries that were skipped because the application exited before it committed them.
+     *
+     * @return The number of entries.
+     */
+    uint64_t getLostCount() const;
+
+private:
+    RingReader(RingHeader* header, size_t mappingSize);
+
+    /**
+     * @brief Zeroes the entry that was read last and advances the consumed position past it.
+     */
+    void release();
+
+    RingHeader* header;
+    char* data;
+    size_t mappingSize;
+    uint64_t position = 0; /**< The consumed position, only kept in the header once an entry is released */
+    uint64_t pendingSize = 0; /**< The size of the entry that was read last and isn't released yet */
+    uint64_t lostCount = 0;
+};
+
+/**
+ * @brief Removes the shared-memory object of a ring. Processes that have it mapped can keep using it.
+ *
+ * @param name The name of the object.
+ */
+void removeRing(const std::string& name);
+
+} // namespace shm_internal
+} // namespace rk
+
+#endif // #ifndef SHM_RING_H
@@ -0,0 +1,150 @@
+/**
+ * @file simd.h
+ * @brief Header file for the vectorized kernels that render digits and scan text while records are formatted.
+ *
+ * Each kernel has a scalar version and, on x86, SSE2 and AVX2 versions. The best version that the CPU supports is
+ * picked once, at the first call, and every version gives exactly the same output.
+ */
+#ifndef SIMD_H
+#define SIMD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace rk {
+namespace simd_internal {
+
+constexpr size_t DIGIT_PAIR_BATCH = 16; /**< The number of digit pairs that renderDigitPairs() reads and writes */
+constexpr size_t MAX_UNSIGNED_DIGITS = 20; /**< The digits of the largest uint64_t */
+constexpr size_t MAX_FIND_CHARS = 8; /**< The most characters that findAnyOf() and matchAnyOf() can look for at once */
+constexpr size_t MAX_MATCH_SIZE = 64; /**< The most characters that matchAnyOf() checks, one per bit of its mask */
+
+/**
+ * The instruction sets that the kernels can use. Each level includes the ones before it.
+ */
+enum class SimdLevel : uint8_t {
+    Scalar,
+    Sse2,
+    Avx2,
+};
+
+/**
+ * @brief Gets the best level that the CPU supports.
+ *
+ * @return The level.
+ */
+SimdLevel getSupportedSimdLevel();
+
+/**
+ * @brief Gets the level that the kernels currently use.
+ *
+ * @return The level.
+ */
+SimdLevel getSimdLevel();
+
+/**
+ * @brief Sets the level that the kernels use, e.g., to compare them against the scalar versions in tests and
+ * benchmarks. A level that the CPU doesn't support is lowered to the best one that it does.
+ *
+ * @param level The level.
+ */
+void setSimdLevel(SimdLevel level);
+
+/**
+ * @brief Gets the name of a level, e.g., "AVX2".
+ *
+ * @param level The level.
+ * @return The name.
+ */
+const char* simdLevelToString(SimdLevel level);
+
+/**
+ * @brief Renders numbers from 0 to 99 as two ASCII digits each, e.g., 7 as "07".
+ *
+ * The vectorized versions always work on a whole batch, so values must have room for DIGIT_PAIR_BATCH numbers and
+ * out for 2 * DIGIT_PAIR_BATCH characters, even if count is smaller. Only the first count pairs are meaningful.
+ *
+ * @param values The numbers. Numbers above 99 give wrong digits.
+ * @param count How many numbers to render. At most DIGIT_PAIR_BATCH.
+ * @param out Output for the digits.
+ */
+void renderDigitPairs(const uint16_t* values, size_t count, char* out);
+
+/**
+ * @brief Renders an unsigned integer in decimal, without leading zeros. The output is the same as std::to_chars.
+ *
+ * @param value The integer.
+ * @param out Output for the digits. Must have room for MAX_UNSIGNED_DIGITS characters.
+ * @return The number of digits that were written.
+ */
+size_t renderUnsigned(uint64_t value, char* out);
+
+/**
+ * @brief Finds the first character in a text that is one of a set of characters.
+ *
+ * @param text The text to search.
+ * @param chars The characters to look for. At most MAX_FIND_CHARS.
+ * @return The index of the first match, or the size of the text if there is none.
+ */
+size_t findAnyOf(std::string_view text, std::string_view chars);
+
+/**
+ * @brief Checks which characters of a short text are one of a set of characters, e.g., to filter a timestamp in one
+ * pass instead of searching for one match after the other.
+ *
+ * @param data The text.
+ * @param size The size of the text. Only the first MAX_MATCH_SIZE characters are checked.
+ * @param chars The characters to look for. At most MAX_FIND_CHARS.
+ * @return A mask with bit i set if character i is one of chars.
+ */
+uint64_t matchAnyOf(const char* data, size_t size, std::string_view chars);
+
+/**
+ * @brief Gets the index of the lowest set bit of a mask from matchAnyOf().
+ *
+ * @param mask The mask. Must not be 0.
+ * @return The index.
+ */
+inline size_t lowestSetBit(const uint64_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<size_t>(__builtin_ctzll(mask));
+#else
+    size_t index = 0;
+    while (((mask >> index) & 1) == 0) {
+        index++;
+    }
+    return index;
+#endif
+}
+
+/**
+ * @brief Appends an integer in decimal. The output is the same as std::to_chars.
+ *
+ * @param out The string to append to.
+ * @param value The integer.
+ */
+template<typename T>
+void appendInteger(std::string& out, const T value) {
+    static_assert(std::is_integral_v<T> && sizeof(T) <= sizeof(uint64_t), "Only integers of up to 64 bits are supported");
+    uint64_t magnitude = static_cast<uint64_t>(value);
+    if constexpr (std::is_signed_v<T>) {
+        if (value < 0) {
+            out += '-';
+            magnitude = 0 - magnitude; // Negating the unsigned value also works for the lowest value of T
+        }
+    }
+    if (magnitude < 10) {
+        out += static_cast<char>('0' + magnitude);
+        return;
+    }
+    char digits[MAX_UNSIGNED_DIGITS];
+    out.append(digits, renderUnsigned(magnitude, digits));
+}
+
+} // namespace simd_internal
+} // namespace rk
+
+#endif // #ifndef SIMD_H
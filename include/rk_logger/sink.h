@@ -0,0 +1,312 @@
+/**
+ * @file sink.h
+ * @brief Header file for the sinks that log messages are written to.
+ */
+#ifndef SINK_H
+#define SINK_H
+
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <ostream>
+#include <fstream>
+#include <filesystem>
+#include <memory>
+
+#include <rk_logger/config.h>
+#include <rk_logger/level.h>
+#include <rk_logger/log_index.h>
+#include <rk_logger/lz4.h>
+
+namespace rk {
+namespace log {
+
+/**
+ * What the logger knows about a message besides its text.
+ */
+struct MessageInfo {
+    Level level = Level::Info;
+    int64_t timeNs = 0; /**< When it was logged, in nanoseconds since the epoch */
+    std::string_view threadId; /**< The id of the thread that logged it, as it is printed in the message */
+};
+
+/**
+ * A destination for log messages, e.g., the console or a file. A logger never calls a sink from two threads at once,
+ * so sinks don't need to be thread-safe. Messages are written in batches, and flush() is called at the end of each batch.
+ */
+class Sink {
+public:
+    virtual ~Sink() = default;
+
+    /**
+     * @brief Writes a formatted log message.
+     * 
+     * @param message The message, including the timestamp, thread id, and function name prefix.
+     */
+    virtual void write(const std::string& message) = 0;
+
+    /**
+     * @brief Writes a formatted log message for a sink that needs its level, e.g., to map it to a syslog severity.
+     * By default, it ignores the level and calls write().
+     * 
+     * @param message The message, including the timestamp, thread id, and function name prefix.
+     * @param level The level of the message.
+     */
+    virtual void writeWithLevel(const std::string& message, [[maybe_unused]] Level level) {
+        write(message);
+    }
+
+    /**
+     * @brief Writes a formatted log message for a sink that needs more than its level, e.g., to index it by time.
+     * This is what the logger calls. By default, it calls writeWithLevel().
+     * 
+     * @param message The message, including the timestamp, thread id, and function name prefix.
+     * @param info The level, time, and thread of the message.
+     */
+    virtual void writeWithInfo(const std::string& message, const MessageInfo& info) {
+        writeWithLevel(message, info.level);
+    }
+
+    /**
+     * @brief Flushes anything that the sink has buffered.
+     */
+    virtual void flush() {}
+
+    /**
+     * @brief Writes out everything that the sink holds, including what flush() holds back on purpose, e.g., before
+     * the process forks. By default, it calls flush().
+     */
+    virtual void sync() {
+        flush();
+    }
+};
+
+/**
+ * Writes log messages to an output stream, e.g., std::cout.
+ */
+class StreamSink : public Sink {
+public:
+    explicit StreamSink(std::ostream& stream) : stream(stream) {};
+
+    void write(const std::string& message) override;
+    void flush() override;
+private:
+    std::ostream& stream;
+};
+
+/**
+ * Writes log messages to a file. The file is flushed after each batch of messages.
+ *
+ * The file can be indexed, i.e., an index of times and offsets is written next to it, to "<path>.idx", which
+ * rk_log_query reads. Messages are only indexed if they come with their info, i.e., through writeWithInfo().
+ */
+class FileSink : public Sink {
+public:
+    explicit FileSink(const std::filesystem::path& path) : file(path) {};
+
+    /**
+     * @brief Creates the file and its index.
+     * 
+     * @param path The path of the file.
+     * @param indexRecordInterval The most messages in an index entry.
+     * @param indexByteInterval The most bytes of the file in an index entry.
+     */
+    FileSink(const std::filesystem::path& path, size_t indexRecordInterval, size_t indexByteInterval);
+
+    void write(const std::string& message) override;
+    void writeWithInfo(const std::string& message, const MessageInfo& info) override;
+
+    /**
+     * @brief Flushes the file, and then its index, so the index doesn't point past what is in the file.
+     */
+    void flush() override;
+
+    /**
+     * @brief Writes the index entry of the last messages too, and flushes.
+     */
+    void sync() override;
+
+    /**
+     * @brief Checks whether the file, and its index if it has one, were created and opened.
+     * 
+     * @return True if they are open, false otherwise.
+     */
+    bool isOpen() const;
+private:
+    std::ofstream file;
+    uint64_t size = 0; /**< How much has been written to the file */
+    std::unique_ptr<rk::index_internal::IndexWriter> index;
+};
+
+/**
+ * Writes log messages to a file compressed into LZ4 frames, which can be read with rk_log_decode or "lz4 -d".
+ *
+ * Only finished frames can be decoded, so a frame is finished at the first flush after frameInterval has passed since
+ * it was started. Until then, messages are collected into blocks of up to 256 KB, which compress much better than
+ * each batch would on its own.
+ */
+class Lz4FileSink : public Sink {
+public:
+    /**
+     * @brief Creates the file and the compressor.
+     * 
+     * @param path The path of the file.
+     * @param level The compression level, from 1 (fastest) to 9 (smallest).
+     * @param frameInterval The most time that a frame stays open for. 0 finishes a frame on every flush.
+     */
+    Lz4FileSink(const std::filesystem::path& path, int level, std::chrono::milliseconds frameInterval);
+
+    /**
+     * @brief Finishes the last frame.
+     */
+    ~Lz4FileSink() override;
+
+    Lz4FileSink(const Lz4FileSink&) = delete;
+    Lz4FileSink& operator=(const Lz4FileSink&) = delete;
+
+    void write(const std::string& message) override;
+
+    /**
+     * @brief Finishes the frame if it has been open for frameInterval.
+     */
+    void flush() override;
+
+    /**
+     * @brief Finishes the frame and flushes the file.
+     */
+    void sync() override;
+
+    /**
+     * @brief Checks whether the file was created and opened.
+     * 
+     * @return True if the file is open, false otherwise.
+     */
+    bool isOpen() const;
+private:
+    void writeCompressed();
+
+    std::ofstream file;
+    rk::lz4_internal::FrameEncoder encoder;
+    std::string compressed; /**< Compressed output that isn't in the file yet */
+    const std::chrono::milliseconds frameInterval;
+    std::chrono::steady_clock::time_point frameStart;
+};
+
+/**
+ * Writes log messages straight to stdout or stderr with its own buffer, instead of through std::cout, so the
+ * application's std::cout is left alone and logging doesn't go through iostream for every message.
+ *
+ * Output to a terminal is colored by level and written at the end of every batch, so each line shows up right away.
+ * Output to a pipe or file is written in large blocks with writev(), and whatever is left when the sink is destroyed.
+ */
+class ConsoleSink : public Sink {
+public:
+    static constexpr int STDOUT_FD = 1;
+    static constexpr int STDERR_FD = 2;
+    static constexpr size_t BUFFER_SIZE = 64 * 1024;
+
+    enum class ColorMode : uint8_t {
+        Auto, /**< Only color output to a terminal, unless the NO_COLOR environment variable is set */
+        Always,
+        Never,
+    };
+
+    /**
+     * @brief Creates a sink for a file descriptor.
+     * 
+     * @param fd The file descriptor, usually STDOUT_FD or STDERR_FD. It isn't closed by the sink.
+     * @param colorMode Whether messages are colored by level.
+     */
+    explicit ConsoleSink(int fd = STDOUT_FD, ColorMode colorMode = ColorMode::Auto);
+
+    /**
+     * @brief Writes whatever is still buffered.
+     */
+    ~ConsoleSink() override;
+
+    ConsoleSink(const ConsoleSink&) = delete;
+    ConsoleSink& operator=(const ConsoleSink&) = delete;
+
+    void write(const std::string& message) override;
+    void writeWithLevel(const std::string& message, Level level) override;
+
+    /**
+     * @brief Writes the buffer if the output is a terminal or the buffer is full.
+     */
+    void flush() override;
+
+    /**
+     * @brief Writes the buffer, even if the output isn't a terminal.
+     */
+    void sync() override;
+
+    /**
+     * @brief Checks whether the output is a terminal.
+     * 
+     * @return True if it is a terminal, false if it is a pipe, file, etc.
+     */
+    bool isTerminal() const;
+
+    /**
+     * @brief Checks whether messages are colored by level.
+     * 
+     * @return True if they are colored, false otherwise.
+     */
+    bool isColored() const;
+
+private:
+    /**
+     * @brief Adds text to the buffer. Text that doesn't fit in an empty buffer is written along with the buffer in
+     * one writev() call instead of being copied.
+     * 
+     * @param text The text to add.
+     */
+    void append(std::string_view text);
+
+    /**
+     * @brief Writes the buffer and then some more text, retrying partial writes. Output that can't be written because
+     * of an error is dropped.
+     * 
+     * @param extra Text to write after the buffer. Can be empty.
+     */
+    void writeBuffer(std::string_view extra = std::string_view());
+
+    const int fd;
+    bool isOutputTerminal = false;
+    bool isOutputColored = false;
+    std::string buffer;
+};
+
+/**
+ * @brief Creates the sink for "write_to_console". Messages are written with a ConsoleSink, unless the application has
+ * pointed std::cout somewhere else, e.g., to capture it, in which case they are written to std::cout.
+ * 
+ * @param config The config to read console_color from.
+ * @return The sink.
+ */
+std::shared_ptr<Sink> createConsoleSink(const rk::config::Config& config);
+
+/**
+ * @brief Gets the name of a log file with the extension for log_file_compression, e.g., "logs_<timestamp>.txt", or
+ * "logs_<timestamp>.txt.lz4" when it is compressed.
+ * 
+ * @param baseName The name without an extension.
+ * @param config The config to read log_file_compression from.
+ * @return The name.
+ */
+std::string getLogFileName(const std::string& baseName, const rk::config::Config& config);
+
+/**
+ * @brief Creates the sink for "write_to_log_file", which is an Lz4FileSink if log_file_compression is set, or a
+ * FileSink otherwise, with an index if log_file_index is enabled.
+ * 
+ * @param path The path of the file, from getLogFileName().
+ * @param config The config to read the compression settings from.
+ * @return The sink, or nullptr if the file couldn't be opened.
+ */
+std::shared_ptr<Sink> createLogFileSink(const std::filesystem::path& path, const rk::config::Config& config);
+
+} // namespace log
+} // namespace rk
+
+#endif // #ifndef SINK_H
@@ -0,0 +1,127 @@
+/**
+ * @file syslog_sink.h
+ * @brief Header file for the sink that sends log messages to the local syslog or journald socket.
+ */
+#ifndef SYSLOG_SINK_H
+#define SYSLOG_SINK_H
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <rk_logger/sink.h>
+
+namespace rk {
+namespace log {
+
+/**
+ * Sends log messages as datagrams over a Unix socket, either to syslog (e.g., rsyslog or journald on /dev/log) or to
+ * journald's native socket. Each message becomes one datagram with a severity that is mapped from its level.
+ *
+ * The messages of a batch are collected in one buffer and sent when the batch is flushed, with a single sendmmsg()
+ * call per 64 messages on Linux. Sending never blocks the log thread. If the socket is missing, or the receiver can't
+ * keep up, messages are dropped and counted instead. A missing socket is retried at most once per second, so the sink
+ * starts working once the daemon is up.
+ *
+ * Only supported on POSIX systems. On other platforms every message is dropped.
+ */
+class SyslogSink : public Sink {
+public:
+    /**
+     * The format of the datagrams.
+     */
+    enum class Format {
+        Rfc5424, /**< "<PRI>1 - HOSTNAME APP-NAME PROCID - - MSG", for syslog daemons */
+        Journald /**< Native journald fields, i.e., MESSAGE, PRIORITY, SYSLOG_FACILITY, and SYSLOG_IDENTIFIER */
+    };
+
+    static constexpr int FACILITY_USER = 1;
+    static constexpr const char* DEFAULT_SYSLOG_PATH = "/dev/log";
+    static constexpr const char* DEFAULT_JOURNALD_PATH = "/run/systemd/journal/socket";
+
+    /**
+     * @brief Creates a sink and connects it to the socket.
+     * 
+     * @param format The format of the datagrams.
+     * @param socketPath The socket to send to. If empty, the default socket for the format is used.
+     * @param identifier The name that the messages are tagged with. If empty, the name of the program is used.
+     * @param facility The syslog facility, e.g., FACILITY_USER or 16 to 23 for local0 to local7.
+     */
+    explicit SyslogSink(Format format, const std::filesystem::path& socketPath = {}, const std::string& identifier = "", int facility = FACILITY_USER);
+    ~SyslogSink() override;
+
+    SyslogSink(const SyslogSink&) = delete;
+    SyslogSink& operator=(const SyslogSink&) = delete;
+
+    void write(const std::string& message) override;
+    void writeWithLevel(const std::string& message, Level level) override;
+    void flush() override;
+
+    /**
+     * @brief Checks whether the sink is connected to the socket.
+     * 
+     * @return True if it is connected, false otherwise.
+     */
+    bool isConnected() const;
+
+    /**
+     * @brief Gets the number of messages that could not be sent.
+     * 
+     * @return The number of messages.
+     */
+    uint64_t getDroppedCount() const;
+
+    /**
+     * @brief Gets the syslog severity for a level, e.g., 3 (err) for Level::Error.
+     * 
+     * @param level The level.
+     * @return The severity.
+     */
+    static int toSeverity(Level level);
+
+private:
+    /**
+     * @brief Connects to the socket if it isn't connected and the last attempt was long enough ago.
+     */
+    void connectIfNeeded();
+
+    /**
+     * @brief Closes the socket, e.g., after the receiver went away.
+     */
+    void disconnect();
+
+    /**
+     * @brief Updates the process id that the messages are tagged with if it has changed, e.g., in a forked child.
+     */
+    void updateProcessId();
+
+    /**
+     * @brief Appends a journald field to the pending datagram. Values with a newline use the binary form.
+     */
+    void appendJournaldField(const char* name, std::string_view value);
+
+    const Format format;
+    const std::filesystem::path socketPath;
+    std::string identifier;
+    const int facility;
+    std::string hostName;
+    std::string processId;
+    long processIdNumber = 0; /**< The process id that processId holds the text of */
+
+    int socketFd = -1;
+    std::chrono::steady_clock::time_point lastConnectAttempt;
+    bool hasConnectAttempt = false;
+    uint64_t droppedCount = 0;
+
+    std::string pending; /**< The datagrams of the current batch, back to back */
+    std::vector<std::pair<size_t, size_t>> pendingDatagrams; /**< The offset and size of each datagram in pending */
+};
+
+} // namespace log
+} // namespace rk
+
+#endif // #ifndef SYSLOG_SINK_H
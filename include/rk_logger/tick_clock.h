@@ -0,0 +1,159 @@
+/**
+ * @file tick_clock.h
+ * @brief Header file for the clock that logging threads read raw ticks from, which the log thread converts to wall time.
+ */
+#ifndef TICK_CLOCK_H
+#define TICK_CLOCK_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <x86intrin.h>
+#define RK_LOG_HAS_TSC 1
+#else
+#define RK_LOG_HAS_TSC 0
+#endif
+
+#include <rk_logger/config.h>
+#include <rk_logger/log_time.h>
+
+namespace rk {
+namespace time_internal {
+
+/**
+ * Where a logger gets the time of its messages from.
+ */
+enum class TickSource : uint8_t {
+    System, /**< system_clock::now() for every message. No conversion needed */
+    Tsc, /**< The CPU timestamp counter */
+    Steady, /**< steady_clock, used instead of the TSC when the TSC isn't invariant */
+};
+
+/**
+ * @brief Reads the CPU timestamp counter. Only meaningful if isInvariantTscAvailable() is true.
+ * 
+ * @return The number of ticks.
+ */
+inline uint64_t readTsc() {
+#if RK_LOG_HAS_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief Reads steady_clock in nanoseconds.
+ * 
+ * @return Nanoseconds since an unspecified point in time.
+ */
+inline uint64_t readSteadyNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/**
+ * @brief Checks if the CPU has a TSC that ticks at a constant rate in all power states and is synchronized across cores.
+ * 
+ * @return True if the TSC can be used as a clock, false otherwise.
+ */
+bool isInvariantTscAvailable();
+
+/**
+ * A pairing of a tick count with the wall time that it was read at, plus the length of a tick. Used to convert tick
+ * counts to wall time.
+ */
+struct TickCalibration {
+    uint64_t baseTicks = 0;
+    int64_t baseNs = 0; /**< system_clock time at baseTicks, in nanoseconds since the epoch */
+    double nsPerTick = 1.0;
+
+    /**
+     * @brief Converts a tick count to wall time.
+     * 
+     * @param ticks The ticks to convert. They can be from before baseTicks.
+     * @return The wall time.
+     */
+    time_point toTimePoint(const uint64_t ticks) const {
+        const int64_t tickOffset = static_cast<int64_t>(ticks - baseTicks);
+        const int64_t ns = baseNs + static_cast<int64_t>(static_cast<double>(tickOffset) * nsPerTick);
+        return time_point(std::chrono::duration_cast<system_clock::duration>(std::chrono::nanoseconds(ns)));
+    }
+};
+
+/**
+ * The clock that a logger reads when a message is logged. With the TSC or steady_clock, the logging thread only
+ * stores the raw tick count, and the log thread converts it to wall time before the timestamp is formatted.
+ * 
+ * The calibration is measured against system_clock when the clock is configured and measured again periodically
+ * by the log thread, so the converted times follow system_clock adjustments, e.g., from NTP.
+ */
+class TickClock {
+public:
+    /**
+     * @brief Picks the tick source from the config and calibrates it. Falls back to steady_clock if the TSC is
+     * configured but isn't invariant.
+     * 
+     * @param config The config to read the clock source from.
+     */
+    void configure(const rk::config::Config& config);
+
+    /**
+     * @brief Gets the tick source.
+     * 
+     * @return The tick source.
+     */
+    TickSource getSource() const {
+        return source.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Reads the current tick count. Only meaningful if the source isn't System.
+     * 
+     * @return The tick count.
+     */
+    uint64_t now() const {
+        return getSource() == TickSource::Tsc ? readTsc() : readSteadyNs();
+    }
+
+    /**
+     * @brief Gets the calibration for converting ticks to wall time, recalibrating first if it is due.
+     * 
+     * Called by the log thread once per batch of records.
+     * 
+     * @return A copy of the calibration.
+     */
+    TickCalibration getCalibration();
+
+    /**
+     * @brief Holds the calibration lock while the process forks, so a child doesn't get it locked by a thread that
+     * it doesn't have. Must be followed by unlockAfterFork() in both the parent and the child.
+     */
+    void lockForFork();
+
+    /**
+     * @brief Releases the lock that was taken by lockForFork().
+     */
+    void unlockAfterFork();
+
+private:
+    /**
+     * @brief Measures the calibration. The caller must hold calibrationMutex.
+     * 
+     * @param isInitial Whether this is the first calibration since the clock was configured.
+     */
+    void calibrate(bool isInitial);
+
+    std::atomic<TickSource> source{TickSource::System};
+    std::mutex calibrationMutex;
+    TickCalibration calibration;
+    TickCalibration initialCalibration; /**< The rate is measured from here, so it gets more accurate over time */
+    std::chrono::steady_clock::time_point nextCalibration;
+};
+
+} // namespace time_internal
+} // namespace rk
+
+#endif // #ifndef TICK_CLOCK_H
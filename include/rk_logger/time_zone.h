@@ -0,0 +1,105 @@
+/**
+ * @file time_zone.h
+ * @brief Header file for converting times to the local time zone without std::localtime.
+ */
+#ifndef TIME_ZONE_H
+#define TIME_ZONE_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+namespace rk {
+namespace time_internal {
+
+/**
+ * A date and time broken down into its parts, like std::tm but with 1-based months and the full year.
+ */
+struct CivilTime {
+    int year;
+    int month; /**< 1-12 */
+    int day; /**< 1-31 */
+    int hour; /**< 0-23 */
+    int minute;
+    int second;
+};
+
+/**
+ * @brief Breaks seconds since the epoch down into a date and time, without any time zone conversion.
+ * 
+ * @param seconds Seconds since 1970-01-01 00:00:00. Can be negative.
+ * @return The date and time.
+ */
+CivilTime toCivilTime(int64_t seconds);
+
+/**
+ * @brief Turns a date and time back into seconds since the epoch, the inverse of toCivilTime(). The parts aren't
+ * checked, e.g., February 30 is counted as March 2.
+ * 
+ * @param civil The date and time.
+ * @return Seconds since 1970-01-01 00:00:00.
+ */
+int64_t fromCivilTime(const CivilTime& civil);
+
+/**
+ * @brief Computes the offset of the local time zone from UTC at a point in time, without caching.
+ * 
+ * Uses the C++20 time zone database when it is available and localtime_r (localtime_s on Windows) otherwise, so it
+ * is thread-safe either way.
+ * 
+ * @param epochSeconds The point in time, in seconds since the epoch.
+ * @return Local time minus UTC, in seconds.
+ */
+int64_t computeUtcOffset(int64_t epochSeconds);
+
+/**
+ * Caches the UTC offset of the local time zone for the period that contains the last converted time, i.e., until
+ * the next DST transition. Times inside the period are converted with one addition. The period is only looked up
+ * again once a time falls outside of it.
+ * 
+ * Reading the cache takes no lock. The period and offset are published with a sequence counter, so a reader that
+ * races with an update just tries again.
+ */
+class TimeZoneCache {
+public:
+    /**
+     * @brief Gets the offset from UTC at a point in time.
+     * 
+     * @param epochSeconds The point in time, in seconds since the epoch.
+     * @return Local time minus UTC, in seconds. Always 0 in UTC mode.
+     */
+    int64_t getOffsetSeconds(int64_t epochSeconds);
+
+    /**
+     * @brief Switches between the local time zone and UTC.
+     * 
+     * @param utc True to convert to UTC, false to convert to local time.
+     */
+    void setUtc(bool utc);
+
+    /**
+     * @brief Drops the cached period, e.g., after the TZ environment variable changed.
+     */
+    void reset();
+
+private:
+    /**
+     * @brief Looks up the period that contains a point in time and publishes it.
+     * 
+     * @param epochSeconds The point in time.
+     * @return The offset in that period.
+     */
+    int64_t update(int64_t epochSeconds);
+
+    std::atomic<bool> isUtc{false};
+    std::atomic<uint64_t> version{0}; /**< Odd while the period is being written */
+    std::atomic<int64_t> periodStart{1}; /**< Inclusive. Starts out after periodEnd, so the first lookup misses */
+    std::atomic<int64_t> periodEnd{0}; /**< Exclusive */
+    std::atomic<int64_t> offsetSeconds{0};
+    std::mutex updateMutex;
+};
+
+} // namespace time_internal
+} // namespace rk
+
+#endif // #ifndef TIME_ZONE_H
@@ -0,0 +1,36 @@
+/**
+ * @file main.cpp
+ * @brief Main file for rk_log_agent, which writes the log of an application that logs through shared memory.
+ *
+ * Usage: rk_log_agent <shm name> [config path]
+ *
+ * The application is started with "log_transport: SHARED_MEMORY". The agent can be started before or after it, and
+ * exits once the application has stopped its logger or exited and everything it logged has been written.
+ */
+#include <iostream>
+
+#include <rk_logger/log_agent.h>
+
+namespace {
+
+constexpr std::chrono::seconds ATTACH_TIMEOUT(60);
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2 || argc > 3) {
+        std::cerr << "Usage: " << argv[0] << " <shm name> [config path]\n";
+        return 1;
+    }
+
+    std::unique_ptr<rk::config::Config> config = rk::config::createInstance();
+    config->parseLoggingConfig(argc == 3 ? std::filesystem::path(argv[2]) : std::filesystem::current_path()/rk::config::CONFIG_FILE_NAME);
+
+    rk::log::LogAgent agent(argv[1], *config);
+    if (!agent.attach(ATTACH_TIMEOUT)) {
+        std::cerr << "The shared memory ring " << argv[1] << " was not created within " << ATTACH_TIMEOUT.count() << " seconds\n";
+        return 1;
+    }
+    agent.run();
+    return 0;
+}
@@ -0,0 +1,51 @@
+/**
+ * @file batch.cpp
+ * @brief Source file for logging several related messages as one batch.
+ */
+#include <rk_logger/batch.h>
+
+namespace rk {
+namespace log {
+
+namespace {
+
+thread_local std::vector<Record> spareRecords; /**< The buffer of the last batch on this thread, kept for the next one */
+
+} // namespace
+
+Batch::Batch(Logger& logger, const Timestamp timestamp) : logger(logger), timestamp(timestamp) {
+    records.swap(spareRecords); // If another batch on this thread is still open, this just takes an empty buffer
+}
+
+Batch::~Batch() {
+    commit();
+    if (records.capacity() > spareRecords.capacity()) {
+        records.swap(spareRecords);
+    }
+}
+
+void Batch::commit() {
+    if (records.empty()) {
+        return;
+    }
+
+    if (timestamp == Timestamp::Shared) {
+        logger.stampTime(records.front());
+        for (Record& record : records) {
+            record.time = records.front().time;
+            record.ticks = records.front().ticks;
+        }
+    }
+    logger.enqueueBatch(records);
+}
+
+size_t Batch::size() const {
+    return records.size();
+}
+
+Logger& Batch::getLogger() {
+    return logger;
+}
+
+} // namespace log
+} // namespace rk
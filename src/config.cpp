@@ -3,9 +3,9 @@
  * @brief Source file for the logging config.
  */
 #include <iostream>
-#include <fstream>
 
 #include <rk_logger/config.h>
+#include <rk_logger/config_parser.h>
 
 namespace rk {
 namespace config {
@@ -34,30 +34,222 @@ namespace hour_format {
     const std::string TWENTY_FOUR_HOUR = "24";
 }
 
+namespace timestamp_precision {
+    const std::string KEY = "timestamp_precision";
+    const std::string MS = "MS";
+    const std::string US = "US";
+    const std::string NS = "NS";
+    const std::string EPOCH_NS = "EPOCH_NS";
+}
+
+namespace time_zone {
+    const std::string KEY = "time_zone";
+    const std::string LOCAL = "LOCAL";
+    const std::string UTC = "UTC";
+}
+
 namespace write_to_log_file {
     const std::string KEY = "write_to_log_file";
     const std::string DISABLE = "DISABLE";
     const std::string ENABLE = "ENABLE";
 }
 
-void Config::setConfigValue(const ConfigKey key, const ConfigValue val) {
+namespace write_to_console {
+    const std::string KEY = "write_to_console";
+    const std::string DISABLE = "DISABLE";
+    const std::string ENABLE = "ENABLE";
+}
+
+namespace console_color {
+    const std::string KEY = "console_color";
+    const std::string AUTO = "AUTO";
+    const std::string ENABLE = "ENABLE";
+    const std::string DISABLE = "DISABLE";
+}
+
+namespace write_to_syslog {
+    const std::string KEY = "write_to_syslog";
+    const std::string DISABLE = "DISABLE";
+    const std::string RFC5424 = "RFC5424";
+    const std::string JOURNALD = "JOURNALD";
+}
+
+namespace syslog_socket_path {
+    const std::string KEY = "syslog_socket_path";
+    const std::string DEFAULT = "DEFAULT";
+}
+
+namespace clock_source {
+    const std::string KEY = "clock_source";
+    const std::string SYSTEM = "SYSTEM";
+    const std::string TSC = "TSC";
+    const std::string STEADY = "STEADY";
+}
+
+namespace log_level {
+    const std::string KEY = "log_level";
+    const std::string DEFAULT_LEVEL = "INFO";
+}
+
+namespace module_level {
+    const std::string KEY_PREFIX = "level.";
+}
+
+namespace flight_recorder_size_kb {
+    const std::string KEY = "flight_recorder_size_kb";
+    const std::string DISABLED = "0";
+}
+
+namespace flight_recorder_level {
+    const std::string KEY = "flight_recorder_level";
+    const std::string DEFAULT_LEVEL = "TRACE";
+}
+
+namespace flight_recorder_trigger {
+    const std::string KEY = "flight_recorder_trigger";
+    const std::string DEFAULT_LEVEL = "ERROR";
+}
+
+namespace flight_recorder_signal {
+    const std::string KEY = "flight_recorder_signal";
+    const std::string DISABLE = "DISABLE";
+    const std::string ENABLE = "ENABLE";
+}
+
+namespace log_transport {
+    const std::string KEY = "log_transport";
+    const std::string THREAD = "THREAD";
+    const std::string SHARED_MEMORY = "SHARED_MEMORY";
+}
+
+namespace shm_name {
+    const std::string KEY = "shm_name";
+    const std::string DEFAULT = "DEFAULT";
+}
+
+namespace shm_size_kb {
+    const std::string KEY = "shm_size_kb";
+    const std::string DEFAULT_SIZE = "4096";
+}
+
+namespace log_shards {
+    const std::string KEY = "log_shards";
+    const std::string DEFAULT_COUNT = "1";
+    const size_t MAX_COUNT = 64;
+}
+
+namespace log_shard_ordering {
+    const std::string KEY = "log_shard_ordering";
+    const std::string GLOBAL = "GLOBAL";
+    const std::string PER_THREAD = "PER_THREAD";
+}
+
+namespace log_shard_files {
+    const std::string KEY = "log_shard_files";
+    const std::string SHARED = "SHARED";
+    const std::string PER_SHARD = "PER_SHARD";
+}
+
+namespace log_thread_name {
+    const std::string KEY = "log_thread_name";
+    const std::string DEFAULT_NAME = "rk_logger";
+}
+
+namespace log_thread_cpu_affinity {
+    const std::string KEY = "log_thread_cpu_affinity";
+    const std::string NONE = "NONE";
+}
+
+namespace log_thread_sched_policy {
+    const std::string KEY = "log_thread_sched_policy";
+    const std::string DEFAULT = "DEFAULT";
+    const std::string OTHER = "OTHER";
+    const std::string BATCH = "BATCH";
+    const std::string IDLE = "IDLE";
+    const std::string FIFO = "FIFO";
+    const std::string RR = "RR";
+}
+
+namespace log_thread_priority {
+    const std::string KEY = "log_thread_priority";
+    const std::string DEFAULT = "DEFAULT";
+}
+
+namespace log_thread_numa_local {
+    const std::string KEY = "log_thread_numa_local";
+    const std::string DISABLE = "DISABLE";
+    const std::string ENABLE = "ENABLE";
+}
+
+namespace shutdown_drain_ms {
+    const std::string KEY = "shutdown_drain_ms";
+    const std::string UNLIMITED = "UNLIMITED";
+}
+
+namespace shutdown_leftovers {
+    const std::string KEY = "shutdown_leftovers";
+    const std::string DROP = "DROP";
+    const std::string SPILL = "SPILL";
+}
+
+namespace fork_log_file {
+    const std::string KEY = "fork_log_file";
+    const std::string SHARED = "SHARED";
+    const std::string PER_PID = "PER_PID";
+}
+
+namespace log_file_compression {
+    const std::string KEY = "log_file_compression";
+    const std::string NONE = "NONE";
+    const std::string LZ4 = "LZ4";
+}
+
+namespace log_file_compression_level {
+    const std::string KEY = "log_file_compression_level";
+    const std::string DEFAULT_LEVEL = "1";
+}
+
+namespace log_file_frame_ms {
+    const std::string KEY = "log_file_frame_ms";
+    const std::string DEFAULT_MS = "1000";
+}
+
+namespace log_file_index {
+    const std::string KEY = "log_file_index";
+    const std::string ENABLE = "ENABLE";
+    const std::string DISABLE = "DISABLE";
+}
+
+namespace log_file_index_records {
+    const std::string KEY = "log_file_index_records";
+    const std::string DEFAULT_RECORDS = "64";
+}
+
+namespace log_file_index_kb {
+    const std::string KEY = "log_file_index_kb";
+    const std::string DEFAULT_KB = "16";
+}
+
+void Config::setConfigValue(const ConfigKey& key, const ConfigValue& val) {
     if (!isKeyAndValueValid(key, val)) {
         return;
     }
     config[key] = val;
 }
 
-ConfigValue Config::getConfigValueByKey(const ConfigKey key) const {
-    if (!isKeyValid(key)) {
-        return "";
+ConfigValue Config::getConfigValueByKey(const ConfigKey& key) const {
+    const auto iter = config.find(key);
+    if (iter == config.end()) {
+        return ""; // Either not valid, or a module level that isn't set
     }
-    return config.at(key);
+    return iter->second;
 }
 
 /**
  * @brief Parses the logging config file and updates the settings based on the contents.
  * 
- * If no config file is provided, then it will just use the default settings.
+ * If no config file is provided, then it will just use the default settings. Lines that can't be parsed or that
+ * have an invalid key or value are reported with their line number and skipped. See ConfigParser for the format.
  * 
  * @param path The path to the config file including the file name itself. The default path is the same directory as the executable.
  */
@@ -74,8 +266,8 @@ void Config::parseLoggingConfig(const std::filesystem::path& path) {
     }
 
     rk::config_internal::cfgLog("Trying to open RK Logger config file at path ", path, "", "\n");
-    std::ifstream configFile(path);
-    if (!configFile) {
+    const rk::config_internal::FileView configFile(path);
+    if (!configFile.isOpen()) {
         rk::config_internal::cfgLog("Could not open RK Logger config file. Either one wasn't provided or the path provided was invalid. Using default RK Logger config", "\n");
         return;
     }
@@ -83,56 +275,57 @@ void Config::parseLoggingConfig(const std::filesystem::path& path) {
         rk::config_internal::cfgLog("Successfully opened the RK Logger config file", "\n");
     }
 
-    // Read through the file and update the config with any valid settings
-    std::string line;
-    while (std::getline(configFile, line)) {
-        // Skip anything that's a comment or doesn't have a ":"
-        const bool isComment = line.find(rk::config::COMMENT) != std::string::npos;
-        const size_t colonIndex = line.find_first_of(rk::config::KEY_VALUE_SEPARATOR);
-        if (isComment || colonIndex == std::string::npos) {
+    // Read through the file and update the config with any valid settings. The key and value strings are reused
+    // for every entry, so they only allocate when an entry is longer than any before it.
+    rk::config_internal::ConfigParser parser(configFile.getText());
+    rk::config_internal::ConfigEntry entry;
+    ConfigKey configKey;
+    ConfigValue configValue;
+    while (parser.next(entry)) {
+        if (entry.error != nullptr) {
+            rk::config_internal::cfgLog("Line ", entry.line, ": ", entry.error, ". Not updating.", "\n");
             continue;
         }
 
-        const ConfigKey configKey = line.substr(0, colonIndex);
+        configKey.assign(entry.key);
         if (!isKeyValid(configKey)) {
-            rk::config_internal::cfgLog("Key \"", configKey, "\" was not valid. Not updating.", "\n");
+            rk::config_internal::cfgLog("Line ", entry.line, ": Key \"", configKey, "\" was not valid. Not updating.", "\n");
             continue;
         }
 
-        const size_t configValueIdx = line.find_first_not_of(" \t", colonIndex + 1);
-        if (configValueIdx == std::string::npos) {
-            rk::config_internal::cfgLog("Could not get the index of the Config value for key ", configKey, ". Not updating",  "\n");
-            continue;
-        }
-
-        ConfigValue configValue = line.substr(configValueIdx);
-        // Remove new line at end of configValue, if it exists
-        const size_t newLineIndex = configValue.find_last_of("\n");
-        if (newLineIndex != std::string::npos && newLineIndex == configValue.size() - 1) {
-            configValue = configValue.substr(0, configValue.size());
-        }
-        if (!isKeyAndValueValid(configKey, configValue)) {
-            rk::config_internal::cfgLog("Value \"" , configValue, "\" for key \"", configKey, "\" was not valid. Not updating.", "\n");
+        configValue.assign(entry.value);
+        if (!isValueValid(configKey, configValue)) {
+            rk::config_internal::cfgLog("Line ", entry.line, ": Value \"" , configValue, "\" for key \"", configKey, "\" was not valid. Not updating.", "\n");
             continue;
         }
 
         rk::config_internal::cfgLog("Updating config key \"", configKey, "\" with value \"", configValue, "\"", "\n");
-        setConfigValue(configKey, configValue);
+        config[configKey] = configValue; // Already validated, so this skips setConfigValue()
     }
 }
 
-bool Config::isKeyValid(const ConfigKey key) const {
+bool Config::isKeyValid(const ConfigKey& key) const {
     if (key.empty()) {
         return false;
     }
-    return validKeyValues.find(key) != validKeyValues.end();
+    return validKeyValues.find(key) != validKeyValues.end() || validKeyValidators.find(key) != validKeyValidators.end() ||
+        rk::config_internal::isModuleLevelKey(key);
 }
 
-bool Config::isKeyAndValueValid(const ConfigKey key, const ConfigValue value) const {
-    if (value.empty() || !isKeyValid(key)) {
+bool Config::isKeyAndValueValid(const ConfigKey& key, const ConfigValue& value) const {
+    return isKeyValid(key) && isValueValid(key, value);
+}
+
+bool Config::isValueValid(const ConfigKey& key, const ConfigValue& value) const {
+    if (value.empty()) {
         return false;
     }
-    const ValidValuesSet& validValues = validKeyValues.at(key);
+    const auto validatorIter = validKeyValidators.find(key);
+    if (validatorIter != validKeyValidators.end()) {
+        return validatorIter->second(value);
+    }
+    const auto valuesIter = validKeyValues.find(key);
+    const ValidValuesSet& validValues = valuesIter != validKeyValues.end() ? valuesIter->second : rk::config_internal::logLevel; // Otherwise, it's a module level
     return validValues.find(value) != validValues.end();
 }
 
@@ -140,11 +333,29 @@ const ValidKeyValuesMap& Config::getValidKeyValues() const {
     return validKeyValues;
 }
 
+const ValidKeyValidatorsMap& Config::getValidKeyValidators() const {
+    return validKeyValidators;
+}
+
+ConfigMap Config::getConfigValuesWithPrefix(const std::string& prefix) const {
+    ConfigMap values;
+    for (const auto& keyValuePair : config) {
+        if (keyValuePair.first.compare(0, prefix.size(), prefix) == 0) {
+            values.insert(keyValuePair);
+        }
+    }
+    return values;
+}
+
 Config& getInstance() {
-    static Config configuration(rk::config_internal::defaultConfig, rk::config_internal::validKeyValues);
+    static Config configuration(rk::config_internal::defaultConfig, rk::config_internal::validKeyValues, rk::config_internal::validKeyValidators);
     return configuration;
 }
 
+std::unique_ptr<Config> createInstance() {
+    return std::unique_ptr<Config>(new Config(rk::config_internal::defaultConfig, rk::config_internal::validKeyValues, rk::config_internal::validKeyValidators));
+}
+
 } // namespace config
 } // namespace rk
 
@@ -167,24 +378,378 @@ const rk::config::ValidValuesSet hourFormat = {
     rk::config::hour_format::TWENTY_FOUR_HOUR,
 };
 
+const rk::config::ValidValuesSet timestampPrecision = {
+    rk::config::timestamp_precision::MS,
+    rk::config::timestamp_precision::US,
+    rk::config::timestamp_precision::NS,
+    rk::config::timestamp_precision::EPOCH_NS,
+};
+
+const rk::config::ValidValuesSet timeZone = {
+    rk::config::time_zone::LOCAL,
+    rk::config::time_zone::UTC,
+};
+
 const rk::config::ValidValuesSet writeToLogFile = {
     rk::config::write_to_log_file::DISABLE,
     rk::config::write_to_log_file::ENABLE,
 };
 
+const rk::config::ValidValuesSet writeToConsole = {
+    rk::config::write_to_console::DISABLE,
+    rk::config::write_to_console::ENABLE,
+};
+
+const rk::config::ValidValuesSet clockSource = {
+    rk::config::clock_source::SYSTEM,
+    rk::config::clock_source::TSC,
+    rk::config::clock_source::STEADY,
+};
+
+// Spelled out rather than named constants because names like DEBUG and ERROR are commonly defined as macros
+const rk::config::ValidValuesSet writeToSyslog = {
+    rk::config::write_to_syslog::DISABLE,
+    rk::config::write_to_syslog::RFC5424,
+    rk::config::write_to_syslog::JOURNALD,
+};
+
+const rk::config::ValidValuesSet logLevel = {
+    "TRACE",
+    "DEBUG",
+    "INFO",
+    "WARN",
+    "ERROR",
+    "FATAL",
+    "OFF",
+};
+
+const rk::config::ValidValuesSet flightRecorderSignal = {
+    rk::config::flight_recorder_signal::DISABLE,
+    rk::config::flight_recorder_signal::ENABLE,
+};
+
+const rk::config::ValidValuesSet consoleColor = {
+    rk::config::console_color::AUTO,
+    rk::config::console_color::ENABLE,
+    rk::config::console_color::DISABLE,
+};
+
+const rk::config::ValidValuesSet logTransport = {
+    rk::config::log_transport::THREAD,
+    rk::config::log_transport::SHARED_MEMORY,
+};
+
+const rk::config::ValidValuesSet logShardOrdering = {
+    rk::config::log_shard_ordering::GLOBAL,
+    rk::config::log_shard_ordering::PER_THREAD,
+};
+
+const rk::config::ValidValuesSet logShardFiles = {
+    rk::config::log_shard_files::SHARED,
+    rk::config::log_shard_files::PER_SHARD,
+};
+
+const rk::config::ValidValuesSet logThreadSchedPolicy = {
+    rk::config::log_thread_sched_policy::DEFAULT,
+    rk::config::log_thread_sched_policy::OTHER,
+    rk::config::log_thread_sched_policy::BATCH,
+    rk::config::log_thread_sched_policy::IDLE,
+    rk::config::log_thread_sched_policy::FIFO,
+    rk::config::log_thread_sched_policy::RR,
+};
+
+const rk::config::ValidValuesSet logThreadNumaLocal = {
+    rk::config::log_thread_numa_local::DISABLE,
+    rk::config::log_thread_numa_local::ENABLE,
+};
+
+const rk::config::ValidValuesSet shutdownLeftovers = {
+    rk::config::shutdown_leftovers::DROP,
+    rk::config::shutdown_leftovers::SPILL,
+};
+
+const rk::config::ValidValuesSet forkLogFile = {
+    rk::config::fork_log_file::SHARED,
+    rk::config::fork_log_file::PER_PID,
+};
+
+const rk::config::ValidValuesSet logFileCompression = {
+    rk::config::log_file_compression::NONE,
+    rk::config::log_file_compression::LZ4,
+};
+
+const rk::config::ValidValuesSet logFileIndex = {
+    rk::config::log_file_index::ENABLE,
+    rk::config::log_file_index::DISABLE,
+};
+
 const rk::config::ValidKeyValuesMap validKeyValues = {
     { rk::config::date_format::KEY, dateFormat },
     { rk::config::month_format::KEY, monthFormat },
     { rk::config::hour_format::KEY, hourFormat },
+    { rk::config::timestamp_precision::KEY, timestampPrecision },
+    { rk::config::time_zone::KEY, timeZone },
     { rk::config::write_to_log_file::KEY, writeToLogFile },
+    { rk::config::write_to_console::KEY, writeToConsole },
+    { rk::config::console_color::KEY, consoleColor },
+    { rk::config::write_to_syslog::KEY, writeToSyslog },
+    { rk::config::log_level::KEY, logLevel },
+    { rk::config::clock_source::KEY, clockSource },
+    { rk::config::flight_recorder_level::KEY, logLevel },
+    { rk::config::flight_recorder_trigger::KEY, logLevel },
+    { rk::config::flight_recorder_signal::KEY, flightRecorderSignal },
+    { rk::config::log_transport::KEY, logTransport },
+    { rk::config::log_shard_ordering::KEY, logShardOrdering },
+    { rk::config::log_shard_files::KEY, logShardFiles },
+    { rk::config::log_thread_sched_policy::KEY, logThreadSchedPolicy },
+    { rk::config::log_thread_numa_local::KEY, logThreadNumaLocal },
+    { rk::config::shutdown_leftovers::KEY, shutdownLeftovers },
+    { rk::config::fork_log_file::KEY, forkLogFile },
+    { rk::config::log_file_compression::KEY, logFileCompression },
+    { rk::config::log_file_index::KEY, logFileIndex },
+};
+
+const rk::config::ValidKeyValidatorsMap validKeyValidators = {
+    { rk::config::syslog_socket_path::KEY, isValidSyslogSocketPath },
+    { rk::config::flight_recorder_size_kb::KEY, isValidFlightRecorderSize },
+    { rk::config::shm_name::KEY, isValidShmName },
+    { rk::config::shm_size_kb::KEY, isValidShmSize },
+    { rk::config::log_shards::KEY, isValidShardCount },
+    { rk::config::log_thread_name::KEY, isValidThreadName },
+    { rk::config::log_thread_cpu_affinity::KEY, isValidCpuAffinity },
+    { rk::config::log_thread_priority::KEY, isValidThreadPriority },
+    { rk::config::shutdown_drain_ms::KEY, isValidDrainTime },
+    { rk::config::log_file_compression_level::KEY, isValidCompressionLevel },
+    { rk::config::log_file_frame_ms::KEY, isValidFrameTime },
+    { rk::config::log_file_index_records::KEY, isValidIndexRecordCount },
+    { rk::config::log_file_index_kb::KEY, isValidIndexSize },
 };
 
 const rk::config::ConfigMap defaultConfig = {
     { rk::config::date_format::KEY, rk::config::date_format::MM_DD_YYYY },
     { rk::config::month_format::KEY, rk::config::month_format::MONTH_NUM },
     { rk::config::hour_format::KEY, rk::config::hour_format::TWELVE_HOUR },
+    { rk::config::timestamp_precision::KEY, rk::config::timestamp_precision::MS },
+    { rk::config::time_zone::KEY, rk::config::time_zone::LOCAL },
     { rk::config::write_to_log_file::KEY, rk::config::write_to_log_file::ENABLE },
+    { rk::config::write_to_console::KEY, rk::config::write_to_console::ENABLE },
+    { rk::config::console_color::KEY, rk::config::console_color::AUTO },
+    { rk::config::write_to_syslog::KEY, rk::config::write_to_syslog::DISABLE },
+    { rk::config::syslog_socket_path::KEY, rk::config::syslog_socket_path::DEFAULT },
+    { rk::config::log_level::KEY, rk::config::log_level::DEFAULT_LEVEL },
+    { rk::config::clock_source::KEY, rk::config::clock_source::SYSTEM },
+    { rk::config::flight_recorder_size_kb::KEY, rk::config::flight_recorder_size_kb::DISABLED },
+    { rk::config::flight_recorder_level::KEY, rk::config::flight_recorder_level::DEFAULT_LEVEL },
+    { rk::config::flight_recorder_trigger::KEY, rk::config::flight_recorder_trigger::DEFAULT_LEVEL },
+    { rk::config::flight_recorder_signal::KEY, rk::config::flight_recorder_signal::DISABLE },
+    { rk::config::log_transport::KEY, rk::config::log_transport::THREAD },
+    { rk::config::shm_name::KEY, rk::config::shm_name::DEFAULT },
+    { rk::config::shm_size_kb::KEY, rk::config::shm_size_kb::DEFAULT_SIZE },
+    { rk::config::log_shards::KEY, rk::config::log_shards::DEFAULT_COUNT },
+    { rk::config::log_shard_ordering::KEY, rk::config::log_shard_ordering::GLOBAL },
+    { rk::config::log_shard_files::KEY, rk::config::log_shard_files::SHARED },
+    { rk::config::log_thread_name::KEY, rk::config::log_thread_name::DEFAULT_NAME },
+    { rk::config::log_thread_cpu_affinity::KEY, rk::config::log_thread_cpu_affinity::NONE },
+    { rk::config::log_thread_sched_policy::KEY, rk::config::log_thread_sched_policy::DEFAULT },
+    { rk::config::log_thread_priority::KEY, rk::config::log_thread_priority::DEFAULT },
+    { rk::config::log_thread_numa_local::KEY, rk::config::log_thread_numa_local::DISABLE },
+    { rk::config::shutdown_drain_ms::KEY, rk::config::shutdown_drain_ms::UNLIMITED },
+    { rk::config::shutdown_leftovers::KEY, rk::config::shutdown_leftovers::DROP },
+    { rk::config::fork_log_file::KEY, rk::config::fork_log_file::SHARED },
+    { rk::config::log_file_compression::KEY, rk::config::log_file_compression::NONE },
+    { rk::config::log_file_compression_level::KEY, rk::config::log_file_compression_level::DEFAULT_LEVEL },
+    { rk::config::log_file_frame_ms::KEY, rk::config::log_file_frame_ms::DEFAULT_MS },
+    { rk::config::log_file_index::KEY, rk::config::log_file_index::DISABLE },
+    { rk::config::log_file_index_records::KEY, rk::config::log_file_index_records::DEFAULT_RECORDS },
+    { rk::config::log_file_index_kb::KEY, rk::config::log_file_index_kb::DEFAULT_KB },
 };
 
+/**
+ * Accepts single CPUs and inclusive ranges separated by commas, e.g., "0,2-3". Whitespace is not allowed and
+ * the CPU numbers are limited to what fits in a CPU set.
+ */
+bool parseCpuList(const rk::config::ConfigValue& value, std::vector<int>& cpus) {
+    constexpr int MAX_CPU = 1023;
+    cpus.clear();
+    size_t pos = 0;
+    while (pos < value.size()) {
+        size_t end = value.find(',', pos);
+        if (end == std::string::npos) {
+            end = value.size();
+        }
+        const std::string item = value.substr(pos, end - pos);
+        const size_t dashIndex = item.find('-');
+        int first = 0;
+        int last = 0;
+        if (dashIndex == std::string::npos) {
+            if (!parseInteger(item, first)) {
+                return false;
+            }
+            last = first;
+        }
+        else if (!parseInteger(item.substr(0, dashIndex), first) || !parseInteger(item.substr(dashIndex + 1), last)) {
+            return false;
+        }
+        if (first < 0 || last < first || last > MAX_CPU) {
+            return false;
+        }
+        for (int cpu = first; cpu <= last; cpu++) {
+            cpus.push_back(cpu);
+        }
+        pos = end + 1;
+    }
+
+    return !cpus.empty() && value.back() != ',';
+}
+
+bool parseInteger(const rk::config::ConfigValue& value, int& number) {
+    size_t pos = 0;
+    const bool isNegative = !value.empty() && value[0] == '-';
+    if (isNegative) {
+        pos++;
+    }
+    if (pos == value.size() || value.size() - pos > 9) {
+        return false;
+    }
+
+    int result = 0;
+    for (; pos < value.size(); pos++) {
+        if (value[pos] < '0' || value[pos] > '9') {
+            return false;
+        }
+        result = result * 10 + (value[pos] - '0');
+    }
+    number = isNegative ? -result : result;
+
+    return true;
+}
+
+bool isModuleLevelKey(const rk::config::ConfigKey& key) {
+    const std::string& prefix = rk::config::module_level::KEY_PREFIX;
+    if (key.size() <= prefix.size() || key.compare(0, prefix.size(), prefix) != 0) {
+        return false;
+    }
+    for (size_t i = prefix.size(); i < key.size(); i++) {
+        const char c = key[i];
+        const bool isAllowed = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == '-' || c == '.';
+        if (!isAllowed) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * The limit comes from the size of sun_path in a Unix socket address, including the null terminator.
+ */
+bool isValidSyslogSocketPath(const rk::config::ConfigValue& value) {
+    constexpr size_t MAX_SOCKET_PATH_SIZE = 107;
+    if (value == rk::config::syslog_socket_path::DEFAULT) {
+        return true;
+    }
+    return !value.empty() && value[0] == '/' && value.size() <= MAX_SOCKET_PATH_SIZE;
+}
+
+bool isValidFlightRecorderSize(const rk::config::ConfigValue& value) {
+    constexpr int MAX_SIZE_KB = 1024 * 1024;
+    int sizeKb = 0;
+    return parseInteger(value, sizeKb) && sizeKb >= 0 && sizeKb <= MAX_SIZE_KB;
+}
+
+/**
+ * POSIX only guarantees that names of the form "/name" work with shm_open(), and limits them to NAME_MAX characters.
+ */
+bool isValidShmName(const rk::config::ConfigValue& value) {
+    constexpr size_t MAX_SHM_NAME_SIZE = 255;
+    if (value == rk::config::shm_name::DEFAULT) {
+        return true;
+    }
+    return value.size() > 1 && value.size() <= MAX_SHM_NAME_SIZE && value[0] == '/' && value.find('/', 1) == std::string::npos;
+}
+
+bool isValidShmSize(const rk::config::ConfigValue& value) {
+    constexpr int MIN_SIZE_KB = 64;
+    constexpr int MAX_SIZE_KB = 1024 * 1024;
+    int sizeKb = 0;
+    return parseInteger(value, sizeKb) && sizeKb >= MIN_SIZE_KB && sizeKb <= MAX_SIZE_KB;
+}
+
+bool isValidShardCount(const rk::config::ConfigValue& value) {
+    int count = 0;
+    return parseInteger(value, count) && count >= 1 && static_cast<size_t>(count) <= rk::config::log_shards::MAX_COUNT;
+}
+
+/**
+ * Thread names are limited to 15 characters (the limit on Linux) and to characters that are safe to show in
+ * tools such as top or ps.
+ */
+bool isValidThreadName(const rk::config::ConfigValue& value) {
+    constexpr size_t MAX_THREAD_NAME_SIZE = 15;
+    if (value.empty() || value.size() > MAX_THREAD_NAME_SIZE) {
+        return false;
+    }
+    for (const char c : value) {
+        const bool isAllowed = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == '-';
+        if (!isAllowed) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool isValidCpuAffinity(const rk::config::ConfigValue& value) {
+    if (value == rk::config::log_thread_cpu_affinity::NONE) {
+        return true;
+    }
+    std::vector<int> cpus;
+    return parseCpuList(value, cpus);
+}
+
+/**
+ * The range covers both nice values (-20 to 19) and real-time priorities (1 to 99). Whether the priority makes
+ * sense for the chosen policy is checked when it is applied to the thread.
+ */
+bool isValidThreadPriority(const rk::config::ConfigValue& value) {
+    if (value == rk::config::log_thread_priority::DEFAULT) {
+        return true;
+    }
+    int priority = 0;
+    return parseInteger(value, priority) && priority >= -20 && priority <= 99;
+}
+
+bool isValidDrainTime(const rk::config::ConfigValue& value) {
+    constexpr int MAX_DRAIN_MS = 60 * 60 * 1000;
+    if (value == rk::config::shutdown_drain_ms::UNLIMITED) {
+        return true;
+    }
+    int drainMs = 0;
+    return parseInteger(value, drainMs) && drainMs >= 0 && drainMs <= MAX_DRAIN_MS;
+}
+
+bool isValidCompressionLevel(const rk::config::ConfigValue& value) {
+    int level = 0;
+    return parseInteger(value, level) && level >= 1 && level <= 9;
+}
+
+bool isValidFrameTime(const rk::config::ConfigValue& value) {
+    constexpr int MAX_FRAME_MS = 60 * 1000;
+    int frameMs = 0;
+    return parseInteger(value, frameMs) && frameMs >= 0 && frameMs <= MAX_FRAME_MS;
+}
+
+bool isValidIndexRecordCount(const rk::config::ConfigValue& value) {
+    constexpr int MAX_RECORDS = 1000000;
+    int records = 0;
+    return parseInteger(value, records) && records >= 1 && records <= MAX_RECORDS;
+}
+
+bool isValidIndexSize(const rk::config::ConfigValue& value) {
+    constexpr int MAX_KB = 64 * 1024;
+    int sizeKb = 0;
+    return parseInteger(value, sizeKb) && sizeKb >= 1 && sizeKb <= MAX_KB;
+}
+
 } // namespace config_internal
 } // namespace rk
@@ -0,0 +1,240 @@
+/**
+ * @file config_parser.cpp
+ * @brief Source file for reading the config file.
+ */
+#include <fstream>
+#include <iterator>
+
+#include <rk_logger/config_parser.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace rk {
+namespace config_internal {
+
+namespace {
+
+constexpr char COMMENT = '#';
+constexpr char KEY_VALUE_SEPARATOR = ':';
+constexpr const char* WHITESPACE = " \t";
+
+std::string_view trimTrailingWhitespace(std::string_view text) {
+    const size_t end = text.find_last_not_of(WHITESPACE);
+    return end == std::string_view::npos ? std::string_view() : text.substr(0, end + 1);
+}
+
+/**
+ * A '#' only starts a comment if it follows whitespace, so values such as "a#b" are kept whole.
+ */
+std::string_view removeComment(std::string_view text) {
+    for (size_t i = 1; i < text.size(); i++) {
+        if (text[i] == COMMENT && (text[i - 1] == ' ' || text[i - 1] == '\t')) {
+            return text.substr(0, i);
+        }
+    }
+    return text;
+}
+
+} // namespace
+
+ConfigParser::ConfigParser(const std::string_view text) : text(text) {}
+
+bool ConfigParser::next(ConfigEntry& entry) {
+    while (pos < text.size()) {
+        const size_t lineEnd = text.find('\n', pos);
+        std::string_view line = text.substr(pos, lineEnd == std::string_view::npos ? std::string_view::npos : lineEnd - pos);
+        pos = lineEnd == std::string_view::npos ? text.size() : lineEnd + 1;
+        lineNumber++;
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+
+        // Skip blank lines and comments
+        const size_t contentStart = line.find_first_not_of(WHITESPACE);
+        if (contentStart == std::string_view::npos || line[contentStart] == COMMENT) {
+            continue;
+        }
+
+        entry = ConfigEntry();
+        entry.line = lineNumber;
+        const size_t indent = line.find_first_not_of(' ');
+        if (indent != contentStart) {
+            entry.error = "Tabs can't be used for indentation";
+            return true;
+        }
+
+        const size_t separatorIndex = line.find(KEY_VALUE_SEPARATOR, contentStart);
+        if (separatorIndex == std::string_view::npos) {
+            entry.error = "Expected \"key: value\" or \"section:\"";
+            return true;
+        }
+        const std::string_view key = trimTrailingWhitespace(line.substr(contentStart, separatorIndex - contentStart));
+        if (key.empty()) {
+            entry.error = "The key is empty";
+            return true;
+        }
+
+        // Leave the sections that this line isn't indented under
+        while (!sections.empty() && sections.back().indent >= indent) {
+            sections.pop_back();
+        }
+        if (indent > 0 && sections.empty()) {
+            entry.error = "Unexpected indentation";
+            return true;
+        }
+        if (sections.empty()) {
+            entry.key = key;
+        }
+        else {
+            keyBuffer.resize(sections.back().keySize);
+            keyBuffer += '.';
+            keyBuffer += key;
+            entry.key = keyBuffer;
+        }
+
+        const std::string_view rest = line.substr(separatorIndex + 1);
+        const size_t valueStart = rest.find_first_not_of(WHITESPACE);
+        if (valueStart == std::string_view::npos || (valueStart > 0 && rest[valueStart] == COMMENT)) {
+            // A key without a value starts a section
+            if (sections.empty()) {
+                keyBuffer.assign(key);
+            }
+            sections.push_back({ indent, keyBuffer.size() });
+            continue;
+        }
+
+        if (rest[valueStart] == '"' || rest[valueStart] == '\'') {
+            parseQuotedValue(rest.substr(valueStart), entry);
+        }
+        else {
+            entry.value = trimTrailingWhitespace(removeComment(rest.substr(valueStart)));
+        }
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * The value is returned as a view into the text unless it has escapes. Only then is it copied into valueBuffer.
+ */
+void ConfigParser::parseQuotedValue(const std::string_view line, ConfigEntry& entry) {
+    const char quote = line[0];
+    bool isBuffered = false;
+    size_t closeIndex = std::string_view::npos;
+    size_t i = 1;
+    while (i < line.size()) {
+        const char c = line[i];
+        const bool isDoubleQuoteEscape = quote == '"' && c == '\\';
+        const bool isSingleQuoteEscape = quote == '\'' && c == '\'' && i + 1 < line.size() && line[i + 1] == '\'';
+        if (isDoubleQuoteEscape || isSingleQuoteEscape) {
+            if (isDoubleQuoteEscape && (i + 1 == line.size() || (line[i + 1] != '"' && line[i + 1] != '\\'))) {
+                entry.key = std::string_view();
+                entry.error = "Only \\\" and \\\\ can be escaped in a quoted value";
+                return;
+            }
+            if (!isBuffered) {
+                valueBuffer.assign(line.substr(1, i - 1));
+                isBuffered = true;
+            }
+            valueBuffer += line[i + 1];
+            i += 2;
+            continue;
+        }
+        if (c == quote) {
+            closeIndex = i;
+            break;
+        }
+        if (isBuffered) {
+            valueBuffer += c;
+        }
+        i++;
+    }
+
+    if (closeIndex == std::string_view::npos) {
+        entry.key = std::string_view();
+        entry.error = "The quoted value is missing its closing quote";
+        return;
+    }
+    const std::string_view after = line.substr(closeIndex + 1);
+    const size_t afterStart = after.find_first_not_of(WHITESPACE);
+    if (afterStart != std::string_view::npos && (afterStart == 0 || after[afterStart] != COMMENT)) {
+        entry.key = std::string_view();
+        entry.error = "Unexpected text after the quoted value";
+        return;
+    }
+
+    entry.value = isBuffered ? std::string_view(valueBuffer) : line.substr(1, closeIndex - 1);
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+
+FileView::FileView(const std::filesystem::path& path) {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd >= 0) {
+        struct stat info{};
+        if (::fstat(fd, &info) == 0 && S_ISREG(info.st_mode)) {
+            if (info.st_size == 0) {
+                isFileOpen = true; // An empty file can't be mapped, but there is nothing to read either
+            }
+            else {
+                void* address = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                if (address != MAP_FAILED) {
+                    mapping = address;
+                    mappingSize = static_cast<size_t>(info.st_size);
+                    isFileOpen = true;
+                }
+            }
+        }
+        ::close(fd);
+    }
+    if (isFileOpen) {
+        return;
+    }
+
+    // Fall back to reading the file, e.g., for files that can't be mapped
+    std::ifstream file(path, std::ios::binary);
+    if (file) {
+        contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        isFileOpen = true;
+    }
+}
+
+FileView::~FileView() {
+    if (mapping != nullptr) {
+        ::munmap(mapping, mappingSize);
+    }
+}
+
+#else
+
+FileView::FileView(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (file) {
+        contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        isFileOpen = true;
+    }
+}
+
+FileView::~FileView() = default;
+
+#endif // #if defined(__unix__) || defined(__APPLE__)
+
+bool FileView::isOpen() const {
+    return isFileOpen;
+}
+
+std::string_view FileView::getText() const {
+    if (mapping != nullptr) {
+        return std::string_view(static_cast<const char*>(mapping), mappingSize);
+    }
+    return contents;
+}
+
+} // namespace config_internal
+} // namespace rk
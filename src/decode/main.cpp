@@ -0,0 +1,90 @@
+/**
+ * @file main.cpp
+ * @brief Main file for rk_log_decode, which decodes a log file that was written with "log_file_compression: LZ4".
+ *
+ * Usage: rk_log_decode [-f] [file]
+ *
+ * The log is written to stdout. Without a file, stdin is decoded. With -f, the file is followed as it is written, like
+ * "tail -f", and each frame is printed once the logger has finished it.
+ */
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <rk_logger/lz4.h>
+
+namespace {
+
+constexpr size_t READ_SIZE = 64 * 1024;
+constexpr std::chrono::milliseconds FOLLOW_POLL_INTERVAL(200);
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    bool isFollowing = false;
+    const char* path = nullptr;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg == "-f" && !isFollowing) {
+            isFollowing = true;
+        }
+        else if (path == nullptr && (arg.empty() || arg[0] != '-')) {
+            path = argv[i];
+        }
+        else {
+            std::cerr << "Usage: " << argv[0] << " [-f] [file]\n";
+            return 1;
+        }
+    }
+
+    std::ifstream file;
+    std::istream* input = &std::cin;
+    if (path != nullptr) {
+        file.open(path, std::ios::binary);
+        if (!file.is_open()) {
+            std::cerr << "Unable to open " << path << "\n";
+            return 1;
+        }
+        input = &file;
+    }
+
+    rk::lz4_internal::FrameDecoder decoder;
+    std::vector<char> buffer(READ_SIZE);
+    std::string decoded;
+    while (true) {
+        input->read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        const std::streamsize count = input->gcount();
+        if (count > 0) {
+            decoded.clear();
+            const bool isValid = decoder.decode(buffer.data(), static_cast<size_t>(count), decoded);
+            std::cout.write(decoded.data(), static_cast<std::streamsize>(decoded.size()));
+            if (!isValid) {
+                std::cout.flush();
+                std::cerr << "The input is corrupt: " << decoder.getError() << "\n";
+                return 1;
+            }
+        }
+        if (input->bad()) {
+            std::cerr << "Unable to read the input\n";
+            return 1;
+        }
+        if (!input->eof()) {
+            continue;
+        }
+        if (!isFollowing) {
+            break;
+        }
+        // At the end of the file for now. Whatever the logger writes next is read after clearing the end-of-file state
+        std::cout.flush();
+        input->clear();
+        std::this_thread::sleep_for(FOLLOW_POLL_INTERVAL);
+    }
+
+    std::cout.flush();
+    if (!decoder.isAtFrameBoundary()) {
+        std::cerr << "The input ends inside a frame, e.g., because the logger hasn't finished it yet\n";
+    }
+    return 0;
+}
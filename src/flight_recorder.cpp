@@ -0,0 +1,110 @@
+/**
+ * @file flight_recorder.cpp
+ * @brief Source file for the flight recorder, which keeps the most recent log messages in memory.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <type_traits>
+
+#include <rk_logger/flight_recorder.h>
+
+namespace rk {
+namespace log {
+
+static_assert(std::is_trivially_copyable_v<FlightRecorder::EntryHeader>, "The entry headers are copied in and out of the buffer as bytes");
+
+FlightRecorder::FlightRecorder(const size_t capacity) : buffer(capacity) {}
+
+/**
+ * Each message is stored as its header followed by its text. Either may wrap around the end of the buffer.
+ */
+void FlightRecorder::write(const RecordedMessage& message) {
+    if (buffer.size() <= ENTRY_OVERHEAD) {
+        return;
+    }
+    const size_t length = std::min(message.message.size(), buffer.size() - ENTRY_OVERHEAD);
+    const size_t needed = ENTRY_OVERHEAD + length;
+    while (buffer.size() - used < needed) {
+        uint32_t oldestLength = 0;
+        copyOut(oldest, reinterpret_cast<char*>(&oldestLength), sizeof(oldestLength)); // The size comes first in the header
+        oldest = (oldest + ENTRY_OVERHEAD + oldestLength) % buffer.size();
+        used -= ENTRY_OVERHEAD + oldestLength;
+        messageCount--;
+    }
+
+    EntryHeader header{};
+    header.size = static_cast<uint32_t>(length);
+    header.level = message.level;
+    header.isTicks = message.ticks != 0;
+    header.stamp = header.isTicks ? message.ticks :
+        static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(message.time.time_since_epoch()).count());
+    header.threadId = message.threadId;
+    header.funcName = message.funcName;
+
+    const size_t end = (oldest + used) % buffer.size();
+    copyIn(end, reinterpret_cast<const char*>(&header), sizeof(header));
+    copyIn((end + sizeof(header)) % buffer.size(), message.message.data(), length);
+    used += needed;
+    messageCount++;
+}
+
+/**
+ * A message whose text wraps around the end of the buffer is copied out so that the function gets it in one piece.
+ */
+void FlightRecorder::forEach(const std::function<void(const RecordedMessage&)>& func) const {
+    std::string wrapped;
+    size_t position = oldest;
+    for (size_t i = 0; i < messageCount; i++) {
+        EntryHeader header{};
+        copyOut(position, reinterpret_cast<char*>(&header), sizeof(header));
+        const size_t start = (position + sizeof(header)) % buffer.size();
+
+        RecordedMessage message;
+        if (header.isTicks) {
+            message.ticks = header.stamp;
+        }
+        else {
+            message.time = rk::time_internal::time_point(std::chrono::duration_cast<rk::time_internal::time_point::duration>(
+                std::chrono::nanoseconds(static_cast<int64_t>(header.stamp))));
+        }
+        message.threadId = header.threadId;
+        message.funcName = header.funcName;
+        message.level = header.level;
+        if (header.size <= buffer.size() - start) {
+            message.message = std::string_view(buffer.data() + start, header.size);
+        }
+        else {
+            wrapped.resize(header.size);
+            copyOut(start, wrapped.data(), header.size);
+            message.message = wrapped;
+        }
+        func(message);
+        position = (start + header.size) % buffer.size();
+    }
+}
+
+void FlightRecorder::clear() {
+    oldest = 0;
+    used = 0;
+    messageCount = 0;
+}
+
+size_t FlightRecorder::getMessageCount() const {
+    return messageCount;
+}
+
+void FlightRecorder::copyIn(const size_t position, const char* data, const size_t size) {
+    const size_t firstPart = std::min(size, buffer.size() - position);
+    std::memcpy(buffer.data() + position, data, firstPart);
+    std::memcpy(buffer.data(), data + firstPart, size - firstPart);
+}
+
+void FlightRecorder::copyOut(const size_t position, char* data, const size_t size) const {
+    const size_t firstPart = std::min(size, buffer.size() - position);
+    std::memcpy(data, buffer.data() + position, firstPart);
+    std::memcpy(data + firstPart, buffer.data(), size - firstPart);
+}
+
+} // namespace log
+} // namespace rk
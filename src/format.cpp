@@ -0,0 +1,37 @@
+/**
+ * @file format.cpp
+ * @brief Source file for writing log arguments into a record.
+ */
+#include <rk_logger/format.h>
+
+namespace rk {
+namespace log_internal {
+
+void appendHex(std::string& out, const rk::log::Hex& hex) {
+    constexpr char DIGITS[] = "0123456789abcdef";
+    if (hex.size == 0) {
+        return;
+    }
+
+    size_t pos = out.size();
+    out.resize(pos + hex.size * 3 - 1, ' ');
+    for (size_t i = 0; i < hex.size; i++) {
+        out[pos] = DIGITS[hex.data[i] >> 4];
+        out[pos + 1] = DIGITS[hex.data[i] & 0x0f];
+        pos += 3;
+    }
+}
+
+/**
+ * std::ostream writes floating-point numbers like printf's "%g" with a precision of 6 by default.
+ */
+void appendFloat(std::string& out, const long double number) {
+    char digits[64];
+    const int size = std::snprintf(digits, sizeof(digits), "%Lg", number);
+    if (size > 0) {
+        out.append(digits, static_cast<size_t>(size) < sizeof(digits) ? static_cast<size_t>(size) : sizeof(digits) - 1);
+    }
+}
+
+} // namespace log_internal
+} // namespace rk
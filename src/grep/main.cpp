@@ -0,0 +1,150 @@
+/**
+ * @file main.cpp
+ * @brief Main file for rk_log_grep, which prints the messages of log files that match some filters, searching each
+ * file on every core.
+ *
+ * Usage: rk_log_grep [--config <config file>] [--from <time>] [--to <time>] [--thread <id>] [--func <name>]
+ *                    [--text <text>] [--regex <pattern>] [-j <threads>] [--count] <log file>...
+ *
+ * The timestamps are read in the format of the config that the logs were written with, which is the default config
+ * if --config isn't given, so every date_format, month_format, hour_format, and timestamp_precision works. A file is
+ * mapped into memory and split into chunks at message boundaries, the chunks are searched by a pool of threads, and
+ * the matching messages are printed in the order of the file. Times are given as for rk_log_query. --thread and
+ * --func match the thread id and the function name as they are printed in the log, and --text and --regex are
+ * searched for in the message after its prefix. With --count, only the number of matching messages is printed.
+ */
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <rk_logger/config.h>
+#include <rk_logger/config_parser.h>
+#include <rk_logger/log_grep.h>
+#include <rk_logger/log_index.h>
+#include <rk_logger/log_time.h>
+
+namespace {
+
+int printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [--config <config file>] [--from <time>] [--to <time>] [--thread <id>] [--func <name>]"
+        " [--text <text>] [--regex <pattern>] [-j <threads>] [--count] <log file>...\n";
+    return 1;
+}
+
+/**
+ * Sets up a formatter for the config that the logs were written with, or for the default config if there isn't a
+ * path. The config and the formatter print what they are doing to stdout, which would be mixed up with the messages,
+ * so that is dropped.
+ */
+void loadFormatter(rk::time_internal::TimeStampFormatter& formatter, const std::string& configPath) {
+    std::ostringstream discarded;
+    std::streambuf* const coutBuffer = std::cout.rdbuf(discarded.rdbuf());
+    std::unique_ptr<rk::config::Config> config = rk::config::createInstance();
+    if (!configPath.empty()) {
+        config->parseLoggingConfig(configPath);
+    }
+    formatter.updateTimeStampFuncs(*config);
+    std::cout.rdbuf(coutBuffer);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    rk::grep_internal::GrepFilter filter;
+    std::string configPath;
+    size_t threadCount = std::max(1u, std::thread::hardware_concurrency());
+    bool isCountOnly = false;
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--config" && hasValue) {
+            configPath = argv[++i];
+        }
+        else if ((arg == "--from" || arg == "--to") && hasValue) {
+            if (!rk::index_internal::parseQueryTime(argv[++i], arg == "--from" ? filter.fromNs : filter.toNs)) {
+                std::cerr << "Invalid time: " << argv[i] << "\n";
+                return 1;
+            }
+        }
+        else if (arg == "--thread" && hasValue) {
+            filter.threadId = argv[++i];
+        }
+        else if (arg == "--func" && hasValue) {
+            filter.funcName = argv[++i];
+        }
+        else if (arg == "--text" && hasValue) {
+            filter.text = argv[++i];
+        }
+        else if (arg == "--regex" && hasValue) {
+            try {
+                filter.pattern = std::make_shared<const std::regex>(argv[++i], std::regex::ECMAScript | std::regex::optimize);
+            }
+            catch (const std::regex_error& e) {
+                std::cerr << "Invalid pattern: " << argv[i] << " (" << e.what() << ")\n";
+                return 1;
+            }
+        }
+        else if (arg == "-j" && hasValue) {
+            try {
+                threadCount = std::stoul(argv[++i]);
+            }
+            catch (const std::exception&) {
+                threadCount = 0;
+            }
+            if (threadCount == 0) {
+                std::cerr << "Invalid thread count: " << argv[i] << "\n";
+                return 1;
+            }
+        }
+        else if (arg == "--count") {
+            isCountOnly = true;
+        }
+        else if (!arg.empty() && arg[0] != '-') {
+            paths.push_back(arg);
+        }
+        else {
+            return printUsage(argv[0]);
+        }
+    }
+    if (paths.empty()) {
+        return printUsage(argv[0]);
+    }
+    if (!configPath.empty() && !std::filesystem::exists(configPath)) {
+        std::cerr << "Unable to open " << configPath << "\n";
+        return 1;
+    }
+
+    rk::time_internal::TimeStampFormatter formatter;
+    loadFormatter(formatter, configPath);
+    const rk::grep_internal::LogGrep logGrep(formatter, filter);
+
+    int result = 0;
+    size_t matchCount = 0;
+    for (const auto& path : paths) {
+        const rk::config_internal::FileView logFile(path);
+        if (!logFile.isOpen()) {
+            std::cerr << "Unable to open " << path << "\n";
+            result = 1;
+            continue;
+        }
+        matchCount += logGrep.grep(logFile.getText(), threadCount, [isCountOnly] (const std::string_view messages) {
+            if (!isCountOnly) {
+                std::cout.write(messages.data(), static_cast<std::streamsize>(messages.size()));
+            }
+        });
+    }
+    if (isCountOnly) {
+        std::cout << matchCount << "\n";
+    }
+    std::cout.flush();
+    return result;
+}
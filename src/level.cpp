@@ -0,0 +1,33 @@
+/**
+ * @file level.cpp
+ * @brief Source file for the log levels.
+ */
+#include <rk_logger/level.h>
+
+namespace rk {
+namespace log {
+
+namespace {
+
+constexpr const char* LEVEL_NAMES[] = { "TRACE", "DEBUG", "INFO", "WARN", "ERROR", "FATAL", "OFF" };
+constexpr size_t LEVEL_COUNT = sizeof(LEVEL_NAMES) / sizeof(LEVEL_NAMES[0]);
+
+} // namespace
+
+const char* levelToString(const Level level) {
+    const size_t index = static_cast<size_t>(level);
+    return index < LEVEL_COUNT ? LEVEL_NAMES[index] : "";
+}
+
+bool parseLevel(const std::string& value, Level& level) {
+    for (size_t i = 0; i < LEVEL_COUNT; i++) {
+        if (value == LEVEL_NAMES[i]) {
+            level = static_cast<Level>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace log
+} // namespace rk
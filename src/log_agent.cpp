@@ -0,0 +1,181 @@
+/**
+ * @file log_agent.cpp
+ * @brief Source file for the agent that writes the log of another process from its shared-memory ring.
+ */
+#include <algorithm>
+#include <thread>
+
+#include <rk_logger/log_agent.h>
+#include <rk_logger/logger.h>
+#include <rk_logger/syslog_sink.h>
+
+namespace rk {
+namespace log {
+
+namespace {
+
+constexpr std::chrono::milliseconds ATTACH_POLL_INTERVAL(10);
+constexpr std::chrono::microseconds MIN_IDLE_WAIT(100);
+constexpr std::chrono::microseconds MAX_IDLE_WAIT(10000);
+constexpr size_t MAX_RECORDS_PER_BATCH = 4096; /**< The sinks are flushed at least this often */
+
+} // namespace
+
+LogAgent::LogAgent(const std::string& shmName, rk::config::Config& config) : shmName(shmName), config(config) {}
+
+void LogAgent::addSink(std::shared_ptr<Sink> sink) {
+    sinks.push_back(std::move(sink));
+}
+
+/**
+ * The agent can be started before or after the application, so the ring is polled for until it has been created.
+ */
+bool LogAgent::attach(const std::chrono::milliseconds timeout) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!(reader = rk::shm_internal::RingReader::open(shmName))) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(ATTACH_POLL_INTERVAL);
+    }
+    return true;
+}
+
+/**
+ * The agent polls the ring, backing off while it is empty. Whether the application is done is checked before the
+ * ring is drained, so a record that was committed right before the application stopped is still written. Once it is
+ * done, entries that it never committed are skipped, so the records after them are still written.
+ */
+void LogAgent::run() {
+    if (!reader) {
+        return;
+    }
+
+    // Timestamps are converted with the application's clock source. The TSC and steady_clock are shared by every
+    // process on the machine, so the agent's calibration applies to the application's ticks too
+    const rk::time_internal::TickSource source = reader->getTickSource();
+    config.setConfigValue(rk::config::clock_source::KEY,
+        source == rk::time_internal::TickSource::Tsc ? rk::config::clock_source::TSC :
+        source == rk::time_internal::TickSource::Steady ? rk::config::clock_source::STEADY : rk::config::clock_source::SYSTEM);
+    tickClock.configure(config);
+    timeStampFormatter.updateTimeStampFuncs(config);
+    openConfiguredSinks();
+
+    std::chrono::microseconds idleWait = MIN_IDLE_WAIT;
+    while (true) {
+        const bool isDone = reader->isProducerDone();
+        if (writeAvailable(isDone) > 0) {
+            idleWait = MIN_IDLE_WAIT;
+            continue;
+        }
+        if (isDone) {
+            break;
+        }
+        if (idleWait == MAX_IDLE_WAIT) {
+            // Finishes the frame of a compressed log file once it is due, even if nothing else gets logged
+            for (const auto& sink : sinks) {
+                sink->flush();
+            }
+        }
+        std::this_thread::sleep_for(idleWait);
+        idleWait = std::min(idleWait * 2, MAX_IDLE_WAIT);
+    }
+
+    const uint64_t fullCount = reader->getDroppedCount();
+    if (fullCount > 0) {
+        rk::log_internal::rkLogInternal(fullCount, " messages were dropped because the shared memory ring was full\n");
+    }
+    const uint64_t lostCount = reader->getLostCount();
+    if (lostCount > 0) {
+        rk::log_internal::rkLogInternal(lostCount, " messages were lost because the application exited while it was writing them\n");
+    }
+    droppedCount = fullCount + lostCount;
+    reader.reset();
+    rk::shm_internal::removeRing(shmName);
+}
+
+uint64_t LogAgent::getWrittenCount() const {
+    return writtenCount;
+}
+
+uint64_t LogAgent::getDroppedCount() const {
+    return droppedCount;
+}
+
+/**
+ * The log file is named the same way as the application's logger would name it, e.g., "logs_<timestamp>.txt" for
+ * the default logger.
+ */
+void LogAgent::openConfiguredSinks() {
+    if (config.getConfigValueByKey(rk::config::write_to_console::KEY) == rk::config::write_to_console::ENABLE) {
+        sinks.push_back(createConsoleSink(config));
+    }
+    const rk::config::ConfigValue syslogFormat = config.getConfigValueByKey(rk::config::write_to_syslog::KEY);
+    if (syslogFormat != rk::config::write_to_syslog::DISABLE) {
+        const rk::config::ConfigValue socketPath = config.getConfigValueByKey(rk::config::syslog_socket_path::KEY);
+        sinks.push_back(std::make_shared<SyslogSink>(
+            syslogFormat == rk::config::write_to_syslog::JOURNALD ? SyslogSink::Format::Journald : SyslogSink::Format::Rfc5424,
+            socketPath == rk::config::syslog_socket_path::DEFAULT ? std::filesystem::path() : std::filesystem::path(socketPath)));
+    }
+    if (config.getConfigValueByKey(rk::config::write_to_log_file::KEY) == rk::config::write_to_log_file::ENABLE) {
+        std::string timeStamp = timeStampFormatter.generateTimeStamp(rk::time_internal::system_clock::now());
+        timeStamp = rk::time_internal::convertTimeStampForFileName(timeStamp);
+        const std::string loggerName = reader->getLoggerName();
+        const std::string namePrefix = (loggerName == DEFAULT_LOGGER_NAME) ? "" : loggerName + "_";
+        const std::string logFileName = getLogFileName(std::string("logs_") + namePrefix + timeStamp, config);
+        rk::log_internal::rkLogInternal("Writing to log file: ", logFileName, "\n");
+
+        std::shared_ptr<Sink> logFile = createLogFileSink(logFileName, config);
+        if (logFile) {
+            sinks.push_back(std::move(logFile));
+        }
+        else {
+            rk::log_internal::rkLogInternal("Unable to open output log file\n");
+        }
+    }
+}
+
+size_t LogAgent::writeAvailable(const bool isProducerDone) {
+    const rk::time_internal::TickCalibration calibration = tickClock.getCalibration();
+    rk::shm_internal::RecordView record;
+    std::string line;
+    size_t count = 0;
+    while (count < MAX_RECORDS_PER_BATCH && reader->read(record, isProducerDone)) {
+        const MessageInfo info = formatRecord(record, calibration, line);
+        for (const auto& sink : sinks) {
+            sink->writeWithInfo(line, info);
+        }
+        count++;
+    }
+    if (count > 0) {
+        for (const auto& sink : sinks) {
+            sink->flush();
+        }
+        writtenCount += count;
+    }
+    return count;
+}
+
+MessageInfo LogAgent::formatRecord(const rk::shm_internal::RecordView& record, const rk::time_internal::TickCalibration& calibration, std::string& out) const {
+    const rk::time_internal::time_point time = record.isTicks ? calibration.toTimePoint(record.stamp) :
+        rk::time_internal::time_point(std::chrono::duration_cast<rk::time_internal::system_clock::duration>(
+            std::chrono::nanoseconds(static_cast<int64_t>(record.stamp))));
+    out.clear();
+    timeStampFormatter.appendTimeStamp(time, out);
+    out += "[";
+    const size_t threadIdOffset = out.size();
+    out += record.threadId;
+    out += "][";
+    out += record.funcName;
+    out += "]";
+    out += record.message;
+
+    MessageInfo info;
+    info.level = record.level;
+    info.timeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+    info.threadId = std::string_view(out).substr(threadIdOffset, record.threadId.size());
+    return info;
+}
+
+} // namespace log
+} // namespace rk
@@ -0,0 +1,195 @@
+/**
+ * @file log_grep.cpp
+ * @brief Source file for searching log files for messages.
+ */
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <rk_logger/log_grep.h>
+
+namespace rk {
+namespace grep_internal {
+
+namespace {
+
+constexpr size_t CHUNKS_AHEAD_PER_THREAD = 2; /**< How many chunks each thread can search ahead of the one that is being written */
+
+/**
+ * @brief Reads the text between a pair of brackets at a position, without going past the end of the line.
+ *
+ * @return False if there isn't a pair of brackets at the position.
+ */
+bool readBracketed(const std::string_view line, size_t& pos, std::string_view& value) {
+    if (pos >= line.size() || line[pos] != '[') {
+        return false;
+    }
+    for (size_t end = pos + 1; end < line.size() && line[end] != '\n'; end++) {
+        if (line[end] == ']') {
+            value = line.substr(pos + 1, end - pos - 1);
+            pos = end + 1;
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+LogGrep::LogGrep(const rk::time_internal::TimeStampFormatter& formatter, GrepFilter filter) :
+    formatter(formatter), filter(std::move(filter)),
+    isPrefixFiltered(this->filter.fromNs != INT64_MIN || this->filter.toNs != INT64_MAX || !this->filter.threadId.empty() || !this->filter.funcName.empty()) {}
+
+bool LogGrep::parsePrefix(const std::string_view line, MessagePrefix& prefix) const {
+    size_t pos = formatter.parseTimeStamp(line, prefix.timeNs);
+    if (pos == 0 || !readBracketed(line, pos, prefix.threadId) || !readBracketed(line, pos, prefix.funcName)) {
+        return false;
+    }
+    prefix.size = pos;
+    return true;
+}
+
+size_t LogGrep::findMessageStart(const std::string_view log, size_t pos) const {
+    MessagePrefix prefix;
+    if (pos > 0 && pos < log.size() && log[pos - 1] != '\n') {
+        const size_t newline = log.find('\n', pos);
+        pos = newline == std::string_view::npos ? log.size() : newline + 1;
+    }
+    while (pos < log.size() && !parsePrefix(log.substr(pos), prefix)) {
+        const size_t newline = log.find('\n', pos);
+        pos = newline == std::string_view::npos ? log.size() : newline + 1;
+    }
+    return std::min(pos, log.size());
+}
+
+/**
+ * A message ends where the next line that starts a message begins, so only lines that start with a bracket are
+ * checked for a prefix.
+ */
+size_t LogGrep::grepChunk(const std::string_view chunk, std::string& out) const {
+    size_t count = 0;
+    MessagePrefix prefix;
+    bool hasPrefix = parsePrefix(chunk, prefix);
+    size_t start = 0;
+    while (start < chunk.size()) {
+        MessagePrefix nextPrefix;
+        bool hasNextPrefix = false;
+        size_t end = start;
+        while (!hasNextPrefix) {
+            const size_t newline = chunk.find('\n', end);
+            if (newline == std::string_view::npos) {
+                end = chunk.size();
+                break;
+            }
+            end = newline + 1;
+            if (end == chunk.size()) {
+                break;
+            }
+            hasNextPrefix = chunk[end] == '[' && parsePrefix(chunk.substr(end), nextPrefix);
+        }
+
+        const size_t prefixSize = hasPrefix ? prefix.size : 0;
+        if (isMatch(hasPrefix ? &prefix : nullptr, chunk.substr(start + prefixSize, end - start - prefixSize))) {
+            out.append(chunk.data() + start, end - start);
+            count++;
+        }
+        start = end;
+        prefix = nextPrefix;
+        hasPrefix = hasNextPrefix;
+    }
+    return count;
+}
+
+/**
+ * The main thread only splits the log and writes the output, and the other threads take the chunks in order. A thread
+ * waits before taking a chunk that is too far ahead of the one that is being written, so a slow chunk doesn't let the
+ * output of all the ones after it pile up.
+ */
+size_t LogGrep::grep(const std::string_view log, const size_t threadCount, const std::function<void(std::string_view)>& write, const size_t chunkSize) const {
+    std::vector<size_t> bounds = { 0 };
+    while (bounds.back() < log.size()) {
+        bounds.push_back(findMessageStart(log, std::min(log.size(), bounds.back() + std::max<size_t>(chunkSize, 1))));
+    }
+    const size_t chunkCount = bounds.size() - 1;
+    auto getChunk = [&log, &bounds] (const size_t chunk) { return log.substr(bounds[chunk], bounds[chunk + 1] - bounds[chunk]); };
+
+    size_t matchCount = 0;
+    if (threadCount <= 1 || chunkCount <= 1) {
+        std::string out;
+        for (size_t chunk = 0; chunk < chunkCount; chunk++) {
+            out.clear();
+            matchCount += grepChunk(getChunk(chunk), out);
+            write(out);
+        }
+        return matchCount;
+    }
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<std::string> outputs(chunkCount);
+    std::vector<bool> isDone(chunkCount, false);
+    size_t nextToSearch = 0;
+    size_t nextToWrite = 0;
+    const size_t maxAhead = threadCount * CHUNKS_AHEAD_PER_THREAD;
+    auto search = [&] () {
+        while (true) {
+            size_t chunk = 0;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cv.wait(lock, [&] () { return nextToSearch >= chunkCount || nextToSearch < nextToWrite + maxAhead; });
+                if (nextToSearch >= chunkCount) {
+                    return;
+                }
+                chunk = nextToSearch++;
+            }
+            std::string out;
+            const size_t count = grepChunk(getChunk(chunk), out);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                outputs[chunk] = std::move(out);
+                isDone[chunk] = true;
+                matchCount += count;
+            }
+            cv.notify_all();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < std::min(threadCount, chunkCount); i++) {
+        threads.emplace_back(search);
+    }
+    while (nextToWrite < chunkCount) {
+        std::string out;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [&] () { return isDone[nextToWrite]; });
+            out.swap(outputs[nextToWrite]);
+            nextToWrite++;
+        }
+        cv.notify_all();
+        write(out);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return matchCount;
+}
+
+bool LogGrep::isMatch(const MessagePrefix* prefix, const std::string_view message) const {
+    if (isPrefixFiltered) {
+        if (prefix == nullptr || prefix->timeNs < filter.fromNs || prefix->timeNs > filter.toNs ||
+            (!filter.threadId.empty() && prefix->threadId != filter.threadId) ||
+            (!filter.funcName.empty() && prefix->funcName != filter.funcName)) {
+            return false;
+        }
+    }
+    if (!filter.text.empty() && message.find(filter.text) == std::string_view::npos) {
+        return false;
+    }
+    return !filter.pattern || std::regex_search(message.begin(), message.end(), *filter.pattern);
+}
+
+} // namespace grep_internal
+} // namespace rk
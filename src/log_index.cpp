@@ -0,0 +1,227 @@
+/**
+ * @file log_index.cpp
+ * @brief Source file for the sidecar index of a log file.
+ */
+#include <algorithm>
+#include <cstring>
+
+#include <rk_logger/log_index.h>
+#include <rk_logger/time_zone.h>
+
+namespace rk {
+namespace index_internal {
+
+namespace {
+
+constexpr int64_t NS_PER_S = 1000000000;
+
+/**
+ * Reads a number with exactly digitCount digits from the front of the text.
+ */
+bool readDigits(std::string_view& text, const size_t digitCount, int& value) {
+    if (text.size() < digitCount) {
+        return false;
+    }
+    value = 0;
+    for (size_t i = 0; i < digitCount; i++) {
+        if (text[i] < '0' || text[i] > '9') {
+            return false;
+        }
+        value = value * 10 + (text[i] - '0');
+    }
+    text.remove_prefix(digitCount);
+    return true;
+}
+
+bool readChar(std::string_view& text, const char expected) {
+    if (text.empty() || text.front() != expected) {
+        return false;
+    }
+    text.remove_prefix(1);
+    return true;
+}
+
+} // namespace
+
+/**
+ * FNV-1a, which is plenty for spreading thread ids over 64 bits.
+ */
+uint64_t getThreadBit(const std::string_view threadId) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (const char c : threadId) {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001b3ULL;
+    }
+    return 1ULL << (hash % 64);
+}
+
+IndexWriter::IndexWriter(const std::filesystem::path& path, const size_t recordInterval, const size_t byteInterval) :
+    file(path, std::ios::binary), recordInterval(std::max<size_t>(recordInterval, 1)), byteInterval(std::max<size_t>(byteInterval, 1)) {
+    IndexHeader header{};
+    std::memcpy(header.magic, INDEX_MAGIC, sizeof(header.magic));
+    header.version = INDEX_VERSION;
+    header.entrySize = sizeof(IndexEntry);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+IndexWriter::~IndexWriter() {
+    finishEntry();
+    file.flush();
+}
+
+void IndexWriter::add(const uint64_t logSize, const int64_t timeNs, const std::string_view threadId) {
+    if (entryRecordCount == 0) {
+        entry.minTimeNs = timeNs;
+        entry.threadMask = 0;
+    }
+    entry.endOffset = logSize;
+    entry.minTimeNs = std::min(entry.minTimeNs, timeNs);
+    entry.threadMask |= getThreadBit(threadId);
+    maxTimeNs = std::max(maxTimeNs, timeNs);
+    entryRecordCount++;
+    if (entryRecordCount >= recordInterval || logSize - entryStart >= byteInterval) {
+        finishEntry();
+    }
+}
+
+void IndexWriter::finishEntry() {
+    if (entryRecordCount == 0) {
+        return;
+    }
+    entry.maxTimeNs = maxTimeNs;
+    file.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+    entryStart = entry.endOffset;
+    entryRecordCount = 0;
+}
+
+void IndexWriter::flush() {
+    file.flush();
+}
+
+bool IndexWriter::isOpen() const {
+    return file.is_open() && file.good();
+}
+
+bool readIndex(const void* data, const size_t size, const IndexEntry*& entries, size_t& count) {
+    IndexHeader header;
+    if (size < sizeof(header)) {
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, INDEX_MAGIC, sizeof(header.magic)) != 0 || header.version != INDEX_VERSION ||
+        header.entrySize != sizeof(IndexEntry)) {
+        return false;
+    }
+    entries = reinterpret_cast<const IndexEntry*>(static_cast<const char*>(data) + sizeof(header));
+    count = (size - sizeof(header)) / sizeof(IndexEntry);
+    return true;
+}
+
+std::vector<ByteRange> findRanges(const IndexEntry* entries, const size_t count, const uint64_t logSize, const int64_t fromNs,
+    const int64_t toNs, const uint64_t threadBit) {
+    std::vector<ByteRange> ranges;
+    auto addRange = [&ranges, logSize] (const uint64_t begin, uint64_t end) {
+        end = std::min(end, logSize);
+        if (begin >= end) {
+            return;
+        }
+        if (!ranges.empty() && ranges.back().end == begin) {
+            ranges.back().end = end;
+        }
+        else {
+            ranges.push_back({ begin, end });
+        }
+    };
+
+    // The latest times never decrease, but the earliest times can, e.g., when a shard falls behind the others that
+    // write to the same file, so every entry after the first one is checked. Only the index is read for that
+    const IndexEntry* first = std::partition_point(entries, entries + count, [fromNs] (const IndexEntry& entry) { return entry.maxTimeNs < fromNs; });
+    for (const IndexEntry* entry = first; entry != entries + count; entry++) {
+        if (entry->minTimeNs > toNs) {
+            continue;
+        }
+        if (threadBit == 0 || (entry->threadMask & threadBit) != 0) {
+            addRange(entry == entries ? 0 : (entry - 1)->endOffset, entry->endOffset);
+        }
+    }
+    if (count == 0 || toNs >= entries[count - 1].maxTimeNs) {
+        addRange(count == 0 ? 0 : entries[count - 1].endOffset, logSize);
+    }
+    return ranges;
+}
+
+std::string_view getLineThreadId(const std::string_view line) {
+    if (line.empty() || line.front() != '[') {
+        return std::string_view();
+    }
+    const size_t start = line.find("][");
+    if (start == std::string_view::npos) {
+        return std::string_view();
+    }
+    const size_t end = line.find(']', start + 2);
+    if (end == std::string_view::npos) {
+        return std::string_view();
+    }
+    return line.substr(start + 2, end - start - 2);
+}
+
+/**
+ * A date is checked by converting it back, so e.g. February 30 is rejected rather than rolled over into March. A
+ * local time is converted with the offset at about that time, which is only off for the hour that repeats when DST ends.
+ */
+bool parseQueryTime(std::string_view text, int64_t& timeNs) {
+    if (!text.empty() && std::all_of(text.begin(), text.end(), [] (const char c) { return c >= '0' && c <= '9'; })) {
+        timeNs = 0;
+        for (const char c : text) {
+            if (timeNs > (INT64_MAX - (c - '0')) / 10) {
+                return false;
+            }
+            timeNs = timeNs * 10 + (c - '0');
+        }
+        return true;
+    }
+
+    rk::time_internal::CivilTime civil{};
+    if (!readDigits(text, 4, civil.year) || !readChar(text, '-') || !readDigits(text, 2, civil.month) || !readChar(text, '-') ||
+        !readDigits(text, 2, civil.day) || !(readChar(text, ' ') || readChar(text, 'T')) ||
+        !readDigits(text, 2, civil.hour) || !readChar(text, ':') || !readDigits(text, 2, civil.minute)) {
+        return false;
+    }
+    int64_t fractionNs = 0;
+    if (readChar(text, ':')) {
+        if (!readDigits(text, 2, civil.second)) {
+            return false;
+        }
+        if (readChar(text, '.')) {
+            int64_t scale = NS_PER_S;
+            int digit = 0;
+            size_t digitCount = 0;
+            while (readDigits(text, 1, digit)) {
+                scale /= 10;
+                fractionNs += digit * scale;
+                digitCount++;
+            }
+            if (digitCount == 0) {
+                return false;
+            }
+        }
+    }
+    const bool isUtc = readChar(text, 'Z');
+    if (!text.empty() || civil.hour > 23 || civil.minute > 59 || civil.second > 59) {
+        return false;
+    }
+
+    const int64_t seconds = rk::time_internal::fromCivilTime(civil);
+    const rk::time_internal::CivilTime check = rk::time_internal::toCivilTime(seconds);
+    if (check.year != civil.year || check.month != civil.month || check.day != civil.day) {
+        return false;
+    }
+    int64_t epochSeconds = seconds;
+    if (!isUtc) {
+        epochSeconds -= rk::time_internal::computeUtcOffset(seconds - rk::time_internal::computeUtcOffset(seconds));
+    }
+    timeNs = epochSeconds * NS_PER_S + fractionNs;
+    return true;
+}
+
+} // namespace index_internal
+} // namespace rk
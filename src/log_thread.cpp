@@ -0,0 +1,150 @@
+/**
+ * @file log_thread.cpp
+ * @brief Source file for configuring the threads that are started by the logger.
+ */
+#include <rk_logger/log_thread.h>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace rk {
+namespace thread_internal {
+
+ThreadSettings getThreadSettings(const rk::config::Config& config) {
+    ThreadSettings settings;
+    settings.name = config.getConfigValueByKey(rk::config::log_thread_name::KEY);
+
+    const rk::config::ConfigValue affinity = config.getConfigValueByKey(rk::config::log_thread_cpu_affinity::KEY);
+    if (affinity != rk::config::log_thread_cpu_affinity::NONE) {
+        rk::config_internal::parseCpuList(affinity, settings.cpus);
+    }
+
+    settings.schedPolicy = config.getConfigValueByKey(rk::config::log_thread_sched_policy::KEY);
+
+    const rk::config::ConfigValue priority = config.getConfigValueByKey(rk::config::log_thread_priority::KEY);
+    if (priority != rk::config::log_thread_priority::DEFAULT) {
+        settings.hasPriority = rk::config_internal::parseInteger(priority, settings.priority);
+    }
+
+    settings.numaLocal = config.getConfigValueByKey(rk::config::log_thread_numa_local::KEY) == rk::config::log_thread_numa_local::ENABLE;
+
+    return settings;
+}
+
+#if defined(__linux__)
+
+namespace {
+
+constexpr size_t MAX_THREAD_NAME_SIZE = 15;
+constexpr int MPOL_LOCAL_MODE = 4; /**< MPOL_LOCAL from linux/mempolicy.h, which isn't always installed */
+
+void setName(const std::string& name) {
+    const std::string truncated = name.substr(0, MAX_THREAD_NAME_SIZE);
+    const int result = pthread_setname_np(pthread_self(), truncated.c_str());
+    if (result != 0) {
+        threadLog("Unable to set the thread name to \"", truncated, "\": ", std::strerror(result), "\n");
+    }
+}
+
+void setAffinity(const std::vector<int>& cpus) {
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    for (const int cpu : cpus) {
+        if (cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &cpuSet);
+        }
+    }
+    const int result = pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+    if (result != 0) {
+        threadLog("Unable to set the thread CPU affinity: ", std::strerror(result), "\n");
+    }
+}
+
+/**
+ * FIFO and RR take a real-time priority through the scheduling parameters. The other policies are set with a
+ * priority of 0 and the configured priority is applied as the thread's nice value instead.
+ */
+void setScheduling(const ThreadSettings& settings) {
+    int policy = SCHED_OTHER;
+    const bool isRealTime = settings.schedPolicy == rk::config::log_thread_sched_policy::FIFO || settings.schedPolicy == rk::config::log_thread_sched_policy::RR;
+    if (settings.schedPolicy == rk::config::log_thread_sched_policy::FIFO) {
+        policy = SCHED_FIFO;
+    }
+    else if (settings.schedPolicy == rk::config::log_thread_sched_policy::RR) {
+        policy = SCHED_RR;
+    }
+    else if (settings.schedPolicy == rk::config::log_thread_sched_policy::BATCH) {
+        policy = SCHED_BATCH;
+    }
+    else if (settings.schedPolicy == rk::config::log_thread_sched_policy::IDLE) {
+        policy = SCHED_IDLE;
+    }
+
+    if (settings.schedPolicy != rk::config::log_thread_sched_policy::DEFAULT) {
+        sched_param param{};
+        param.sched_priority = (isRealTime && settings.hasPriority) ? settings.priority : (isRealTime ? 1 : 0);
+        const int result = pthread_setschedparam(pthread_self(), policy, &param);
+        if (result != 0) {
+            threadLog("Unable to set the thread scheduling policy to ", settings.schedPolicy, ": ", std::strerror(result), "\n");
+        }
+    }
+
+    if (settings.hasPriority && !isRealTime) {
+        // On Linux, the nice value is per thread when given the thread id
+        const pid_t threadId = static_cast<pid_t>(syscall(SYS_gettid));
+        if (setpriority(PRIO_PROCESS, threadId, settings.priority) != 0) {
+            threadLog("Unable to set the thread nice value to ", settings.priority, ": ", std::strerror(errno), "\n");
+        }
+    }
+}
+
+/**
+ * Makes the kernel allocate memory for this thread on the node it is running on. Combined with the CPU affinity,
+ * the buffers the thread allocates afterwards stay on the node of the pinned CPUs.
+ */
+void setLocalMemoryPolicy() {
+#if defined(SYS_set_mempolicy)
+    if (syscall(SYS_set_mempolicy, MPOL_LOCAL_MODE, nullptr, 0) != 0) {
+        threadLog("Unable to set the NUMA memory policy: ", std::strerror(errno), "\n");
+    }
+#else
+    threadLog("Setting the NUMA memory policy is not supported on this platform\n");
+#endif
+}
+
+} // namespace
+
+void applyThreadSettings(const ThreadSettings& settings, const std::string& nameSuffix) {
+    if (!settings.name.empty()) {
+        setName(settings.name + nameSuffix);
+    }
+    if (!settings.cpus.empty()) {
+        setAffinity(settings.cpus);
+    }
+    setScheduling(settings);
+    if (settings.numaLocal) {
+        setLocalMemoryPolicy();
+    }
+}
+
+#else
+
+void applyThreadSettings(const ThreadSettings& settings, const std::string& nameSuffix) {
+    const bool hasNonDefaultSettings = !settings.cpus.empty() || settings.hasPriority || settings.numaLocal ||
+        settings.schedPolicy != rk::config::log_thread_sched_policy::DEFAULT;
+    if (hasNonDefaultSettings) {
+        threadLog("Thread affinity, scheduling, and NUMA settings are not supported on this platform. Ignoring them.\n");
+    }
+}
+
+#endif // #if defined(__linux__)
+
+} // namespace thread_internal
+} // namespace rk
@@ -2,63 +2,283 @@
  * @file log_time.cpp
  * @brief Source file for code related to time for logs.
  */
+#include <algorithm>
+#include <cstring>
 #include <iomanip>
 #include <iostream>
 
 #include <rk_logger/log_time.h>
 #include <rk_logger/config.h>
+#include <rk_logger/simd.h>
 
 namespace rk {
 namespace time_internal {
 
-std::mutex tmMutex;
+namespace {
 
-std::string generateTimeStamp(time_point time_point) {
-    // Convert time to other type for easier access to sub-units
-    std::time_t time_t = system_clock::to_time_t(time_point);
-    std::tm tm_local;
-    {
-        std::lock_guard<std::mutex> lock(tmMutex);
-        tm_local = *std::localtime(&time_t);
-    }
-
-    std::string year = std::to_string(tm_local.tm_year + 1900); // tm_year starts from 1900
-    std::string day = std::to_string(tm_local.tm_mday);
-    padWithZeros(day, 2);
-    std::string hour = std::to_string(tm_local.tm_hour);
-    padWithZeros(hour, 2);
-    std::string minute = std::to_string(tm_local.tm_min);
-    padWithZeros(minute, 2);
-    std::string second = std::to_string(tm_local.tm_sec);
-    padWithZeros(second, 2);
-
-    // Get month based on the config settings (as a name or as a number)
-    std::string month;
-    month = monthFunc(tm_local.tm_mon + 1); // Add 1 because std::tm's months start at 0
-    if (rk::config::getInstance().getConfigValueByKey(rk::config::month_format::KEY) == rk::config::month_format::MONTH_NUM) {
-        padWithZeros(month, 2);
-    }
-
-    /**
-     * Need to calculate milliseconds. Convert the current time to seconds in order to lose precision and lose
-     * the fractional portion. Then, subtract that number from the current time in milliseconds and the difference
-     * should be the milliseconds portion of the current time.
-     */
-    auto time_point_as_ms = std::chrono::duration_cast<std::chrono::milliseconds>(time_point.time_since_epoch()).count();
-    auto time_point_as_s = std::chrono::duration_cast<std::chrono::seconds>(time_point.time_since_epoch()).count();
-    auto diff = time_point_as_ms - (time_point_as_s * static_cast<uint64_t>(1e3)); // Need to multiply seconds by 1e3 in order to get milliseconds
-    std::string milliseconds = std::to_string(diff);
-    padWithZeros(milliseconds, 3);
-
-    // Format date and time based on the config settings
-    std::string date = dateFunc(year, month, day);
-    std::string time = timeFunc(hour, minute, second, milliseconds);
-
-    const std::string timeStamp = date + time;
+constexpr int64_t NS_PER_S = 1000000000;
+
+constexpr size_t MAX_TIMESTAMP_SIZE = 48;
+
+/**
+ * @brief Copies the two digits of a rendered pair.
+ *
+ * @param out Where to write them. Advanced past them.
+ * @param digits The rendered digit pairs.
+ * @param pair The index of the pair.
+ */
+inline void copyPair(char*& out, const char* digits, const size_t pair) {
+    std::memcpy(out, digits + 2 * pair, 2);
+    out += 2;
+}
+
+} // namespace
 
+std::string TimeStampFormatter::generateTimeStamp(time_point time_point) const {
+    std::string timeStamp;
+    appendTimeStamp(time_point, timeStamp);
     return timeStamp;
 }
 
+/**
+ * Writes e.g. "[02-04-2025|08:30:00.000 PM]", with the parts ordered and formatted according to the config. The
+ * fractional seconds come from the nanoseconds since the epoch, so they are the same in every precision, just cut
+ * off at a different digit.
+ */
+void TimeStampFormatter::appendTimeStamp(time_point time_point, std::string& out) const {
+    const int64_t epochNs = std::chrono::duration_cast<std::chrono::nanoseconds>(time_point.time_since_epoch()).count();
+    if (precision == TimeStampPrecision::EpochNanoseconds) {
+        out += "[";
+        rk::simd_internal::appendInteger(out, epochNs);
+        out += "]";
+        return;
+    }
+
+    // Floor rather than truncate, so times before the epoch still get a positive fraction
+    const int64_t fractionNs = ((epochNs % NS_PER_S) + NS_PER_S) % NS_PER_S;
+    const int64_t epochSeconds = (epochNs - fractionNs) / NS_PER_S;
+
+    // Break the local time down into its parts for easier access to sub-units
+    const CivilTime local = toCivilTime(epochSeconds + timeZone.getOffsetSeconds(epochSeconds));
+
+    int hour = local.hour;
+    const bool isPM = hour >= 12;
+    if (isTwelveHour && hour > 12) {
+        hour -= 12;
+    }
+
+    // Every numeric field is a run of digit pairs, so they are all rendered in one batch. The year is cut off to
+    // its last four digits. The fraction is scaled to a whole number of pairs, and its extra digit is dropped below
+    enum Pair : size_t { MONTH, DAY, CENTURY, YEAR_OF_CENTURY, HOUR, MINUTE, SECOND, FRACTION };
+    const uint64_t year = static_cast<uint64_t>(local.year) % 10000;
+    uint64_t fraction = 0;
+    size_t fractionPairs = 0;
+    size_t fractionDigits = 0;
+    switch (precision) {
+        case TimeStampPrecision::Milliseconds:
+            fraction = static_cast<uint64_t>(fractionNs / 100000);
+            fractionPairs = 2;
+            fractionDigits = 3;
+            break;
+        case TimeStampPrecision::Microseconds:
+            fraction = static_cast<uint64_t>(fractionNs / 1000);
+            fractionPairs = 3;
+            fractionDigits = 6;
+            break;
+        default:
+            fraction = static_cast<uint64_t>(fractionNs) * 10;
+            fractionPairs = 5;
+            fractionDigits = 9;
+            break;
+    }
+    alignas(32) uint16_t pairs[rk::simd_internal::DIGIT_PAIR_BATCH] = {
+        static_cast<uint16_t>(local.month), static_cast<uint16_t>(local.day),
+        static_cast<uint16_t>(year / 100), static_cast<uint16_t>(year % 100),
+        static_cast<uint16_t>(hour), static_cast<uint16_t>(local.minute), static_cast<uint16_t>(local.second),
+    };
+    for (size_t i = fractionPairs; i > 0; i--) {
+        pairs[FRACTION + i - 1] = static_cast<uint16_t>(fraction % 100);
+        fraction /= 100;
+    }
+    alignas(32) char digits[2 * rk::simd_internal::DIGIT_PAIR_BATCH];
+    rk::simd_internal::renderDigitPairs(pairs, FRACTION + fractionPairs, digits);
+
+    char line[MAX_TIMESTAMP_SIZE];
+    char* pos = line;
+    auto appendMonth = [this, &pos, &digits, &local] () {
+        if (isMonthName && local.month >= 1 && local.month <= 12) {
+            std::memcpy(pos, months[local.month - 1], 3);
+            pos += 3;
+        }
+        else if (isMonthName) {
+            std::memcpy(pos, "N/A", 3);
+            pos += 3;
+        }
+        else {
+            copyPair(pos, digits, MONTH);
+        }
+    };
+    auto appendYear = [&pos, &digits] () {
+        copyPair(pos, digits, CENTURY);
+        copyPair(pos, digits, YEAR_OF_CENTURY);
+    };
+
+    *pos++ = '[';
+    switch (dateOrder) {
+        case DateOrder::MonthDayYear:
+            appendMonth();
+            *pos++ = '-';
+            copyPair(pos, digits, DAY);
+            *pos++ = '-';
+            appendYear();
+            break;
+        case DateOrder::DayMonthYear:
+            copyPair(pos, digits, DAY);
+            *pos++ = '-';
+            appendMonth();
+            *pos++ = '-';
+            appendYear();
+            break;
+        case DateOrder::YearMonthDay:
+            appendYear();
+            *pos++ = '-';
+            appendMonth();
+            *pos++ = '-';
+            copyPair(pos, digits, DAY);
+            break;
+    }
+    *pos++ = '|';
+    copyPair(pos, digits, HOUR);
+    *pos++ = ':';
+    copyPair(pos, digits, MINUTE);
+    *pos++ = ':';
+    copyPair(pos, digits, SECOND);
+    *pos++ = '.';
+    std::memcpy(pos, digits + 2 * FRACTION, fractionDigits);
+    pos += fractionDigits;
+    if (isTwelveHour) {
+        std::memcpy(pos, isPM ? " PM" : " AM", 3);
+        pos += 3;
+    }
+    *pos++ = ']';
+    out.append(line, pos - line);
+}
+
+/**
+ * A local time is converted with the offset at about that time. The two lookups only disagree around a DST
+ * transition, and a time in the hour that repeats when DST ends is read as the later of the two.
+ */
+size_t TimeStampFormatter::parseTimeStamp(const std::string_view text, int64_t& epochNs) const {
+    size_t pos = 0;
+    auto isAt = [&text, &pos] (const char c) {
+        if (pos < text.size() && text[pos] == c) {
+            pos++;
+            return true;
+        }
+        return false;
+    };
+    auto readDigits = [&text, &pos] (const size_t count, int& value) {
+        if (text.size() - pos < count) {
+            return false;
+        }
+        value = 0;
+        for (size_t i = 0; i < count; i++) {
+            const char c = text[pos + i];
+            if (c < '0' || c > '9') {
+                return false;
+            }
+            value = value * 10 + (c - '0');
+        }
+        pos += count;
+        return true;
+    };
+
+    if (!isAt('[')) {
+        return 0;
+    }
+    if (precision == TimeStampPrecision::EpochNanoseconds) {
+        const bool isNegative = isAt('-');
+        int64_t value = 0;
+        const size_t start = pos;
+        while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9') {
+            if (value > (INT64_MAX - (text[pos] - '0')) / 10) {
+                return 0;
+            }
+            value = value * 10 + (text[pos++] - '0');
+        }
+        if (pos == start || !isAt(']')) {
+            return 0;
+        }
+        epochNs = isNegative ? -value : value;
+        return pos;
+    }
+
+    CivilTime local{};
+    auto readMonth = [this, &text, &pos, &readDigits, &local] () {
+        if (!isMonthName) {
+            return readDigits(2, local.month);
+        }
+        if (text.size() - pos < 3) {
+            return false;
+        }
+        for (int i = 0; i < 12; i++) {
+            if (std::memcmp(text.data() + pos, months[i], 3) == 0) {
+                local.month = i + 1;
+                pos += 3;
+                return true;
+            }
+        }
+        return false;
+    };
+    bool isDateRead = false;
+    switch (dateOrder) {
+        case DateOrder::MonthDayYear:
+            isDateRead = readMonth() && isAt('-') && readDigits(2, local.day) && isAt('-') && readDigits(4, local.year);
+            break;
+        case DateOrder::DayMonthYear:
+            isDateRead = readDigits(2, local.day) && isAt('-') && readMonth() && isAt('-') && readDigits(4, local.year);
+            break;
+        case DateOrder::YearMonthDay:
+            isDateRead = readDigits(4, local.year) && isAt('-') && readMonth() && isAt('-') && readDigits(2, local.day);
+            break;
+    }
+    if (!isDateRead || !isAt('|') || !readDigits(2, local.hour) || !isAt(':') || !readDigits(2, local.minute) || !isAt(':') ||
+        !readDigits(2, local.second) || !isAt('.')) {
+        return 0;
+    }
+    const size_t fractionDigits = precision == TimeStampPrecision::Milliseconds ? 3 : precision == TimeStampPrecision::Microseconds ? 6 : 9;
+    int fraction = 0;
+    if (!readDigits(fractionDigits, fraction)) {
+        return 0;
+    }
+    if (isTwelveHour) {
+        const std::string_view suffix = text.substr(pos, 3);
+        if ((suffix != " AM" && suffix != " PM") || local.hour > 12) {
+            return 0;
+        }
+        if (suffix == " PM" && local.hour < 12) {
+            local.hour += 12;
+        }
+        pos += 3;
+    }
+    if (!isAt(']') || local.month < 1 || local.month > 12 || local.day < 1 || local.day > 31 || local.hour > 23 ||
+        local.minute > 59 || local.second > 59) {
+        return 0;
+    }
+
+    int64_t fractionNs = fraction;
+    for (size_t i = fractionDigits; i < 9; i++) {
+        fractionNs *= 10;
+    }
+    const int64_t localSeconds = fromCivilTime(local);
+    if (toCivilTime(localSeconds).day != local.day) {
+        return 0; // A day past the end of the month, e.g., February 30
+    }
+    const int64_t epochSeconds = localSeconds - timeZone.getOffsetSeconds(localSeconds - timeZone.getOffsetSeconds(localSeconds));
+    epochNs = epochSeconds * NS_PER_S + fractionNs;
+    return pos;
+}
+
 std::string monthNumToName(const int monthNum) {
     if (monthNum < 1 || monthNum > 12) {
         return "N/A";
@@ -72,178 +292,114 @@ void padWithZeros(std::string& number, const int targetSize) {
     if (number.empty() || targetSize < 2) {
         return;
     }
-    if (number.size() == targetSize) {
+    if (number.size() >= static_cast<size_t>(targetSize)) {
         return;
     }
 
-    const size_t amountOfZeros = targetSize - number.size();
-    const std::string zeros(amountOfZeros, '0');
-    number = zeros + number;
+    number.insert(0, targetSize - number.size(), '0');
 }
 
+/**
+ * The characters that need to change are found with one vectorized match per 64 characters, and the text between
+ * them is moved down as a whole, instead of erasing the characters one at a time.
+ */
 std::string convertTimeStampForFileName(std::string timeStamp) {
-    for (auto iter = timeStamp.begin(); iter != timeStamp.end(); ) {
-        if (*iter == '[' || *iter == ']') { // Remove any square brackets
-            iter = timeStamp.erase(iter);
-        }
-        else if (*iter == '|') { // Replace any vertical lines with underscores
-            *iter = '_';
-            iter++;
-        }
-        else if (*iter == ':') { // Replace any colons with dashes
-            *iter = '-';
-            iter++;
-        }
-        else if (*iter == ' ') { // Remove any white spaces
-            iter = timeStamp.erase(iter);
-        }
-        else {
-            iter++;
+    constexpr std::string_view SPECIAL_CHARS = "[]|: ";
+    size_t writePos = 0;
+    for (size_t chunkPos = 0; chunkPos < timeStamp.size(); chunkPos += rk::simd_internal::MAX_MATCH_SIZE) {
+        const size_t chunkSize = std::min(timeStamp.size() - chunkPos, rk::simd_internal::MAX_MATCH_SIZE);
+        uint64_t specialMask = rk::simd_internal::matchAnyOf(timeStamp.data() + chunkPos, chunkSize, SPECIAL_CHARS);
+        size_t readPos = chunkPos;
+        while (true) {
+            const size_t specialPos = specialMask != 0 ? chunkPos + rk::simd_internal::lowestSetBit(specialMask) : chunkPos + chunkSize;
+            std::memmove(&timeStamp[writePos], &timeStamp[readPos], specialPos - readPos);
+            writePos += specialPos - readPos;
+            if (specialMask == 0) {
+                break;
+            }
+            specialMask &= specialMask - 1;
+            readPos = specialPos + 1;
+            if (timeStamp[specialPos] == '|') { // Replace any vertical lines with underscores
+                timeStamp[writePos++] = '_';
+            }
+            else if (timeStamp[specialPos] == ':') { // Replace any colons with dashes
+                timeStamp[writePos++] = '-';
+            }
+            // Square brackets and white spaces are removed
         }
     }
+    timeStamp.resize(writePos);
 
     return timeStamp;
 }
 
-std::function<std::string(const int)> monthFunc = [] (const int monthNum) {
-    std::string month;
-    month = std::to_string(monthNum);
-    return month;
-};
-
-std::function<std::string(const std::string, const std::string, const std::string)> dateFunc = [](const std::string year, const std::string month, const std::string day) {
-    std::string date;
-    date = "[" +
-        month +
-        "-" +
-        day +
-        "-" +
-        year +
-        "|";
-    return date;
-};
-
-std::function<std::string(std::string, const std::string, const std::string, const std::string)> timeFunc = [] (std::string hour, const std::string minute, const std::string second, const std::string millisecond) {
-    int hourNum = std::stoi(hour);
-    const bool isPM = (hourNum >= 12) ? true : false;
+void TimeStampFormatter::updateMonthFormat(const rk::config::Config& config) {
+    timeLog("Updating month format\n");
+    isMonthName = config.getConfigValueByKey(rk::config::month_format::KEY) == rk::config::month_format::MONTH_NAME;
+}
 
-    if (isPM && hourNum != 12) {
-        hour = std::to_string(hourNum - 12);
-        padWithZeros(hour, 2);
+void TimeStampFormatter::updateDateFormat(const rk::config::Config& config) {
+    timeLog("Updating date format\n");
+    const rk::config::ConfigValue dateFormat = config.getConfigValueByKey(rk::config::date_format::KEY);
+    if (dateFormat == rk::config::date_format::MM_DD_YYYY) {
+        dateOrder = DateOrder::MonthDayYear;
     }
-
-    std::string time = hour + ":" + minute + ":" + second + "." + millisecond;
-    if (isPM) {
-        time += " PM";
+    else if (dateFormat == rk::config::date_format::DD_MM_YYYY) {
+        dateOrder = DateOrder::DayMonthYear;
     }
-    else {
-        time += " AM";
+    else if (dateFormat == rk::config::date_format::YYYY_MM_DD) {
+        dateOrder = DateOrder::YearMonthDay;
     }
-    time += "]";
+}
 
-    return time;
-};
+void TimeStampFormatter::updateHourFormat(const rk::config::Config& config) {
+    timeLog("Updating hour format\n");
+    isTwelveHour = config.getConfigValueByKey(rk::config::hour_format::KEY) != rk::config::hour_format::TWENTY_FOUR_HOUR;
+}
 
-void updateMonthFunc() {
-    timeLog("Updating month function\n");
-    const rk::config::ConfigValue monthFormat = rk::config::getInstance().getConfigValueByKey(rk::config::month_format::KEY);
-    if (monthFormat == rk::config::month_format::MONTH_NUM) {
-        monthFunc = [] (const int monthNum) {
-            std::string month;
-            month = std::to_string(monthNum);
-            return month;
-        };
+void TimeStampFormatter::updatePrecision(const rk::config::Config& config) {
+    timeLog("Updating timestamp precision\n");
+    const rk::config::ConfigValue configuredPrecision = config.getConfigValueByKey(rk::config::timestamp_precision::KEY);
+    if (configuredPrecision == rk::config::timestamp_precision::US) {
+        precision = TimeStampPrecision::Microseconds;
     }
-    else if(monthFormat == rk::config::month_format::MONTH_NAME) {
-        monthFunc = [] (const int monthNum) {
-            std::string month;
-            month = monthNumToName(monthNum);
-            return month;
-        };
+    else if (configuredPrecision == rk::config::timestamp_precision::NS) {
+        precision = TimeStampPrecision::Nanoseconds;
     }
-}
-
-void updateDateFunc() {
-    timeLog("Updating date function\n");
-    const rk::config::ConfigValue dateFormat = rk::config::getInstance().getConfigValueByKey(rk::config::date_format::KEY);
-    if (dateFormat == rk::config::date_format::MM_DD_YYYY) {
-        dateFunc = [](const std::string year, const std::string month, const std::string day) {
-            std::string date;
-            date = "[" +
-                        month +
-                        "-" +
-                        day +
-                        "-" +
-                        year +
-                        "|";
-            return date;
-        };
+    else if (configuredPrecision == rk::config::timestamp_precision::EPOCH_NS) {
+        precision = TimeStampPrecision::EpochNanoseconds;
     }
-    else if (dateFormat == rk::config::date_format::DD_MM_YYYY) {
-        dateFunc = [](const std::string year, const std::string month, const std::string day) {
-            std::string date;
-            date = "[" +
-                        day +
-                        "-" +
-                        month +
-                        "-" +
-                        year +
-                        "|";
-            return date;
-        };
+    else {
+        precision = TimeStampPrecision::Milliseconds;
     }
-    else if (dateFormat == rk::config::date_format::YYYY_MM_DD) {
-        dateFunc = [](const std::string year, const std::string month, const std::string day) {
-            std::string date;
-            date = "[" +
-                        year +
-                        "-" +
-                        month +
-                        "-" +
-                        day +
-                        "|";
-            return date;
-        };
-    }
-}
-
-void updateTimeFunc() {
-    timeLog("Updating time function\n");
-    const rk::config::ConfigValue hourFormat = rk::config::getInstance().getConfigValueByKey(rk::config::hour_format::KEY);
-    if (hourFormat == rk::config::hour_format::TWELVE_HOUR) {
-        timeFunc = [] (std::string hour, const std::string minute, const std::string second, const std::string millisecond) {
-            int hourNum = std::stoi(hour);
-            const bool isPM = (hourNum >= 12) ? true : false;
-
-            if (isPM && hourNum != 12) {
-                hour = std::to_string(hourNum - 12);
-                padWithZeros(hour, 2);
-            }
+}
 
-            std::string time = hour + ":" + minute + ":" + second + "." + millisecond;
-            if (isPM) {
-                time += " PM";
-            }
-            else {
-                time += " AM";
-            }
-            time += "]";
+void TimeStampFormatter::updateTimeZone(const rk::config::Config& config) {
+    timeLog("Updating time zone\n");
+    timeZone.setUtc(config.getConfigValueByKey(rk::config::time_zone::KEY) == rk::config::time_zone::UTC);
+    timeZone.reset();
+}
 
-            return time;
-        };
-    }
-    else if(hourFormat == rk::config::hour_format::TWENTY_FOUR_HOUR) {
-        timeFunc = [] (std::string hour, const std::string minute, const std::string second, const std::string millisecond) {
-            return hour + ":" + minute + ":" + second + "." + millisecond + "]";
-        };
-    }
+void TimeStampFormatter::updateTimeStampFuncs(const rk::config::Config& config) {
+    timeLog("Updating timestamp functions\n");
+    updateMonthFormat(config);
+    updateDateFormat(config);
+    updateHourFormat(config);
+    updatePrecision(config);
+    updateTimeZone(config);
+}
+
+TimeStampFormatter& getDefaultFormatter() {
+    static TimeStampFormatter formatter;
+    return formatter;
+}
+
+std::string generateTimeStamp(time_point time_point) {
+    return getDefaultFormatter().generateTimeStamp(time_point);
 }
 
 void updateTimeStampFuncs() {
-    timeLog("Updating timestamp functions\n");
-    updateMonthFunc();
-    updateDateFunc();
-    updateTimeFunc();
+    getDefaultFormatter().updateTimeStampFuncs(rk::config::getInstance());
 }
 
 } // namespace time_internal
@@ -2,144 +2,1419 @@
  * @file log.cpp
  * @brief Source file for the logger.
  */
+#include <unordered_map>
+#include <queue>
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+#include <new>
+
 #include <rk_logger/logger.h>
 #include <rk_logger/log_time.h>
+#include <rk_logger/log_thread.h>
+#include <rk_logger/syslog_sink.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <csignal>
+#include <pthread.h>
+#include <unistd.h>
+#endif
 
 namespace rk {
 namespace log {
 
-std::thread startLogger(const std::filesystem::path& configPath) {
-    rk::log_internal::rkLogInternal("Starting RK Logger\n");
+const std::string DEFAULT_LOGGER_NAME = "default";
+
+namespace {
+
+constexpr uint8_t NOTHING_ENABLED = UINT8_MAX; /**< A threshold above every level that a message can have */
+constexpr uint32_t MAX_LOGGER_ID = UINT32_MAX;
+constexpr size_t BYTES_PER_KB = 1024;
+constexpr std::chrono::milliseconds SIGNAL_POLL_INTERVAL(100); /**< How often the log thread checks for SIGUSR1 */
+constexpr size_t DRAIN_CHECK_INTERVAL = 64; /**< How many records are written between checks of the drain deadline */
+constexpr size_t MAX_CACHED_THREAD_IDS = 4096; /**< The thread id texts that a log thread keeps before it starts over */
+
+std::atomic<uint32_t> loggerCount{0};
+std::mutex callSiteMutex; /**< Guards the owner and list of every call site. Taken after levelMutex */
+
+/**
+ * Ids start at 1 because a cached value of 0 means that nothing is cached.
+ */
+uint32_t createLoggerId() {
+    return loggerCount.fetch_add(1, std::memory_order_relaxed) % MAX_LOGGER_ID + 1;
+}
+
+/**
+ * @brief Gets the file name from a path such as __FILE__, e.g., "src/order_book.cpp" becomes "order_book.cpp".
+ */
+std::string getFileName(const char* path) {
+    const std::string_view pathView(path);
+    const size_t separatorIndex = pathView.find_last_of("/\\");
+    return std::string(separatorIndex == std::string_view::npos ? pathView : pathView.substr(separatorIndex + 1));
+}
+
+std::atomic<uint64_t> dumpSignalCount{0}; /**< Incremented by the SIGUSR1 handler */
+
+std::mutex runningLoggersMutex;
+
+/**
+ * Never destroyed, so loggers that are destroyed during static destruction can still remove themselves from it.
+ */
+std::vector<Logger*>& getRunningLoggers() {
+    static std::vector<Logger*>* runningLoggers = new std::vector<Logger*>();
+    return *runningLoggers;
+}
+
+/**
+ * The at-exit handler is registered when the first logger starts, i.e., after the default logger and the registry of
+ * named loggers were created, so it runs before they are destroyed.
+ *
+ * A logger is added before it takes its lifecycle lock, and removed after it has released it, because the fork
+ * handlers take the lock of the list first and then the lifecycle lock of each logger.
+ */
+void addRunningLogger(Logger* logger) {
+    static std::once_flag atExitRegistered;
+    std::call_once(atExitRegistered, [] () {
+        std::atexit(stopAllLoggers);
+    });
+    std::lock_guard<std::mutex> lock(runningLoggersMutex);
+    std::vector<Logger*>& runningLoggers = getRunningLoggers();
+    if (std::find(runningLoggers.begin(), runningLoggers.end(), logger) == runningLoggers.end()) {
+        runningLoggers.push_back(logger);
+    }
+}
+
+/**
+ * The logger is only removed if it is still stopped, in case another thread started it again in the meantime.
+ */
+void removeRunningLogger(Logger* logger) {
+    std::lock_guard<std::mutex> lock(runningLoggersMutex);
+    if (logger->isRunning()) {
+        return;
+    }
+    std::vector<Logger*>& runningLoggers = getRunningLoggers();
+    runningLoggers.erase(std::remove(runningLoggers.begin(), runningLoggers.end(), logger), runningLoggers.end());
+}
+
+/**
+ * @brief Leaks a thread object from the parent process in a child process. The thread doesn't exist in the child, so
+ * it can't be joined, and destroying a joinable std::thread terminates the process.
+ */
+void leakThreadOfParent(std::thread thread) {
+    if (thread.joinable()) {
+        static_cast<void>(new std::thread(std::move(thread)));
+    }
+}
+
+/**
+ * @brief Gets the text of a thread id as operator<< writes it, without a stream for every record.
+ *
+ * The texts are cached by each thread that formats records, i.e., by each shard's consumer, so the cache isn't
+ * shared. Most records come from the same thread as the one before, so that one is checked first. A new thread can
+ * get the id of a thread that exited, but its text is the same.
+ */
+const std::string& getThreadIdText(const std::thread::id threadId) {
+    struct Cache {
+        std::thread::id lastId;
+        const std::string* lastText = nullptr;
+        std::unordered_map<std::thread::id, std::string> texts;
+    };
+    thread_local Cache cache;
+    if (cache.lastText != nullptr && cache.lastId == threadId) {
+        return *cache.lastText;
+    }
+
+    auto it = cache.texts.find(threadId);
+    if (it == cache.texts.end()) {
+        if (cache.texts.size() >= MAX_CACHED_THREAD_IDS) {
+            cache.texts.clear();
+        }
+        std::ostringstream text;
+        text << threadId;
+        it = cache.texts.emplace(threadId, text.str()).first;
+    }
+    cache.lastId = threadId;
+    cache.lastText = &it->second; // Elements of an unordered_map stay where they are until they are erased
+    return it->second;
+}
+
+/**
+ * @brief Appends the message of a record to a string, with its owned and deferred arguments spliced in.
+ */
+void appendMessage(const Record& record, std::string& out) {
+    if (record.spliced.empty()) {
+        out += record.message;
+        return;
+    }
+    std::ostringstream deferredOutput;
+    size_t offset = 0;
+    for (const SplicedArg& arg : record.spliced) {
+        out.append(record.message, offset, arg.offset - offset);
+        if (arg.format != nullptr) {
+            arg.format(arg.text, out);
+        }
+        else if (arg.write) {
+            deferredOutput.str("");
+            arg.write(deferredOutput);
+            out += deferredOutput.str();
+        }
+        else {
+            out += arg.text;
+        }
+        offset = arg.offset;
+    }
+    out.append(record.message, offset, std::string::npos);
+}
+
+/**
+ * @brief Gets the message of a record with its owned and deferred arguments spliced in.
+ *
+ * @param record The record.
+ * @param scratch Holds the message if anything had to be spliced into it.
+ * @return The message.
+ */
+std::string_view getMessage(const Record& record, std::string& scratch) {
+    if (record.spliced.empty()) {
+        return record.message;
+    }
+    scratch.clear();
+    appendMessage(record, scratch);
+    return scratch;
+}
+
+RecordedMessage toRecordedMessage(const Record& record, const std::string_view message) {
+    RecordedMessage recorded;
+    recorded.time = record.time;
+    recorded.ticks = record.ticks;
+    recorded.threadId = record.threadId;
+    recorded.funcName = record.funcName;
+    recorded.level = record.level;
+    recorded.message = message;
+    return recorded;
+}
+
+int64_t steadyNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * The handler only increments a lock-free counter, which is safe to do in a signal handler. The log threads of the
+ * loggers that dump on the signal poll the counter, so nothing is written from inside the handler.
+ */
+void installDumpSignalHandler() {
+#if defined(__unix__) || defined(__APPLE__)
+    static std::once_flag installed;
+    std::call_once(installed, [] () {
+        struct sigaction action{};
+        action.sa_handler = [] (int) { dumpSignalCount.fetch_add(1, std::memory_order_relaxed); };
+        sigemptyset(&action.sa_mask);
+        action.sa_flags = SA_RESTART;
+        if (sigaction(SIGUSR1, &action, nullptr) != 0) {
+            rk::log_internal::rkLogInternal("Unable to install the SIGUSR1 handler for the flight recorder\n");
+        }
+    });
+#else
+    rk::log_internal::rkLogInternal("Dumping the flight recorder on a signal is not supported on this platform\n");
+#endif
+}
+
+} // namespace
+
+Logger::Logger(const std::string& name) :
+    name(name),
+    ownedConfig(rk::config::createInstance()),
+    config(*ownedConfig),
+    ownedTimeStampFormatter(std::make_unique<rk::time_internal::TimeStampFormatter>()),
+    timeStampFormatter(*ownedTimeStampFormatter),
+    id(createLoggerId()),
+    shards(std::make_unique<Shard[]>(rk::config::log_shards::MAX_COUNT)) {}
+
+Logger::Logger(const std::string& name, rk::config::Config& config, rk::time_internal::TimeStampFormatter& formatter) :
+    name(name),
+    config(config),
+    timeStampFormatter(formatter),
+    id(createLoggerId()),
+    shards(std::make_unique<Shard[]>(rk::config::log_shards::MAX_COUNT)) {}
+
+Logger::~Logger() {
+    stop();
+
+    std::lock_guard<std::mutex> lock(callSiteMutex);
+    rk::log_internal::CallSite* site = callSites;
+    while (site != nullptr) {
+        rk::log_internal::CallSite* next = site->next;
+        site->cached.store(0, std::memory_order_relaxed);
+        site->ownerId = 0;
+        site->next = nullptr;
+        site = next;
+    }
+}
+
+std::thread Logger::start(const std::filesystem::path& configPath) {
+    installForkHandlers();
+    addRunningLogger(this);
+    std::lock_guard<std::mutex> lock(lifecycleMutex);
+    if (isStarted) {
+        rk::log_internal::rkLogInternal("RK Logger \"", name, "\" is already started\n");
+        return std::thread();
+    }
+    return startLocked(configPath);
+}
+
+void Logger::startOwned(const std::filesystem::path& configPath) {
+    installForkHandlers();
+    addRunningLogger(this);
+    std::lock_guard<std::mutex> lock(lifecycleMutex);
+    if (isStarted) {
+        rk::log_internal::rkLogInternal("RK Logger \"", name, "\" is already started\n");
+        return;
+    }
+    ownedLogThread = startLocked(configPath);
+}
+
+std::thread Logger::startLocked(const std::filesystem::path& configPath) {
+    rk::log_internal::rkLogInternal("Starting RK Logger \"", name, "\"\n");
 
     // Read config settings from a file (if it exists) and update the internal config
-    rk::config::getInstance().parseLoggingConfig(configPath);
-    rk::time_internal::updateTimeStampFuncs();
+    config.parseLoggingConfig(configPath);
+    timeStampFormatter.updateTimeStampFuncs(config);
+    tickClock.configure(config);
+    ringWriter = nullptr;
+    if (config.getConfigValueByKey(rk::config::log_transport::KEY) == rk::config::log_transport::SHARED_MEMORY) {
+        openSharedMemoryRing();
+    }
+    const bool isSharedMemoryTransport = ringWriter.load() != nullptr;
+
+    int configuredShardCount = 1;
+    rk::config_internal::parseInteger(config.getConfigValueByKey(rk::config::log_shards::KEY), configuredShardCount);
+    shardCount = static_cast<size_t>(configuredShardCount);
+    isGloballyOrdered = shardCount > 1 && config.getConfigValueByKey(rk::config::log_shard_ordering::KEY) == rk::config::log_shard_ordering::GLOBAL;
+    nextSequence = 0;
 
-    if (rk::config::getInstance().getConfigValueByKey(rk::config::write_to_log_file::KEY) == rk::config::write_to_log_file::ENABLE) {
-        rk::log_internal::openLogFile();
-        rk::log_internal::verifyLogFile();
+    Level configuredLevel = Level::Info;
+    rk::log::parseLevel(config.getConfigValueByKey(rk::config::log_level::KEY), configuredLevel);
+    int flightRecorderSizeKb = 0;
+    rk::config_internal::parseInteger(config.getConfigValueByKey(rk::config::flight_recorder_size_kb::KEY), flightRecorderSizeKb);
+    if (isSharedMemoryTransport && flightRecorderSizeKb > 0) {
+        rk::log_internal::rkLogInternal("The flight recorder isn't supported with the shared memory transport. Ignoring it\n");
+        flightRecorderSizeKb = 0;
+    }
+    flightRecorderLevel = Level::Trace;
+    rk::log::parseLevel(config.getConfigValueByKey(rk::config::flight_recorder_level::KEY), flightRecorderLevel);
+    flightRecorderTrigger = Level::Error;
+    rk::log::parseLevel(config.getConfigValueByKey(rk::config::flight_recorder_trigger::KEY), flightRecorderTrigger);
+    isSignalDumpEnabled = flightRecorderSizeKb > 0 &&
+        config.getConfigValueByKey(rk::config::flight_recorder_signal::KEY) == rk::config::flight_recorder_signal::ENABLE;
+    if (isSignalDumpEnabled) {
+        installDumpSignalHandler();
+    }
+    handledSignalCount = dumpSignalCount.load();
+    {
+        std::lock_guard<std::mutex> lock(sinksMutex);
+        flightRecorder.reset();
+        if (flightRecorderSizeKb > 0) {
+            flightRecorder = std::make_unique<FlightRecorder>(static_cast<size_t>(flightRecorderSizeKb) * BYTES_PER_KB);
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(levelMutex);
+        const bool isRecording = flightRecorderSizeKb > 0 && flightRecorderLevel != Level::Off;
+        flightRecorderThreshold = isRecording ? static_cast<uint8_t>(flightRecorderLevel) : NOTHING_ENABLED;
+        hasFlightRecorder = isRecording;
+        moduleLevels.clear();
+        for (const auto& keyValuePair : config.getConfigValuesWithPrefix(rk::config::module_level::KEY_PREFIX)) {
+            Level moduleLevel = Level::Info;
+            if (rk::log::parseLevel(keyValuePair.second, moduleLevel)) {
+                moduleLevels[keyValuePair.first.substr(rk::config::module_level::KEY_PREFIX.size())] = moduleLevel;
+            }
+        }
+        hasModuleLevels = !moduleLevels.empty();
+    }
+    setLevel(configuredLevel); // Also clears the levels cached by the call sites
+
+    // With the shared-memory transport, the console, syslog, and log file are written by rk_log_agent instead
+    {
+        std::lock_guard<std::mutex> lock(sinksMutex);
+        configuredSinks.clear();
+        if (!isSharedMemoryTransport && config.getConfigValueByKey(rk::config::write_to_console::KEY) == rk::config::write_to_console::ENABLE) {
+            configuredSinks.push_back(createConsoleSink(config));
+        }
+        const rk::config::ConfigValue syslogFormat = config.getConfigValueByKey(rk::config::write_to_syslog::KEY);
+        if (!isSharedMemoryTransport && syslogFormat != rk::config::write_to_syslog::DISABLE) {
+            const rk::config::ConfigValue socketPath = config.getConfigValueByKey(rk::config::syslog_socket_path::KEY);
+            auto syslogSink = std::make_shared<SyslogSink>(
+                syslogFormat == rk::config::write_to_syslog::JOURNALD ? SyslogSink::Format::Journald : SyslogSink::Format::Rfc5424,
+                socketPath == rk::config::syslog_socket_path::DEFAULT ? std::filesystem::path() : std::filesystem::path(socketPath));
+            if (!syslogSink->isConnected()) {
+                rk::log_internal::rkLogInternal("Unable to connect to the syslog socket. Messages are dropped until it is available\n");
+            }
+            configuredSinks.push_back(std::move(syslogSink));
+        }
+    }
+    const bool isWritingLogFile = !isSharedMemoryTransport &&
+        config.getConfigValueByKey(rk::config::write_to_log_file::KEY) == rk::config::write_to_log_file::ENABLE;
+    isLogFileCompressed = isWritingLogFile &&
+        config.getConfigValueByKey(rk::config::log_file_compression::KEY) == rk::config::log_file_compression::LZ4;
+    int frameMs = 0;
+    rk::config_internal::parseInteger(config.getConfigValueByKey(rk::config::log_file_frame_ms::KEY), frameMs);
+    idleFlushInterval = std::chrono::milliseconds(isLogFileCompressed ? frameMs : 0);
+    isLogFileIndexed = isWritingLogFile && !isLogFileCompressed &&
+        config.getConfigValueByKey(rk::config::log_file_index::KEY) == rk::config::log_file_index::ENABLE;
+    if (isWritingLogFile) {
+        openLogFile();
     }
 
-    rk::log_internal::enableAutoFlush();
-    std::thread logThread = rk::log_internal::startLogThread();
+    endLogLoop = false;
+    drainDeadlineNs = INT64_MAX;
+    {
+        std::lock_guard<std::mutex> lock(logThreadDoneMutex);
+        isLogThreadDone = false;
+    }
+    std::thread logThread = startLogThread();
+    isStarted = true;
+    isRestartedAfterFork = false;
+    isRingInherited = false;
 
     return logThread;
 }
 
-void stopLogger(std::thread logThread) {
-    rk::log_internal::rkLogInternal("Stopping RK Logger\n");
-    rk::log_internal::endLogThread(std::move(logThread));
-    rk::log_internal::disableAutoFlush();
-    if (rk::config::getInstance().getConfigValueByKey(rk::config::write_to_log_file::KEY) == rk::config::write_to_log_file::ENABLE) {
-        rk::log_internal::closeLogFile();
+/**
+ * In a child process, the thread is the one from the parent, so the log thread that was restarted in the child is
+ * stopped instead.
+ */
+void Logger::stop(std::thread logThread) {
+    {
+        std::lock_guard<std::mutex> lock(lifecycleMutex);
+        if (!isRestartedAfterFork) {
+            stopLocked(std::move(logThread));
+        }
+        else {
+            leakThreadOfParent(std::move(logThread));
+            if (isStarted) {
+                stopLocked(std::move(ownedLogThread));
+            }
+        }
     }
+    removeRunningLogger(this);
 }
 
-} // namespace log
-} // namespace rk
+void Logger::stop() {
+    {
+        std::lock_guard<std::mutex> lock(lifecycleMutex);
+        if (isStarted) {
+            stopLocked(std::move(ownedLogThread));
+        }
+    }
+    removeRunningLogger(this);
+}
 
-namespace rk {
-namespace log_internal {
+bool Logger::isRunning() const {
+    std::lock_guard<std::mutex> lock(lifecycleMutex);
+    return isStarted;
+}
+
+void Logger::stopLocked(std::thread logThread) {
+    rk::log_internal::rkLogInternal("Stopping RK Logger \"", name, "\"\n");
+    endLogThread(std::move(logThread));
+    rk::shm_internal::RingWriter* ring = ringWriter.exchange(nullptr);
+    if (ring != nullptr) {
+        ring->close();
+    }
+    isStarted = false;
+    isRestartedAfterFork = false;
+
+    // Closes the log file(s), if there are any
+    std::lock_guard<std::mutex> lock(sinksMutex);
+    configuredSinks.clear();
+    sharedLogFile.reset();
+    spillFile.reset();
+    for (size_t i = 0; i < rk::config::log_shards::MAX_COUNT; i++) {
+        shards[i].file.reset();
+    }
+}
+
+void Logger::addSink(std::shared_ptr<Sink> sink) {
+    std::lock_guard<std::mutex> lock(sinksMutex);
+    addedSinks.push_back(std::move(sink));
+}
+
+void Logger::setLevel(const Level newLevel) {
+    std::lock_guard<std::mutex> lock(levelMutex);
+    level = newLevel;
+    updateThreshold();
+}
+
+Level Logger::getLevel() const {
+    std::lock_guard<std::mutex> lock(levelMutex);
+    return level;
+}
+
+void Logger::setModuleLevel(const std::string& module, const Level moduleLevel) {
+    std::lock_guard<std::mutex> lock(levelMutex);
+    moduleLevels[module] = moduleLevel;
+    hasModuleLevels = true;
+    updateThreshold();
+}
+
+void Logger::setEnabled(const bool enabled) {
+    std::lock_guard<std::mutex> lock(levelMutex);
+    isLoggingEnabled = enabled;
+    updateThreshold();
+}
+
+/**
+ * The request goes through the calling thread's shard, so with global ordering it also gets a sequence number and is
+ * handled in order with the messages from other threads.
+ */
+void Logger::dumpFlightRecorder() {
+    Record record;
+    record.threadId = std::this_thread::get_id();
+    record.isForSinks = false;
+    record.isFlightRecorderDump = true;
+    enqueue(std::move(record));
+}
+
+rk::config::Config& Logger::getConfig() {
+    return config;
+}
+
+const std::string& Logger::getName() const {
+    return name;
+}
+
+/**
+ * The shard is picked by hashing the thread id, so a thread always logs to the same shard. The sequence number is
+ * only needed, and only paid for, when the shards are merged back into one global order.
+ *
+ * With the shared-memory transport, the record is copied into the ring instead and this thread never takes a lock.
+ */
+void Logger::enqueue(Record&& record) {
+    if (rk::shm_internal::RingWriter* ring = ringWriter.load(std::memory_order_acquire)) {
+        if (record.isForSinks) {
+            ring->write(record);
+        }
+        return;
+    }
+
+    const size_t count = shardCount.load(std::memory_order_relaxed);
+    Shard& shard = shards[count == 1 ? 0 : std::hash<std::thread::id>{}(record.threadId) % count];
+    if (isGloballyOrdered.load(std::memory_order_relaxed)) {
+        record.sequence = nextSequence.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::lock_guard<std::mutex> lock(shard.queueMutex);
+    shard.queue.push_back(std::move(record));
+    shard.queueCv.notify_one();
+}
+
+/**
+ * When the shard's queue is empty, the whole buffer is swapped in instead of moving the records one by one. With
+ * global ordering, the records take a contiguous range of sequence numbers, so nothing logged by another thread can
+ * be written between them.
+ */
+void Logger::enqueueBatch(std::vector<Record>& records) {
+    if (records.empty()) {
+        return;
+    }
+    if (rk::shm_internal::RingWriter* ring = ringWriter.load(std::memory_order_acquire)) {
+        for (const Record& record : records) {
+            if (record.isForSinks) {
+                ring->write(record);
+            }
+        }
+        records.clear();
+        return;
+    }
 
-std::mutex logQueueMutex;
-std::queue<std::string> logQueue;
-std::mutex endLoopMtx;
-bool endLogLoop;
-std::ofstream logFile;
-std::condition_variable logQueueCv;
+    const size_t count = shardCount.load(std::memory_order_relaxed);
+    Shard& shard = shards[count == 1 ? 0 : std::hash<std::thread::id>{}(std::this_thread::get_id()) % count];
+    if (isGloballyOrdered.load(std::memory_order_relaxed)) {
+        uint64_t sequence = nextSequence.fetch_add(records.size(), std::memory_order_relaxed);
+        for (Record& record : records) {
+            record.sequence = sequence++;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(shard.queueMutex);
+        if (shard.queue.empty()) {
+            shard.queue.swap(records);
+        }
+        else {
+            std::move(records.begin(), records.end(), std::back_inserter(shard.queue));
+        }
+        shard.queueCv.notify_one();
+    }
+    records.clear(); // Destroys the moved-from records outside of the lock
+}
 
 /**
- * Checks whether the log queue has messages or the endLogLoop flag is true. If either are true, it will return true,
- * stop the condition variable from waiting, and resume execution of the log loop. This should be called as part of
- * the log loop's condition variable, so the mutex for the log queue will be locked by the condition variable when
- * this function executes, so it doesn't need to be locked explicitly.
+ * The thread id in the info points into the line, so its position is only turned into a view once the line is done
+ * growing.
  */
-bool condVarPredicate() {
-    std::unique_lock<std::mutex> endLoopLock(endLoopMtx);
-    return !logQueue.empty() || endLogLoop;
+MessageInfo Logger::formatRecord(const Record& record, const rk::time_internal::TickCalibration& calibration, std::string& out,
+    size_t* messageOffset) const {
+    const rk::time_internal::time_point time = record.ticks != 0 ? calibration.toTimePoint(record.ticks) : record.time;
+    out.clear();
+    size_t threadIdOffset = 0;
+    const std::string& threadIdText = appendPrefix(time, record.threadId, record.funcName, out, threadIdOffset);
+    if (messageOffset != nullptr) {
+        *messageOffset = out.size();
+    }
+    appendMessage(record, out);
+
+    MessageInfo info;
+    info.level = record.level;
+    info.timeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+    info.threadId = std::string_view(out).substr(threadIdOffset, threadIdText.size());
+    return info;
+}
+
+const std::string& Logger::appendPrefix(const rk::time_internal::time_point time, const std::thread::id threadId, const char* funcName,
+    std::string& out, size_t& threadIdOffset) const {
+    const std::string& threadIdText = getThreadIdText(threadId);
+    timeStampFormatter.appendTimeStamp(time, out); // Prefix the timestamp
+    out += "[";
+    threadIdOffset = out.size();
+    out += threadIdText;
+    out += "][";
+    out += funcName;
+    out += "]"; // Prefix the thread id and function name
+    return threadIdText;
 }
 
 /**
- * This function will continously check the log queue for new messages and print them via std::cout.
- * If no logs are in the queue, it'll wait until new ones get added.
+ * With one shard, or with shards that are only ordered per thread, this thread consumes shard 0 itself. When the shards
+ * are globally ordered, every shard gets its own thread and this thread merges their output. Either way, this thread
+ * returns only after all the shard threads are done.
+ */
+void Logger::logThreadMain(const rk::thread_internal::ThreadSettings& settings) {
+    rk::thread_internal::applyThreadSettings(settings);
+
+    const size_t count = shardCount.load();
+    const bool isOrdered = isGloballyOrdered.load();
+    {
+        std::lock_guard<std::mutex> lock(orderedWriter.mutex);
+        orderedWriter.activeShards = count;
+    }
+
+    std::vector<std::thread> shardThreads;
+    for (size_t i = isOrdered ? 0 : 1; i < count; i++) {
+        shardThreads.emplace_back([this, &settings, i, isOrdered] () {
+            rk::thread_internal::applyThreadSettings(settings, "_s" + std::to_string(i));
+            logQueueLoop(i, isOrdered);
+        });
+    }
+
+    if (isOrdered) {
+        orderedWriterLoop();
+    }
+    else {
+        logQueueLoop(0, false);
+    }
+
+    for (auto& thread : shardThreads) {
+        thread.join();
+    }
+}
+
+/**
+ * This function will continously check the queue of a shard for new records, format them, and write them out.
+ * If no records are in the queue, it'll wait until new ones get added. The whole queue is taken at once, so the
+ * logging threads only wait on the lock for a swap and the sinks are flushed once per batch rather than per message.
  * It will end the loop once the endLogLoop flag is set to true and the queue is empty.
  */
-void logQueueLoop() {
+void Logger::logQueueLoop(size_t shardIndex, bool isOrdered) {
+    Shard& shard = shards[shardIndex];
+    const bool isSignalDumper = shardIndex == 0 && !isOrdered && isSignalDumpEnabled;
+    const bool isIdleFlusher = !isOrdered && idleFlushInterval.count() > 0;
+    const std::chrono::milliseconds pollInterval = getPollInterval(isSignalDumper, isIdleFlusher);
+    std::vector<Record> batch;
     std::string msg;
+    msg.reserve(rk::log_internal::MESSAGE_BUFFER_RESERVE);
+    std::vector<FormattedRecord> formatted;
+    std::string text;
+    std::vector<BatchLine> lines;
+
     while (true) {
-        std::unique_lock<std::mutex> logLock(logQueueMutex);
-        if (!logQueue.empty()) {
-            msg = logQueue.front();
-            logQueue.pop();
-            if (!msg.empty()){
-                std::cout << msg;
-                if (logFile) {
-                    logFile << msg;
-                    logFile.flush();
+        bool isDumpDue = false;
+        {
+            std::unique_lock<std::mutex> queueLock(shard.queueMutex);
+            auto isReady = [this, &shard, isSignalDumper] () { return !shard.queue.empty() || endLogLoop.load() || (isSignalDumper && hasPendingSignal()); };
+            if (isSignalDumper || isIdleFlusher) {
+                shard.queueCv.wait_for(queueLock, pollInterval, isReady);
+            }
+            else {
+                shard.queueCv.wait(queueLock, isReady);
+            }
+            if (shard.queue.empty() && endLogLoop.load()) {
+                break;
+            }
+            batch.swap(shard.queue);
+            isDumpDue = isSignalDumper && takePendingSignal();
+        }
+        if (batch.empty() && !isDumpDue) {
+            if (isIdleFlusher) {
+                // Finishes the frame of a compressed log file once it is due, even if nothing else gets logged
+                if (shard.file) {
+                    std::lock_guard<std::mutex> fileLock(shard.fileMutex);
+                    shard.file->flush();
                 }
-                msg.clear();
+                std::lock_guard<std::mutex> lock(sinksMutex);
+                flushSinks();
             }
+            continue;
+        }
+
+        // Once the drain time is up, the rest of the batch is left over. The deadline is only checked every few
+        // records, and only while the logger is stopping
+        size_t writtenCount = batch.size();
+        auto isStoppingAt = [this, &writtenCount] (const size_t index) {
+            if (index % DRAIN_CHECK_INTERVAL != 0 || !isDrainTimeUp()) {
+                return false;
+            }
+            writtenCount = index;
+            return true;
+        };
+        const rk::time_internal::TickCalibration calibration = tickClock.getCalibration();
+        if (isOrdered) {
+            for (size_t i = 0; i < batch.size() && !isStoppingAt(i); i++) {
+                const Record& record = batch[i];
+                if (record.isFlightRecorderDump) {
+                    formatted.push_back({ record.sequence, false, true, std::string(), 0, 0, std::string(), RecordedMessage() });
+                    continue;
+                }
+                if (!record.isForSinks) {
+                    // Only kept by the flight recorder, which formats the prefix if it is dumped
+                    formatted.push_back({ record.sequence, false, false, std::string(getMessage(record, msg)), 0, 0, std::string(),
+                        toRecordedMessage(record, std::string_view()) });
+                    continue;
+                }
+                size_t messageOffset = 0;
+                const MessageInfo info = formatRecord(record, calibration, msg, &messageOffset);
+                formatted.push_back({ record.sequence, true, false, msg, messageOffset, info.timeNs, std::string(info.threadId),
+                    toRecordedMessage(record, std::string_view()) });
+            }
+            std::lock_guard<std::mutex> lock(orderedWriter.mutex);
+            for (auto& entry : formatted) {
+                orderedWriter.incoming.push_back(std::move(entry));
+            }
+            orderedWriter.cv.notify_one();
+            formatted.clear();
         }
         else {
-            std::unique_lock<std::mutex> endLoopLock(endLoopMtx);
-            if (!endLogLoop) {
-                endLoopLock.unlock();
-                logQueueCv.wait(logLock, rk::log_internal::condVarPredicate);
+            // The whole batch is formatted before any lock is taken, so the shards format in parallel. The shard's own
+            // log file is written under its own lock, and sinksMutex is only taken for the sinks that every shard shares
+            text.clear();
+            lines.clear();
+            for (size_t i = 0; i < batch.size() && !isStoppingAt(i); i++) {
+                const Record& record = batch[i];
+                BatchLine line{ text.size(), 0, 0, 0, record.isForSinks, record.isFlightRecorderDump, MessageInfo(),
+                    toRecordedMessage(record, std::string_view()) };
+                if (record.isFlightRecorderDump) {
+                    // Nothing to format
+                }
+                else if (!record.isForSinks) {
+                    // Only kept by the flight recorder, which formats the prefix if it is dumped
+                    text += getMessage(record, msg);
+                }
+                else {
+                    line.info = formatRecord(record, calibration, msg, &line.messageOffset);
+                    line.threadIdOffset = static_cast<size_t>(line.info.threadId.data() - msg.data());
+                    text += msg;
+                }
+                line.size = text.size() - line.offset;
+                lines.push_back(line);
+            }
+            // The views into the text are only taken once it is done growing
+            for (BatchLine& line : lines) {
+                line.info.threadId = std::string_view(text).substr(line.offset + line.threadIdOffset, line.info.threadId.size());
+                line.recorded.message = std::string_view(text).substr(line.offset + line.messageOffset, line.size - line.messageOffset);
+            }
+
+            if (shard.file) {
+                std::lock_guard<std::mutex> fileLock(shard.fileMutex);
+                for (const BatchLine& line : lines) {
+                    if (line.isForSinks) {
+                        msg.assign(text, line.offset, line.size);
+                        shard.file->writeWithInfo(msg, line.info);
+                    }
+                }
+                shard.file->flush();
+            }
+            std::lock_guard<std::mutex> lock(sinksMutex);
+            const bool hasSharedSinks = !configuredSinks.empty() || !addedSinks.empty();
+            for (const BatchLine& line : lines) {
+                if (line.isFlightRecorderDump) {
+                    writeFlightRecorderDump();
+                    continue;
+                }
+                if (line.isForSinks && hasSharedSinks) {
+                    msg.assign(text, line.offset, line.size);
+                    writeToSinks(msg, line.info);
+                }
+                recordMessage(line.recorded);
+            }
+            flushSinks();
+            if (isDumpDue) {
+                writeFlightRecorderDump();
+            }
+        }
+        if (writtenCount < batch.size()) {
+            handleLeftovers(batch, writtenCount);
+            batch.clear();
+            break; // Whatever is still queued is handled by endLogThread() once the threads are done
+        }
+        batch.clear();
+    }
+
+    if (isSignalDumper && takePendingSignal()) {
+        std::lock_guard<std::mutex> lock(sinksMutex);
+        writeFlightRecorderDump();
+    }
+    if (isOrdered) {
+        std::lock_guard<std::mutex> lock(orderedWriter.mutex);
+        orderedWriter.activeShards--;
+        orderedWriter.cv.notify_one();
+    }
+}
+
+/**
+ * Sequence numbers are handed out without gaps, so a message is written as soon as every message before it has been
+ * written. Messages that arrive early wait in a min-heap. Once every shard is done, whatever is left is written in order.
+ * This is the same order that a single queue would have produced, i.e., the order in which the messages were logged.
+ */
+void Logger::orderedWriterLoop() {
+    auto isLater = [] (const FormattedRecord& a, const FormattedRecord& b) { return a.sequence > b.sequence; };
+    std::priority_queue<FormattedRecord, std::vector<FormattedRecord>, decltype(isLater)> pending(isLater);
+    std::vector<FormattedRecord> incoming;
+    uint64_t nextToWrite = 0;
+    bool isDone = false;
+
+    while (!isDone) {
+        bool isDumpDue = false;
+        {
+            std::unique_lock<std::mutex> lock(orderedWriter.mutex);
+            auto isReady = [this] () { return !orderedWriter.incoming.empty() || orderedWriter.activeShards == 0 || hasPendingSignal(); };
+            if (isSignalDumpEnabled || idleFlushInterval.count() > 0) {
+                orderedWriter.cv.wait_for(lock, getPollInterval(isSignalDumpEnabled, idleFlushInterval.count() > 0), isReady);
             }
             else {
-                break;
+                orderedWriter.cv.wait(lock, isReady);
+            }
+            incoming.swap(orderedWriter.incoming);
+            isDone = orderedWriter.activeShards == 0; // The shards hand over their last messages before they finish
+            isDumpDue = takePendingSignal();
+        }
+
+        for (auto& entry : incoming) {
+            pending.push(std::move(entry));
+        }
+        incoming.clear();
+
+        std::lock_guard<std::mutex> lock(sinksMutex);
+        while (!pending.empty() && (pending.top().sequence <= nextToWrite || isDone)) {
+            const FormattedRecord& entry = pending.top();
+            if (entry.isFlightRecorderDump) {
+                writeFlightRecorderDump();
+            }
+            else {
+                if (entry.isForSinks) {
+                    MessageInfo info;
+                    info.level = entry.recorded.level;
+                    info.timeNs = entry.timeNs;
+                    info.threadId = entry.threadId;
+                    writeToSinks(entry.text, info);
+                }
+                RecordedMessage recorded = entry.recorded;
+                recorded.message = std::string_view(entry.text).substr(entry.messageOffset);
+                recordMessage(recorded);
             }
+            nextToWrite = std::max(nextToWrite, entry.sequence + 1);
+            pending.pop();
+        }
+        flushSinks();
+        if (isDumpDue) {
+            writeFlightRecorderDump();
         }
     }
 }
 
-std::thread startLogThread() {
-    std::thread logThread(logQueueLoop);
+/**
+ * The thread settings are read before the thread starts, but applied from inside it so that the buffers of the log
+ * loop are allocated after the thread has been pinned.
+ */
+std::thread Logger::startLogThread() {
+    const rk::thread_internal::ThreadSettings settings = rk::thread_internal::getThreadSettings(config);
+    std::thread logThread([this, settings] () {
+        logThreadMain(settings);
+        std::lock_guard<std::mutex> lock(logThreadDoneMutex);
+        isLogThreadDone = true;
+        logThreadDoneCv.notify_all();
+    });
     return logThread;
 }
 
 /**
- * Ends the log thread that was passed in by first setting the endLogLoop flag to
- * true. This will allow the log loop to exit. Then, it will join the thread.
+ * Ends the log thread that was passed in by first setting the drain deadline and the endLogLoop flag. This will
+ * allow the log loops to exit once their queues are empty, or once the deadline has passed. Then, it will join the
+ * thread, or wait for it to finish if the caller doesn't own it.
+ *
+ * A backlog is drained in large batches, i.e., each loop takes its whole queue at once and flushes the sinks once
+ * per batch, so a deadline mostly matters for slow sinks. A sink that blocks forever still blocks the join.
  */
-void endLogThread(std::thread thread) {
-    {
-        std::lock_guard<std::mutex> lock(endLoopMtx);
-        endLogLoop = true;
-        logQueueCv.notify_all();
+void Logger::endLogThread(std::thread thread) {
+    int drainMs = 0;
+    const rk::config::ConfigValue drainTime = config.getConfigValueByKey(rk::config::shutdown_drain_ms::KEY);
+    const bool isDrainLimited = drainTime != rk::config::shutdown_drain_ms::UNLIMITED && rk::config_internal::parseInteger(drainTime, drainMs);
+    drainDeadlineNs = isDrainLimited ? steadyNowNs() + static_cast<int64_t>(drainMs) * 1000000 : INT64_MAX;
+    isSpillingLeftovers = config.getConfigValueByKey(rk::config::shutdown_leftovers::KEY) == rk::config::shutdown_leftovers::SPILL;
+    droppedLeftoverCount = 0;
+    spilledLeftoverCount = 0;
+
+    endLogLoop = true;
+    for (size_t i = 0; i < rk::config::log_shards::MAX_COUNT; i++) {
+        // Taking the lock makes sure that a shard thread is either waiting and gets notified, or sees the flag before it waits
+        std::lock_guard<std::mutex> lock(shards[i].queueMutex);
+        shards[i].queueCv.notify_all();
     }
 
     if (thread.joinable()) {
         thread.join();
     }
+    else {
+        std::unique_lock<std::mutex> lock(logThreadDoneMutex);
+        logThreadDoneCv.wait(lock, [this] () { return isLogThreadDone; });
+    }
+
+    // Records that were still queued when the loops gave up, or that were logged while the logger was stopping
+    std::vector<Record> leftovers;
+    for (size_t i = 0; i < rk::config::log_shards::MAX_COUNT; i++) {
+        {
+            std::lock_guard<std::mutex> lock(shards[i].queueMutex);
+            leftovers.swap(shards[i].queue);
+        }
+        handleLeftovers(leftovers, 0);
+        leftovers.clear();
+    }
+
+    const uint64_t droppedCount = droppedLeftoverCount.load();
+    const uint64_t spilledCount = spilledLeftoverCount.load();
+    if (droppedCount > 0) {
+        rk::log_internal::rkLogInternal(droppedCount, " messages were dropped because the shutdown drain time ran out\n");
+        writeNotice(std::to_string(droppedCount) + " messages were dropped because the shutdown drain time ran out\n", Level::Warn);
+    }
+    if (spilledCount > 0) {
+        std::lock_guard<std::mutex> lock(sinksMutex);
+        rk::log_internal::rkLogInternal(spilledCount, " messages were written to ", spillFileName, " because the shutdown drain time ran out\n");
+    }
+}
+
+bool Logger::isDrainTimeUp() const {
+    return endLogLoop.load(std::memory_order_relaxed) && steadyNowNs() >= drainDeadlineNs.load(std::memory_order_relaxed);
+}
+
+/**
+ * Spilled records are formatted into one buffer and written to the spill file with one write, without going through
+ * the console, syslog, or flight recorder. Requests to dump the flight recorder are dropped either way.
+ */
+void Logger::handleLeftovers(const std::vector<Record>& records, const size_t first) {
+    size_t count = 0;
+    for (size_t i = first; i < records.size(); i++) {
+        count += records[i].isForSinks && !records[i].isFlightRecorderDump ? 1 : 0;
+    }
+    if (count == 0) {
+        return;
+    }
+    if (!isSpillingLeftovers.load()) {
+        droppedLeftoverCount += count;
+        return;
+    }
+
+    const rk::time_internal::TickCalibration calibration = tickClock.getCalibration();
+    std::string text;
+    std::string line;
+    for (size_t i = first; i < records.size(); i++) {
+        if (records[i].isForSinks && !records[i].isFlightRecorderDump) {
+            formatRecord(records[i], calibration, line);
+            text += line;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(sinksMutex);
+    if (!spillFile) {
+        std::string timeStamp = timeStampFormatter.generateTimeStamp(rk::time_internal::system_clock::now());
+        timeStamp = rk::time_internal::convertTimeStampForFileName(timeStamp);
+        const std::string namePrefix = (name == DEFAULT_LOGGER_NAME) ? "" : name + "_";
+        spillFileName = std::string("logs_") + namePrefix + timeStamp + "_unwritten.txt";
+        auto file = std::make_shared<FileSink>(spillFileName);
+        if (!file->isOpen()) {
+            rk::log_internal::rkLogInternal("Unable to open the file for the messages left at shutdown: ", spillFileName, "\n");
+            droppedLeftoverCount += count;
+            return;
+        }
+        spillFile = std::move(file);
+    }
+    spillFile->write(text);
+    spillFile->flush();
+    spilledLeftoverCount += count;
+}
+
+void Logger::writeNotice(const std::string& message, const Level messageLevel) {
+    Record record;
+    record.time = rk::time_internal::system_clock::now();
+    record.threadId = std::this_thread::get_id();
+    record.funcName = "RKLogger";
+    record.level = messageLevel;
+    record.message = message;
+    std::string line;
+    const MessageInfo info = formatRecord(record, rk::time_internal::TickCalibration(), line);
+
+    std::lock_guard<std::mutex> lock(sinksMutex);
+    writeToSinks(line, info);
+    flushSinks();
+}
+
+/**
+ * The default logger writes to "logs_<timestamp>.txt". Other loggers include their name, e.g., "logs_net_<timestamp>.txt",
+ * so that loggers started at the same time don't write to the same file. When each shard has its own file, the shard
+ * number is added to the end, e.g., "logs_<timestamp>_shard1.txt".
+ */
+void Logger::openLogFile(const std::string& nameSuffix) {
+    std::string timeStamp = timeStampFormatter.generateTimeStamp(rk::time_internal::system_clock::now());
+    timeStamp = rk::time_internal::convertTimeStampForFileName(timeStamp);
+    const std::string namePrefix = (name == DEFAULT_LOGGER_NAME) ? "" : name + "_";
+    const std::string baseName = std::string("logs_") + namePrefix + timeStamp + nameSuffix;
+
+    const bool isFilePerShard = !isGloballyOrdered && shardCount > 1 &&
+        config.getConfigValueByKey(rk::config::log_shard_files::KEY) == rk::config::log_shard_files::PER_SHARD;
+    const size_t fileCount = isFilePerShard ? shardCount.load() : 1;
+    for (size_t i = 0; i < fileCount; i++) {
+        const std::string logFileName = getLogFileName(baseName + (isFilePerShard ? "_shard" + std::to_string(i) : ""), config);
+        rk::log_internal::rkLogInternal("Writing to log file: ", logFileName, "\n");
+
+        std::shared_ptr<Sink> logFile = createLogFileSink(logFileName, config);
+        if (!logFile) {
+            rk::log_internal::rkLogInternal("Unable to open output log file\n");
+            throw -1;
+        }
+        std::lock_guard<std::mutex> lock(sinksMutex);
+        if (isFilePerShard) {
+            shards[i].file = std::move(logFile);
+        }
+        else {
+            sharedLogFile = logFile;
+            configuredSinks.push_back(std::move(logFile));
+        }
+    }
+}
+
+/**
+ * The default name is "/rk_log_<logger name>", e.g., "/rk_log_default", which is what rk_log_agent is started with.
+ */
+void Logger::openSharedMemoryRing() {
+    const rk::config::ConfigValue configuredName = config.getConfigValueByKey(rk::config::shm_name::KEY);
+    const std::string shmName = configuredName == rk::config::shm_name::DEFAULT ? "/rk_log_" + name : configuredName;
+    int sizeKb = 0;
+    rk::config_internal::parseInteger(config.getConfigValueByKey(rk::config::shm_size_kb::KEY), sizeKb);
+
+    std::unique_ptr<rk::shm_internal::RingWriter> writer =
+        rk::shm_internal::RingWriter::create(shmName, static_cast<size_t>(sizeKb) * BYTES_PER_KB, name, tickClock.getSource());
+    if (!writer) {
+        rk::log_internal::rkLogInternal("Unable to create the shared memory ring \"", shmName, "\". Writing the log from this process instead\n");
+        return;
+    }
+    rk::log_internal::rkLogInternal("Writing to the shared memory ring \"", shmName, "\". Run \"rk_log_agent ", shmName, "\" to write the log\n");
+    ringWriter = writer.get();
+    ringWriters.push_back(std::move(writer));
+}
+
+void Logger::installForkHandlers() {
+#if defined(__unix__) || defined(__APPLE__)
+    static std::once_flag installed;
+    std::call_once(installed, [] () {
+        if (pthread_atfork(prepareForFork, resumeParentAfterFork, resumeChildAfterFork) != 0) {
+            rk::log_internal::rkLogInternal("Unable to install the fork handlers. A child process can't log after a fork\n");
+        }
+    });
+#endif
+}
+
+/**
+ * The locks are taken in the same order as everywhere else, i.e., the list of running loggers, then each logger's
+ * locks, then the call sites. The forking thread holds them across the fork, so no other thread can be in the middle
+ * of changing what they guard.
+ */
+void Logger::prepareForFork() {
+    runningLoggersMutex.lock();
+    for (Logger* logger : getRunningLoggers()) {
+        logger->lockForFork();
+    }
+    callSiteMutex.lock();
+}
+
+void Logger::resumeParentAfterFork() {
+    callSiteMutex.unlock();
+    for (Logger* logger : getRunningLoggers()) {
+        logger->unlockAfterFork();
+    }
+    runningLoggersMutex.unlock();
+}
+
+/**
+ * The child only has the thread that forked, which is the one that holds the locks, so it can unlock them.
+ */
+void Logger::resumeChildAfterFork() {
+    callSiteMutex.unlock();
+    for (Logger* logger : getRunningLoggers()) {
+        logger->unlockAfterFork();
+    }
+    const std::vector<Logger*> runningLoggers = getRunningLoggers();
+    runningLoggersMutex.unlock();
+
+    for (Logger* logger : runningLoggers) {
+        logger->restartAfterFork();
+    }
+}
+
+/**
+ * The sinks are flushed while they are locked, so whatever they have buffered is written once, by the parent, rather
+ * than by both processes. Only the shards that are in use are locked. The count can't change while lifecycleMutex is
+ * held, and the child recreates the locks of the other shards instead.
+ */
+void Logger::lockForFork() {
+    lifecycleMutex.lock();
+    levelMutex.lock();
+    sinksMutex.lock();
+    // Synced rather than flushed, so a compressed log file finishes its frame and neither process is left with part of it
+    for (const auto& sink : configuredSinks) {
+        sink->sync();
+    }
+    for (const auto& sink : addedSinks) {
+        sink->sync();
+    }
+    orderedWriter.mutex.lock();
+    for (size_t i = 0; i < shardCount.load(); i++) {
+        shards[i].queueMutex.lock();
+        shards[i].fileMutex.lock();
+        if (shards[i].file) {
+            shards[i].file->sync();
+        }
+    }
+    logThreadDoneMutex.lock();
+    tickClock.lockForFork();
+    if (rk::shm_internal::RingWriter* ring = ringWriter.load()) {
+        ring->prepareForFork();
+    }
+}
+
+void Logger::unlockAfterFork() {
+    tickClock.unlockAfterFork();
+    logThreadDoneMutex.unlock();
+    for (size_t i = 0; i < shardCount.load(); i++) {
+        shards[i].fileMutex.unlock();
+        shards[i].queueMutex.unlock();
+    }
+    orderedWriter.mutex.unlock();
+    sinksMutex.unlock();
+    levelMutex.unlock();
+    lifecycleMutex.unlock();
+}
+
+/**
+ * The records that were queued in the parent are written by the parent, so the child drops its copy of them. They are
+ * leaked rather than destroyed, since freeing them would copy every page that they are on from the parent. The
+ * condition variables are recreated, since they may still count the parent's log threads as waiters, and those
+ * threads don't exist in the child. So are the locks of the shards that weren't locked for the fork.
+ */
+void Logger::restartAfterFork() {
+    for (size_t i = 0; i < rk::config::log_shards::MAX_COUNT; i++) {
+        if (!shards[i].queue.empty()) {
+            static_cast<void>(new std::vector<Record>(std::move(shards[i].queue)));
+            shards[i].queue = std::vector<Record>();
+        }
+        new (&shards[i].queueCv) std::condition_variable();
+        if (i >= shardCount.load()) {
+            new (&shards[i].queueMutex) std::mutex();
+            new (&shards[i].fileMutex) std::mutex();
+        }
+    }
+    if (!orderedWriter.incoming.empty()) {
+        static_cast<void>(new std::vector<FormattedRecord>(std::move(orderedWriter.incoming)));
+        orderedWriter.incoming = std::vector<FormattedRecord>();
+    }
+    new (&orderedWriter.cv) std::condition_variable();
+    new (&logThreadDoneCv) std::condition_variable();
+
+    std::lock_guard<std::mutex> lock(lifecycleMutex);
+    if (!isStarted) {
+        return;
+    }
+#if defined(__unix__) || defined(__APPLE__)
+    const std::string processId = std::to_string(getpid());
+    rk::log_internal::rkLogInternal("Restarting RK Logger \"", name, "\" in process ", processId, "\n");
+    leakThreadOfParent(std::move(ownedLogThread));
+    isRingInherited = ringWriter.load() != nullptr;
+    if (isRingInherited && !ringWriter.load()->restartAfterFork()) {
+        rk::log_internal::rkLogInternal("Too many processes write to the shared memory ring. rk_log_agent may finish before this one does\n");
+    }
+    {
+        std::lock_guard<std::mutex> sinksLock(sinksMutex);
+        if (flightRecorder) {
+            flightRecorder->clear();
+        }
+    }
+
+    // The frames of a compressed log file can't be interleaved with the parent's, and neither can the offsets in the
+    // index of an indexed one, so those are always per process
+    const bool isFilePerProcess = !isRingInherited &&
+        config.getConfigValueByKey(rk::config::write_to_log_file::KEY) == rk::config::write_to_log_file::ENABLE &&
+        (config.getConfigValueByKey(rk::config::fork_log_file::KEY) == rk::config::fork_log_file::PER_PID || isLogFileCompressed || isLogFileIndexed);
+    if (isFilePerProcess) {
+        {
+            std::lock_guard<std::mutex> sinksLock(sinksMutex);
+            configuredSinks.erase(std::remove(configuredSinks.begin(), configuredSinks.end(), sharedLogFile), configuredSinks.end());
+            sharedLogFile.reset();
+            for (size_t i = 0; i < rk::config::log_shards::MAX_COUNT; i++) {
+                shards[i].file.reset();
+            }
+        }
+        try {
+            openLogFile("_pid" + processId);
+        }
+        catch (...) {
+            rk::log_internal::rkLogInternal("Unable to open the log file of process ", processId, ". Writing to the other sinks only\n");
+        }
+    }
+
+    endLogLoop = false;
+    drainDeadlineNs = INT64_MAX;
+    {
+        std::lock_guard<std::mutex> doneLock(logThreadDoneMutex);
+        isLogThreadDone = false;
+    }
+    ownedLogThread = startLogThread();
+    isRestartedAfterFork = true;
+#endif
 }
 
-void openLogFile() {
-    std::string timeStamp = rk::time_internal::generateTimeStamp(rk::time_internal::system_clock::now());
+void Logger::writeToSinks(const std::string& message, const MessageInfo& info) {
+    for (const auto& sink : configuredSinks) {
+        sink->writeWithInfo(message, info);
+    }
+    for (const auto& sink : addedSinks) {
+        sink->writeWithInfo(message, info);
+    }
+}
+
+/**
+ * The idle flush interval is the frame time of a compressed log file, so a frame is finished within about twice the
+ * frame time of being started, even if nothing else gets logged.
+ */
+std::chrono::milliseconds Logger::getPollInterval(const bool isPollingSignal, const bool isFlushingWhenIdle) const {
+    if (isPollingSignal && isFlushingWhenIdle) {
+        return std::min(SIGNAL_POLL_INTERVAL, idleFlushInterval);
+    }
+    return isPollingSignal ? SIGNAL_POLL_INTERVAL : idleFlushInterval;
+}
+
+void Logger::flushSinks() {
+    for (const auto& sink : configuredSinks) {
+        sink->flush();
+    }
+    for (const auto& sink : addedSinks) {
+        sink->flush();
+    }
+}
+
+/**
+ * The flight recorder sees every message that reaches the log thread, including the ones that are only logged for
+ * it. Dumping on the trigger right away means the dump ends with the message that caused it.
+ */
+void Logger::recordMessage(const RecordedMessage& message) {
+    if (!flightRecorder) {
+        return;
+    }
+    if (message.level >= flightRecorderLevel) {
+        flightRecorder->write(message);
+    }
+    if (flightRecorderTrigger != Level::Off && message.level >= flightRecorderTrigger) {
+        writeFlightRecorderDump();
+    }
+}
+
+bool Logger::hasPendingSignal() const {
+    return isSignalDumpEnabled && dumpSignalCount.load(std::memory_order_relaxed) != handledSignalCount;
+}
+
+bool Logger::takePendingSignal() {
+    const bool isPending = hasPendingSignal();
+    handledSignalCount = dumpSignalCount.load(std::memory_order_relaxed);
+    return isPending;
+}
+
+/**
+ * The dumps are numbered, so several dumps within the same second of the timestamp don't overwrite each other. Like
+ * the log file, the name includes the logger's name unless it is the default logger. This runs on the log thread,
+ * so only failures are printed.
+ *
+ * The recorder only keeps the messages, so their prefixes are formatted here, the same way as for the sinks. Ticks are
+ * converted with the current calibration, which is at most a recalibration away from the one they were logged under.
+ */
+void Logger::writeFlightRecorderDump() {
+    if (!flightRecorder) {
+        rk::log_internal::rkLogInternal("Unable to dump the flight recorder because it is not enabled\n");
+        return;
+    }
+
+    std::string timeStamp = timeStampFormatter.generateTimeStamp(rk::time_internal::system_clock::now());
     timeStamp = rk::time_internal::convertTimeStampForFileName(timeStamp);
-    const std::string logFileName = std::string("logs_") + timeStamp + ".txt";
-    rkLogInternal("Writing to log file: ", logFileName, "\n");
-    logFile.open(logFileName);
+    const std::string namePrefix = (name == DEFAULT_LOGGER_NAME) ? "" : name + "_";
+    const std::string fileName = "flight_recorder_" + namePrefix + timeStamp + "_" + std::to_string(dumpCount++) + ".txt";
+    std::ofstream file(fileName, std::ios::binary);
+    if (!file) {
+        rk::log_internal::rkLogInternal("Unable to open the flight recorder dump file: ", fileName, "\n");
+        return;
+    }
+    const rk::time_internal::TickCalibration calibration = tickClock.getCalibration();
+    std::string line;
+    flightRecorder->forEach([this, &calibration, &line, &file] (const RecordedMessage& message) {
+        const rk::time_internal::time_point time = message.ticks != 0 ? calibration.toTimePoint(message.ticks) : message.time;
+        size_t threadIdOffset = 0;
+        line.clear();
+        appendPrefix(time, message.threadId, message.funcName, line, threadIdOffset);
+        line += message.message;
+        file.write(line.data(), static_cast<std::streamsize>(line.size()));
+    });
+    flightRecorder->clear();
+}
+
+/**
+ * Turning logging off raises the threshold above every level that a message can have, so the macros need no separate
+ * check for it. The call sites work out their level again the next time they log.
+ */
+void Logger::updateThreshold() {
+    sinkThreshold = (!isLoggingEnabled || level == Level::Off) ? NOTHING_ENABLED : static_cast<uint8_t>(level);
+    threshold = addFlightRecorderLevel(sinkThreshold.load());
+
+    std::lock_guard<std::mutex> lock(callSiteMutex);
+    for (rk::log_internal::CallSite* site = callSites; site != nullptr; site = site->next) {
+        site->cached.store(0, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * The threshold is resolved and cached while holding levelMutex, so a level that changes in between can't be
+ * overwritten by a stale threshold. A call site that has never been cached is claimed by this logger.
+ */
+bool Logger::isEnabledSlow(const Level messageLevel, rk::log_internal::CallSite& site) {
+    std::lock_guard<std::mutex> levelLock(levelMutex);
+    const uint8_t siteSinkThreshold = resolveThreshold(site);
+    const uint8_t siteThreshold = addFlightRecorderLevel(siteSinkThreshold);
+    {
+        std::lock_guard<std::mutex> siteLock(callSiteMutex);
+        if (site.ownerId == 0) {
+            site.ownerId = id;
+            site.next = callSites;
+            callSites = &site;
+        }
+        if (site.ownerId == id) {
+            const uint64_t cached = (static_cast<uint64_t>(id) << rk::log_internal::CallSite::LOGGER_ID_SHIFT) |
+                (static_cast<uint64_t>(siteSinkThreshold) << rk::log_internal::CallSite::SINK_THRESHOLD_SHIFT) | siteThreshold;
+            site.cached.store(cached, std::memory_order_relaxed);
+        }
+    }
+    return static_cast<uint8_t>(messageLevel) >= siteThreshold;
 }
 
-void closeLogFile() {
-    logFile.close();
+bool Logger::isForSinksSlow(const Level messageLevel, const rk::log_internal::CallSite& site) const {
+    std::lock_guard<std::mutex> lock(levelMutex);
+    return static_cast<uint8_t>(messageLevel) >= resolveThreshold(site);
 }
 
-void verifyLogFile() {
-    if (!logFile) {
-        rkLogInternal("Unable to open output log file\n");
-        throw -1;
+/**
+ * The module tag takes precedence over the file name, so a file can contain statements for several modules.
+ */
+uint8_t Logger::resolveThreshold(const rk::log_internal::CallSite& site) const {
+    if (!isLoggingEnabled) {
+        return NOTHING_ENABLED;
     }
+    Level siteLevel = level;
+    if (!moduleLevels.empty()) {
+        auto iter = site.module != nullptr ? moduleLevels.find(site.module) : moduleLevels.end();
+        if (iter == moduleLevels.end() && site.file != nullptr) {
+            iter = moduleLevels.find(getFileName(site.file));
+        }
+        if (iter != moduleLevels.end()) {
+            siteLevel = iter->second;
+        }
+    }
+    return siteLevel == Level::Off ? NOTHING_ENABLED : static_cast<uint8_t>(siteLevel);
 }
 
-void enableAutoFlush() {
-    std::cout << std::unitbuf;
+/**
+ * Turning logging off also stops the flight recorder, so it takes precedence over the flight recorder's level.
+ */
+uint8_t Logger::addFlightRecorderLevel(const uint8_t siteSinkThreshold) const {
+    return isLoggingEnabled ? std::min(siteSinkThreshold, flightRecorderThreshold) : NOTHING_ENABLED;
 }
 
-void disableAutoFlush() {
-    std::cout << std::nounitbuf;
+Logger& getDefaultLogger() {
+    static Logger logger(DEFAULT_LOGGER_NAME, rk::config::getInstance(), rk::time_internal::getDefaultFormatter());
+    return logger;
 }
 
-} // namespace log_internal
+Logger& getLogger(const std::string& name) {
+    if (name == DEFAULT_LOGGER_NAME) {
+        return getDefaultLogger();
+    }
+
+    static std::mutex loggersMutex;
+    static std::unordered_map<std::string, std::unique_ptr<Logger>> loggers;
+    std::lock_guard<std::mutex> lock(loggersMutex);
+    std::unique_ptr<Logger>& logger = loggers[name];
+    if (!logger) {
+        logger = std::make_unique<Logger>(name);
+    }
+
+    return *logger;
+}
+
+std::thread startLogger(const std::filesystem::path& configPath) {
+    return getDefaultLogger().start(configPath);
+}
+
+void dumpFlightRecorder() {
+    getDefaultLogger().dumpFlightRecorder();
+}
+
+void stopLogger(std::thread logThread) {
+    getDefaultLogger().stop(std::move(logThread));
+}
+
+/**
+ * The list is copied, since stopping a logger removes it from the list.
+ */
+void stopAllLoggers() {
+    std::vector<Logger*> runningLoggers;
+    {
+        std::lock_guard<std::mutex> lock(runningLoggersMutex);
+        runningLoggers = getRunningLoggers();
+    }
+    for (Logger* logger : runningLoggers) {
+        logger->stop();
+    }
+}
+
+ScopedLogger::ScopedLogger(Logger& logger, const std::filesystem::path& configPath) : logger(logger) {
+    logger.startOwned(configPath);
+}
+
+ScopedLogger::ScopedLogger(const std::filesystem::path& configPath) : ScopedLogger(getDefaultLogger(), configPath) {}
+
+ScopedLogger::~ScopedLogger() {
+    logger.stop();
+}
+
+} // namespace log
 } // namespace rk
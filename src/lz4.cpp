@@ -0,0 +1,697 @@
+/**
+ * @file lz4.cpp
+ * @brief Source file for the LZ4 compressor and decompressor that compressed log files are written and read with.
+ */
+#include <algorithm>
+#include <cstring>
+
+#include <rk_logger/lz4.h>
+
+namespace rk {
+namespace lz4_internal {
+
+namespace {
+
+constexpr uint32_t PRIME1 = 2654435761U;
+constexpr uint32_t PRIME2 = 2246822519U;
+constexpr uint32_t PRIME3 = 3266489917U;
+constexpr uint32_t PRIME4 = 668265263U;
+constexpr uint32_t PRIME5 = 374761393U;
+constexpr size_t STRIPE_SIZE = 16; /**< The data that XXH32 takes in at a time */
+
+constexpr size_t MIN_MATCH = 4;
+constexpr size_t LAST_LITERALS = 5; /**< The last bytes of a block are always literals */
+constexpr size_t MATCH_FIND_LIMIT = 12; /**< A match can't start in the last bytes of a block */
+constexpr size_t MAX_TOKEN_LENGTH = 15; /**< Lengths from this on continue in extra bytes after the token */
+constexpr int HASH_LOG = 16;
+constexpr size_t HASH_TABLE_SIZE = size_t(1) << HASH_LOG;
+constexpr size_t CHAIN_TABLE_SIZE = MAX_DISTANCE + 1;
+constexpr int SKIP_TRIGGER = 6; /**< The fast level looks at fewer positions the longer it goes without a match */
+constexpr int LAZY_LEVEL = 4; /**< From this level on, a match is dropped if the next position has a longer one */
+constexpr uint32_t MAX_POSITION = 0x80000000U;
+constexpr size_t COPY_SIZE = 16; /**< Short copies while decoding are done with this fixed size when there is room */
+
+constexpr uint32_t UNCOMPRESSED_BLOCK_FLAG = 0x80000000U;
+constexpr unsigned char FRAME_FLAGS = 0x60; // Version 01, independent blocks, no checksums, no content size
+constexpr unsigned char BLOCK_DESCRIPTOR = 0x50; // Blocks of up to 256 KB
+constexpr unsigned char FLAG_INDEPENDENT_BLOCKS = 0x20;
+constexpr unsigned char FLAG_BLOCK_CHECKSUM = 0x10;
+constexpr unsigned char FLAG_CONTENT_SIZE = 0x08;
+constexpr unsigned char FLAG_CONTENT_CHECKSUM = 0x04;
+constexpr unsigned char FLAG_RESERVED = 0x02;
+constexpr unsigned char FLAG_DICTIONARY_ID = 0x01;
+constexpr unsigned char DESCRIPTOR_RESERVED = 0x8F;
+constexpr unsigned MIN_BLOCK_SIZE_ID = 4; /**< 64 KB. Ids 4 to 7 are 64 KB, 256 KB, 1 MB, and 4 MB */
+
+uint32_t rotateLeft(const uint32_t value, const int bits) {
+    return (value << bits) | (value >> (32 - bits));
+}
+
+uint32_t readLe32(const unsigned char* data) {
+    return static_cast<uint32_t>(data[0]) | (static_cast<uint32_t>(data[1]) << 8) |
+        (static_cast<uint32_t>(data[2]) << 16) | (static_cast<uint32_t>(data[3]) << 24);
+}
+
+uint64_t readLe64(const unsigned char* data) {
+    return static_cast<uint64_t>(readLe32(data)) | (static_cast<uint64_t>(readLe32(data + 4)) << 32);
+}
+
+void writeLe32(unsigned char* out, const uint32_t value) {
+    out[0] = static_cast<unsigned char>(value);
+    out[1] = static_cast<unsigned char>(value >> 8);
+    out[2] = static_cast<unsigned char>(value >> 16);
+    out[3] = static_cast<unsigned char>(value >> 24);
+}
+
+/**
+ * Reads in the machine's byte order, for hashing and comparing bytes where the order doesn't matter.
+ */
+uint32_t read32(const unsigned char* data) {
+    uint32_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+uint64_t read64(const unsigned char* data) {
+    uint64_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+uint32_t hashPosition(const unsigned char* data) {
+    return (read32(data) * PRIME1) >> (32 - HASH_LOG);
+}
+
+void consumeStripe(uint32_t* accumulators, const unsigned char* stripe) {
+    for (int i = 0; i < 4; i++) {
+        accumulators[i] = rotateLeft(accumulators[i] + readLe32(stripe + i * 4) * PRIME2, 13) * PRIME1;
+    }
+}
+
+/**
+ * Compares eight bytes at a time. On little-endian machines, the lowest differing bit of the XOR is in the first
+ * differing byte.
+ */
+size_t countMatch(const unsigned char* data, const unsigned char* match, const unsigned char* limit) {
+    const unsigned char* const start = data;
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    while (data + sizeof(uint64_t) <= limit) {
+        const uint64_t difference = read64(data) ^ read64(match);
+        if (difference != 0) {
+            return static_cast<size_t>(data - start) + static_cast<size_t>(__builtin_ctzll(difference) >> 3);
+        }
+        data += sizeof(uint64_t);
+        match += sizeof(uint64_t);
+    }
+#endif
+    while (data < limit && *data == *match) {
+        data++;
+        match++;
+    }
+    return static_cast<size_t>(data - start);
+}
+
+unsigned char* writeExtraLength(unsigned char* out, size_t length) {
+    while (length >= 255) {
+        *out++ = 255;
+        length -= 255;
+    }
+    *out++ = static_cast<unsigned char>(length);
+    return out;
+}
+
+unsigned char* writeSequence(unsigned char* out, const unsigned char* literals, const size_t literalCount, const size_t offset, const size_t matchLength) {
+    unsigned char* const token = out++;
+    const size_t matchCode = matchLength - MIN_MATCH;
+    *token = static_cast<unsigned char>((std::min(literalCount, MAX_TOKEN_LENGTH) << 4) | std::min(matchCode, MAX_TOKEN_LENGTH));
+    if (literalCount >= MAX_TOKEN_LENGTH) {
+        out = writeExtraLength(out, literalCount - MAX_TOKEN_LENGTH);
+    }
+    std::memcpy(out, literals, literalCount);
+    out += literalCount;
+    *out++ = static_cast<unsigned char>(offset);
+    *out++ = static_cast<unsigned char>(offset >> 8);
+    if (matchCode >= MAX_TOKEN_LENGTH) {
+        out = writeExtraLength(out, matchCode - MAX_TOKEN_LENGTH);
+    }
+    return out;
+}
+
+unsigned char* writeLastLiterals(unsigned char* out, const unsigned char* literals, const size_t literalCount) {
+    *out++ = static_cast<unsigned char>(std::min(literalCount, MAX_TOKEN_LENGTH) << 4);
+    if (literalCount >= MAX_TOKEN_LENGTH) {
+        out = writeExtraLength(out, literalCount - MAX_TOKEN_LENGTH);
+    }
+    std::memcpy(out, literals, literalCount);
+    return out + literalCount;
+}
+
+void appendFrameHeader(std::string& out) {
+    const unsigned char descriptor[2] = { FRAME_FLAGS, BLOCK_DESCRIPTOR };
+    unsigned char header[7];
+    writeLe32(header, FRAME_MAGIC);
+    header[4] = descriptor[0];
+    header[5] = descriptor[1];
+    header[6] = static_cast<unsigned char>(xxh32(descriptor, sizeof(descriptor)) >> 8);
+    out.append(reinterpret_cast<const char*>(header), sizeof(header));
+}
+
+} // namespace
+
+Xxh32::Xxh32(const uint32_t seed) : accumulators{ seed + PRIME1 + PRIME2, seed + PRIME2, seed, seed - PRIME1 }, seed(seed) {}
+
+void Xxh32::update(const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    totalSize += size;
+    if (bufferSize + size < STRIPE_SIZE) {
+        std::memcpy(buffer + bufferSize, bytes, size);
+        bufferSize += size;
+        return;
+    }
+    if (bufferSize > 0) {
+        const size_t fill = STRIPE_SIZE - bufferSize;
+        std::memcpy(buffer + bufferSize, bytes, fill);
+        consumeStripe(accumulators, buffer);
+        bytes += fill;
+        size -= fill;
+        bufferSize = 0;
+    }
+    for (; size >= STRIPE_SIZE; bytes += STRIPE_SIZE, size -= STRIPE_SIZE) {
+        consumeStripe(accumulators, bytes);
+    }
+    std::memcpy(buffer, bytes, size);
+    bufferSize = size;
+}
+
+uint32_t Xxh32::digest() const {
+    uint32_t hash = totalSize >= STRIPE_SIZE ?
+        rotateLeft(accumulators[0], 1) + rotateLeft(accumulators[1], 7) + rotateLeft(accumulators[2], 12) + rotateLeft(accumulators[3], 18) :
+        seed + PRIME5;
+    hash += static_cast<uint32_t>(totalSize);
+    size_t i = 0;
+    for (; i + 4 <= bufferSize; i += 4) {
+        hash = rotateLeft(hash + readLe32(buffer + i) * PRIME3, 17) * PRIME4;
+    }
+    for (; i < bufferSize; i++) {
+        hash = rotateLeft(hash + buffer[i] * PRIME5, 11) * PRIME1;
+    }
+    hash ^= hash >> 15;
+    hash *= PRIME2;
+    hash ^= hash >> 13;
+    hash *= PRIME3;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+uint32_t xxh32(const void* data, const size_t size, const uint32_t seed) {
+    Xxh32 hash(seed);
+    hash.update(data, size);
+    return hash.digest();
+}
+
+/**
+ * The chain table is only needed by the levels above the fastest one.
+ */
+BlockCompressor::BlockCompressor(const int level) : level(std::clamp(level, MIN_LEVEL, MAX_LEVEL)), hashTable(HASH_TABLE_SIZE, 0) {
+    if (this->level > MIN_LEVEL) {
+        chainTable.resize(CHAIN_TABLE_SIZE, 0);
+    }
+}
+
+size_t BlockCompressor::compress(const char* data, const size_t size, char* out) {
+    startBlock(size);
+    const unsigned char* const source = reinterpret_cast<const unsigned char*>(data);
+    unsigned char* const destination = reinterpret_cast<unsigned char*>(out);
+    const size_t written = level == MIN_LEVEL ? compressFast(source, size, destination) : compressChained(source, size, destination);
+    blockStart += static_cast<uint32_t>(size);
+    return written;
+}
+
+int BlockCompressor::getLevel() const {
+    return level;
+}
+
+void BlockCompressor::startBlock(const size_t size) {
+    if (size >= MAX_POSITION - blockStart) {
+        std::fill(hashTable.begin(), hashTable.end(), 0);
+        std::fill(chainTable.begin(), chainTable.end(), 0);
+        blockStart = 1;
+    }
+}
+
+/**
+ * Each position is only compared against the last earlier position with the same hash. The further it gets from the
+ * last match, the more positions it skips, so data that doesn't compress goes through quickly.
+ */
+size_t BlockCompressor::compressFast(const unsigned char* data, const size_t size, unsigned char* out) {
+    unsigned char* op = out;
+    const unsigned char* anchor = data;
+    if (size > MATCH_FIND_LIMIT) {
+        const unsigned char* const matchFindEnd = data + size - MATCH_FIND_LIMIT;
+        const unsigned char* const matchEnd = data + size - LAST_LITERALS;
+        auto positionOf = [this, data] (const unsigned char* p) { return blockStart + static_cast<uint32_t>(p - data); };
+
+        hashTable[hashPosition(data)] = positionOf(data);
+        const unsigned char* ip = data + 1;
+        while (ip <= matchFindEnd) {
+            const unsigned char* match = nullptr;
+            while (ip <= matchFindEnd) {
+                const uint32_t hash = hashPosition(ip);
+                const uint32_t candidate = hashTable[hash];
+                const uint32_t position = positionOf(ip);
+                hashTable[hash] = position;
+                if (candidate >= blockStart && position - candidate <= MAX_DISTANCE && read32(data + (candidate - blockStart)) == read32(ip)) {
+                    match = data + (candidate - blockStart);
+                    break;
+                }
+                ip += 1 + (static_cast<size_t>(ip - anchor) >> SKIP_TRIGGER);
+            }
+            if (match == nullptr) {
+                break;
+            }
+
+            while (ip > anchor && match > data && ip[-1] == match[-1]) {
+                ip--;
+                match--;
+            }
+            const size_t length = MIN_MATCH + countMatch(ip + MIN_MATCH, match + MIN_MATCH, matchEnd);
+            op = writeSequence(op, anchor, static_cast<size_t>(ip - anchor), static_cast<size_t>(ip - match), length);
+            ip += length;
+            anchor = ip;
+            if (ip <= matchFindEnd) {
+                hashTable[hashPosition(ip - 2)] = positionOf(ip - 2);
+            }
+        }
+    }
+    return static_cast<size_t>(writeLastLiterals(op, anchor, static_cast<size_t>(data + size - anchor)) - out);
+}
+
+/**
+ * Every position is added to a hash chain, and up to 2^(level - 1) earlier positions with the same hash are compared
+ * to find the longest match. From LAZY_LEVEL on, a match is put off by one position while the next one is longer.
+ */
+size_t BlockCompressor::compressChained(const unsigned char* data, const size_t size, unsigned char* out) {
+    unsigned char* op = out;
+    const unsigned char* anchor = data;
+    if (size > MATCH_FIND_LIMIT) {
+        const unsigned char* const matchFindEnd = data + size - MATCH_FIND_LIMIT;
+        const unsigned char* const matchEnd = data + size - LAST_LITERALS;
+        const int maxAttempts = 1 << (level - 1);
+        auto positionOf = [this, data] (const unsigned char* p) { return blockStart + static_cast<uint32_t>(p - data); };
+
+        const unsigned char* nextToInsert = data;
+        auto findMatch = [&] (const unsigned char* p, const unsigned char*& match) {
+            for (; nextToInsert < p; nextToInsert++) {
+                const uint32_t position = positionOf(nextToInsert);
+                const uint32_t hash = hashPosition(nextToInsert);
+                const uint32_t distance = position - hashTable[hash];
+                chainTable[position & MAX_DISTANCE] = static_cast<uint16_t>(distance > MAX_DISTANCE ? 0 : distance);
+                hashTable[hash] = position;
+            }
+
+            const uint32_t position = positionOf(p);
+            uint32_t candidate = hashTable[hashPosition(p)];
+            size_t best = 0;
+            for (int attempt = 0; attempt < maxAttempts && candidate >= blockStart && position - candidate <= MAX_DISTANCE; attempt++) {
+                const unsigned char* const candidateData = data + (candidate - blockStart);
+                const bool canBeLonger = best == 0 || (p + best < matchEnd && candidateData[best] == p[best]);
+                if (canBeLonger && read32(candidateData) == read32(p)) {
+                    const size_t length = MIN_MATCH + countMatch(p + MIN_MATCH, candidateData + MIN_MATCH, matchEnd);
+                    if (length > best) {
+                        best = length;
+                        match = candidateData;
+                    }
+                }
+                const uint16_t step = chainTable[candidate & MAX_DISTANCE];
+                if (step == 0 || step > candidate - blockStart) {
+                    break;
+                }
+                candidate -= step;
+            }
+            return best;
+        };
+
+        const unsigned char* ip = data;
+        while (ip <= matchFindEnd) {
+            const unsigned char* match = nullptr;
+            size_t length = findMatch(ip, match);
+            if (length == 0) {
+                ip++;
+                continue;
+            }
+            if (level >= LAZY_LEVEL) {
+                while (ip < matchFindEnd) {
+                    const unsigned char* nextMatch = nullptr;
+                    const size_t nextLength = findMatch(ip + 1, nextMatch);
+                    if (nextLength <= length) {
+                        break;
+                    }
+                    ip++;
+                    match = nextMatch;
+                    length = nextLength;
+                }
+            }
+            op = writeSequence(op, anchor, static_cast<size_t>(ip - anchor), static_cast<size_t>(ip - match), length);
+            ip += length;
+            anchor = ip;
+        }
+    }
+    return static_cast<size_t>(writeLastLiterals(op, anchor, static_cast<size_t>(data + size - anchor)) - out);
+}
+
+/**
+ * Every length and offset is checked against what is left of the input and the output before it is used.
+ */
+bool decompressBlock(const char* data, const size_t size, const size_t maxSize, std::string& out, const size_t historySize) {
+    const size_t start = out.size();
+    out.resize(start + maxSize);
+    unsigned char* const base = reinterpret_cast<unsigned char*>(out.data());
+    unsigned char* op = base + start;
+    unsigned char* const outEnd = op + maxSize;
+    const unsigned char* const lowest = base + start - std::min(historySize, start);
+    const unsigned char* ip = reinterpret_cast<const unsigned char*>(data);
+    const unsigned char* const inEnd = ip + size;
+
+    auto readExtraLength = [&ip, inEnd] (size_t& length) {
+        unsigned char byte = 0;
+        do {
+            if (ip >= inEnd) {
+                return false;
+            }
+            byte = *ip++;
+            length += byte;
+        } while (byte == 255);
+        return true;
+    };
+
+    bool isValid = false;
+    while (ip < inEnd) {
+        const unsigned char token = *ip++;
+        size_t literalCount = token >> 4;
+        if (literalCount == MAX_TOKEN_LENGTH && !readExtraLength(literalCount)) {
+            break;
+        }
+        if (literalCount > static_cast<size_t>(inEnd - ip) || literalCount > static_cast<size_t>(outEnd - op)) {
+            break;
+        }
+        if (literalCount <= COPY_SIZE && inEnd - ip >= static_cast<ptrdiff_t>(COPY_SIZE) && outEnd - op >= static_cast<ptrdiff_t>(COPY_SIZE)) {
+            std::memcpy(op, ip, COPY_SIZE); // Most literal runs are short, and a fixed size copy is much faster
+        }
+        else {
+            std::memcpy(op, ip, literalCount);
+        }
+        op += literalCount;
+        ip += literalCount;
+        if (ip == inEnd) {
+            isValid = true; // The last sequence only has literals
+            break;
+        }
+
+        if (inEnd - ip < 2) {
+            break;
+        }
+        const size_t offset = static_cast<size_t>(ip[0]) | (static_cast<size_t>(ip[1]) << 8);
+        ip += 2;
+        size_t matchLength = token & MAX_TOKEN_LENGTH;
+        if (matchLength == MAX_TOKEN_LENGTH && !readExtraLength(matchLength)) {
+            break;
+        }
+        matchLength += MIN_MATCH;
+        if (offset == 0 || offset > static_cast<size_t>(op - lowest) || matchLength > static_cast<size_t>(outEnd - op)) {
+            break;
+        }
+        const unsigned char* match = op - offset;
+        if (offset >= COPY_SIZE && static_cast<size_t>(outEnd - op) >= matchLength + COPY_SIZE) {
+            for (size_t i = 0; i < matchLength; i += COPY_SIZE) {
+                std::memcpy(op + i, match + i, COPY_SIZE); // Can write past the match, which the next sequence overwrites
+            }
+            op += matchLength;
+        }
+        else if (offset >= matchLength) {
+            std::memcpy(op, match, matchLength);
+            op += matchLength;
+        }
+        else {
+            for (size_t i = 0; i < matchLength; i++) {
+                *op++ = *match++; // The match overlaps what it writes, e.g., a run of one repeated byte
+            }
+        }
+    }
+
+    out.resize(isValid ? static_cast<size_t>(op - base) : start);
+    return isValid;
+}
+
+FrameEncoder::FrameEncoder(const int level) : compressor(level) {
+    pending.reserve(BLOCK_SIZE);
+}
+
+/**
+ * Data that fills a whole block on its own is compressed without being copied.
+ */
+void FrameEncoder::write(std::string_view data, std::string& out) {
+    if (!isOpen) {
+        appendFrameHeader(out);
+        isOpen = true;
+    }
+    while (!data.empty()) {
+        if (pending.empty() && data.size() >= BLOCK_SIZE) {
+            writeBlock(data.data(), BLOCK_SIZE, out);
+            data.remove_prefix(BLOCK_SIZE);
+            continue;
+        }
+        const size_t count = std::min(data.size(), BLOCK_SIZE - pending.size());
+        pending.append(data.data(), count);
+        data.remove_prefix(count);
+        if (pending.size() == BLOCK_SIZE) {
+            writeBlock(pending.data(), pending.size(), out);
+            pending.clear();
+        }
+    }
+}
+
+void FrameEncoder::finishFrame(std::string& out) {
+    if (!isOpen) {
+        return;
+    }
+    if (!pending.empty()) {
+        writeBlock(pending.data(), pending.size(), out);
+        pending.clear();
+    }
+    const unsigned char endMark[4] = { 0, 0, 0, 0 };
+    out.append(reinterpret_cast<const char*>(endMark), sizeof(endMark));
+    isOpen = false;
+}
+
+bool FrameEncoder::isFrameOpen() const {
+    return isOpen;
+}
+
+/**
+ * A block that doesn't get smaller is stored as it is, which the block size marks with its highest bit.
+ */
+void FrameEncoder::writeBlock(const char* data, const size_t size, std::string& out) {
+    const size_t headerAt = out.size();
+    out.resize(headerAt + sizeof(uint32_t) + getMaxCompressedSize(size));
+    char* const blockData = &out[headerAt + sizeof(uint32_t)];
+    size_t blockSize = compressor.compress(data, size, blockData);
+    uint32_t header = static_cast<uint32_t>(blockSize);
+    if (blockSize >= size) {
+        std::memcpy(blockData, data, size);
+        blockSize = size;
+        header = static_cast<uint32_t>(size) | UNCOMPRESSED_BLOCK_FLAG;
+    }
+    writeLe32(reinterpret_cast<unsigned char*>(&out[headerAt]), header);
+    out.resize(headerAt + sizeof(uint32_t) + blockSize);
+}
+
+bool FrameDecoder::decode(const char* data, const size_t size, std::string& out) {
+    if (!error.empty()) {
+        return false;
+    }
+    input.append(data, size);
+    size_t position = 0;
+    while (position < input.size()) {
+        const size_t used = step(reinterpret_cast<const unsigned char*>(input.data()) + position, input.size() - position, out);
+        if (used == 0) {
+            break;
+        }
+        position += used;
+    }
+    input.erase(0, position);
+    return error.empty();
+}
+
+bool FrameDecoder::isAtFrameBoundary() const {
+    return stage == Stage::Magic && input.empty();
+}
+
+const std::string& FrameDecoder::getError() const {
+    return error;
+}
+
+size_t FrameDecoder::step(const unsigned char* data, const size_t size, std::string& out) {
+    switch (stage) {
+        case Stage::Magic: {
+            if (size < 4) {
+                return 0;
+            }
+            const uint32_t magic = readLe32(data);
+            if (magic == FRAME_MAGIC) {
+                stage = Stage::Header;
+            }
+            else if ((magic & 0xFFFFFFF0U) == SKIPPABLE_FRAME_MAGIC) {
+                stage = Stage::SkippableSize;
+            }
+            else {
+                return fail("Not an LZ4 frame");
+            }
+            return 4;
+        }
+        case Stage::SkippableSize:
+            if (size < 4) {
+                return 0;
+            }
+            skipRemaining = readLe32(data);
+            stage = skipRemaining == 0 ? Stage::Magic : Stage::Skip;
+            return 4;
+        case Stage::Skip: {
+            const size_t used = static_cast<size_t>(std::min<uint64_t>(size, skipRemaining));
+            skipRemaining -= used;
+            if (skipRemaining == 0) {
+                stage = Stage::Magic;
+            }
+            return used;
+        }
+        case Stage::Header:
+            return parseHeader(data, size);
+        case Stage::BlockSize: {
+            if (size < 4) {
+                return 0;
+            }
+            const uint32_t value = readLe32(data);
+            if (value == 0) {
+                if (hasContentChecksum) {
+                    stage = Stage::ContentChecksum;
+                }
+                else if (!finishFrame()) {
+                    return 0;
+                }
+                return 4;
+            }
+            blockSize = value & ~UNCOMPRESSED_BLOCK_FLAG;
+            isBlockCompressed = (value & UNCOMPRESSED_BLOCK_FLAG) == 0;
+            if (blockSize > maxBlockSize) {
+                return fail("A block is larger than the frame allows");
+            }
+            stage = Stage::Block;
+            return 4;
+        }
+        case Stage::Block:
+            return decodeBlock(data, size, out);
+        case Stage::ContentChecksum:
+            if (size < 4) {
+                return 0;
+            }
+            if (readLe32(data) != contentHash.digest()) {
+                return fail("The content checksum doesn't match");
+            }
+            return finishFrame() ? 4 : 0;
+    }
+    return 0;
+}
+
+size_t FrameDecoder::parseHeader(const unsigned char* data, const size_t size) {
+    if (size < 2) {
+        return 0;
+    }
+    const unsigned char flags = data[0];
+    const unsigned char descriptor = data[1];
+    const size_t headerSize = 2 + ((flags & FLAG_CONTENT_SIZE) != 0 ? 8 : 0) + ((flags & FLAG_DICTIONARY_ID) != 0 ? 4 : 0) + 1;
+    if (size < headerSize) {
+        return 0;
+    }
+    if ((flags >> 6) != 1) {
+        return fail("Unsupported LZ4 frame version");
+    }
+    if ((flags & FLAG_RESERVED) != 0 || (descriptor & DESCRIPTOR_RESERVED) != 0) {
+        return fail("Reserved bits are set in the frame header");
+    }
+    if ((flags & FLAG_DICTIONARY_ID) != 0) {
+        return fail("Frames with a dictionary aren't supported");
+    }
+    const unsigned blockSizeId = (descriptor >> 4) & 0x07;
+    if (blockSizeId < MIN_BLOCK_SIZE_ID) {
+        return fail("Invalid maximum block size");
+    }
+    if (static_cast<unsigned char>(xxh32(data, headerSize - 1) >> 8) != data[headerSize - 1]) {
+        return fail("The frame header checksum doesn't match");
+    }
+
+    maxBlockSize = size_t(1) << (8 + 2 * blockSizeId);
+    areBlocksLinked = (flags & FLAG_INDEPENDENT_BLOCKS) == 0;
+    hasBlockChecksum = (flags & FLAG_BLOCK_CHECKSUM) != 0;
+    hasContentSize = (flags & FLAG_CONTENT_SIZE) != 0;
+    hasContentChecksum = (flags & FLAG_CONTENT_CHECKSUM) != 0;
+    contentSize = hasContentSize ? readLe64(data + 2) : 0;
+    contentHash = Xxh32();
+    decodedSize = 0;
+    window.clear();
+    stage = Stage::BlockSize;
+    return headerSize;
+}
+
+/**
+ * Independent blocks are decoded straight into the output. Linked blocks are decoded after the last 64 KB of the
+ * frame's output, which they can refer to, and then copied.
+ */
+size_t FrameDecoder::decodeBlock(const unsigned char* data, const size_t size, std::string& out) {
+    const size_t needed = blockSize + (hasBlockChecksum ? 4 : 0);
+    if (size < needed) {
+        return 0;
+    }
+    if (hasBlockChecksum && readLe32(data + blockSize) != xxh32(data, blockSize)) {
+        return fail("A block checksum doesn't match");
+    }
+
+    std::string& target = areBlocksLinked ? window : out;
+    if (areBlocksLinked && window.size() > MAX_DISTANCE) {
+        window.erase(0, window.size() - MAX_DISTANCE);
+    }
+    const size_t start = target.size();
+    if (isBlockCompressed) {
+        if (!decompressBlock(reinterpret_cast<const char*>(data), blockSize, maxBlockSize, target, areBlocksLinked ? start : 0)) {
+            return fail("A block is corrupt");
+        }
+    }
+    else {
+        target.append(reinterpret_cast<const char*>(data), blockSize);
+    }
+    const size_t decodedCount = target.size() - start;
+    if (areBlocksLinked) {
+        out.append(window, start, decodedCount);
+    }
+    if (hasContentChecksum) {
+        contentHash.update(target.data() + start, decodedCount);
+    }
+    decodedSize += decodedCount;
+    stage = Stage::BlockSize;
+    return needed;
+}
+
+bool FrameDecoder::finishFrame() {
+    if (hasContentSize && decodedSize != contentSize) {
+        fail("The frame's size doesn't match its header");
+        return false;
+    }
+    stage = Stage::Magic;
+    return true;
+}
+
+size_t FrameDecoder::fail(const char* reason) {
+    error = reason;
+    return 0;
+}
+
+} // namespace lz4_internal
+} // namespace rk
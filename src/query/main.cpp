@@ -0,0 +1,114 @@
+/**
+ * @file main.cpp
+ * @brief Main file for rk_log_query, which prints the messages of a time range from a log file that was written with
+ * "log_file_index: ENABLE".
+ *
+ * Usage: rk_log_query [--from <time>] [--to <time>] [--thread <id>] <log file>
+ *
+ * The log file and its index, "<log file>.idx", are mapped into memory, and the index is searched for the parts of
+ * the file that the range is in, so only those are read. Whole index entries are printed, so a few messages just
+ * outside of the range can be printed too. Times are nanoseconds since the epoch, or local times like
+ * "2026-10-19 10:42:00.250", or UTC times like "2026-10-19T10:42:00Z". With --thread, only the messages of the thread
+ * with that id, as it is printed in the log, are printed.
+ */
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include <rk_logger/config_parser.h>
+#include <rk_logger/log_index.h>
+
+namespace {
+
+int printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [--from <time>] [--to <time>] [--thread <id>] <log file>\n";
+    return 1;
+}
+
+/**
+ * Prints the lines of the messages that were logged by a thread. The lines after the first one of a message don't
+ * have a thread id, so they go with the message before them.
+ */
+void printThreadLines(std::string_view text, const std::string_view threadId) {
+    bool isMatching = false;
+    while (!text.empty()) {
+        const size_t lineEnd = text.find('\n');
+        const size_t lineSize = lineEnd == std::string_view::npos ? text.size() : lineEnd + 1;
+        const std::string_view line = text.substr(0, lineSize);
+        const std::string_view lineThreadId = rk::index_internal::getLineThreadId(line);
+        if (!lineThreadId.empty()) {
+            isMatching = lineThreadId == threadId;
+        }
+        if (isMatching) {
+            std::cout.write(line.data(), static_cast<std::streamsize>(line.size()));
+        }
+        text.remove_prefix(lineSize);
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int64_t fromNs = INT64_MIN;
+    int64_t toNs = INT64_MAX;
+    std::string threadId;
+    const char* path = nullptr;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--from" && hasValue) {
+            if (!rk::index_internal::parseQueryTime(argv[++i], fromNs)) {
+                std::cerr << "Invalid time: " << argv[i] << "\n";
+                return 1;
+            }
+        }
+        else if (arg == "--to" && hasValue) {
+            if (!rk::index_internal::parseQueryTime(argv[++i], toNs)) {
+                std::cerr << "Invalid time: " << argv[i] << "\n";
+                return 1;
+            }
+        }
+        else if (arg == "--thread" && hasValue) {
+            threadId = argv[++i];
+        }
+        else if (path == nullptr && (arg.empty() || arg[0] != '-')) {
+            path = argv[i];
+        }
+        else {
+            return printUsage(argv[0]);
+        }
+    }
+    if (path == nullptr) {
+        return printUsage(argv[0]);
+    }
+
+    const rk::config_internal::FileView logFile(path);
+    if (!logFile.isOpen()) {
+        std::cerr << "Unable to open " << path << "\n";
+        return 1;
+    }
+    const std::string_view log = logFile.getText();
+    const std::string indexPath = path + rk::index_internal::INDEX_FILE_SUFFIX;
+    const rk::config_internal::FileView indexFile(indexPath);
+    const std::string_view index = indexFile.getText();
+    const rk::index_internal::IndexEntry* entries = nullptr;
+    size_t entryCount = 0;
+    if (!indexFile.isOpen() || !rk::index_internal::readIndex(index.data(), index.size(), entries, entryCount)) {
+        std::cerr << "Unable to read the index " << indexPath << ". It is written when log_file_index is enabled\n";
+        return 1;
+    }
+
+    const uint64_t threadBit = threadId.empty() ? 0 : rk::index_internal::getThreadBit(threadId);
+    for (const auto& range : rk::index_internal::findRanges(entries, entryCount, log.size(), fromNs, toNs, threadBit)) {
+        const std::string_view text = log.substr(range.begin, range.end - range.begin);
+        if (threadId.empty()) {
+            std::cout.write(text.data(), static_cast<std::streamsize>(text.size()));
+        }
+        else {
+            printThreadLines(text, threadId);
+        }
+    }
+    std::cout.flush();
+    return 0;
+}
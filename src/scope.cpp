@@ -0,0 +1,22 @@
+/**
+ * @file scope.cpp
+ * @brief Source file for scoped context fields.
+ */
+#include <rk_logger/scope.h>
+
+namespace rk {
+namespace log {
+
+Scope::Scope(const std::initializer_list<ScopeField> fields) : previousSize(rk::log_internal::getThreadContext().size()) {
+    std::string& context = rk::log_internal::getThreadContext();
+    for (const ScopeField& field : fields) {
+        context += field.text;
+    }
+}
+
+Scope::~Scope() {
+    rk::log_internal::getThreadContext().resize(previousSize);
+}
+
+} // namespace log
+} // namespace rk
@@ -0,0 +1,451 @@
+/**
+ * @file shm_ring.cpp
+ * @brief Source file for the shared-memory ring that carries log records from an application to the rk_log_agent process.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <sstream>
+#include <thread>
+
+#include <rk_logger/shm_ring.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace rk {
+namespace shm_internal {
+
+namespace {
+
+/**
+ * Every entry starts with a 32-bit state and a 32-bit type. The state is 0 until the entry is reserved, then holds
+ * the size of the entry, and once the entry is committed, its size with COMMITTED_BIT set. Entries are 8-byte aligned and never wrap around the end of the
+ * data area: an entry that doesn't fit before the end is preceded by a padding entry that fills the rest of it.
+ */
+constexpr size_t ENTRY_ALIGNMENT = 8;
+constexpr size_t ENTRY_HEADER_SIZE = 8;
+constexpr uint32_t COMMITTED_BIT = 0x80000000;
+constexpr uint32_t ENTRY_TYPE_RECORD = 1;
+constexpr uint32_t ENTRY_TYPE_PADDING = 2;
+constexpr size_t DATA_OFFSET = (sizeof(RingHeader) + 63) / 64 * 64;
+constexpr size_t MAX_FIELD_SIZE = UINT16_MAX;
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free && std::atomic<uint64_t>::is_always_lock_free,
+    "The ring is shared between processes, so its atomics can't use locks");
+
+/**
+ * The fixed-size part of a record entry, which is followed by the thread id, function name, and message.
+ */
+struct RecordFields {
+    uint64_t stamp;
+    uint32_t messageSize;
+    uint16_t threadIdSize;
+    uint16_t funcNameSize;
+    uint8_t level;
+    uint8_t isTicks;
+    uint8_t unused[6];
+};
+
+constexpr size_t alignEntry(const size_t size) {
+    return (size + ENTRY_ALIGNMENT - 1) / ENTRY_ALIGNMENT * ENTRY_ALIGNMENT;
+}
+
+std::atomic<uint32_t>* getEntryState(char* data, const size_t offset) {
+    return reinterpret_cast<std::atomic<uint32_t>*>(data + offset);
+}
+
+void setEntryType(char* data, const size_t offset, const uint32_t type) {
+    std::memcpy(data + offset + sizeof(uint32_t), &type, sizeof(type));
+}
+
+uint32_t getEntryType(const char* data, const size_t offset) {
+    uint32_t type = 0;
+    std::memcpy(&type, data + offset + sizeof(uint32_t), sizeof(type));
+    return type;
+}
+
+/**
+ * The text of the calling thread's id is only formatted once per thread.
+ */
+const std::string& getThreadIdText() {
+    static thread_local const std::string text = [] () {
+        std::ostringstream oss;
+        oss << std::this_thread::get_id();
+        return oss.str();
+    }();
+    return text;
+}
+
+/**
+ * @brief Gets the message of a record with its owned and deferred arguments spliced in.
+ *
+ * @param record The record.
+ * @param scratch Holds the message if anything had to be spliced into it.
+ * @return The message.
+ */
+std::string_view getFullMessage(const rk::log::Record& record, std::string& scratch) {
+    if (record.spliced.empty()) {
+        return record.message;
+    }
+    scratch.clear();
+    std::ostringstream deferredOutput;
+    size_t offset = 0;
+    for (const rk::log::SplicedArg& arg : record.spliced) {
+        scratch.append(record.message, offset, arg.offset - offset);
+        if (arg.format != nullptr) {
+            arg.format(arg.text, scratch);
+        }
+        else if (arg.write) {
+            deferredOutput.str("");
+            arg.write(deferredOutput);
+            scratch += deferredOutput.str();
+        }
+        else {
+            scratch += arg.text;
+        }
+        offset = arg.offset;
+    }
+    scratch.append(record.message, offset, std::string::npos);
+    return scratch;
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+
+/**
+ * kill() with signal 0 only checks if the process exists. A process that has exited but hasn't been reaped by its
+ * parent yet still counts as running.
+ */
+bool hasExited(const uint32_t pid) {
+    return ::kill(static_cast<pid_t>(pid), 0) != 0 && errno == ESRCH;
+}
+
+#endif // #if defined(__unix__) || defined(__APPLE__)
+
+} // namespace
+
+RingWriter::RingWriter(RingHeader* header, const size_t mappingSize) :
+    header(header),
+    data(reinterpret_cast<char*>(header) + DATA_OFFSET),
+    mappingSize(mappingSize)
+{}
+
+/**
+ * A record is written in three steps: reserve its space by advancing the reserved position, copy it in, and then
+ * publish it by storing its committed state. The agent reads entries in order and waits at the first one that isn't
+ * committed yet. The size is stored as soon as the space is reserved, so if the process dies before it commits the
+ * entry, the agent can still skip over it to the entries after it.
+ */
+bool RingWriter::write(const rk::log::Record& record) {
+    static thread_local std::string scratch;
+    const std::string_view message = getFullMessage(record, scratch);
+    const std::string& threadId = getThreadIdText();
+    const size_t threadIdSize = std::min(threadId.size(), MAX_FIELD_SIZE);
+    const size_t funcNameSize = std::min(std::strlen(record.funcName), MAX_FIELD_SIZE);
+    const size_t payloadSize = sizeof(RecordFields) + threadIdSize + funcNameSize + message.size();
+    const uint64_t capacity = header->capacity;
+    const size_t entrySize = alignEntry(ENTRY_HEADER_SIZE + payloadSize);
+    if (entrySize > capacity) {
+        header->droppedCount.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    uint64_t position = header->reserved.load(std::memory_order_relaxed);
+    size_t paddingSize = 0;
+    while (true) {
+        const size_t offset = position % capacity;
+        paddingSize = entrySize <= capacity - offset ? 0 : capacity - offset;
+        if (position + paddingSize + entrySize - header->consumed.load(std::memory_order_acquire) > capacity) {
+            header->droppedCount.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        if (header->reserved.compare_exchange_weak(position, position + paddingSize + entrySize, std::memory_order_relaxed)) {
+            break;
+        }
+    }
+
+    if (paddingSize > 0) {
+        const size_t paddingOffset = position % capacity;
+        setEntryType(data, paddingOffset, ENTRY_TYPE_PADDING);
+        getEntryState(data, paddingOffset)->store(static_cast<uint32_t>(paddingSize) | COMMITTED_BIT, std::memory_order_release);
+    }
+
+    const size_t offset = (position + paddingSize) % capacity;
+    getEntryState(data, offset)->store(static_cast<uint32_t>(entrySize), std::memory_order_relaxed);
+    RecordFields fields{};
+    fields.stamp = record.ticks != 0 ? record.ticks :
+        static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(record.time.time_since_epoch()).count());
+    fields.isTicks = record.ticks != 0;
+    fields.level = static_cast<uint8_t>(record.level);
+    fields.threadIdSize = static_cast<uint16_t>(threadIdSize);
+    fields.funcNameSize = static_cast<uint16_t>(funcNameSize);
+    fields.messageSize = static_cast<uint32_t>(message.size());
+
+    char* out = data + offset + ENTRY_HEADER_SIZE;
+    std::memcpy(out, &fields, sizeof(fields));
+    out += sizeof(fields);
+    std::memcpy(out, threadId.data(), threadIdSize);
+    out += threadIdSize;
+    std::memcpy(out, record.funcName, funcNameSize);
+    out += funcNameSize;
+    std::memcpy(out, message.data(), message.size());
+
+    setEntryType(data, offset, ENTRY_TYPE_RECORD);
+    getEntryState(data, offset)->store(static_cast<uint32_t>(entrySize) | COMMITTED_BIT, std::memory_order_release);
+    return true;
+}
+
+void RingWriter::close() {
+    if (producerSlot < MAX_RING_PRODUCERS) {
+        header->producerPids[producerSlot].store(0, std::memory_order_release);
+    }
+}
+
+uint64_t RingWriter::getDroppedCount() const {
+    return header->droppedCount.load(std::memory_order_relaxed);
+}
+
+RingReader::RingReader(RingHeader* header, const size_t mappingSize) :
+    header(header),
+    data(reinterpret_cast<char*>(header) + DATA_OFFSET),
+    mappingSize(mappingSize),
+    position(header->consumed.load(std::memory_order_relaxed))
+{}
+
+/**
+ * The space of a record is only released on the next read, so the views of the record stay valid until then.
+ *
+ * An entry of a producer that died before committing it is skipped by its reserved size. If the producer died right
+ * after reserving it, before even storing its size, where the next entry starts isn't known, so everything up to the
+ * reserved position is skipped as one entry.
+ */
+bool RingReader::read(RecordView& record, const bool isProducerDone) {
+    release();
+    const uint64_t capacity = header->capacity;
+    while (true) {
+        const uint64_t reserved = header->reserved.load(std::memory_order_acquire);
+        if (position == reserved) {
+            return false;
+        }
+        const size_t offset = position % capacity;
+        const uint32_t state = getEntryState(data, offset)->load(std::memory_order_acquire);
+        if ((state & COMMITTED_BIT) == 0) {
+            if (!isProducerDone) {
+                return false; // Reserved, but the producer is still writing it
+            }
+            pendingSize = state != 0 ? state : reserved - position;
+            release();
+            lostCount++;
+            continue;
+        }
+        pendingSize = state & ~COMMITTED_BIT;
+        if (getEntryType(data, offset) == ENTRY_TYPE_PADDING) {
+            release();
+            continue;
+        }
+
+        const char* in = data + offset + ENTRY_HEADER_SIZE;
+        RecordFields fields;
+        std::memcpy(&fields, in, sizeof(fields));
+        in += sizeof(fields);
+        record.stamp = fields.stamp;
+        record.isTicks = fields.isTicks != 0;
+        record.level = static_cast<rk::log::Level>(fields.level);
+        record.threadId = std::string_view(in, fields.threadIdSize);
+        in += fields.threadIdSize;
+        record.funcName = std::string_view(in, fields.funcNameSize);
+        in += fields.funcNameSize;
+        record.message = std::string_view(in, fields.messageSize);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * The whole entry is zeroed, not just its state, because an entry on the next pass around the ring can start anywhere
+ * inside this one, and producers rely on an entry's state being 0 until they reserve it. Only the span that is skipped
+ * after a producer died can wrap around the end of the data area.
+ */
+void RingReader::release() {
+    if (pendingSize == 0) {
+        return;
+    }
+    const size_t offset = position % header->capacity;
+    const size_t firstPart = std::min<size_t>(pendingSize, header->capacity - offset);
+    std::memset(data + offset, 0, firstPart);
+    std::memset(data, 0, pendingSize - firstPart);
+    position += pendingSize;
+    pendingSize = 0;
+    header->consumed.store(position, std::memory_order_release);
+}
+
+std::string RingReader::getLoggerName() const {
+    return std::string(header->loggerName, strnlen(header->loggerName, sizeof(header->loggerName)));
+}
+
+rk::time_internal::TickSource RingReader::getTickSource() const {
+    return header->tickSource;
+}
+
+uint64_t RingReader::getDroppedCount() const {
+    return header->droppedCount.load(std::memory_order_relaxed);
+}
+
+uint64_t RingReader::getLostCount() const {
+    return lostCount;
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+
+/**
+ * The object is created with O_EXCL after removing any old one, so a ring left behind by a crashed run isn't reused
+ * with its old positions. The new object is zero-filled, which is also the initial state of every entry.
+ */
+std::unique_ptr<RingWriter> RingWriter::create(const std::string& name, size_t capacity, const std::string& loggerName,
+    const rk::time_internal::TickSource tickSource) {
+    capacity = capacity / ENTRY_ALIGNMENT * ENTRY_ALIGNMENT;
+    ::shm_unlink(name.c_str());
+    const int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+    if (fd < 0) {
+        return nullptr;
+    }
+    const size_t mappingSize = DATA_OFFSET + capacity;
+    void* address = MAP_FAILED;
+    if (::ftruncate(fd, static_cast<off_t>(mappingSize)) == 0) {
+        address = ::mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (address == MAP_FAILED) {
+        ::shm_unlink(name.c_str());
+        return nullptr;
+    }
+
+    RingHeader* header = new (address) RingHeader{};
+    header->version = RING_VERSION;
+    header->producerPids[0].store(static_cast<uint32_t>(::getpid()), std::memory_order_relaxed);
+    header->capacity = capacity;
+    header->tickSource = tickSource;
+    std::strncpy(header->loggerName, loggerName.c_str(), MAX_RING_LOGGER_NAME_SIZE);
+    header->magic.store(RING_MAGIC, std::memory_order_release);
+    return std::unique_ptr<RingWriter>(new RingWriter(header, mappingSize));
+}
+
+RingWriter::~RingWriter() {
+    ::munmap(header, mappingSize);
+}
+
+std::unique_ptr<RingReader> RingReader::open(const std::string& name) {
+    const int fd = ::shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        return nullptr;
+    }
+    struct stat info{};
+    void* address = MAP_FAILED;
+    size_t mappingSize = 0;
+    if (::fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) >= DATA_OFFSET) {
+        mappingSize = static_cast<size_t>(info.st_size);
+        address = ::mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (address == MAP_FAILED) {
+        return nullptr;
+    }
+
+    auto* header = static_cast<RingHeader*>(address);
+    const bool isReady = header->magic.load(std::memory_order_acquire) == RING_MAGIC && header->version == RING_VERSION &&
+        header->capacity > 0 && DATA_OFFSET + header->capacity <= mappingSize;
+    if (!isReady) {
+        ::munmap(address, mappingSize);
+        return nullptr;
+    }
+    return std::unique_ptr<RingReader>(new RingReader(header, mappingSize));
+}
+
+RingReader::~RingReader() {
+    release();
+    ::munmap(header, mappingSize);
+}
+
+/**
+ * The slot of a child that exited without stopping its logger is reused, so a process that keeps replacing the
+ * children that it forks doesn't run out of slots.
+ */
+void RingWriter::prepareForFork() {
+    const uint32_t pid = static_cast<uint32_t>(::getpid());
+    for (forkSlot = 0; forkSlot < MAX_RING_PRODUCERS; forkSlot++) {
+        uint32_t slotPid = header->producerPids[forkSlot].load(std::memory_order_relaxed);
+        if ((slotPid == 0 || hasExited(slotPid)) &&
+            header->producerPids[forkSlot].compare_exchange_strong(slotPid, pid, std::memory_order_acq_rel)) {
+            return;
+        }
+    }
+}
+
+bool RingWriter::restartAfterFork() {
+    producerSlot = forkSlot;
+    if (producerSlot == MAX_RING_PRODUCERS) {
+        return false;
+    }
+    header->producerPids[producerSlot].store(static_cast<uint32_t>(::getpid()), std::memory_order_release);
+    return true;
+}
+
+bool RingReader::isProducerDone() const {
+    for (const std::atomic<uint32_t>& producerPid : header->producerPids) {
+        const uint32_t pid = producerPid.load(std::memory_order_acquire);
+        if (pid != 0 && !hasExited(pid)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void removeRing(const std::string& name) {
+    ::shm_unlink(name.c_str());
+}
+
+#else
+
+std::unique_ptr<RingWriter> RingWriter::create(const std::string&, size_t, const std::string&, const rk::time_internal::TickSource) {
+    return nullptr;
+}
+
+RingWriter::~RingWriter() = default;
+
+void RingWriter::prepareForFork() {
+    forkSlot = MAX_RING_PRODUCERS;
+}
+
+bool RingWriter::restartAfterFork() {
+    producerSlot = MAX_RING_PRODUCERS;
+    return false;
+}
+
+std::unique_ptr<RingReader> RingReader::open(const std::string&) {
+    return nullptr;
+}
+
+RingReader::~RingReader() = default;
+
+bool RingReader::isProducerDone() const {
+    for (const std::atomic<uint32_t>& producerPid : header->producerPids) {
+        if (producerPid.load(std::memory_order_acquire) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void removeRing(const std::string&) {}
+
+#endif // #if defined(__unix__) || defined(__APPLE__)
+
+} // namespace shm_internal
+} // namespace rk
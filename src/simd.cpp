@@ -0,0 +1,372 @@
+/**
+ * @file simd.cpp
+ * @brief Source file for the vectorized kernels that render digits and scan text while records are formatted.
+ */
+#include <array>
+#include <atomic>
+#include <cstring>
+
+#include <rk_logger/simd.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define RK_SIMD_HAS_X86 1
+#define RK_SIMD_TARGET(isa) __attribute__((target(isa)))
+#else
+#define RK_SIMD_HAS_X86 0
+#endif
+
+namespace rk {
+namespace simd_internal {
+
+namespace {
+
+constexpr uint64_t TEN_TO_8 = 100000000;
+constexpr uint64_t TEN_TO_16 = 10000000000000000;
+constexpr size_t SSE2_DIGIT_PAIRS = 8; /**< The digit pairs that fit in one 128-bit register */
+
+/**
+ * "00", "01", ..., "99" back to back, so the two digits of n start at index 2 * n.
+ */
+constexpr std::array<char, 200> DIGIT_PAIR_TABLE = [] () {
+    std::array<char, 200> table {};
+    for (size_t i = 0; i < 100; i++) {
+        table[2 * i] = static_cast<char>('0' + i / 10);
+        table[2 * i + 1] = static_cast<char>('0' + i % 10);
+    }
+    return table;
+}();
+
+/**
+ * @brief Splits a number below 10^16 into its 8 digit pairs, with the most significant pair first.
+ */
+void splitIntoDigitPairs(const uint64_t value, uint16_t* pairs) {
+    const uint32_t halves[2] = { static_cast<uint32_t>(value / TEN_TO_8), static_cast<uint32_t>(value % TEN_TO_8) };
+    for (size_t i = 0; i < 2; i++) {
+        const uint32_t high = halves[i] / 10000;
+        const uint32_t low = halves[i] % 10000;
+        pairs[4 * i] = static_cast<uint16_t>(high / 100);
+        pairs[4 * i + 1] = static_cast<uint16_t>(high % 100);
+        pairs[4 * i + 2] = static_cast<uint16_t>(low / 100);
+        pairs[4 * i + 3] = static_cast<uint16_t>(low % 100);
+    }
+}
+
+/**
+ * @brief Writes the digits of a number below 10^4 without leading zeros. Used for the digits in front of the 16
+ * that the kernels render.
+ */
+size_t renderSmallPrefix(uint32_t value, char* out) {
+    char digits[4];
+    size_t count = 0;
+    do {
+        digits[3 - count++] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+    std::memcpy(out, digits + 4 - count, count);
+    return count;
+}
+
+void renderDigitPairsScalar(const uint16_t* values, const size_t count, char* out) {
+    for (size_t i = 0; i < count; i++) {
+        std::memcpy(out + 2 * i, &DIGIT_PAIR_TABLE[2 * values[i]], 2);
+    }
+}
+
+size_t renderUnsignedScalar(uint64_t value, char* out) {
+    char digits[MAX_UNSIGNED_DIGITS];
+    size_t start = MAX_UNSIGNED_DIGITS;
+    while (value >= 100) {
+        start -= 2;
+        std::memcpy(digits + start, &DIGIT_PAIR_TABLE[2 * (value % 100)], 2);
+        value /= 100;
+    }
+    if (value >= 10) {
+        start -= 2;
+        std::memcpy(digits + start, &DIGIT_PAIR_TABLE[2 * value], 2);
+    }
+    else {
+        digits[--start] = static_cast<char>('0' + value);
+    }
+    std::memcpy(out, digits + start, MAX_UNSIGNED_DIGITS - start);
+    return MAX_UNSIGNED_DIGITS - start;
+}
+
+size_t findAnyOfScalar(const std::string_view text, const std::string_view chars) {
+    for (size_t i = 0; i < text.size(); i++) {
+        for (const char c : chars) {
+            if (text[i] == c) {
+                return i;
+            }
+        }
+    }
+    return text.size();
+}
+
+uint64_t matchAnyOfScalar(const char* data, const size_t size, const std::string_view chars) {
+    uint64_t mask = 0;
+    for (size_t i = 0; i < size; i++) {
+        for (const char c : chars) {
+            if (data[i] == c) {
+                mask |= uint64_t(1) << i;
+                break;
+            }
+        }
+    }
+    return mask;
+}
+
+#if RK_SIMD_HAS_X86
+
+/**
+ * Each 16-bit lane holds a number n from 0 to 99. (n * 103) >> 10 is n / 10 for all of them, so both digits are
+ * found with a multiply and a shift, and the tens end up in the low byte, which is the first character in memory.
+ */
+RK_SIMD_TARGET("sse2") inline __m128i digitPairsToAscii(const __m128i values) {
+    const __m128i tens = _mm_srli_epi16(_mm_mullo_epi16(values, _mm_set1_epi16(103)), 10);
+    const __m128i ones = _mm_sub_epi16(values, _mm_mullo_epi16(tens, _mm_set1_epi16(10)));
+    return _mm_add_epi16(_mm_or_si128(tens, _mm_slli_epi16(ones, 8)), _mm_set1_epi16(0x3030));
+}
+
+RK_SIMD_TARGET("sse2") void renderDigitPairsSse2(const uint16_t* values, const size_t count, char* out) {
+    for (size_t i = 0; i < count; i += SSE2_DIGIT_PAIRS) {
+        const __m128i pairs = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i), digitPairsToAscii(pairs));
+    }
+}
+
+RK_SIMD_TARGET("avx2") void renderDigitPairsAvx2(const uint16_t* values, const size_t count, char* out) {
+    if (count <= SSE2_DIGIT_PAIRS) {
+        renderDigitPairsSse2(values, count, out);
+        return;
+    }
+    const __m256i pairs = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values));
+    const __m256i tens = _mm256_srli_epi16(_mm256_mullo_epi16(pairs, _mm256_set1_epi16(103)), 10);
+    const __m256i ones = _mm256_sub_epi16(pairs, _mm256_mullo_epi16(tens, _mm256_set1_epi16(10)));
+    const __m256i ascii = _mm256_add_epi16(_mm256_or_si256(tens, _mm256_slli_epi16(ones, 8)), _mm256_set1_epi16(0x3030));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), ascii);
+}
+
+/**
+ * The low 16 digits are rendered in one register, and the leading zeros are found from a mask of the '0' bytes
+ * instead of by counting the digits first.
+ */
+RK_SIMD_TARGET("sse2") size_t renderUnsignedSse2(const uint64_t value, char* out) {
+    size_t prefixSize = 0;
+    uint64_t low = value;
+    if (value >= TEN_TO_16) {
+        prefixSize = renderSmallPrefix(static_cast<uint32_t>(value / TEN_TO_16), out);
+        low = value % TEN_TO_16;
+    }
+
+    alignas(16) uint16_t pairs[SSE2_DIGIT_PAIRS];
+    splitIntoDigitPairs(low, pairs);
+    const __m128i digits = digitPairsToAscii(_mm_load_si128(reinterpret_cast<const __m128i*>(pairs)));
+    if (prefixSize > 0) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + prefixSize), digits);
+        return prefixSize + 16;
+    }
+
+    const unsigned int zeroMask = static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(digits, _mm_set1_epi8('0'))));
+    const size_t leadingZeros = static_cast<size_t>(__builtin_ctz(~zeroMask | 0x8000)); // Keeps the last digit of 0
+    alignas(16) char buffer[16];
+    _mm_store_si128(reinterpret_cast<__m128i*>(buffer), digits);
+    std::memcpy(out, buffer + leadingZeros, 16 - leadingZeros);
+    return 16 - leadingZeros;
+}
+
+RK_SIMD_TARGET("sse2") inline int matchMaskSse2(const __m128i block, const __m128i* needles, const size_t needleCount) {
+    __m128i matches = _mm_setzero_si128();
+    for (size_t i = 0; i < needleCount; i++) {
+        matches = _mm_or_si128(matches, _mm_cmpeq_epi8(block, needles[i]));
+    }
+    return _mm_movemask_epi8(matches);
+}
+
+/**
+ * A tail that is shorter than a block is read as the last 16 bytes of the text, overlapping the block before it,
+ * so there is no loop over its characters. Only texts shorter than a block are copied.
+ */
+RK_SIMD_TARGET("sse2") uint64_t matchAnyOfSse2(const char* data, const size_t size, const std::string_view chars) {
+    __m128i needles[MAX_FIND_CHARS];
+    for (size_t i = 0; i < chars.size(); i++) {
+        needles[i] = _mm_set1_epi8(chars[i]);
+    }
+    uint64_t mask = 0;
+    size_t pos = 0;
+    for (; pos + 16 <= size; pos += 16) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+        mask |= static_cast<uint64_t>(matchMaskSse2(block, needles, chars.size())) << pos;
+    }
+    const size_t tailSize = size - pos;
+    if (tailSize == 0) {
+        return mask;
+    }
+    if (size >= 16) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + size - 16));
+        return mask | (static_cast<uint64_t>(matchMaskSse2(block, needles, chars.size())) >> (16 - tailSize) << pos);
+    }
+    alignas(16) char tail[16] = {};
+    std::memcpy(tail, data, size);
+    const int tailMask = matchMaskSse2(_mm_load_si128(reinterpret_cast<const __m128i*>(tail)), needles, chars.size());
+    return static_cast<uint64_t>(tailMask) & ((uint64_t(1) << size) - 1);
+}
+
+RK_SIMD_TARGET("sse2") size_t findAnyOfSse2(const std::string_view text, const std::string_view chars) {
+    __m128i needles[MAX_FIND_CHARS];
+    for (size_t i = 0; i < chars.size(); i++) {
+        needles[i] = _mm_set1_epi8(chars[i]);
+    }
+    size_t pos = 0;
+    for (; pos + 16 <= text.size(); pos += 16) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text.data() + pos));
+        const int mask = matchMaskSse2(block, needles, chars.size());
+        if (mask != 0) {
+            return pos + static_cast<size_t>(__builtin_ctz(static_cast<unsigned int>(mask)));
+        }
+    }
+    const uint64_t tailMask = matchAnyOfSse2(text.data() + pos, text.size() - pos, chars);
+    return tailMask != 0 ? pos + static_cast<size_t>(__builtin_ctzll(tailMask)) : text.size();
+}
+
+RK_SIMD_TARGET("avx2") inline uint64_t matchMaskAvx2(const char* block, const __m256i* needles, const size_t needleCount) {
+    const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+    __m256i matches = _mm256_setzero_si256();
+    for (size_t i = 0; i < needleCount; i++) {
+        matches = _mm256_or_si256(matches, _mm256_cmpeq_epi8(bytes, needles[i]));
+    }
+    return static_cast<uint32_t>(_mm256_movemask_epi8(matches));
+}
+
+RK_SIMD_TARGET("avx2") size_t findAnyOfAvx2(const std::string_view text, const std::string_view chars) {
+    __m256i needles[MAX_FIND_CHARS];
+    for (size_t i = 0; i < chars.size(); i++) {
+        needles[i] = _mm256_set1_epi8(chars[i]);
+    }
+    size_t pos = 0;
+    for (; pos + 32 <= text.size(); pos += 32) {
+        const uint64_t mask = matchMaskAvx2(text.data() + pos, needles, chars.size());
+        if (mask != 0) {
+            return pos + static_cast<size_t>(__builtin_ctzll(mask));
+        }
+    }
+    const uint64_t tailMask = matchAnyOfSse2(text.data() + pos, text.size() - pos, chars);
+    return tailMask != 0 ? pos + static_cast<size_t>(__builtin_ctzll(tailMask)) : text.size();
+}
+
+RK_SIMD_TARGET("avx2") uint64_t matchAnyOfAvx2(const char* data, const size_t size, const std::string_view chars) {
+    if (size < 32) {
+        return matchAnyOfSse2(data, size, chars);
+    }
+    __m256i needles[MAX_FIND_CHARS];
+    for (size_t i = 0; i < chars.size(); i++) {
+        needles[i] = _mm256_set1_epi8(chars[i]);
+    }
+    uint64_t mask = matchMaskAvx2(data, needles, chars.size());
+    if (size == 64) {
+        return mask | matchMaskAvx2(data + 32, needles, chars.size()) << 32;
+    }
+    if (size > 32) {
+        mask |= matchMaskAvx2(data + size - 32, needles, chars.size()) >> (64 - size) << 32;
+    }
+    return mask;
+}
+
+#endif // #if RK_SIMD_HAS_X86
+
+/**
+ * The versions of the kernels for one level.
+ */
+struct Kernels {
+    void (*renderDigitPairs)(const uint16_t*, size_t, char*);
+    size_t (*renderUnsigned)(uint64_t, char*);
+    size_t (*findAnyOf)(std::string_view, std::string_view);
+    uint64_t (*matchAnyOf)(const char*, size_t, std::string_view);
+};
+
+constexpr Kernels SCALAR_KERNELS = { renderDigitPairsScalar, renderUnsignedScalar, findAnyOfScalar, matchAnyOfScalar };
+#if RK_SIMD_HAS_X86
+constexpr Kernels SSE2_KERNELS = { renderDigitPairsSse2, renderUnsignedSse2, findAnyOfSse2, matchAnyOfSse2 };
+constexpr Kernels AVX2_KERNELS = { renderDigitPairsAvx2, renderUnsignedSse2, findAnyOfAvx2, matchAnyOfAvx2 }; // 16 digits already fit in SSE2
+#endif
+
+std::atomic<SimdLevel>& getLevelStorage() {
+    static std::atomic<SimdLevel> level(getSupportedSimdLevel());
+    return level;
+}
+
+const Kernels& getKernels() {
+#if RK_SIMD_HAS_X86
+    switch (getLevelStorage().load(std::memory_order_relaxed)) {
+        case SimdLevel::Avx2:
+            return AVX2_KERNELS;
+        case SimdLevel::Sse2:
+            return SSE2_KERNELS;
+        default:
+            break;
+    }
+#endif
+    return SCALAR_KERNELS;
+}
+
+} // namespace
+
+SimdLevel getSupportedSimdLevel() {
+#if RK_SIMD_HAS_X86
+    static const SimdLevel supported = [] () {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            return SimdLevel::Avx2;
+        }
+        return __builtin_cpu_supports("sse2") ? SimdLevel::Sse2 : SimdLevel::Scalar;
+    }();
+    return supported;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+SimdLevel getSimdLevel() {
+    return getLevelStorage().load(std::memory_order_relaxed);
+}
+
+void setSimdLevel(const SimdLevel level) {
+    const SimdLevel supported = getSupportedSimdLevel();
+    getLevelStorage().store(level > supported ? supported : level, std::memory_order_relaxed);
+}
+
+const char* simdLevelToString(const SimdLevel level) {
+    switch (level) {
+        case SimdLevel::Avx2:
+            return "AVX2";
+        case SimdLevel::Sse2:
+            return "SSE2";
+        default:
+            return "Scalar";
+    }
+}
+
+void renderDigitPairs(const uint16_t* values, const size_t count, char* out) {
+    getKernels().renderDigitPairs(values, count, out);
+}
+
+size_t renderUnsigned(const uint64_t value, char* out) {
+    return getKernels().renderUnsigned(value, out);
+}
+
+size_t findAnyOf(const std::string_view text, const std::string_view chars) {
+    if (chars.size() > MAX_FIND_CHARS) {
+        return findAnyOfScalar(text, chars);
+    }
+    return getKernels().findAnyOf(text, chars);
+}
+
+uint64_t matchAnyOf(const char* data, const size_t size, const std::string_view chars) {
+    if (chars.size() > MAX_FIND_CHARS) {
+        return matchAnyOfScalar(data, size < MAX_MATCH_SIZE ? size : MAX_MATCH_SIZE, chars);
+    }
+    return getKernels().matchAnyOf(data, size < MAX_MATCH_SIZE ? size : MAX_MATCH_SIZE, chars);
+}
+
+} // namespace simd_internal
+} // namespace rk
@@ -0,0 +1,286 @@
+/**
+ * @file sink.cpp
+ * @brief Source file for the sinks that log messages are written to.
+ */
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include <rk_logger/sink.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace rk {
+namespace log {
+
+namespace {
+
+const std::ios_base::Init iosInit; /**< Makes sure std::cout is constructed before its buffer is saved below */
+const std::streambuf* const STDOUT_STREAM_BUFFER = std::cout.rdbuf(); /**< std::cout's buffer before the application could replace it */
+
+constexpr std::string_view COLOR_RESET = "\x1b[0m";
+constexpr size_t BYTES_PER_KB = 1024;
+
+/**
+ * Info is left uncolored, so only the messages that stand out from normal output are colored.
+ */
+std::string_view getColor(const Level level) {
+    switch (level) {
+        case Level::Trace:
+        case Level::Debug:
+            return "\x1b[90m"; // Gray
+        case Level::Warn:
+            return "\x1b[33m"; // Yellow
+        case Level::Error:
+            return "\x1b[31m"; // Red
+        case Level::Fatal:
+            return "\x1b[1;31m"; // Bold red
+        default:
+            return "";
+    }
+}
+
+} // namespace
+
+void StreamSink::write(const std::string& message) {
+    stream << message;
+}
+
+void StreamSink::flush() {
+    stream.flush();
+}
+
+/**
+ * The file is binary, so the offsets in the index are the same as the ones in the file on every platform.
+ */
+FileSink::FileSink(const std::filesystem::path& path, const size_t indexRecordInterval, const size_t indexByteInterval) :
+    file(path, std::ios::binary), index(std::make_unique<rk::index_internal::IndexWriter>(path.string() + rk::index_internal::INDEX_FILE_SUFFIX, indexRecordInterval, indexByteInterval)) {}
+
+void FileSink::write(const std::string& message) {
+    file << message;
+    size += message.size();
+}
+
+void FileSink::writeWithInfo(const std::string& message, const MessageInfo& info) {
+    write(message);
+    if (index) {
+        index->add(size, info.timeNs, info.threadId);
+    }
+}
+
+void FileSink::flush() {
+    file.flush();
+    if (index) {
+        index->flush();
+    }
+}
+
+void FileSink::sync() {
+    if (index) {
+        index->finishEntry();
+    }
+    flush();
+}
+
+bool FileSink::isOpen() const {
+    return file.is_open() && file.good() && (!index || index->isOpen());
+}
+
+Lz4FileSink::Lz4FileSink(const std::filesystem::path& path, const int level, const std::chrono::milliseconds frameInterval) :
+    file(path, std::ios::binary), encoder(level), frameInterval(frameInterval) {}
+
+Lz4FileSink::~Lz4FileSink() {
+    sync();
+}
+
+/**
+ * The encoder only hands back output once a block is full, which is written right away so it doesn't pile up here.
+ */
+void Lz4FileSink::write(const std::string& message) {
+    if (!encoder.isFrameOpen()) {
+        frameStart = std::chrono::steady_clock::now();
+    }
+    encoder.write(message, compressed);
+    writeCompressed();
+}
+
+void Lz4FileSink::flush() {
+    if (encoder.isFrameOpen() && std::chrono::steady_clock::now() - frameStart >= frameInterval) {
+        sync();
+    }
+}
+
+void Lz4FileSink::sync() {
+    encoder.finishFrame(compressed);
+    writeCompressed();
+    file.flush();
+}
+
+bool Lz4FileSink::isOpen() const {
+    return file.is_open() && file.good();
+}
+
+void Lz4FileSink::writeCompressed() {
+    if (!compressed.empty()) {
+        file.write(compressed.data(), static_cast<std::streamsize>(compressed.size()));
+        compressed.clear();
+    }
+}
+
+ConsoleSink::ConsoleSink(const int fd, const ColorMode colorMode) : fd(fd) {
+#if defined(__unix__) || defined(__APPLE__)
+    isOutputTerminal = ::isatty(fd) == 1;
+#endif
+    const char* term = std::getenv("TERM");
+    const bool isColorSupported = isOutputTerminal && std::getenv("NO_COLOR") == nullptr && !(term != nullptr && std::strcmp(term, "dumb") == 0);
+    isOutputColored = colorMode == ColorMode::Always || (colorMode == ColorMode::Auto && isColorSupported);
+    buffer.reserve(BUFFER_SIZE);
+}
+
+ConsoleSink::~ConsoleSink() {
+    writeBuffer();
+}
+
+void ConsoleSink::write(const std::string& message) {
+    append(message);
+}
+
+/**
+ * The color is reset before the message's trailing newline, so a terminal that is cut off mid-line isn't left colored.
+ */
+void ConsoleSink::writeWithLevel(const std::string& message, const Level level) {
+    const std::string_view color = isOutputColored ? getColor(level) : std::string_view();
+    if (color.empty()) {
+        append(message);
+        return;
+    }
+    const bool hasNewline = !message.empty() && message.back() == '\n';
+    append(color);
+    append(std::string_view(message).substr(0, message.size() - (hasNewline ? 1 : 0)));
+    append(COLOR_RESET);
+    if (hasNewline) {
+        append("\n");
+    }
+}
+
+void ConsoleSink::flush() {
+    if (isOutputTerminal || buffer.size() >= BUFFER_SIZE) {
+        writeBuffer();
+    }
+}
+
+void ConsoleSink::sync() {
+    writeBuffer();
+}
+
+bool ConsoleSink::isTerminal() const {
+    return isOutputTerminal;
+}
+
+bool ConsoleSink::isColored() const {
+    return isOutputColored;
+}
+
+void ConsoleSink::append(const std::string_view text) {
+    if (buffer.size() + text.size() <= BUFFER_SIZE) {
+        buffer += text;
+    }
+    else if (text.size() >= BUFFER_SIZE) {
+        writeBuffer(text);
+    }
+    else {
+        writeBuffer();
+        buffer += text;
+    }
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+
+void ConsoleSink::writeBuffer(std::string_view extra) {
+    std::string_view pending = buffer;
+    while (!pending.empty() || !extra.empty()) {
+        iovec pieces[2];
+        int pieceCount = 0;
+        for (const std::string_view piece : { pending, extra }) {
+            if (!piece.empty()) {
+                pieces[pieceCount].iov_base = const_cast<char*>(piece.data());
+                pieces[pieceCount].iov_len = piece.size();
+                pieceCount++;
+            }
+        }
+        const ssize_t result = ::writev(fd, pieces, pieceCount);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break; // E.g., the other end of a pipe was closed. The output is dropped
+        }
+        if (result == 0) {
+            break;
+        }
+        const size_t written = static_cast<size_t>(result);
+        const size_t fromPending = std::min(written, pending.size());
+        pending.remove_prefix(fromPending);
+        extra.remove_prefix(written - fromPending);
+    }
+    buffer.clear();
+}
+
+#else
+
+void ConsoleSink::writeBuffer(const std::string_view extra) {
+    std::FILE* stream = fd == STDERR_FD ? stderr : stdout;
+    std::fwrite(buffer.data(), 1, buffer.size(), stream);
+    std::fwrite(extra.data(), 1, extra.size(), stream);
+    std::fflush(stream);
+    buffer.clear();
+}
+
+#endif // #if defined(__unix__) || defined(__APPLE__)
+
+std::shared_ptr<Sink> createConsoleSink(const rk::config::Config& config) {
+    if (std::cout.rdbuf() != STDOUT_STREAM_BUFFER) {
+        return std::make_shared<StreamSink>(std::cout);
+    }
+    const rk::config::ConfigValue color = config.getConfigValueByKey(rk::config::console_color::KEY);
+    const ConsoleSink::ColorMode colorMode = color == rk::config::console_color::ENABLE ? ConsoleSink::ColorMode::Always :
+        color == rk::config::console_color::DISABLE ? ConsoleSink::ColorMode::Never : ConsoleSink::ColorMode::Auto;
+    return std::make_shared<ConsoleSink>(ConsoleSink::STDOUT_FD, colorMode);
+}
+
+std::string getLogFileName(const std::string& baseName, const rk::config::Config& config) {
+    const bool isCompressed = config.getConfigValueByKey(rk::config::log_file_compression::KEY) == rk::config::log_file_compression::LZ4;
+    return baseName + (isCompressed ? ".txt.lz4" : ".txt");
+}
+
+std::shared_ptr<Sink> createLogFileSink(const std::filesystem::path& path, const rk::config::Config& config) {
+    if (config.getConfigValueByKey(rk::config::log_file_compression::KEY) != rk::config::log_file_compression::LZ4) {
+        std::shared_ptr<FileSink> sink;
+        if (config.getConfigValueByKey(rk::config::log_file_index::KEY) == rk::config::log_file_index::ENABLE) {
+            int recordInterval = 0;
+            rk::config_internal::parseInteger(config.getConfigValueByKey(rk::config::log_file_index_records::KEY), recordInterval);
+            int sizeKb = 0;
+            rk::config_internal::parseInteger(config.getConfigValueByKey(rk::config::log_file_index_kb::KEY), sizeKb);
+            sink = std::make_shared<FileSink>(path, static_cast<size_t>(recordInterval), static_cast<size_t>(sizeKb) * BYTES_PER_KB);
+        }
+        else {
+            sink = std::make_shared<FileSink>(path);
+        }
+        return sink->isOpen() ? sink : nullptr;
+    }
+    int level = rk::lz4_internal::MIN_LEVEL;
+    rk::config_internal::parseInteger(config.getConfigValueByKey(rk::config::log_file_compression_level::KEY), level);
+    int frameMs = 0;
+    rk::config_internal::parseInteger(config.getConfigValueByKey(rk::config::log_file_frame_ms::KEY), frameMs);
+    auto sink = std::make_shared<Lz4FileSink>(path, level, std::chrono::milliseconds(frameMs));
+    return sink->isOpen() ? sink : nullptr;
+}
+
+} // namespace log
+} // namespace rk
@@ -0,0 +1,291 @@
+/**
+ * @file syslog_sink.cpp
+ * @brief Source file for the sink that sends log messages to the local syslog or journald socket.
+ */
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <rk_logger/syslog_sink.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace rk {
+namespace log {
+
+namespace {
+
+constexpr size_t SEND_BATCH_SIZE = 64; /**< Datagrams per sendmmsg() call */
+constexpr std::chrono::seconds RECONNECT_INTERVAL(1);
+constexpr int SEND_WAIT_MS = 20; /**< How long to wait for room in the receiver's queue before dropping the rest of a batch */
+constexpr size_t MAX_HOST_NAME_SIZE = 255; /**< RFC 5424 limits */
+constexpr size_t MAX_APP_NAME_SIZE = 48;
+constexpr int SEVERITY_CRIT = 2;
+constexpr int SEVERITY_ERR = 3;
+constexpr int SEVERITY_WARNING = 4;
+constexpr int SEVERITY_INFO = 6;
+constexpr int SEVERITY_DEBUG = 7;
+
+std::string_view removeTrailingNewline(const std::string& message) {
+    std::string_view text(message);
+    while (!text.empty() && (text.back() == '\n' || text.back() == '\r')) {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+/**
+ * RFC 5424 header fields can only contain printable ASCII without spaces, and "-" stands for an empty field.
+ */
+std::string toHeaderField(const std::string& value, const size_t maxSize) {
+    std::string field = value.substr(0, maxSize);
+    for (char& c : field) {
+        if (c < '!' || c > '~') {
+            c = '_';
+        }
+    }
+    return field.empty() ? "-" : field;
+}
+
+std::string getProgramName() {
+#if defined(__GLIBC__)
+    return program_invocation_short_name;
+#else
+    return "rk_logger";
+#endif
+}
+
+} // namespace
+
+SyslogSink::SyslogSink(const Format format, const std::filesystem::path& socketPath, const std::string& identifier, const int facility) :
+    format(format),
+    socketPath(!socketPath.empty() ? socketPath : std::filesystem::path(format == Format::Rfc5424 ? DEFAULT_SYSLOG_PATH : DEFAULT_JOURNALD_PATH)),
+    identifier(identifier.empty() ? getProgramName() : identifier),
+    facility(facility) {
+#if defined(__unix__) || defined(__APPLE__)
+    char name[MAX_HOST_NAME_SIZE + 1] = {};
+    if (gethostname(name, sizeof(name) - 1) == 0) {
+        hostName = name;
+    }
+#endif
+    if (format == Format::Rfc5424) {
+        this->identifier = toHeaderField(this->identifier, MAX_APP_NAME_SIZE);
+        hostName = toHeaderField(hostName, MAX_HOST_NAME_SIZE);
+    }
+    connectIfNeeded();
+}
+
+SyslogSink::~SyslogSink() {
+    flush();
+    disconnect();
+}
+
+void SyslogSink::write(const std::string& message) {
+    writeWithLevel(message, Level::Info);
+}
+
+void SyslogSink::writeWithLevel(const std::string& message, const Level level) {
+    const size_t start = pending.size();
+    const std::string_view text = removeTrailingNewline(message);
+    if (format == Format::Rfc5424) {
+        if (pendingDatagrams.empty()) {
+            updateProcessId();
+        }
+        pending += '<';
+        pending += std::to_string(facility * 8 + toSeverity(level));
+        pending += ">1 - ";
+        pending += hostName;
+        pending += ' ';
+        pending += identifier;
+        pending += ' ';
+        pending += processId.empty() ? "-" : processId;
+        pending += " - - ";
+        pending += text;
+    }
+    else {
+        appendJournaldField("PRIORITY", std::to_string(toSeverity(level)));
+        appendJournaldField("SYSLOG_FACILITY", std::to_string(facility));
+        appendJournaldField("SYSLOG_IDENTIFIER", identifier);
+        appendJournaldField("MESSAGE", text);
+    }
+    pendingDatagrams.emplace_back(start, pending.size() - start);
+}
+
+/**
+ * Only checked at the start of each batch. A batch never spans a fork, since the sinks are synced right before it.
+ */
+void SyslogSink::updateProcessId() {
+#if defined(__unix__) || defined(__APPLE__)
+    const long pid = static_cast<long>(getpid());
+    if (pid != processIdNumber) {
+        processIdNumber = pid;
+        processId = std::to_string(pid);
+    }
+#endif
+}
+
+bool SyslogSink::isConnected() const {
+    return socketFd >= 0;
+}
+
+uint64_t SyslogSink::getDroppedCount() const {
+    return droppedCount;
+}
+
+int SyslogSink::toSeverity(const Level level) {
+    switch (level) {
+        case Level::Trace:
+        case Level::Debug:
+            return SEVERITY_DEBUG;
+        case Level::Warn:
+            return SEVERITY_WARNING;
+        case Level::Error:
+            return SEVERITY_ERR;
+        case Level::Fatal:
+            return SEVERITY_CRIT;
+        default:
+            return SEVERITY_INFO;
+    }
+}
+
+/**
+ * The journald native protocol writes each field as "NAME=value\n". A value that contains a newline is written as
+ * the name, a newline, its size as a 64-bit little-endian integer, the value, and a newline.
+ */
+void SyslogSink::appendJournaldField(const char* name, const std::string_view value) {
+    pending += name;
+    if (value.find('\n') == std::string_view::npos) {
+        pending += '=';
+    }
+    else {
+        pending += '\n';
+        uint64_t size = value.size();
+        for (size_t i = 0; i < sizeof(size); i++) {
+            pending += static_cast<char>(size & 0xFF);
+            size >>= 8;
+        }
+    }
+    pending += value;
+    pending += '\n';
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+
+/**
+ * Errors that only affect one message, such as a message that is too large, drop that message. If the receiver's
+ * queue is full, the sink waits briefly for room, then drops the rest of the batch rather than stalling the log
+ * thread. Any other error means the receiver went away, so the socket is closed and connected again on a later flush.
+ */
+void SyslogSink::flush() {
+    if (pendingDatagrams.empty()) {
+        return;
+    }
+    connectIfNeeded();
+
+    size_t sent = 0;
+    while (socketFd >= 0 && sent < pendingDatagrams.size()) {
+        int result = 0;
+#if defined(__linux__)
+        mmsghdr messages[SEND_BATCH_SIZE];
+        iovec parts[SEND_BATCH_SIZE];
+        const size_t count = std::min(SEND_BATCH_SIZE, pendingDatagrams.size() - sent);
+        for (size_t i = 0; i < count; i++) {
+            const auto& datagram = pendingDatagrams[sent + i];
+            parts[i].iov_base = pending.data() + datagram.first;
+            parts[i].iov_len = datagram.second;
+            messages[i] = mmsghdr{};
+            messages[i].msg_hdr.msg_iov = &parts[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+        result = sendmmsg(socketFd, messages, static_cast<unsigned int>(count), MSG_DONTWAIT | MSG_NOSIGNAL);
+#else
+        const auto& datagram = pendingDatagrams[sent];
+        result = send(socketFd, pending.data() + datagram.first, datagram.second, MSG_DONTWAIT) < 0 ? -1 : 1;
+#endif
+        if (result > 0) {
+            sent += static_cast<size_t>(result);
+        }
+        else if (errno == EINTR) {
+            continue;
+        }
+        else if (errno == EMSGSIZE) {
+            sent++;
+            droppedCount++;
+        }
+        else if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS) {
+            pollfd writable{};
+            writable.fd = socketFd;
+            writable.events = POLLOUT;
+            if (poll(&writable, 1, SEND_WAIT_MS) <= 0) {
+                break;
+            }
+        }
+        else {
+            disconnect();
+        }
+    }
+
+    droppedCount += pendingDatagrams.size() - sent;
+    pending.clear();
+    pendingDatagrams.clear();
+}
+
+void SyslogSink::connectIfNeeded() {
+    const auto now = std::chrono::steady_clock::now();
+    if (socketFd >= 0 || (hasConnectAttempt && now - lastConnectAttempt < RECONNECT_INTERVAL)) {
+        return;
+    }
+    hasConnectAttempt = true;
+    lastConnectAttempt = now;
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    const std::string path = socketPath.string();
+    if (path.size() >= sizeof(address.sun_path)) {
+        return;
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+#if defined(SOCK_CLOEXEC)
+    const int fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+#else
+    const int fd = socket(AF_UNIX, SOCK_DGRAM, 0);
+#endif
+    if (fd < 0) {
+        return;
+    }
+    if (connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        close(fd);
+        return;
+    }
+    socketFd = fd;
+}
+
+void SyslogSink::disconnect() {
+    if (socketFd >= 0) {
+        close(socketFd);
+        socketFd = -1;
+    }
+}
+
+#else
+
+void SyslogSink::flush() {
+    droppedCount += pendingDatagrams.size();
+    pending.clear();
+    pendingDatagrams.clear();
+}
+
+void SyslogSink::connectIfNeeded() {}
+
+void SyslogSink::disconnect() {}
+
+#endif // #if defined(__unix__) || defined(__APPLE__)
+
+} // namespace log
+} // namespace rk
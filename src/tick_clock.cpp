@@ -0,0 +1,127 @@
+/**
+ * @file tick_clock.cpp
+ * @brief Source file for the clock that logging threads read raw ticks from, which the log thread converts to wall time.
+ */
+#include <rk_logger/tick_clock.h>
+
+#if RK_LOG_HAS_TSC
+#include <cpuid.h>
+#endif
+
+namespace rk {
+namespace time_internal {
+
+namespace {
+
+constexpr std::chrono::milliseconds INITIAL_CALIBRATION_DURATION(10);
+constexpr std::chrono::seconds RECALIBRATION_INTERVAL(1);
+
+int64_t systemNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(system_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * Reads the ticks on both sides of reading system_clock and uses the midpoint, so that the pairing isn't skewed by
+ * how long system_clock takes to read.
+ */
+TickCalibration samplePair(const TickSource source) {
+    auto readTicks = [source] () { return source == TickSource::Tsc ? readTsc() : readSteadyNs(); };
+    TickCalibration sample;
+    const uint64_t before = readTicks();
+    sample.baseNs = systemNowNs();
+    const uint64_t after = readTicks();
+    sample.baseTicks = before + (after - before) / 2;
+    return sample;
+}
+
+} // namespace
+
+bool isInvariantTscAvailable() {
+#if RK_LOG_HAS_TSC
+    constexpr unsigned int ADVANCED_POWER_MANAGEMENT_LEAF = 0x80000007;
+    constexpr unsigned int INVARIANT_TSC_BIT = 1u << 8;
+    unsigned int eax = 0;
+    unsigned int ebx = 0;
+    unsigned int ecx = 0;
+    unsigned int edx = 0;
+    if (__get_cpuid_max(0x80000000, nullptr) < ADVANCED_POWER_MANAGEMENT_LEAF) {
+        return false;
+    }
+    __get_cpuid(ADVANCED_POWER_MANAGEMENT_LEAF, &eax, &ebx, &ecx, &edx);
+    return (edx & INVARIANT_TSC_BIT) != 0;
+#else
+    return false;
+#endif
+}
+
+void TickClock::configure(const rk::config::Config& config) {
+    const rk::config::ConfigValue configuredSource = config.getConfigValueByKey(rk::config::clock_source::KEY);
+    TickSource newSource = TickSource::System;
+    if (configuredSource == rk::config::clock_source::TSC) {
+        if (isInvariantTscAvailable()) {
+            newSource = TickSource::Tsc;
+        }
+        else {
+            timeLog("The CPU doesn't have an invariant TSC. Using steady_clock instead\n");
+            newSource = TickSource::Steady;
+        }
+    }
+    else if (configuredSource == rk::config::clock_source::STEADY) {
+        newSource = TickSource::Steady;
+    }
+
+    std::lock_guard<std::mutex> lock(calibrationMutex);
+    source = newSource;
+    if (newSource != TickSource::System) {
+        calibrate(true);
+    }
+}
+
+TickCalibration TickClock::getCalibration() {
+    std::lock_guard<std::mutex> lock(calibrationMutex);
+    if (source.load(std::memory_order_relaxed) != TickSource::System && std::chrono::steady_clock::now() >= nextCalibration) {
+        calibrate(false);
+    }
+    return calibration;
+}
+
+void TickClock::lockForFork() {
+    calibrationMutex.lock();
+}
+
+void TickClock::unlockAfterFork() {
+    calibrationMutex.unlock();
+}
+
+/**
+ * steady_clock already ticks in nanoseconds, so only the offset to system_clock is measured. For the TSC, the first
+ * calibration spins for a short time to get a rough rate. Later calibrations measure the rate over everything since
+ * the first one.
+ */
+void TickClock::calibrate(const bool isInitial) {
+    const TickSource currentSource = source.load(std::memory_order_relaxed);
+    if (isInitial) {
+        initialCalibration = samplePair(currentSource);
+        if (currentSource == TickSource::Tsc) {
+            const auto spinEnd = std::chrono::steady_clock::now() + INITIAL_CALIBRATION_DURATION;
+            while (std::chrono::steady_clock::now() < spinEnd) {}
+        }
+    }
+
+    TickCalibration sample = samplePair(currentSource);
+    sample.nsPerTick = calibration.nsPerTick;
+    if (currentSource == TickSource::Tsc && sample.baseTicks > initialCalibration.baseTicks) {
+        const double measured = static_cast<double>(sample.baseNs - initialCalibration.baseNs) / static_cast<double>(sample.baseTicks - initialCalibration.baseTicks);
+        if (measured > 0) { // Keeps the previous rate if system_clock was set back
+            sample.nsPerTick = measured;
+        }
+    }
+    else if (currentSource == TickSource::Steady) {
+        sample.nsPerTick = 1.0;
+    }
+    calibration = sample;
+    nextCalibration = std::chrono::steady_clock::now() + RECALIBRATION_INTERVAL;
+}
+
+} // namespace time_internal
+} // namespace rk
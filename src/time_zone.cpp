@@ -0,0 +1,204 @@
+/**
+ * @file time_zone.cpp
+ * @brief Source file for converting times to the local time zone without std::localtime.
+ */
+#include <ctime>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include <exception>
+
+#include <rk_logger/time_zone.h>
+
+namespace rk {
+namespace time_internal {
+
+namespace {
+
+constexpr int64_t SECONDS_PER_DAY = 86400;
+constexpr int64_t SECONDS_PER_HOUR = 3600;
+constexpr int64_t MAX_PERIOD_SECONDS = 31 * SECONDS_PER_DAY; /**< Limits how far a lookup searches for a transition */
+constexpr int64_t MAX_PROBE_STEP_SECONDS = SECONDS_PER_DAY; /**< Shorter than any DST period, so no transition pair is skipped */
+
+int64_t floorDiv(const int64_t a, const int64_t b) {
+    return a / b - ((a % b != 0) && ((a < 0) != (b < 0)));
+}
+
+/**
+ * Days since the epoch for a date in the proleptic Gregorian calendar. From Howard Hinnant's "chrono-Compatible
+ * Low-Level Date Algorithms".
+ */
+int64_t daysFromCivil(int64_t year, const int64_t month, const int64_t day) {
+    year -= month <= 2;
+    const int64_t era = floorDiv(year, 400);
+    const int64_t yearOfEra = year - era * 400;
+    const int64_t dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const int64_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+/**
+ * @brief Finds the end of the period with the same offset, searching forward or backward from a point in time.
+ * 
+ * Probes at growing steps until the offset changes, then narrows the change down to the second.
+ * 
+ * @param epochSeconds Where to start. Its offset is offset.
+ * @param offset The offset at epochSeconds.
+ * @param direction 1 to search forward, -1 to search backward.
+ * @return The last second (in the search direction) with the same offset, or the search limit.
+ */
+int64_t findLastSameOffset(const int64_t epochSeconds, const int64_t offset, const int64_t direction) {
+    int64_t same = 0; // Distances from epochSeconds
+    int64_t step = SECONDS_PER_HOUR;
+    while (same < MAX_PERIOD_SECONDS) {
+        const int64_t probe = std::min(same + step, MAX_PERIOD_SECONDS);
+        if (computeUtcOffset(epochSeconds + direction * probe) != offset) {
+            // The transition is in (same, probe]
+            int64_t different = probe;
+            while (different - same > 1) {
+                const int64_t middle = same + (different - same) / 2;
+                if (computeUtcOffset(epochSeconds + direction * middle) == offset) {
+                    same = middle;
+                }
+                else {
+                    different = middle;
+                }
+            }
+            return epochSeconds + direction * same;
+        }
+        same = probe;
+        step = std::min(step * 2, MAX_PROBE_STEP_SECONDS);
+    }
+    return epochSeconds + direction * same;
+}
+
+/**
+ * The offset is the local time from localtime_r() read back as if it were UTC, minus the actual time. This works
+ * without tm_gmtoff or timegm(), which aren't available everywhere.
+ */
+int64_t computeUtcOffsetWithLocaltime(const int64_t epochSeconds) {
+    const std::time_t time = static_cast<std::time_t>(epochSeconds);
+    std::tm local{};
+#if defined(_WIN32)
+    if (localtime_s(&local, &time) != 0) {
+        return 0;
+    }
+#else
+    if (localtime_r(&time, &local) == nullptr) {
+        return 0;
+    }
+#endif
+    const int64_t localSeconds = daysFromCivil(local.tm_year + 1900, local.tm_mon + 1, local.tm_mday) * SECONDS_PER_DAY +
+        local.tm_hour * SECONDS_PER_HOUR + local.tm_min * 60 + local.tm_sec;
+    return localSeconds - epochSeconds;
+}
+
+} // namespace
+
+CivilTime toCivilTime(const int64_t seconds) {
+    const int64_t days = floorDiv(seconds, SECONDS_PER_DAY);
+    const int64_t secondOfDay = seconds - days * SECONDS_PER_DAY;
+
+    // The inverse of daysFromCivil()
+    const int64_t shifted = days + 719468;
+    const int64_t era = floorDiv(shifted, 146097);
+    const int64_t dayOfEra = shifted - era * 146097;
+    const int64_t yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    const int64_t dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    const int64_t monthIndex = (5 * dayOfYear + 2) / 153;
+    const int64_t month = monthIndex < 10 ? monthIndex + 3 : monthIndex - 9;
+
+    CivilTime civil;
+    civil.year = static_cast<int>(yearOfEra + era * 400 + (month <= 2));
+    civil.month = static_cast<int>(month);
+    civil.day = static_cast<int>(dayOfYear - (153 * monthIndex + 2) / 5 + 1);
+    civil.hour = static_cast<int>(secondOfDay / SECONDS_PER_HOUR);
+    civil.minute = static_cast<int>(secondOfDay % SECONDS_PER_HOUR / 60);
+    civil.second = static_cast<int>(secondOfDay % 60);
+    return civil;
+}
+
+int64_t fromCivilTime(const CivilTime& civil) {
+    return daysFromCivil(civil.year, civil.month, civil.day) * SECONDS_PER_DAY + civil.hour * SECONDS_PER_HOUR +
+        civil.minute * 60 + civil.second;
+}
+
+/**
+ * The C++20 time zone database doesn't understand POSIX TZ strings such as "EST5EDT,M3.2.0,M11.1.0", so the C
+ * library is used whenever TZ is set.
+ */
+int64_t computeUtcOffset(const int64_t epochSeconds) {
+#if defined(__cpp_lib_chrono) && __cpp_lib_chrono >= 201907L
+    if (std::getenv("TZ") == nullptr) {
+        try {
+            const std::chrono::sys_seconds time{std::chrono::seconds(epochSeconds)};
+            return std::chrono::current_zone()->get_info(time).offset.count();
+        }
+        catch (const std::exception&) {
+            // The database isn't installed. Fall back to the C library
+        }
+    }
+#endif
+    return computeUtcOffsetWithLocaltime(epochSeconds);
+}
+
+int64_t TimeZoneCache::getOffsetSeconds(const int64_t epochSeconds) {
+    if (isUtc.load(std::memory_order_relaxed)) {
+        return 0;
+    }
+
+    const uint64_t versionBefore = version.load(std::memory_order_acquire);
+    if ((versionBefore & 1) == 0) {
+        const int64_t start = periodStart.load(std::memory_order_relaxed);
+        const int64_t end = periodEnd.load(std::memory_order_relaxed);
+        const int64_t offset = offsetSeconds.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (version.load(std::memory_order_relaxed) == versionBefore && epochSeconds >= start && epochSeconds < end) {
+            return offset;
+        }
+    }
+    return update(epochSeconds);
+}
+
+void TimeZoneCache::setUtc(const bool utc) {
+    isUtc = utc;
+}
+
+void TimeZoneCache::reset() {
+    std::lock_guard<std::mutex> lock(updateMutex);
+    const uint64_t current = version.load(std::memory_order_relaxed);
+    version.store(current + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    periodStart.store(1, std::memory_order_relaxed);
+    periodEnd.store(0, std::memory_order_relaxed);
+    version.store(current + 2, std::memory_order_release);
+}
+
+/**
+ * The period is searched for around the requested time, up to a month in each direction. Lookups happen about once
+ * per DST period, or once a month in zones without DST.
+ */
+int64_t TimeZoneCache::update(const int64_t epochSeconds) {
+    std::lock_guard<std::mutex> lock(updateMutex);
+    const int64_t start = periodStart.load(std::memory_order_relaxed);
+    const int64_t end = periodEnd.load(std::memory_order_relaxed);
+    if (epochSeconds >= start && epochSeconds < end) { // Another thread already looked it up
+        return offsetSeconds.load(std::memory_order_relaxed);
+    }
+
+    const int64_t offset = computeUtcOffset(epochSeconds);
+    const int64_t newStart = findLastSameOffset(epochSeconds, offset, -1);
+    const int64_t newEnd = findLastSameOffset(epochSeconds, offset, 1) + 1;
+
+    const uint64_t current = version.load(std::memory_order_relaxed);
+    version.store(current + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    periodStart.store(newStart, std::memory_order_relaxed);
+    periodEnd.store(newEnd, std::memory_order_relaxed);
+    offsetSeconds.store(offset, std::memory_order_relaxed);
+    version.store(current + 2, std::memory_order_release);
+    return offset;
+}
+
+} // namespace time_internal
+} // namespace rk
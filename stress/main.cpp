@@ -0,0 +1,529 @@
+/**
+ * @file main.cpp
+ * @brief Main file for rk_logger_stress, which logs from many threads at once in every queue, transport, and output
+ * mode, and checks that every message is written exactly once and in order per thread, or is accounted for as dropped.
+ *
+ * Usage: rk_logger_stress [--producers <count>] [--messages <count per producer>] [--seconds <soak time>] [--scenario <name>]
+ *
+ * Each message carries its producer and a sequence number, e.g., "stress p=3 seq=1041 ...", and the output of each
+ * scenario, whether it is a sink, log files, or a spill file, is read back and checked:
+ * - Every producer's sequence numbers are in increasing order, so nothing is duplicated or reordered within a thread.
+ * - Nothing is missing, unless the scenario can drop messages, and then the written and the dropped messages add up
+ *   to exactly what was logged.
+ * - Stopping the logger while the producers are still logging writes a gapless prefix of each producer's messages.
+ * - The logger stops within the watchdog time.
+ *
+ * With --seconds, the scenarios are run over and over until that much time has passed. The exit code is 1 if any
+ * check failed. Build it with the tsan or asan preset to also check for data races and memory errors.
+ */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <rk_logger/batch.h>
+#include <rk_logger/logger.h>
+#include <rk_logger/lz4.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+
+#include <rk_logger/log_agent.h>
+#include <rk_logger/shm_ring.h>
+#endif
+
+#if defined(__SANITIZE_THREAD__)
+#define IS_THREAD_SANITIZER_ENABLED 1
+#elif defined(__has_feature)
+#if __has_feature(thread_sanitizer)
+#define IS_THREAD_SANITIZER_ENABLED 1
+#endif
+#endif
+#ifndef IS_THREAD_SANITIZER_ENABLED
+#define IS_THREAD_SANITIZER_ENABLED 0
+#endif
+
+namespace {
+
+constexpr std::chrono::seconds WATCHDOG_TIME = std::chrono::seconds(300); /**< How long a scenario may take before it is considered hung */
+constexpr size_t BATCH_SIZE = 32;
+constexpr size_t SLOW_SINK_INTERVAL = 256; /**< The slow sink pauses after this many messages */
+constexpr size_t MAX_REPORTED_ERRORS = 10;
+const std::string MESSAGE_MARKER = "stress p=";
+const std::string DROPPED_NOTICE = " messages were dropped because the shutdown drain time ran out";
+const std::string SPILL_FILE_SUFFIX = "_unwritten.txt";
+
+enum class Output : uint8_t {
+    Sink, /**< An in-memory sink */
+    LogFile, /**< The log file or files, which are read back after the logger stops */
+    SharedMemory, /**< An in-memory sink of an agent that reads the logger's shared-memory ring on another thread */
+};
+
+enum class Producer : uint8_t {
+    Messages, /**< RK_LOG_TO */
+    Batches, /**< RK_LOG_BATCH, committed every BATCH_SIZE messages */
+};
+
+enum class Shutdown : uint8_t {
+    AfterProducers, /**< The logger is stopped after the producers are done, so every message has to be written */
+    WhileProducing, /**< The logger is stopped while the producers are logging */
+    DrainTimeout, /**< Stopping the logger doesn't wait for the queue, so what is left is dropped or spilled */
+};
+
+struct Scenario {
+    const char* name;
+    std::vector<std::pair<std::string, std::string>> config;
+    Output output = Output::Sink;
+    Producer producer = Producer::Messages;
+    Shutdown shutdown = Shutdown::AfterProducers;
+    bool isSinkSlow = false; /**< Makes the sink fall behind, so there is a backlog at shutdown */
+};
+
+/**
+ * Checks the messages of one run as they are read from the output.
+ */
+class Verifier {
+public:
+    Verifier(const size_t producerCount, const size_t messageCount) : messageCount(messageCount), nextSequences(producerCount, 0) {}
+
+    /**
+     * @brief Checks the lines of some output. A producer's lines have to be added in the order they were written.
+     */
+    void addText(std::string_view text) {
+        std::lock_guard<std::mutex> lock(mutex);
+        while (!text.empty()) {
+            const size_t lineEnd = text.find('\n');
+            const std::string_view line = text.substr(0, lineEnd);
+            text.remove_prefix(lineEnd == std::string_view::npos ? text.size() : lineEnd + 1);
+            addLine(line);
+        }
+    }
+
+    /**
+     * @brief Checks that every message was written, or dropped if the scenario can drop them.
+     *
+     * @param sentCounts How many messages each producer logged.
+     * @param isPrefixAllowed Whether a producer's last messages can be missing without being counted as dropped.
+     * @param extraDroppedCount Drops that were reported somewhere other than the output, e.g., by the agent.
+     */
+    void finish(const std::vector<size_t>& sentCounts, const bool isPrefixAllowed, const uint64_t extraDroppedCount) {
+        std::lock_guard<std::mutex> lock(mutex);
+        droppedCount += extraDroppedCount;
+        size_t sentCount = 0;
+        for (size_t producer = 0; producer < sentCounts.size(); producer++) {
+            sentCount += sentCounts[producer];
+            if (nextSequences[producer] > sentCounts[producer]) {
+                addError("producer " + std::to_string(producer) + " wrote " + std::to_string(nextSequences[producer]) +
+                    " messages but only logged " + std::to_string(sentCounts[producer]));
+            }
+            else if (!isPrefixAllowed && droppedCount == 0 && nextSequences[producer] != sentCounts[producer]) {
+                addError("producer " + std::to_string(producer) + " is missing its messages from " + std::to_string(nextSequences[producer]));
+            }
+        }
+        if (!isPrefixAllowed && writtenCount + droppedCount != sentCount) {
+            addError(std::to_string(writtenCount) + " written and " + std::to_string(droppedCount) + " dropped, but " +
+                std::to_string(sentCount) + " logged");
+        }
+    }
+
+    size_t getWrittenCount() const { return writtenCount; }
+    uint64_t getDroppedCount() const { return droppedCount; }
+    const std::vector<std::string>& getErrors() const { return errors; }
+
+private:
+    /**
+     * Drops make holes in a producer's sequence, so a message only has to be after the previous one then.
+     */
+    void addLine(const std::string_view line) {
+        const size_t markerPos = line.find(MESSAGE_MARKER);
+        if (markerPos == std::string_view::npos) {
+            const size_t noticePos = line.find(DROPPED_NOTICE);
+            if (noticePos != std::string_view::npos) {
+                const size_t numberStart = line.find_last_of(']', noticePos) + 1;
+                droppedCount += std::strtoull(std::string(line.substr(numberStart, noticePos - numberStart)).c_str(), nullptr, 10);
+            }
+            return;
+        }
+
+        size_t producer = 0;
+        size_t sequence = 0;
+        if (std::sscanf(std::string(line.substr(markerPos)).c_str(), "stress p=%zu seq=%zu", &producer, &sequence) != 2 ||
+            producer >= nextSequences.size() || sequence >= messageCount) {
+            addError("unexpected line: " + std::string(line));
+            return;
+        }
+        if (sequence < nextSequences[producer]) {
+            addError("producer " + std::to_string(producer) + " wrote " + std::to_string(sequence) + " after " +
+                std::to_string(nextSequences[producer] - 1));
+        }
+        else if (sequence > nextSequences[producer]) {
+            gapCount++;
+        }
+        nextSequences[producer] = std::max(nextSequences[producer], sequence + 1);
+        writtenCount++;
+    }
+
+    void addError(const std::string& error) {
+        if (errors.size() < MAX_REPORTED_ERRORS) {
+            errors.push_back(error);
+        }
+    }
+
+    const size_t messageCount;
+    std::mutex mutex;
+    std::vector<size_t> nextSequences;
+    size_t writtenCount = 0;
+    size_t gapCount = 0;
+    uint64_t droppedCount = 0;
+    std::vector<std::string> errors;
+};
+
+/**
+ * Passes what is written to the verifier, optionally pausing now and then like a slow disk.
+ */
+class VerifyingSink : public rk::log::Sink {
+public:
+    VerifyingSink(Verifier& verifier, const bool isSlow) : verifier(verifier), isSlow(isSlow) {}
+
+    void write(const std::string& message) override {
+        verifier.addText(message);
+        if (isSlow && ++writeCount % SLOW_SINK_INTERVAL == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+private:
+    Verifier& verifier;
+    const bool isSlow;
+    size_t writeCount = 0;
+};
+
+/**
+ * Aborts the process if a scenario takes too long, e.g., because stopping the logger hangs.
+ */
+class Watchdog {
+public:
+    explicit Watchdog(const char* scenarioName) : thread([this, scenarioName] () {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (!cv.wait_for(lock, WATCHDOG_TIME, [this] () { return isDone; })) {
+            std::fprintf(stderr, "%s didn't finish within %lld s\n", scenarioName, static_cast<long long>(WATCHDOG_TIME.count()));
+            std::abort();
+        }
+    }) {}
+
+    ~Watchdog() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            isDone = true;
+        }
+        cv.notify_all();
+        thread.join();
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool isDone = false;
+    std::thread thread;
+};
+
+/**
+ * @brief Logs a producer's messages. Some arguments are moved or deferred into the record, and some messages are
+ * long, so the splicing and the larger allocations are covered too.
+ *
+ * @return How many messages were logged.
+ */
+size_t produce(rk::log::Logger& logger, const Producer mode, const size_t producer, const size_t messageCount, const std::atomic<bool>& isStopping) {
+    static const std::string LONG_PAYLOAD(200, 'x');
+    std::unique_ptr<rk::log::Batch> batch = mode == Producer::Batches ? std::make_unique<rk::log::Batch>(logger) : nullptr;
+    size_t sequence = 0;
+    for (; sequence < messageCount && !isStopping.load(std::memory_order_relaxed); sequence++) {
+        if (batch) {
+            RK_LOG_BATCH(*batch, MESSAGE_MARKER, producer, " seq=", sequence, " batched\n");
+            if (sequence % BATCH_SIZE == BATCH_SIZE - 1) {
+                batch->commit();
+            }
+        }
+        else if (sequence % 16 == 0) {
+            RK_LOG_TO(logger, MESSAGE_MARKER, producer, " seq=", sequence, " ", rk::log::owned(std::string(LONG_PAYLOAD)), "\n");
+        }
+        else if (sequence % 16 == 1) {
+            RK_LOG_TO(logger, MESSAGE_MARKER, producer, " seq=", sequence, " ", rk::log::defer([sequence] () { return sequence * 2; }), "\n");
+        }
+        else {
+            RK_LOG_TO(logger, MESSAGE_MARKER, producer, " seq=", sequence, " ", sequence % 4 == 0 ? LONG_PAYLOAD : "short", "\n");
+        }
+    }
+    if (batch) {
+        batch->commit();
+    }
+    return sequence;
+}
+
+/**
+ * @brief Reads a log file, decoding it if it is compressed.
+ */
+std::string readLogFile(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (path.extension() != ".lz4") {
+        return contents;
+    }
+    std::string decoded;
+    rk::lz4_internal::FrameDecoder decoder;
+    if (!decoder.decode(contents.data(), contents.size(), decoded)) {
+        return "unable to decode " + path.string() + "\n";
+    }
+    return decoded;
+}
+
+/**
+ * @brief Finds the files that a logger wrote to the current directory, in the order of their names.
+ */
+std::vector<std::filesystem::path> findFiles(const std::string& loggerName) {
+    std::vector<std::filesystem::path> paths;
+    const std::string prefix = "logs_" + loggerName + "_";
+    for (const auto& entry : std::filesystem::directory_iterator(std::filesystem::current_path())) {
+        if (entry.path().filename().string().rfind(prefix, 0) == 0) {
+            paths.push_back(entry.path());
+        }
+    }
+    std::sort(paths.begin(), paths.end());
+    return paths;
+}
+
+bool endsWith(const std::string& text, const std::string& suffix) {
+    return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+/**
+ * @brief Runs a scenario once and prints the result.
+ *
+ * @return True if every check passed.
+ */
+bool runScenario(const Scenario& scenario, const size_t producerCount, const size_t messageCount) {
+    const Watchdog watchdog(scenario.name);
+    const std::string loggerName = std::string("stress_") + scenario.name;
+    Verifier verifier(producerCount, messageCount);
+    auto sink = std::make_shared<VerifyingSink>(verifier, scenario.isSinkSlow);
+    std::vector<size_t> sentCounts(producerCount, 0);
+    uint64_t agentDroppedCount = 0;
+    const auto start = std::chrono::steady_clock::now();
+    {
+        rk::log::Logger logger(loggerName);
+        rk::config::Config& config = logger.getConfig();
+        config.setConfigValue(rk::config::write_to_console::KEY, rk::config::write_to_console::DISABLE);
+        config.setConfigValue(rk::config::write_to_log_file::KEY,
+            scenario.output == Output::LogFile ? rk::config::write_to_log_file::ENABLE : rk::config::write_to_log_file::DISABLE);
+        for (const auto& [key, value] : scenario.config) {
+            config.setConfigValue(key, value);
+        }
+
+#if defined(__unix__) || defined(__APPLE__)
+        std::unique_ptr<rk::config::Config> agentConfig;
+        std::unique_ptr<rk::log::LogAgent> agent;
+        std::thread agentThread;
+        if (scenario.output == Output::SharedMemory) {
+            const std::string shmName = "/rk_stress_" + std::to_string(::getpid());
+            rk::shm_internal::removeRing(shmName);
+            config.setConfigValue(rk::config::log_transport::KEY, rk::config::log_transport::SHARED_MEMORY);
+            config.setConfigValue(rk::config::shm_name::KEY, shmName);
+            agentConfig = rk::config::createInstance();
+            agentConfig->setConfigValue(rk::config::write_to_console::KEY, rk::config::write_to_console::DISABLE);
+            agentConfig->setConfigValue(rk::config::write_to_log_file::KEY, rk::config::write_to_log_file::DISABLE);
+            agent = std::make_unique<rk::log::LogAgent>(shmName, *agentConfig);
+            agent->addSink(sink);
+            agentThread = std::thread([&agent] () {
+                if (agent->attach(std::chrono::seconds(10))) {
+                    agent->run();
+                }
+            });
+        }
+        else
+#endif
+        if (scenario.output == Output::Sink) {
+            logger.addSink(sink);
+        }
+
+        std::thread logThread = logger.start(std::filesystem::path());
+        std::atomic<bool> isStopping{false};
+        std::vector<std::thread> producers;
+        for (size_t producer = 0; producer < producerCount; producer++) {
+            producers.emplace_back([&, producer] () {
+                sentCounts[producer] = produce(logger, scenario.producer, producer, messageCount, isStopping);
+            });
+        }
+        if (scenario.shutdown == Shutdown::WhileProducing) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            logger.stop(std::move(logThread));
+            isStopping = true;
+        }
+        for (auto& producer : producers) {
+            producer.join();
+        }
+        if (logThread.joinable()) {
+            logger.stop(std::move(logThread));
+        }
+
+#if defined(__unix__) || defined(__APPLE__)
+        if (agentThread.joinable()) {
+            agentThread.join();
+            agentDroppedCount = agent->getDroppedCount();
+        }
+#endif
+    }
+
+    // The log files are closed once the logger is gone. The spill file goes last, since it has the newest messages
+    std::vector<std::filesystem::path> spillFiles;
+    for (const auto& path : findFiles(loggerName)) {
+        if (endsWith(path.filename().string(), SPILL_FILE_SUFFIX)) {
+            spillFiles.push_back(path);
+        }
+        else if (scenario.output == Output::LogFile) {
+            verifier.addText(readLogFile(path));
+        }
+    }
+    for (const auto& path : spillFiles) {
+        verifier.addText(readLogFile(path));
+    }
+    for (const auto& path : findFiles(loggerName)) {
+        std::filesystem::remove(path);
+    }
+
+    verifier.finish(sentCounts, scenario.shutdown == Shutdown::WhileProducing, agentDroppedCount);
+    const bool isPassed = verifier.getErrors().empty();
+    size_t sentCount = 0;
+    for (const size_t count : sentCounts) {
+        sentCount += count;
+    }
+    std::printf("%-28s %10zu %10zu %10llu %8.2f  %s\n", scenario.name, sentCount, verifier.getWrittenCount(),
+        static_cast<unsigned long long>(verifier.getDroppedCount()),
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(), isPassed ? "OK" : "FAILED");
+    for (const auto& error : verifier.getErrors()) {
+        std::printf("    %s\n", error.c_str());
+    }
+    std::fflush(stdout);
+    return isPassed;
+}
+
+std::vector<Scenario> createScenarios() {
+    using namespace rk::config;
+    std::vector<Scenario> scenarios = {
+        { "queue", {} },
+        { "queue_batches", {}, Output::Sink, Producer::Batches },
+        { "queue_tsc_clock", { { clock_source::KEY, clock_source::TSC } } },
+        { "shards_global", { { log_shards::KEY, "4" }, { log_shard_ordering::KEY, log_shard_ordering::GLOBAL } } },
+        { "shards_global_batches", { { log_shards::KEY, "4" }, { log_shard_ordering::KEY, log_shard_ordering::GLOBAL } }, Output::Sink, Producer::Batches },
+        { "shards_per_thread", { { log_shards::KEY, "4" }, { log_shard_ordering::KEY, log_shard_ordering::PER_THREAD } } },
+        { "shards_per_thread_batches", { { log_shards::KEY, "4" }, { log_shard_ordering::KEY, log_shard_ordering::PER_THREAD } }, Output::Sink, Producer::Batches },
+        { "log_file", { { log_shards::KEY, "4" }, { log_shard_ordering::KEY, log_shard_ordering::GLOBAL } }, Output::LogFile },
+        { "log_file_per_shard", { { log_shards::KEY, "4" }, { log_shard_ordering::KEY, log_shard_ordering::PER_THREAD },
+            { log_shard_files::KEY, log_shard_files::PER_SHARD } }, Output::LogFile },
+        { "log_file_lz4", { { log_file_compression::KEY, log_file_compression::LZ4 }, { log_file_frame_ms::KEY, "0" } }, Output::LogFile },
+        { "log_file_indexed", { { log_file_index::KEY, log_file_index::ENABLE } }, Output::LogFile, Producer::Batches },
+        { "stop_while_logging", {}, Output::Sink, Producer::Messages, Shutdown::WhileProducing },
+        { "stop_while_logging_shards", { { log_shards::KEY, "4" }, { log_shard_ordering::KEY, log_shard_ordering::GLOBAL } }, Output::Sink,
+            Producer::Batches, Shutdown::WhileProducing },
+        { "drain_timeout_drop", { { shutdown_drain_ms::KEY, "0" }, { shutdown_leftovers::KEY, shutdown_leftovers::DROP } }, Output::Sink,
+            Producer::Messages, Shutdown::DrainTimeout, true },
+        { "drain_timeout_spill", { { log_shards::KEY, "4" }, { log_shard_ordering::KEY, log_shard_ordering::PER_THREAD },
+            { shutdown_drain_ms::KEY, "0" }, { shutdown_leftovers::KEY, shutdown_leftovers::SPILL } }, Output::Sink,
+            Producer::Messages, Shutdown::DrainTimeout, true },
+    };
+#if (defined(__unix__) || defined(__APPLE__)) && !IS_THREAD_SANITIZER_ENABLED
+    // The logger and the agent map the ring at different addresses, so ThreadSanitizer can't match up their atomics
+    // within one process
+    scenarios.push_back({ "shared_memory", {}, Output::SharedMemory });
+    scenarios.push_back({ "shared_memory_small_ring", { { shm_size_kb::KEY, "64" } }, Output::SharedMemory });
+#endif
+    return scenarios;
+}
+
+int printUsage(const char* program) {
+    std::fprintf(stderr, "Usage: %s [--producers <count>] [--messages <count per producer>] [--seconds <soak time>] [--scenario <name>]\n", program);
+    return 1;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t producerCount = 8;
+    size_t messageCount = 20000;
+    double soakSeconds = 0;
+    std::string scenarioName;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            return printUsage(argv[0]);
+        }
+        if (arg == "--producers") {
+            producerCount = std::strtoul(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--messages") {
+            messageCount = std::strtoul(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--seconds") {
+            soakSeconds = std::strtod(argv[++i], nullptr);
+        }
+        else if (arg == "--scenario") {
+            scenarioName = argv[++i];
+        }
+        else {
+            return printUsage(argv[0]);
+        }
+    }
+    if (producerCount == 0 || messageCount == 0) {
+        return printUsage(argv[0]);
+    }
+
+    const std::vector<Scenario> scenarios = createScenarios();
+    if (!scenarioName.empty() && std::none_of(scenarios.begin(), scenarios.end(), [&scenarioName] (const Scenario& scenario) {
+        return scenarioName == scenario.name;
+    })) {
+        std::fprintf(stderr, "No scenario is named %s\n", scenarioName.c_str());
+        return 1;
+    }
+
+    // Log files are written to the current directory, so they go to a directory of their own
+    const std::filesystem::path originalDirectory = std::filesystem::current_path();
+    const std::filesystem::path directory = std::filesystem::temp_directory_path()/("rk_logger_stress_" + std::to_string(
+        std::chrono::steady_clock::now().time_since_epoch().count()));
+    std::filesystem::create_directories(directory);
+    std::filesystem::current_path(directory);
+
+    // The loggers' internal messages, e.g., "Starting RK Logger", would bury the results
+    std::ostringstream discarded;
+    std::streambuf* const coutBuffer = std::cout.rdbuf(discarded.rdbuf());
+
+    std::printf("%zu producers x %zu messages\n\n", producerCount, messageCount);
+    std::printf("%-28s %10s %10s %10s %8s\n", "scenario", "logged", "written", "dropped", "seconds");
+    const auto start = std::chrono::steady_clock::now();
+    size_t runCount = 0;
+    size_t failureCount = 0;
+    do {
+        for (const Scenario& scenario : scenarios) {
+            if (scenarioName.empty() || scenarioName == scenario.name) {
+                failureCount += runScenario(scenario, producerCount, messageCount) ? 0 : 1;
+                runCount++;
+            }
+            discarded.str("");
+        }
+    } while (std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() < soakSeconds);
+
+    std::cout.rdbuf(coutBuffer);
+    std::filesystem::current_path(originalDirectory);
+    std::filesystem::remove_all(directory);
+    std::printf("\n%zu of %zu runs passed\n", runCount - failureCount, runCount);
+    return failureCount == 0 ? 0 : 1;
+}
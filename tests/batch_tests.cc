@@ -0,0 +1,135 @@
+#include <thread>
+
+#include <rk_logger/batch.h>
+#include "batch_tests.h"
+
+namespace rk_logger_tests {
+namespace batch_tests {
+
+// The messages of a batch are written together, even while other threads are logging and committing batches
+TEST_P(BatchTest, MessagesStayContiguous) {
+    SCOPED_TRACE("Logging batches and single messages from several threads");
+    std::vector<std::thread> producers;
+    for (size_t producer = 0; producer < PRODUCER_COUNT; producer++) {
+        producers.emplace_back([this, producer] () {
+            for (size_t batchIndex = 0; batchIndex < BATCHES_PER_PRODUCER; batchIndex++) {
+                rk::log::Batch batch(logger);
+                for (size_t i = 0; i < MESSAGES_PER_BATCH; i++) {
+                    RK_LOG_BATCH(batch, "batch=", producer, "_", batchIndex, " seq=", i, "\n");
+                }
+                RK_LOG_TO(logger, "single\n");
+                batch.commit();
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    const std::vector<std::string> lines = stopAndGetLines();
+
+    SCOPED_TRACE("Checking the output");
+    size_t batchLines = 0;
+    for (size_t i = 0; i < lines.size(); i++) {
+        const size_t batchPos = lines[i].find("batch=");
+        if (batchPos == std::string::npos) {
+            continue;
+        }
+        const std::string batchId = lines[i].substr(batchPos, lines[i].find(" seq=") - batchPos);
+        ASSERT_NE(lines[i].find(" seq=0"), std::string::npos) << "A batch doesn't start with its first message";
+        for (size_t seq = 0; seq < MESSAGES_PER_BATCH; seq++) {
+            ASSERT_LT(i + seq, lines.size());
+            ASSERT_EQ(lines[i + seq].substr(lines[i + seq].find("batch=")), batchId + " seq=" + std::to_string(seq));
+        }
+        batchLines += MESSAGES_PER_BATCH;
+        i += MESSAGES_PER_BATCH - 1;
+    }
+    ASSERT_EQ(batchLines, PRODUCER_COUNT * BATCHES_PER_PRODUCER * MESSAGES_PER_BATCH);
+    ASSERT_EQ(lines.size(), PRODUCER_COUNT * BATCHES_PER_PRODUCER * (MESSAGES_PER_BATCH + 1));
+}
+
+TEST_P(BatchTest, SharedTimestamp) {
+    {
+        rk::log::Batch batch(logger, rk::log::Batch::Timestamp::Shared);
+        for (size_t i = 0; i < MESSAGES_PER_BATCH; i++) {
+            RK_LOG_BATCH(batch, "seq=", i, "\n");
+        }
+    }
+    const std::vector<std::string> lines = stopAndGetLines();
+
+    ASSERT_EQ(lines.size(), MESSAGES_PER_BATCH);
+    const std::string timeStamp = lines[0].substr(0, lines[0].find(']'));
+    for (const std::string& line : lines) {
+        ASSERT_EQ(line.substr(0, line.find(']')), timeStamp);
+    }
+}
+
+TEST_P(BatchTest, CommittedOnDestructionAndOnlyOnce) {
+    {
+        rk::log::Batch batch(logger);
+        RK_LOG_BATCH(batch, "first\n");
+        batch.commit();
+        ASSERT_EQ(batch.size(), 0);
+        batch.commit(); // Nothing left to commit
+        RK_LOG_BATCH(batch, "second\n");
+        ASSERT_EQ(batch.size(), 1);
+    }
+    const std::vector<std::string> lines = stopAndGetLines();
+
+    ASSERT_EQ(lines.size(), 2);
+    ASSERT_NE(lines[0].find("]first"), std::string::npos);
+    ASSERT_NE(lines[1].find("]second"), std::string::npos);
+}
+
+TEST_P(BatchTest, LevelCheckedBeforeArgumentsAreEvaluated) {
+    logger.setLevel(rk::log::Level::Warn);
+    size_t evaluations = 0;
+    auto evaluate = [&evaluations] () { return ++evaluations; };
+    {
+        rk::log::Batch batch(logger);
+        RK_LOG_BATCH_AT(batch, rk::log::Level::Debug, "dropped ", evaluate(), "\n");
+        RK_LOG_BATCH(batch, "dropped ", evaluate(), "\n");
+        RK_LOG_BATCH_AT(batch, rk::log::Level::Error, "kept ", evaluate(), "\n");
+        ASSERT_EQ(batch.size(), 1);
+    }
+    const std::vector<std::string> lines = stopAndGetLines();
+
+    ASSERT_EQ(evaluations, 1);
+    ASSERT_EQ(lines.size(), 1);
+    ASSERT_NE(lines[0].find("]kept 1"), std::string::npos);
+}
+
+// A batch that is opened while another one on the same thread is still open works independently of it
+TEST_P(BatchTest, NestedBatches) {
+    {
+        rk::log::Batch outer(logger);
+        RK_LOG_BATCH(outer, "outer 0\n");
+        {
+            rk::log::Batch inner(logger);
+            RK_LOG_BATCH(inner, "inner 0\n");
+            RK_LOG_BATCH(inner, "inner 1\n");
+        }
+        RK_LOG_BATCH(outer, "outer 1\n");
+    }
+    const std::vector<std::string> lines = stopAndGetLines();
+
+    ASSERT_EQ(lines.size(), 4);
+    ASSERT_NE(lines[0].find("]inner 0"), std::string::npos);
+    ASSERT_NE(lines[1].find("]inner 1"), std::string::npos);
+    ASSERT_NE(lines[2].find("]outer 0"), std::string::npos);
+    ASSERT_NE(lines[3].find("]outer 1"), std::string::npos);
+}
+
+INSTANTIATE_TEST_SUITE_P(BatchTest,
+    BatchTest,
+    testing::Values(
+        BatchTestParam("one_shard", "1", rk::config::log_shard_ordering::GLOBAL),
+        BatchTestParam("four_shards_global", "4", rk::config::log_shard_ordering::GLOBAL),
+        BatchTestParam("four_shards_per_thread", "4", rk::config::log_shard_ordering::PER_THREAD)
+    ),
+    [](const testing::TestParamInfo<BatchTestParam>& info) {
+        return info.param.description;
+    }
+);
+
+} // namespace batch_tests
+} // namespace rk_logger_tests
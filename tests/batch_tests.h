@@ -0,0 +1,63 @@
+#ifndef BATCH_TESTS_H
+#define BATCH_TESTS_H
+
+#include <rk_logger/logger.h>
+#include <rk_logger/batch.h>
+#include <rk_logger_tests/test_base.h>
+
+namespace rk_logger_tests {
+namespace batch_tests {
+
+struct BatchTestParam : public BaseParam {
+    BatchTestParam(const std::string description, const std::string shardCount, const rk::config::ConfigValue ordering)
+        : BaseParam(description), shardCount(shardCount), ordering(ordering) {};
+
+    const std::string shardCount;
+    const rk::config::ConfigValue ordering;
+};
+
+class BatchTest : public Base, public ::testing::WithParamInterface<BatchTestParam> {
+protected:
+    static constexpr size_t PRODUCER_COUNT = 4;
+    static constexpr size_t BATCHES_PER_PRODUCER = 20;
+    static constexpr size_t MESSAGES_PER_BATCH = 50;
+
+    void SetUp() override {
+        redirectStdCout();
+        logger.getConfig().setConfigValue(rk::config::write_to_log_file::KEY, rk::config::write_to_log_file::DISABLE);
+        logger.getConfig().setConfigValue(rk::config::write_to_console::KEY, rk::config::write_to_console::DISABLE);
+        logger.getConfig().setConfigValue(rk::config::log_shards::KEY, GetParam().shardCount);
+        logger.getConfig().setConfigValue(rk::config::log_shard_ordering::KEY, GetParam().ordering);
+        logger.getConfig().setConfigValue(rk::config::timestamp_precision::KEY, rk::config::timestamp_precision::NS);
+        logger.addSink(sink);
+        ASSERT_NO_FATAL_FAILURE(Base::startLogger(std::filesystem::path()));
+    }
+
+    void TearDown() override {
+        if (logThread.joinable()) {
+            Base::stopLogger();
+        }
+        undoRedirectStdCout();
+    }
+
+    /**
+     * @brief Stops the logger and splits the output into lines.
+     */
+    std::vector<std::string> stopAndGetLines() {
+        Base::stopLogger();
+        std::vector<std::string> lines;
+        std::istringstream output(sink->str());
+        std::string line;
+        while (std::getline(output, line)) {
+            lines.push_back(line);
+        }
+        return lines;
+    }
+
+    std::shared_ptr<StringSink> sink = std::make_shared<StringSink>();
+};
+
+} // namespace batch_tests
+} // namespace rk_logger_tests
+
+#endif // #ifndef BATCH_TESTS_H
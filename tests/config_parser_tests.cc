@@ -0,0 +1,155 @@
+#include <random>
+
+#include <rk_logger/config.h>
+#include <rk_logger/config_parser.h>
+#include "config_parser_tests.h"
+
+namespace rk_logger_tests {
+namespace config_parser_tests {
+
+TEST_P(ConfigParserTest, ParseText) {
+    const std::vector<ExpectedEntry> entries = parseAll(GetParam().text);
+    const std::vector<ExpectedEntry>& expected = GetParam().expected;
+
+    ASSERT_EQ(entries.size(), expected.size());
+    for (size_t i = 0; i < entries.size(); i++) {
+        SCOPED_TRACE("Entry " + std::to_string(i));
+        ASSERT_EQ(entries[i].line, expected[i].line);
+        ASSERT_EQ(entries[i].key, expected[i].key);
+        ASSERT_EQ(entries[i].value, expected[i].value);
+        ASSERT_EQ(entries[i].error, expected[i].error);
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(ConfigParserTest,
+    ConfigParserTest,
+    testing::Values(
+        ConfigParserTestParam("empty", "", {}),
+        ConfigParserTestParam("only_comments_and_blank_lines", "# comment\n\n   \n\t\n  # indented comment\n", {}),
+        ConfigParserTestParam("key_value", "a: b\nc:d\n", { { 1, "a", "b", "" }, { 2, "c", "d", "" } }),
+        ConfigParserTestParam("no_newline_at_end", "a: b", { { 1, "a", "b", "" } }),
+        ConfigParserTestParam("crlf", "a: b\r\nc: d\r\n", { { 1, "a", "b", "" }, { 2, "c", "d", "" } }),
+        ConfigParserTestParam("whitespace_trimmed", "a  :   b  \t\n", { { 1, "a", "b", "" } }),
+        ConfigParserTestParam("inline_comment", "a: b # comment\nc: d\t# comment\n", { { 1, "a", "b", "" }, { 2, "c", "d", "" } }),
+        ConfigParserTestParam("hash_inside_value", "a: b#c\n", { { 1, "a", "b#c", "" } }),
+        ConfigParserTestParam("colon_inside_value", "a: 12:30\n", { { 1, "a", "12:30", "" } }),
+        ConfigParserTestParam("double_quoted", "a: \" b # c \"\n", { { 1, "a", " b # c ", "" } }),
+        ConfigParserTestParam("single_quoted", "a: 'b' # comment\n", { { 1, "a", "b", "" } }),
+        ConfigParserTestParam("double_quoted_escapes", "a: \"x\\\"y\\\\z\"\n", { { 1, "a", "x\"y\\z", "" } }),
+        ConfigParserTestParam("single_quoted_escape", "a: 'it''s'\n", { { 1, "a", "it's", "" } }),
+        ConfigParserTestParam("empty_quoted", "a: \"\"\n", { { 1, "a", "", "" } }),
+        ConfigParserTestParam("sections",
+            "sinks:\n"
+            "  console:\n"
+            "    enabled: ENABLE\n"
+            "    level: WARN # comment\n"
+            "  file:\n"
+            "    enabled: DISABLE\n"
+            "date_format: YYYY_MM_DD\n",
+            {
+                { 3, "sinks.console.enabled", "ENABLE", "" },
+                { 4, "sinks.console.level", "WARN", "" },
+                { 6, "sinks.file.enabled", "DISABLE", "" },
+                { 7, "date_format", "YYYY_MM_DD", "" },
+            }),
+        ConfigParserTestParam("section_with_comment", "a: # comment\n  b: c\n", { { 2, "a.b", "c", "" } }),
+        ConfigParserTestParam("missing_separator", "a: b\nnot a setting\nc: d\n",
+            { { 1, "a", "b", "" }, { 2, "", "", "Expected \"key: value\" or \"section:\"" }, { 3, "c", "d", "" } }),
+        ConfigParserTestParam("empty_key", ": b\n", { { 1, "", "", "The key is empty" } }),
+        ConfigParserTestParam("tab_indentation", "a:\n\tb: c\n", { { 2, "", "", "Tabs can't be used for indentation" } }),
+        ConfigParserTestParam("unexpected_indentation", "a: b\n  c: d\n", { { 1, "a", "b", "" }, { 2, "", "", "Unexpected indentation" } }),
+        ConfigParserTestParam("unterminated_quote", "a: \"b\n", { { 1, "", "", "The quoted value is missing its closing quote" } }),
+        ConfigParserTestParam("text_after_quote", "a: \"b\" c\n", { { 1, "", "", "Unexpected text after the quoted value" } }),
+        ConfigParserTestParam("unsupported_escape", "a: \"b\\n\"\n", { { 1, "", "", "Only \\\" and \\\\ can be escaped in a quoted value" } })
+    ),
+    [](const testing::TestParamInfo<ConfigParserTestParam>& info) {
+        return info.param.description;
+    }
+);
+
+// The values from the file are applied even with comments and quotes, and bad lines are reported by line number
+TEST_F(ConfigParserFileTest, ParseLoggingConfig) {
+    ASSERT_NO_FATAL_FAILURE(writeConfigFile(
+        "# Settings\n"
+        "date_format: YYYY_MM_DD # Sorts well\n"
+        "hour_format: \"24\"\n"
+        "log_thread_name: 'writer'\n"
+        "month_format MONTH_NAME\n"
+        "log_level: LOUD\n"
+    ));
+    config->parseLoggingConfig(configPath);
+
+    ASSERT_EQ(config->getConfigValueByKey(rk::config::date_format::KEY), rk::config::date_format::YYYY_MM_DD);
+    ASSERT_EQ(config->getConfigValueByKey(rk::config::hour_format::KEY), rk::config::hour_format::TWENTY_FOUR_HOUR);
+    ASSERT_EQ(config->getConfigValueByKey(rk::config::log_thread_name::KEY), "writer");
+    ASSERT_EQ(config->getConfigValueByKey(rk::config::month_format::KEY), rk::config::month_format::MONTH_NUM);
+    ASSERT_EQ(config->getConfigValueByKey(rk::config::log_level::KEY), rk::config::log_level::DEFAULT_LEVEL);
+    ASSERT_NE(logOutput.str().find("Line 5: Expected \"key: value\""), std::string::npos);
+    ASSERT_NE(logOutput.str().find("Line 6: Value \"LOUD\" for key \"log_level\" was not valid"), std::string::npos);
+}
+
+TEST_F(ConfigParserFileTest, EmptyFile) {
+    ASSERT_NO_FATAL_FAILURE(writeConfigFile(""));
+    config->parseLoggingConfig(configPath);
+
+    for (const auto& keyValuePair : rk::config_internal::defaultConfig) {
+        ASSERT_EQ(config->getConfigValueByKey(keyValuePair.first), keyValuePair.second);
+    }
+}
+
+/**
+ * Parses random mutations of the default config file. Whatever the input, the parser must not crash or read past
+ * the text, every entry must be well formed, and the config must only ever hold valid values.
+ */
+TEST_F(ConfigParserFileTest, RandomInput) {
+    constexpr size_t ITERATIONS = 300;
+    const std::string alphabet = " \t\r\n#:\"'\\.-_aZ9";
+    std::ifstream baseFile(std::filesystem::path(RK_LOGGER_TESTS_BASE_DIR)/"test_data"/rk::config::CONFIG_FILE_NAME);
+    const std::string base((std::istreambuf_iterator<char>(baseFile)), std::istreambuf_iterator<char>());
+    ASSERT_FALSE(base.empty());
+
+    std::mt19937 random(12345); // Fixed, so failures can be reproduced
+    for (size_t iteration = 0; iteration < ITERATIONS; iteration++) {
+        std::string text = base;
+        const size_t mutations = random() % 64;
+        for (size_t i = 0; i < mutations; i++) {
+            const size_t position = random() % (text.size() + 1);
+            switch (random() % 3) {
+                case 0: text.insert(position, 1, alphabet[random() % alphabet.size()]); break;
+                case 1: if (position < text.size()) { text.erase(position, 1); } break;
+                default: if (position < text.size()) { text[position] = static_cast<char>(random() % 256); } break;
+            }
+        }
+        if (random() % 4 == 0) {
+            text.resize(random() % (text.size() + 1));
+        }
+        SCOPED_TRACE("Iteration " + std::to_string(iteration));
+
+        const size_t lineCount = static_cast<size_t>(std::count(text.begin(), text.end(), '\n')) + 1;
+        rk::config_internal::ConfigParser parser(text);
+        rk::config_internal::ConfigEntry entry;
+        size_t lastLine = 0;
+        while (parser.next(entry)) {
+            ASSERT_GT(entry.line, lastLine);
+            ASSERT_LE(entry.line, lineCount);
+            lastLine = entry.line;
+            if (entry.error != nullptr) {
+                ASSERT_TRUE(entry.key.empty());
+                continue;
+            }
+            ASSERT_FALSE(entry.key.empty());
+            ASSERT_EQ(entry.key.find('\n'), std::string_view::npos);
+            ASSERT_EQ(entry.value.find('\n'), std::string_view::npos);
+        }
+
+        ASSERT_NO_FATAL_FAILURE(writeConfigFile(text));
+        config->parseLoggingConfig(configPath);
+        for (const auto& keyValuePair : rk::config_internal::defaultConfig) {
+            ASSERT_TRUE(config->isKeyAndValueValid(keyValuePair.first, config->getConfigValueByKey(keyValuePair.first)));
+        }
+        logOutput.str("");
+    }
+}
+
+} // namespace config_parser_tests
+} // namespace rk_logger_tests
@@ -0,0 +1,71 @@
+#ifndef CONFIG_PARSER_TESTS_H
+#define CONFIG_PARSER_TESTS_H
+
+#include <rk_logger/config.h>
+#include <rk_logger/config_parser.h>
+#include <rk_logger_tests/test_base.h>
+
+namespace rk_logger_tests {
+namespace config_parser_tests {
+
+/**
+ * An entry that the parser is expected to return. An empty error means a key/value pair.
+ */
+struct ExpectedEntry {
+    size_t line;
+    std::string key;
+    std::string value;
+    std::string error;
+};
+
+struct ConfigParserTestParam : public BaseParam {
+    ConfigParserTestParam(const std::string description, const std::string text, const std::vector<ExpectedEntry> expected)
+        : BaseParam(description), text(text), expected(expected) {};
+
+    const std::string text;
+    const std::vector<ExpectedEntry> expected;
+};
+
+class ConfigParserTest : public ::testing::TestWithParam<ConfigParserTestParam> {};
+
+/**
+ * @brief Parses the text and returns every entry, with the views copied so they outlive the parser.
+ */
+inline std::vector<ExpectedEntry> parseAll(const std::string& text) {
+    std::vector<ExpectedEntry> entries;
+    rk::config_internal::ConfigParser parser(text);
+    rk::config_internal::ConfigEntry entry;
+    while (parser.next(entry)) {
+        entries.push_back({ entry.line, std::string(entry.key), std::string(entry.value), entry.error != nullptr ? entry.error : "" });
+    }
+    return entries;
+}
+
+class ConfigParserFileTest : public Base {
+protected:
+    void SetUp() override {
+        redirectStdCout();
+        std::filesystem::create_directory(std::filesystem::path(RK_LOGGER_TESTS_BINARY_DIR)/TEMP_DIR);
+        configPath = std::filesystem::path(RK_LOGGER_TESTS_BINARY_DIR)/TEMP_DIR/rk::config::CONFIG_FILE_NAME;
+    }
+
+    void TearDown() override {
+        undoRedirectStdCout();
+        std::filesystem::remove_all(std::filesystem::path(RK_LOGGER_TESTS_BINARY_DIR)/TEMP_DIR);
+    }
+
+    void writeConfigFile(const std::string& text) {
+        std::ofstream file(configPath, std::ios::binary);
+        ASSERT_TRUE(file.good());
+        file << text;
+    }
+
+    inline static const std::string TEMP_DIR = "parser_temp";
+    std::filesystem::path configPath;
+    std::unique_ptr<rk::config::Config> config = rk::config::createInstance();
+};
+
+} // namespace config_parser_tests
+} // namespace rk_logger_tests
+
+#endif // #ifndef CONFIG_PARSER_TESTS_H
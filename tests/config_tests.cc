@@ -36,7 +36,39 @@ INSTANTIATE_TEST_SUITE_P(ConfigIsKeyValid,
         ConfigKeyValueTestParam("", rk::config::date_format::KEY, true, "", false),
         ConfigKeyValueTestParam("", rk::config::month_format::KEY, true, "", false),
         ConfigKeyValueTestParam("", rk::config::hour_format::KEY, true, "", false),
+        ConfigKeyValueTestParam("", rk::config::timestamp_precision::KEY, true, "", false),
+        ConfigKeyValueTestParam("", rk::config::time_zone::KEY, true, "", false),
         ConfigKeyValueTestParam("", rk::config::write_to_log_file::KEY, true, "", false),
+        ConfigKeyValueTestParam("", rk::config::write_to_console::KEY, true, "", false),
+        ConfigKeyValueTestParam("", rk::config::console_color::KEY, true, "", false),
+        ConfigKeyValueTestParam("", rk::config::write_to_syslog::KEY, true, "", false),
+        ConfigKeyValueTestParam("", rk::config::syslog_socket_path::KEY, true, "", false),
+        ConfigKeyValueTestParam("", rk::config::log_level::KEY, true, "", false),
+        ConfigKeyValueTestParam("", rk::config::clock_source::KEY, true, "", false),
+        ConfigKeyValueTestParam("", rk::config::flight_recorder_size_kb::KEY, true, "", false),
+        ConfigKeyValueTestParam("", rk::config::flight_recorder_level::KEY, true, "", false),
+        ConfigKeyValueTestParam("", rk::config::flight_recorder_trigger::KEY, true, "", false),
+        ConfigKeyValueTestParam("", rk::config::flight_recorder_signal::KEY, true, "", false),
+        ConfigKeyValueTestParam("", rk::config::log_transport::KEY, true, "", false),
+        ConfigKeyValueTestParam("", rk::config::shm_name::KEY, true, "", false),
+        ConfigKeyValueTestParam("", rk::config::shm_size_kb::KEY, true, "", false),
+        ConfigKeyValueTestParam("", rk::config::log_shards::KEY, true, "", false),
+        ConfigKeyValueTestParam("", rk::config::log_shard_ordering::KEY, true, "", false),
+        ConfigKeyValueTestParam("", rk::config::log_shard_files::KEY, true, "", false),
+        ConfigKeyValueTestParam("", rk::config::log_thread_name::KEY, true, "", false),
+        ConfigKeyValueTestParam("", rk::config::log_thread_cpu_affinity::KEY, true, "", false),
+        ConfigKeyValueTestParam("", rk::config::log_thread_sched_policy::KEY, true, "", false),
+        ConfigKeyValueTestParam("", rk::config::log_thread_priority::KEY, true, "", false),
+        ConfigKeyValueTestParam("", rk::config::log_thread_numa_local::KEY, true, "", false),
+        ConfigKeyValueTestParam("", rk::config::shutdown_drain_ms::KEY, true, "", false),
+        ConfigKeyValueTestParam("", rk::config::shutdown_leftovers::KEY, true, "", false),
+        ConfigKeyValueTestParam("", rk::config::fork_log_file::KEY, true, "", false),
+        ConfigKeyValueTestParam("", rk::config::log_file_compression::KEY, true, "", false),
+        ConfigKeyValueTestParam("", rk::config::log_file_compression_level::KEY, true, "", false),
+        ConfigKeyValueTestParam("", rk::config::log_file_frame_ms::KEY, true, "", false),
+        ConfigKeyValueTestParam("", rk::config::log_file_index::KEY, true, "", false),
+        ConfigKeyValueTestParam("", rk::config::log_file_index_records::KEY, true, "", false),
+        ConfigKeyValueTestParam("", rk::config::log_file_index_kb::KEY, true, "", false),
 
         // Invalid keys
         ConfigKeyValueTestParam("", INVALID_KEY_GENERIC, false, "", false),
@@ -69,8 +101,81 @@ INSTANTIATE_TEST_SUITE_P(ConfigIsKeyValueValid,
         ConfigKeyValueTestParam("", rk::config::month_format::KEY, true, rk::config::month_format::MONTH_NUM, true),
         ConfigKeyValueTestParam("", rk::config::hour_format::KEY, true, rk::config::hour_format::TWELVE_HOUR, true),
         ConfigKeyValueTestParam("", rk::config::hour_format::KEY, true, rk::config::hour_format::TWENTY_FOUR_HOUR, true),
+        ConfigKeyValueTestParam("", rk::config::timestamp_precision::KEY, true, rk::config::timestamp_precision::MS, true),
+        ConfigKeyValueTestParam("", rk::config::timestamp_precision::KEY, true, rk::config::timestamp_precision::US, true),
+        ConfigKeyValueTestParam("", rk::config::timestamp_precision::KEY, true, rk::config::timestamp_precision::NS, true),
+        ConfigKeyValueTestParam("", rk::config::timestamp_precision::KEY, true, rk::config::timestamp_precision::EPOCH_NS, true),
+        ConfigKeyValueTestParam("", rk::config::time_zone::KEY, true, rk::config::time_zone::LOCAL, true),
+        ConfigKeyValueTestParam("", rk::config::time_zone::KEY, true, rk::config::time_zone::UTC, true),
         ConfigKeyValueTestParam("", rk::config::write_to_log_file::KEY, true, rk::config::write_to_log_file::DISABLE, true),
         ConfigKeyValueTestParam("", rk::config::write_to_log_file::KEY, true, rk::config::write_to_log_file::ENABLE, true),
+        ConfigKeyValueTestParam("", rk::config::write_to_console::KEY, true, rk::config::write_to_console::DISABLE, true),
+        ConfigKeyValueTestParam("", rk::config::write_to_console::KEY, true, rk::config::write_to_console::ENABLE, true),
+        ConfigKeyValueTestParam("", rk::config::console_color::KEY, true, rk::config::console_color::AUTO, true),
+        ConfigKeyValueTestParam("", rk::config::console_color::KEY, true, rk::config::console_color::ENABLE, true),
+        ConfigKeyValueTestParam("", rk::config::console_color::KEY, true, rk::config::console_color::DISABLE, true),
+        ConfigKeyValueTestParam("", rk::config::write_to_syslog::KEY, true, rk::config::write_to_syslog::DISABLE, true),
+        ConfigKeyValueTestParam("", rk::config::write_to_syslog::KEY, true, rk::config::write_to_syslog::RFC5424, true),
+        ConfigKeyValueTestParam("", rk::config::write_to_syslog::KEY, true, rk::config::write_to_syslog::JOURNALD, true),
+        ConfigKeyValueTestParam("", rk::config::syslog_socket_path::KEY, true, rk::config::syslog_socket_path::DEFAULT, true),
+        ConfigKeyValueTestParam("", rk::config::syslog_socket_path::KEY, true, "/var/run/syslog", true, "", "absolute_path"),
+        ConfigKeyValueTestParam("", rk::config::log_level::KEY, true, rk::config::log_level::DEFAULT_LEVEL, true),
+        ConfigKeyValueTestParam("", rk::config::log_level::KEY, true, "TRACE", true),
+        ConfigKeyValueTestParam("", rk::config::log_level::KEY, true, "ERROR", true),
+        ConfigKeyValueTestParam("", rk::config::log_level::KEY, true, "OFF", true),
+        ConfigKeyValueTestParam("", rk::config::clock_source::KEY, true, rk::config::clock_source::SYSTEM, true),
+        ConfigKeyValueTestParam("", rk::config::clock_source::KEY, true, rk::config::clock_source::TSC, true),
+        ConfigKeyValueTestParam("", rk::config::clock_source::KEY, true, rk::config::clock_source::STEADY, true),
+        ConfigKeyValueTestParam("", rk::config::flight_recorder_size_kb::KEY, true, rk::config::flight_recorder_size_kb::DISABLED, true),
+        ConfigKeyValueTestParam("", rk::config::flight_recorder_size_kb::KEY, true, "1048576", true),
+        ConfigKeyValueTestParam("", rk::config::flight_recorder_level::KEY, true, rk::config::flight_recorder_level::DEFAULT_LEVEL, true),
+        ConfigKeyValueTestParam("", rk::config::flight_recorder_level::KEY, true, "DEBUG", true),
+        ConfigKeyValueTestParam("", rk::config::flight_recorder_trigger::KEY, true, rk::config::flight_recorder_trigger::DEFAULT_LEVEL, true),
+        ConfigKeyValueTestParam("", rk::config::flight_recorder_trigger::KEY, true, "OFF", true),
+        ConfigKeyValueTestParam("", rk::config::flight_recorder_signal::KEY, true, rk::config::flight_recorder_signal::DISABLE, true),
+        ConfigKeyValueTestParam("", rk::config::flight_recorder_signal::KEY, true, rk::config::flight_recorder_signal::ENABLE, true),
+        ConfigKeyValueTestParam("", rk::config::log_transport::KEY, true, rk::config::log_transport::THREAD, true),
+        ConfigKeyValueTestParam("", rk::config::log_transport::KEY, true, rk::config::log_transport::SHARED_MEMORY, true),
+        ConfigKeyValueTestParam("", rk::config::shm_name::KEY, true, rk::config::shm_name::DEFAULT, true),
+        ConfigKeyValueTestParam("", rk::config::shm_name::KEY, true, "/my_app_log", true, "", "shm_object_name"),
+        ConfigKeyValueTestParam("", rk::config::shm_size_kb::KEY, true, rk::config::shm_size_kb::DEFAULT_SIZE, true),
+        ConfigKeyValueTestParam("", rk::config::shm_size_kb::KEY, true, "64", true),
+        ConfigKeyValueTestParam("", rk::config::log_shards::KEY, true, rk::config::log_shards::DEFAULT_COUNT, true),
+        ConfigKeyValueTestParam("", rk::config::log_shards::KEY, true, "64", true),
+        ConfigKeyValueTestParam("", rk::config::log_shard_ordering::KEY, true, rk::config::log_shard_ordering::GLOBAL, true),
+        ConfigKeyValueTestParam("", rk::config::log_shard_ordering::KEY, true, rk::config::log_shard_ordering::PER_THREAD, true),
+        ConfigKeyValueTestParam("", rk::config::log_shard_files::KEY, true, rk::config::log_shard_files::SHARED, true),
+        ConfigKeyValueTestParam("", rk::config::log_shard_files::KEY, true, rk::config::log_shard_files::PER_SHARD, true),
+        ConfigKeyValueTestParam("", rk::config::log_thread_name::KEY, true, rk::config::log_thread_name::DEFAULT_NAME, true),
+        ConfigKeyValueTestParam("", rk::config::log_thread_name::KEY, true, "rk_worker_1", true),
+        ConfigKeyValueTestParam("", rk::config::log_thread_cpu_affinity::KEY, true, rk::config::log_thread_cpu_affinity::NONE, true),
+        ConfigKeyValueTestParam("", rk::config::log_thread_cpu_affinity::KEY, true, "3", true),
+        ConfigKeyValueTestParam("", rk::config::log_thread_sched_policy::KEY, true, rk::config::log_thread_sched_policy::DEFAULT, true),
+        ConfigKeyValueTestParam("", rk::config::log_thread_sched_policy::KEY, true, rk::config::log_thread_sched_policy::BATCH, true),
+        ConfigKeyValueTestParam("", rk::config::log_thread_sched_policy::KEY, true, rk::config::log_thread_sched_policy::FIFO, true),
+        ConfigKeyValueTestParam("", rk::config::log_thread_priority::KEY, true, rk::config::log_thread_priority::DEFAULT, true),
+        ConfigKeyValueTestParam("", rk::config::log_thread_priority::KEY, true, "10", true),
+        ConfigKeyValueTestParam("", rk::config::log_thread_numa_local::KEY, true, rk::config::log_thread_numa_local::ENABLE, true),
+        ConfigKeyValueTestParam("", rk::config::log_thread_numa_local::KEY, true, rk::config::log_thread_numa_local::DISABLE, true),
+        ConfigKeyValueTestParam("", rk::config::shutdown_drain_ms::KEY, true, rk::config::shutdown_drain_ms::UNLIMITED, true),
+        ConfigKeyValueTestParam("", rk::config::shutdown_drain_ms::KEY, true, "0", true),
+        ConfigKeyValueTestParam("", rk::config::shutdown_drain_ms::KEY, true, "500", true),
+        ConfigKeyValueTestParam("", rk::config::shutdown_leftovers::KEY, true, rk::config::shutdown_leftovers::DROP, true),
+        ConfigKeyValueTestParam("", rk::config::shutdown_leftovers::KEY, true, rk::config::shutdown_leftovers::SPILL, true),
+        ConfigKeyValueTestParam("", rk::config::fork_log_file::KEY, true, rk::config::fork_log_file::SHARED, true),
+        ConfigKeyValueTestParam("", rk::config::fork_log_file::KEY, true, rk::config::fork_log_file::PER_PID, true),
+        ConfigKeyValueTestParam("", rk::config::log_file_compression::KEY, true, rk::config::log_file_compression::NONE, true),
+        ConfigKeyValueTestParam("", rk::config::log_file_compression::KEY, true, rk::config::log_file_compression::LZ4, true),
+        ConfigKeyValueTestParam("", rk::config::log_file_compression_level::KEY, true, "1", true),
+        ConfigKeyValueTestParam("", rk::config::log_file_compression_level::KEY, true, "9", true),
+        ConfigKeyValueTestParam("", rk::config::log_file_frame_ms::KEY, true, "0", true),
+        ConfigKeyValueTestParam("", rk::config::log_file_frame_ms::KEY, true, "60000", true),
+        ConfigKeyValueTestParam("", rk::config::log_file_index::KEY, true, rk::config::log_file_index::ENABLE, true),
+        ConfigKeyValueTestParam("", rk::config::log_file_index::KEY, true, rk::config::log_file_index::DISABLE, true),
+        ConfigKeyValueTestParam("", rk::config::log_file_index_records::KEY, true, "1", true),
+        ConfigKeyValueTestParam("", rk::config::log_file_index_records::KEY, true, "1000000", true),
+        ConfigKeyValueTestParam("", rk::config::log_file_index_kb::KEY, true, "1", true),
+        ConfigKeyValueTestParam("", rk::config::log_file_index_kb::KEY, true, "65536", true),
 
         // Invalid values for a given key
         ConfigKeyValueTestParam("", rk::config::date_format::KEY, true, INVALID_KEY_GENERIC, false),
@@ -94,6 +199,57 @@ INSTANTIATE_TEST_SUITE_P(ConfigIsKeyValueValid,
         ConfigKeyValueTestParam("", rk::config::write_to_log_file::KEY, true, rk::config::month_format::MONTH_NAME, false), // Value from another key
         ConfigKeyValueTestParam("", rk::config::write_to_log_file::KEY, true, rk::config::hour_format::TWELVE_HOUR, false), // Value from another key
         ConfigKeyValueTestParam("", rk::config::write_to_log_file::KEY, true, rk::config::date_format::DD_MM_YYYY, false), // Value from another key
+        ConfigKeyValueTestParam("", rk::config::write_to_console::KEY, true, "enable", false), // Lowercase version of valid value
+        ConfigKeyValueTestParam("", rk::config::timestamp_precision::KEY, true, "ns", false), // Lowercase version of valid value
+        ConfigKeyValueTestParam("", rk::config::timestamp_precision::KEY, true, "PS", false), // Not a supported precision
+        ConfigKeyValueTestParam("", rk::config::time_zone::KEY, true, "utc", false), // Lowercase version of valid value
+        ConfigKeyValueTestParam("", rk::config::time_zone::KEY, true, "EST", false), // Named zones aren't supported
+        ConfigKeyValueTestParam("", rk::config::console_color::KEY, true, "TTY", false), // Not a valid value
+        ConfigKeyValueTestParam("", rk::config::write_to_syslog::KEY, true, rk::config::write_to_console::ENABLE, false), // Value from another key
+        ConfigKeyValueTestParam("", rk::config::write_to_syslog::KEY, true, "journald", false), // Lowercase version of valid value
+        ConfigKeyValueTestParam("", rk::config::syslog_socket_path::KEY, true, "dev/log", false, "", "relative_path"), // Not an absolute path
+        ConfigKeyValueTestParam("", rk::config::syslog_socket_path::KEY, true, "/" + std::string(107, 'a'), false, "", "too_long_path"), // Too long for a socket address
+        ConfigKeyValueTestParam("", rk::config::log_level::KEY, true, "debug", false), // Lowercase version of valid value
+        ConfigKeyValueTestParam("", rk::config::log_level::KEY, true, "WARNING", false), // Not a level name
+        ConfigKeyValueTestParam("", rk::config::clock_source::KEY, true, "tsc", false), // Lowercase version of valid value
+        ConfigKeyValueTestParam("", rk::config::flight_recorder_size_kb::KEY, true, "1048577", false), // Out of range
+        ConfigKeyValueTestParam("", rk::config::flight_recorder_size_kb::KEY, true, "1MB", false), // Not a number
+        ConfigKeyValueTestParam("", rk::config::flight_recorder_trigger::KEY, true, "error", false), // Lowercase version of valid value
+        ConfigKeyValueTestParam("", rk::config::flight_recorder_signal::KEY, true, "SIGUSR1", false), // Not a valid value
+        ConfigKeyValueTestParam("", rk::config::log_transport::KEY, true, "shared_memory", false), // Lowercase version of valid value
+        ConfigKeyValueTestParam("", rk::config::shm_name::KEY, true, "my_app_log", false, "", "no_leading_slash"), // Doesn't start with '/'
+        ConfigKeyValueTestParam("", rk::config::shm_name::KEY, true, "/my/app_log", false, "", "inner_slash"), // Has another '/'
+        ConfigKeyValueTestParam("", rk::config::shm_name::KEY, true, "/", false, "", "only_slash"), // No name after the '/'
+        ConfigKeyValueTestParam("", rk::config::shm_size_kb::KEY, true, "63", false), // Below the minimum
+        ConfigKeyValueTestParam("", rk::config::shm_size_kb::KEY, true, "1048577", false), // Out of range
+        ConfigKeyValueTestParam("", rk::config::log_shards::KEY, true, "0", false), // Out of range
+        ConfigKeyValueTestParam("", rk::config::log_shards::KEY, true, "65", false), // Out of range
+        ConfigKeyValueTestParam("", rk::config::log_shard_ordering::KEY, true, rk::config::log_shard_files::SHARED, false), // Value from another key
+        ConfigKeyValueTestParam("", rk::config::log_shard_files::KEY, true, rk::config::log_shard_ordering::GLOBAL, false), // Value from another key
+        ConfigKeyValueTestParam("", rk::config::log_thread_name::KEY, true, "name_longer_than_15", false), // Too long for a thread name
+        ConfigKeyValueTestParam("", rk::config::log_thread_cpu_affinity::KEY, true, "none", false), // Lowercase version of valid value
+        ConfigKeyValueTestParam("", rk::config::log_thread_cpu_affinity::KEY, true, "CPU0", false), // Not a CPU list
+        ConfigKeyValueTestParam("", rk::config::log_thread_sched_policy::KEY, true, "fifo", false), // Lowercase version of valid value
+        ConfigKeyValueTestParam("", rk::config::log_thread_priority::KEY, true, "100", false), // Out of range
+        ConfigKeyValueTestParam("", rk::config::log_thread_priority::KEY, true, "HIGH", false), // Not a number
+        ConfigKeyValueTestParam("", rk::config::log_thread_numa_local::KEY, true, rk::config::log_thread_sched_policy::DEFAULT, false), // Value from another key
+        ConfigKeyValueTestParam("", rk::config::shutdown_drain_ms::KEY, true, "-1", false, "", "negative"), // Out of range
+        ConfigKeyValueTestParam("", rk::config::shutdown_drain_ms::KEY, true, "3600001", false), // Out of range
+        ConfigKeyValueTestParam("", rk::config::shutdown_drain_ms::KEY, true, "unlimited", false), // Lowercase version of valid value
+        ConfigKeyValueTestParam("", rk::config::shutdown_leftovers::KEY, true, "drop", false), // Lowercase version of valid value
+        ConfigKeyValueTestParam("", rk::config::fork_log_file::KEY, true, "per_pid", false), // Lowercase version of valid value
+        ConfigKeyValueTestParam("", rk::config::fork_log_file::KEY, true, rk::config::log_shard_files::PER_SHARD, false), // Value from another key
+        ConfigKeyValueTestParam("", rk::config::log_file_compression::KEY, true, "lz4", false), // Lowercase version of valid value
+        ConfigKeyValueTestParam("", rk::config::log_file_compression::KEY, true, "ZSTD", false), // Not supported
+        ConfigKeyValueTestParam("", rk::config::log_file_compression_level::KEY, true, "0", false), // Out of range
+        ConfigKeyValueTestParam("", rk::config::log_file_compression_level::KEY, true, "10", false), // Out of range
+        ConfigKeyValueTestParam("", rk::config::log_file_frame_ms::KEY, true, "-1", false, "", "negative"), // Out of range
+        ConfigKeyValueTestParam("", rk::config::log_file_frame_ms::KEY, true, "60001", false), // Out of range
+        ConfigKeyValueTestParam("", rk::config::log_file_index::KEY, true, "enable", false), // Lowercase version of valid value
+        ConfigKeyValueTestParam("", rk::config::log_file_index_records::KEY, true, "0", false), // Out of range
+        ConfigKeyValueTestParam("", rk::config::log_file_index_records::KEY, true, "1000001", false), // Out of range
+        ConfigKeyValueTestParam("", rk::config::log_file_index_kb::KEY, true, "0", false), // Out of range
+        ConfigKeyValueTestParam("", rk::config::log_file_index_kb::KEY, true, "65537", false), // Out of range
 
         // Invalid keys
         ConfigKeyValueTestParam("", INVALID_KEY_GENERIC, false, "", false),
@@ -104,7 +260,7 @@ INSTANTIATE_TEST_SUITE_P(ConfigIsKeyValueValid,
         ConfigKeyValueTestParam("", "a", false, "", false)
     ),
     [](const testing::TestParamInfo<ConfigKeyValueTestParam>& info) {
-        return std::string(!info.param.description.empty() ? info.param.description : "") + (info.param.keyForSuffix.empty() ? info.param.key : info.param.keyForSuffix) + "_" + (info.param.isKeyValid ? "isValid" : "isInvalid") + "_" + info.param.value + "_" + (info.param.isValueValid ? "isValid" : "isInvalid");
+        return std::string(!info.param.description.empty() ? info.param.description : "") + (info.param.keyForSuffix.empty() ? info.param.key : info.param.keyForSuffix) + "_" + (info.param.isKeyValid ? "isValid" : "isInvalid") + "_" + (info.param.valueForSuffix.empty() ? info.param.value : info.param.valueForSuffix) + "_" + (info.param.isValueValid ? "isValid" : "isInvalid");
     }
 );
 
@@ -122,7 +278,29 @@ INSTANTIATE_TEST_SUITE_P(ConfigGetKeyValueTest,
         ConfigKeyValueTestParam("", rk::config::date_format::KEY, true, "", false),
         ConfigKeyValueTestParam("", rk::config::month_format::KEY, true, "", false),
         ConfigKeyValueTestParam("", rk::config::hour_format::KEY, true, "", false),
+        ConfigKeyValueTestParam("", rk::config::timestamp_precision::KEY, true, "", false),
+        ConfigKeyValueTestParam("", rk::config::time_zone::KEY, true, "", false),
         ConfigKeyValueTestParam("", rk::config::write_to_log_file::KEY, true, "", false),
+        ConfigKeyValueTestParam("", rk::config::write_to_console::KEY, true, "", false),
+        ConfigKeyValueTestParam("", rk::config::log_level::KEY, true, "", false),
+        ConfigKeyValueTestParam("", rk::config::clock_source::KEY, true, "", false),
+        ConfigKeyValueTestParam("", rk::config::log_shards::KEY, true, "", false),
+        ConfigKeyValueTestParam("", rk::config::log_shard_ordering::KEY, true, "", false),
+        ConfigKeyValueTestParam("", rk::config::log_shard_files::KEY, true, "", false),
+        ConfigKeyValueTestParam("", rk::config::log_thread_name::KEY, true, "", false),
+        ConfigKeyValueTestParam("", rk::config::log_thread_cpu_affinity::KEY, true, "", false),
+        ConfigKeyValueTestParam("", rk::config::log_thread_sched_policy::KEY, true, "", false),
+        ConfigKeyValueTestParam("", rk::config::log_thread_priority::KEY, true, "", false),
+        ConfigKeyValueTestParam("", rk::config::log_thread_numa_local::KEY, true, "", false),
+        ConfigKeyValueTestParam("", rk::config::shutdown_drain_ms::KEY, true, "", false),
+        ConfigKeyValueTestParam("", rk::config::shutdown_leftovers::KEY, true, "", false),
+        ConfigKeyValueTestParam("", rk::config::fork_log_file::KEY, true, "", false),
+        ConfigKeyValueTestParam("", rk::config::log_file_compression::KEY, true, "", false),
+        ConfigKeyValueTestParam("", rk::config::log_file_compression_level::KEY, true, "", false),
+        ConfigKeyValueTestParam("", rk::config::log_file_frame_ms::KEY, true, "", false),
+        ConfigKeyValueTestParam("", rk::config::log_file_index::KEY, true, "", false),
+        ConfigKeyValueTestParam("", rk::config::log_file_index_records::KEY, true, "", false),
+        ConfigKeyValueTestParam("", rk::config::log_file_index_kb::KEY, true, "", false),
 
         // Invalid keys
         ConfigKeyValueTestParam("", INVALID_KEY_GENERIC, false, "", false),
@@ -157,12 +335,18 @@ INSTANTIATE_TEST_SUITE_P(ConfigSetKeyValueTest,
         ConfigKeyValueTestParam("valid_key_and_value", rk::config::month_format::KEY, true, rk::config::month_format::MONTH_NAME, true),
         ConfigKeyValueTestParam("valid_key_and_value", rk::config::hour_format::KEY, true, rk::config::hour_format::TWENTY_FOUR_HOUR, true),
         ConfigKeyValueTestParam("valid_key_and_value", rk::config::write_to_log_file::KEY, true, rk::config::write_to_log_file::DISABLE, true),
+        ConfigKeyValueTestParam("valid_key_and_value", rk::config::log_level::KEY, true, "WARN", true),
+        ConfigKeyValueTestParam("valid_key_and_value", rk::config::log_thread_cpu_affinity::KEY, true, "0", true),
+        ConfigKeyValueTestParam("valid_key_and_value", rk::config::log_thread_priority::KEY, true, "5", true),
 
         // Valid keys, but invalid values
         ConfigKeyValueTestParam("valid_key_invalid_value", rk::config::date_format::KEY, true, INVALID_VALUE_GENERIC, false),
         ConfigKeyValueTestParam("valid_key_invalid_value", rk::config::month_format::KEY, true, INVALID_VALUE_GENERIC, false),
         ConfigKeyValueTestParam("valid_key_invalid_value", rk::config::hour_format::KEY, true, INVALID_VALUE_GENERIC, false),
         ConfigKeyValueTestParam("valid_key_invalid_value", rk::config::write_to_log_file::KEY, true, INVALID_VALUE_GENERIC, false),
+        ConfigKeyValueTestParam("valid_key_invalid_value", rk::config::log_level::KEY, true, INVALID_VALUE_GENERIC, false),
+        ConfigKeyValueTestParam("valid_key_invalid_value", rk::config::log_thread_cpu_affinity::KEY, true, INVALID_VALUE_GENERIC, false),
+        ConfigKeyValueTestParam("valid_key_invalid_value", rk::config::log_thread_priority::KEY, true, INVALID_VALUE_GENERIC, false),
 
         // Invalid keys
         ConfigKeyValueTestParam("invalid_key", INVALID_KEY_GENERIC, false, "", false),
@@ -238,7 +422,28 @@ INSTANTIATE_TEST_SUITE_P(ConfigFileTestParameterized,
                 { rk::config::date_format::KEY, rk::config::date_format::YYYY_MM_DD },
                 { rk::config::month_format::KEY, rk::config::month_format::MONTH_NAME },
                 { rk::config::hour_format::KEY, rk::config::hour_format::TWENTY_FOUR_HOUR },
-                { rk::config::write_to_log_file::KEY, rk::config::write_to_log_file::DISABLE }
+                { rk::config::timestamp_precision::KEY, rk::config::timestamp_precision::US },
+                { rk::config::time_zone::KEY, rk::config::time_zone::UTC },
+                { rk::config::write_to_log_file::KEY, rk::config::write_to_log_file::DISABLE },
+                { rk::config::log_level::KEY, "DEBUG" },
+                { rk::config::clock_source::KEY, rk::config::clock_source::STEADY },
+                { rk::config::flight_recorder_level::KEY, "DEBUG" },
+                { rk::config::flight_recorder_trigger::KEY, "FATAL" },
+                { rk::config::shm_size_kb::KEY, "8192" },
+                { rk::config::log_thread_name::KEY, "rk_log_io" },
+                { rk::config::log_thread_cpu_affinity::KEY, "0" },
+                { rk::config::log_thread_sched_policy::KEY, rk::config::log_thread_sched_policy::BATCH },
+                { rk::config::log_thread_priority::KEY, "5" },
+                { rk::config::log_thread_numa_local::KEY, rk::config::log_thread_numa_local::ENABLE },
+                { rk::config::shutdown_drain_ms::KEY, "250" },
+                { rk::config::shutdown_leftovers::KEY, rk::config::shutdown_leftovers::SPILL },
+                { rk::config::fork_log_file::KEY, rk::config::fork_log_file::PER_PID },
+                { rk::config::log_file_compression::KEY, rk::config::log_file_compression::LZ4 },
+                { rk::config::log_file_compression_level::KEY, "6" },
+                { rk::config::log_file_frame_ms::KEY, "250" },
+                { rk::config::log_file_index::KEY, rk::config::log_file_index::ENABLE },
+                { rk::config::log_file_index_records::KEY, "128" },
+                { rk::config::log_file_index_kb::KEY, "32" }
             }
         ),
         ConfigFileTestParam(
@@ -247,7 +452,15 @@ INSTANTIATE_TEST_SUITE_P(ConfigFileTestParameterized,
                 { rk::config::date_format::KEY, "YY_MM_DD" },
                 { rk::config::month_format::KEY, "!@#$%^&" },
                 { rk::config::hour_format::KEY, "5" },
-                { rk::config::write_to_log_file::KEY, "enable" }
+                { rk::config::write_to_log_file::KEY, "enable" },
+                { rk::config::log_level::KEY, "VERBOSE" },
+                { rk::config::clock_source::KEY, "RDTSC" },
+                { rk::config::write_to_syslog::KEY, "SYSLOG" },
+                { rk::config::flight_recorder_size_kb::KEY, "-1" },
+                { rk::config::log_transport::KEY, "SOCKET" },
+                { rk::config::log_thread_name::KEY, "bad name" },
+                { rk::config::log_thread_cpu_affinity::KEY, "2-1" },
+                { rk::config::log_thread_priority::KEY, "-21" }
             }
         )
     ),
@@ -104,8 +104,8 @@ protected:
         std::string line;
         while (std::getline(configFileBase, line)) {
             for (const auto& pair : keyValues) {
-                auto iter = line.find(pair.first);
-                if (iter != std::string::npos) {
+                // The whole key has to match, since some keys start with another key, e.g., "log_file_compression_level"
+                if (line.rfind(pair.first + ":", 0) == 0) {
                     line = replaceConfigValue(line, pair.second);
                 }
             }
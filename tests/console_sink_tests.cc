@@ -0,0 +1,115 @@
+#include <thread>
+
+#include "console_sink_tests.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+
+namespace rk_logger_tests {
+namespace console_sink_tests {
+
+// Output to a pipe is only written once a block is full, or when the sink is destroyed
+TEST_F(ConsolePipeTest, PipeIsBlockBuffered) {
+    auto sink = std::make_unique<rk::log::ConsoleSink>(fds[1]);
+    ASSERT_FALSE(sink->isTerminal());
+    ASSERT_FALSE(sink->isColored());
+    sink->writeWithLevel("[time][thread][func]first\n", rk::log::Level::Error);
+    sink->flush();
+    ASSERT_EQ(readAvailable(), "");
+
+    sink.reset();
+    ASSERT_EQ(readAvailable(), "[time][thread][func]first\n");
+}
+
+TEST_F(ConsolePipeTest, FullBufferIsWritten) {
+    rk::log::ConsoleSink sink(fds[1]);
+    const std::string message(1000, 'x');
+    size_t bufferedSize = 0;
+    while (bufferedSize + message.size() <= rk::log::ConsoleSink::BUFFER_SIZE) {
+        sink.write(message);
+        bufferedSize += message.size();
+    }
+    sink.flush();
+    ASSERT_EQ(readAvailable(), "");
+
+    sink.write(message); // Doesn't fit, so the buffer is written first
+    ASSERT_EQ(readAvailable().size(), bufferedSize);
+}
+
+// A message larger than the buffer is written in the same writev() call as the buffer, and in order with it
+TEST_F(ConsolePipeTest, LargeMessageIsWrittenInOrder) {
+    std::string output;
+    std::thread reader([this, &output] () {
+        const size_t expectedSize = 6 + 2 * rk::log::ConsoleSink::BUFFER_SIZE + 5;
+        while (output.size() < expectedSize) {
+            output += readAvailable();
+            std::this_thread::yield();
+        }
+    });
+    {
+        rk::log::ConsoleSink sink(fds[1]);
+        sink.write("first\n");
+        sink.write(std::string(2 * rk::log::ConsoleSink::BUFFER_SIZE, 'x'));
+        sink.write("last\n");
+    }
+    reader.join();
+    ASSERT_EQ(output, "first\n" + std::string(2 * rk::log::ConsoleSink::BUFFER_SIZE, 'x') + "last\n");
+}
+
+TEST_F(ConsolePipeTest, ColorByLevel) {
+    {
+        rk::log::ConsoleSink sink(fds[1], rk::log::ConsoleSink::ColorMode::Always);
+        ASSERT_TRUE(sink.isColored());
+        sink.writeWithLevel("info\n", rk::log::Level::Info);
+        sink.writeWithLevel("warn\n", rk::log::Level::Warn);
+        sink.writeWithLevel("error\n", rk::log::Level::Error);
+    }
+    ASSERT_EQ(readAvailable(), "info\n\x1b[33mwarn\x1b[0m\n\x1b[31merror\x1b[0m\n");
+}
+
+// Output to a terminal is written at the end of every batch, and colored by level
+TEST_F(ConsoleTerminalTest, TerminalIsLineFlushedAndColored) {
+    const char* noColor = std::getenv("NO_COLOR");
+    const char* term = std::getenv("TERM");
+    rk::log::ConsoleSink sink(slaveFd);
+    ASSERT_TRUE(sink.isTerminal());
+    ASSERT_EQ(sink.isColored(), noColor == nullptr && !(term != nullptr && std::string(term) == "dumb"));
+    sink.writeWithLevel("error\n", rk::log::Level::Error);
+    sink.flush();
+    ASSERT_EQ(readAvailable(), sink.isColored() ? "\x1b[31merror\x1b[0m\n" : "error\n");
+}
+
+TEST_F(ConsoleTerminalTest, ColorCanBeDisabled) {
+    rk::log::ConsoleSink sink(slaveFd, rk::log::ConsoleSink::ColorMode::Never);
+    ASSERT_FALSE(sink.isColored());
+    sink.writeWithLevel("error\n", rk::log::Level::Error);
+    sink.flush();
+    ASSERT_EQ(readAvailable(), "error\n");
+}
+
+// Starting and stopping a logger that writes to the console leaves the application's std::cout as it was
+TEST_F(ConsoleLoggerTest, StdCoutIsLeftAlone) {
+    logger.getConfig().setConfigValue(rk::config::write_to_log_file::KEY, rk::config::write_to_log_file::DISABLE);
+    const std::ios_base::fmtflags flags = std::cout.flags();
+    ASSERT_NO_FATAL_FAILURE(Base::startLogger(std::filesystem::path()));
+    ASSERT_EQ(std::cout.flags(), flags);
+    ASSERT_FALSE(std::cout.flags() & std::ios_base::unitbuf);
+    ASSERT_NO_FATAL_FAILURE(Base::stopLogger());
+    ASSERT_EQ(std::cout.flags(), flags);
+}
+
+// When the application has pointed std::cout somewhere else, the console output follows it
+TEST_F(ConsoleLoggerTest, RedirectedStdCoutIsUsed) {
+    rk::config::Config& config = logger.getConfig();
+    redirectStdCout();
+    const std::shared_ptr<rk::log::Sink> redirected = rk::log::createConsoleSink(config);
+    undoRedirectStdCout();
+    ASSERT_NE(std::dynamic_pointer_cast<rk::log::StreamSink>(redirected), nullptr);
+
+    const std::shared_ptr<rk::log::Sink> console = rk::log::createConsoleSink(config);
+    ASSERT_NE(std::dynamic_pointer_cast<rk::log::ConsoleSink>(console), nullptr);
+}
+
+} // namespace console_sink_tests
+} // namespace rk_logger_tests
+
+#endif // #if defined(__unix__) || defined(__APPLE__)
@@ -0,0 +1,100 @@
+#ifndef CONSOLE_SINK_TESTS_H
+#define CONSOLE_SINK_TESTS_H
+
+#include <rk_logger/logger.h>
+#include <rk_logger/sink.h>
+#include <rk_logger_tests/test_base.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstdlib>
+
+namespace rk_logger_tests {
+namespace console_sink_tests {
+
+/**
+ * A pipe that stands in for stdout when it is redirected to another process or a file.
+ */
+class ConsolePipeTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_EQ(pipe(fds), 0);
+        ASSERT_EQ(fcntl(fds[0], F_SETFL, O_NONBLOCK), 0);
+    }
+
+    void TearDown() override {
+        close(fds[0]);
+        close(fds[1]);
+    }
+
+    /**
+     * @brief Reads everything that is in the pipe without waiting for more.
+     */
+    std::string readAvailable() {
+        std::string output;
+        char chunk[4096];
+        ssize_t size = 0;
+        while ((size = read(fds[0], chunk, sizeof(chunk))) > 0) {
+            output.append(chunk, static_cast<size_t>(size));
+        }
+        return output;
+    }
+
+    int fds[2] = { -1, -1 };
+};
+
+/**
+ * A pseudo-terminal that stands in for stdout when it is a terminal.
+ */
+class ConsoleTerminalTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        masterFd = posix_openpt(O_RDWR | O_NOCTTY);
+        if (masterFd < 0 || grantpt(masterFd) != 0 || unlockpt(masterFd) != 0) {
+            GTEST_SKIP() << "Pseudo-terminals are not available";
+        }
+        slaveFd = open(ptsname(masterFd), O_RDWR | O_NOCTTY);
+        ASSERT_GE(slaveFd, 0);
+        ASSERT_EQ(fcntl(masterFd, F_SETFL, O_NONBLOCK), 0);
+    }
+
+    void TearDown() override {
+        if (slaveFd >= 0) {
+            close(slaveFd);
+        }
+        if (masterFd >= 0) {
+            close(masterFd);
+        }
+    }
+
+    /**
+     * @brief Reads everything that was written to the terminal without waiting for more. The terminal turns "\n"
+     * into "\r\n", so that is turned back.
+     */
+    std::string readAvailable() {
+        std::string output;
+        char chunk[4096];
+        ssize_t size = 0;
+        while ((size = read(masterFd, chunk, sizeof(chunk))) > 0) {
+            output.append(chunk, static_cast<size_t>(size));
+        }
+        size_t index = 0;
+        while ((index = output.find("\r\n", index)) != std::string::npos) {
+            output.erase(index, 1);
+        }
+        return output;
+    }
+
+    int masterFd = -1;
+    int slaveFd = -1;
+};
+
+class ConsoleLoggerTest : public Base {};
+
+} // namespace console_sink_tests
+} // namespace rk_logger_tests
+
+#endif // #if defined(__unix__) || defined(__APPLE__)
+
+#endif // #ifndef CONSOLE_SINK_TESTS_H
@@ -0,0 +1,276 @@
+#include <algorithm>
+#include <csignal>
+
+#include "flight_recorder_tests.h"
+
+namespace rk_logger_tests {
+namespace flight_recorder_tests {
+
+namespace {
+
+constexpr size_t OVERHEAD = rk::log::FlightRecorder::ENTRY_OVERHEAD;
+
+rk::log::RecordedMessage messageOf(const std::string& text) {
+    rk::log::RecordedMessage message;
+    message.message = text;
+    return message;
+}
+
+std::string dumpOf(const rk::log::FlightRecorder& recorder) {
+    std::string out;
+    recorder.forEach([&out] (const rk::log::RecordedMessage& message) {
+        out += message.message;
+    });
+    return out;
+}
+
+} // namespace
+
+TEST(FlightRecorderBufferTest, KeepsTheNewestMessages) {
+    rk::log::FlightRecorder recorder(4 * (OVERHEAD + 11) + 4); // Room for four 11-byte messages with their headers
+    recorder.write(messageOf("message 00\n"));
+    recorder.write(messageOf("message 01\n"));
+    recorder.write(messageOf("message 02\n"));
+    ASSERT_EQ(recorder.getMessageCount(), 3);
+    ASSERT_EQ(dumpOf(recorder), "message 00\nmessage 01\nmessage 02\n");
+
+    SCOPED_TRACE("Wrapping around the end of the buffer several times");
+    for (int i = 3; i < 20; i++) {
+        recorder.write(messageOf("message " + std::string(i < 10 ? "0" : "") + std::to_string(i) + "\n"));
+    }
+    ASSERT_EQ(recorder.getMessageCount(), 4);
+    ASSERT_EQ(dumpOf(recorder), "message 16\nmessage 17\nmessage 18\nmessage 19\n");
+}
+
+TEST(FlightRecorderBufferTest, MessagesOfDifferentSizes) {
+    rk::log::FlightRecorder recorder(3 * OVERHEAD + 38);
+    recorder.write(messageOf("a\n"));
+    recorder.write(messageOf(std::string(30, 'b') + "\n"));
+    recorder.write(messageOf("c\n"));
+    ASSERT_EQ(dumpOf(recorder), "a\n" + std::string(30, 'b') + "\nc\n");
+
+    recorder.write(messageOf(std::string(20, 'd') + "\n")); // Drops the first two messages
+    ASSERT_EQ(recorder.getMessageCount(), 2);
+    ASSERT_EQ(dumpOf(recorder), "c\n" + std::string(20, 'd') + "\n");
+}
+
+TEST(FlightRecorderBufferTest, MessageLargerThanTheBuffer) {
+    rk::log::FlightRecorder recorder(OVERHEAD + 16);
+    recorder.write(messageOf("first\n"));
+    recorder.write(messageOf(std::string(100, 'x')));
+    ASSERT_EQ(recorder.getMessageCount(), 1);
+    ASSERT_EQ(dumpOf(recorder), std::string(16, 'x'));
+}
+
+TEST(FlightRecorderBufferTest, Clear) {
+    rk::log::FlightRecorder recorder(2 * OVERHEAD + 16);
+    recorder.write(messageOf("first\n"));
+    recorder.clear();
+    ASSERT_EQ(recorder.getMessageCount(), 0);
+    ASSERT_EQ(dumpOf(recorder), "");
+    recorder.write(messageOf("second\n"));
+    ASSERT_EQ(dumpOf(recorder), "second\n");
+}
+
+// The fields that the prefix is formatted from come back as they went in, including for messages that wrap around
+TEST(FlightRecorderBufferTest, KeepsTheFieldsOfEachMessage) {
+    rk::log::FlightRecorder recorder(2 * OVERHEAD + 30);
+    std::thread otherThread([] () {});
+    const std::thread::id otherThreadId = otherThread.get_id();
+    otherThread.join();
+    const rk::time_internal::time_point time = rk::time_internal::time_point(std::chrono::seconds(1760000000)) + std::chrono::microseconds(123456);
+    for (int i = 0; i < 5; i++) {
+        rk::log::RecordedMessage message;
+        const std::string text = "message " + std::to_string(i) + "\n";
+        message.message = text;
+        message.level = i % 2 == 0 ? rk::log::Level::Debug : rk::log::Level::Error;
+        message.funcName = i % 2 == 0 ? "even" : "odd";
+        message.threadId = i % 2 == 0 ? std::this_thread::get_id() : otherThreadId;
+        if (i % 2 == 0) {
+            message.time = time + std::chrono::seconds(i);
+        }
+        else {
+            message.ticks = 1000 + i;
+        }
+        recorder.write(message);
+    }
+
+    std::vector<int> seen;
+    recorder.forEach([&] (const rk::log::RecordedMessage& message) {
+        const int i = message.message[8] - '0';
+        seen.push_back(i);
+        ASSERT_EQ(message.message, "message " + std::to_string(i) + "\n");
+        ASSERT_EQ(message.level, i % 2 == 0 ? rk::log::Level::Debug : rk::log::Level::Error);
+        ASSERT_STREQ(message.funcName, i % 2 == 0 ? "even" : "odd");
+        ASSERT_EQ(message.threadId, i % 2 == 0 ? std::this_thread::get_id() : otherThreadId);
+        if (i % 2 == 0) {
+            ASSERT_EQ(message.ticks, 0);
+            ASSERT_EQ(message.time, time + std::chrono::seconds(i));
+        }
+        else {
+            ASSERT_EQ(message.ticks, 1000 + i);
+        }
+    });
+    ASSERT_EQ(seen, std::vector<int>({ 3, 4 }));
+}
+
+// Messages below the logger's level are kept in memory and only written when an error is logged
+TEST_P(FlightRecorderTest, DumpedOnError) {
+    ASSERT_NO_FATAL_FAILURE(Base::startLogger(std::filesystem::path()));
+    RK_LOG_TO_AT(logger, rk::log::Level::Debug, "debug 1\n");
+    RK_LOG_TO(logger, "info 1\n");
+    RK_LOG_TO_AT(logger, rk::log::Level::Error, "error 1\n");
+    RK_LOG_TO_AT(logger, rk::log::Level::Trace, "trace 2\n");
+    ASSERT_NO_FATAL_FAILURE(Base::stopLogger());
+
+    const std::string output = sink->str();
+    ASSERT_EQ(output.find("debug 1"), std::string::npos);
+    ASSERT_EQ(output.find("trace 2"), std::string::npos);
+    ASSERT_NE(output.find("info 1"), std::string::npos);
+    ASSERT_NE(output.find("error 1"), std::string::npos);
+
+    const std::vector<std::string> dumps = takeDumps();
+    ASSERT_EQ(dumps.size(), 1);
+    const size_t debugPos = dumps[0].find("]debug 1\n");
+    const size_t infoPos = dumps[0].find("]info 1\n");
+    const size_t errorPos = dumps[0].find("]error 1\n");
+    ASSERT_NE(debugPos, std::string::npos);
+    ASSERT_NE(infoPos, std::string::npos);
+    ASSERT_NE(errorPos, std::string::npos);
+    ASSERT_LT(debugPos, infoPos);
+    ASSERT_LT(infoPos, errorPos);
+    ASSERT_EQ(dumps[0].find("trace 2"), std::string::npos);
+}
+
+// The prefix of a message in a dump is the same as it would have been in the log, whether or not the message went to
+// the sinks, and its owned and deferred arguments are written into it
+TEST_P(FlightRecorderTest, DumpedLinesMatchTheLog) {
+    ASSERT_NO_FATAL_FAILURE(Base::startLogger(std::filesystem::path()));
+    RK_LOG_TO_AT(logger, rk::log::Level::Debug, "debug ", rk::log::owned(std::string("owned")), " ", rk::log::defer([] () { return 42; }), "\n");
+    RK_LOG_TO_AT(logger, rk::log::Level::Error, "error ", rk::log::defer([] () { return 43; }), "\n");
+    ASSERT_NO_FATAL_FAILURE(Base::stopLogger());
+
+    const std::string output = sink->str();
+    const std::vector<std::string> dumps = takeDumps();
+    ASSERT_EQ(dumps.size(), 1);
+    const size_t errorEnd = output.find("]error 43\n");
+    ASSERT_NE(errorEnd, std::string::npos);
+    const std::string errorLine = output.substr(0, errorEnd + std::string("]error 43\n").size());
+    ASSERT_NE(dumps[0].find(errorLine), std::string::npos);
+
+    const size_t threadIdStart = errorLine.find("][") + 1;
+    const std::string threadAndFunc = errorLine.substr(threadIdStart, errorEnd + 1 - threadIdStart);
+    ASSERT_NE(dumps[0].find(threadAndFunc + "debug owned 42\n"), std::string::npos);
+}
+
+TEST_P(FlightRecorderTest, DumpedOnRequest) {
+    logger.getConfig().setConfigValue(rk::config::flight_recorder_trigger::KEY, "OFF");
+    ASSERT_NO_FATAL_FAILURE(Base::startLogger(std::filesystem::path()));
+    RK_LOG_TO_AT(logger, rk::log::Level::Trace, "trace 1\n");
+    RK_LOG_TO_AT(logger, rk::log::Level::Fatal, "fatal 1\n");
+    logger.dumpFlightRecorder();
+    ASSERT_NO_FATAL_FAILURE(Base::stopLogger());
+
+    const std::vector<std::string> dumps = takeDumps();
+    ASSERT_EQ(dumps.size(), 1);
+    ASSERT_NE(dumps[0].find("]trace 1\n"), std::string::npos);
+    ASSERT_NE(dumps[0].find("]fatal 1\n"), std::string::npos);
+}
+
+// Each dump only has the messages since the last one
+TEST_P(FlightRecorderTest, ClearedAfterDump) {
+    ASSERT_NO_FATAL_FAILURE(Base::startLogger(std::filesystem::path()));
+    RK_LOG_TO_AT(logger, rk::log::Level::Debug, "debug 1\n");
+    RK_LOG_TO_AT(logger, rk::log::Level::Error, "error 1\n");
+    RK_LOG_TO_AT(logger, rk::log::Level::Debug, "debug 2\n");
+    RK_LOG_TO_AT(logger, rk::log::Level::Error, "error 2\n");
+    ASSERT_NO_FATAL_FAILURE(Base::stopLogger());
+
+    const std::vector<std::string> dumps = takeDumps();
+    ASSERT_EQ(dumps.size(), 2);
+    ASSERT_NE(dumps[0].find("]error 1\n"), std::string::npos);
+    ASSERT_EQ(dumps[0].find("debug 2"), std::string::npos);
+    ASSERT_EQ(dumps[1].find("debug 1"), std::string::npos);
+    ASSERT_NE(dumps[1].find("]debug 2\n"), std::string::npos);
+    ASSERT_NE(dumps[1].find("]error 2\n"), std::string::npos);
+}
+
+// The flight recorder level applies on top of the module levels
+TEST_P(FlightRecorderTest, RecorderLevelAndModuleLevels) {
+    logger.getConfig().setConfigValue(rk::config::flight_recorder_level::KEY, "DEBUG");
+    logger.getConfig().setConfigValue(rk::config::module_level::KEY_PREFIX + "flight_recorder_tests.cc", "WARN");
+    ASSERT_NO_FATAL_FAILURE(Base::startLogger(std::filesystem::path()));
+    for (int i = 0; i < 2; i++) { // The second time, the thresholds are cached by the call sites
+        RK_LOG_TO_AT(logger, rk::log::Level::Trace, "trace ", i, "\n");
+        RK_LOG_TO_AT(logger, rk::log::Level::Debug, "debug ", i, "\n");
+        RK_LOG_TO(logger, "info ", i, "\n");
+        RK_LOG_TO_AT(logger, rk::log::Level::Warn, "warn ", i, "\n");
+    }
+    logger.dumpFlightRecorder();
+    ASSERT_NO_FATAL_FAILURE(Base::stopLogger());
+
+    const std::string output = sink->str();
+    ASSERT_EQ(output.find("info"), std::string::npos);
+    ASSERT_NE(output.find("]warn 0\n"), std::string::npos);
+    ASSERT_NE(output.find("]warn 1\n"), std::string::npos);
+
+    const std::vector<std::string> dumps = takeDumps();
+    ASSERT_EQ(dumps.size(), 1);
+    ASSERT_EQ(dumps[0].find("trace"), std::string::npos);
+    for (const std::string message : { "debug", "info", "warn" }) {
+        ASSERT_NE(dumps[0].find("]" + message + " 0\n"), std::string::npos) << message;
+        ASSERT_NE(dumps[0].find("]" + message + " 1\n"), std::string::npos) << message;
+    }
+}
+
+TEST_P(FlightRecorderTest, OffByDefault) {
+    logger.getConfig().setConfigValue(rk::config::flight_recorder_size_kb::KEY, rk::config::flight_recorder_size_kb::DISABLED);
+    size_t evaluations = 0;
+    auto evaluate = [&evaluations] () { return ++evaluations; };
+    ASSERT_NO_FATAL_FAILURE(Base::startLogger(std::filesystem::path()));
+    RK_LOG_TO_AT(logger, rk::log::Level::Debug, "debug ", evaluate(), "\n");
+    RK_LOG_TO_AT(logger, rk::log::Level::Error, "error ", evaluate(), "\n");
+    logger.dumpFlightRecorder();
+    ASSERT_NO_FATAL_FAILURE(Base::stopLogger());
+
+    ASSERT_EQ(evaluations, 1);
+    ASSERT_TRUE(takeDumps().empty());
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+TEST_P(FlightRecorderTest, DumpedOnSignal) {
+    logger.getConfig().setConfigValue(rk::config::flight_recorder_signal::KEY, rk::config::flight_recorder_signal::ENABLE);
+    ASSERT_NO_FATAL_FAILURE(Base::startLogger(std::filesystem::path()));
+    RK_LOG_TO_AT(logger, rk::log::Level::Debug, "debug 1\n");
+    RK_LOG_TO(logger, "info 1\n");
+    for (int i = 0; i < 100 && sink->str().find("info 1") == std::string::npos; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(std::raise(SIGUSR1), 0);
+
+    SCOPED_TRACE("Waiting for the log thread to notice the signal");
+    for (int i = 0; i < 100 && findDumpFiles().empty(); i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    ASSERT_NO_FATAL_FAILURE(Base::stopLogger());
+    const std::vector<std::string> dumps = takeDumps();
+    ASSERT_EQ(dumps.size(), 1);
+    ASSERT_NE(dumps[0].find("]debug 1\n"), std::string::npos);
+    ASSERT_NE(dumps[0].find("]info 1\n"), std::string::npos);
+}
+#endif
+
+INSTANTIATE_TEST_SUITE_P(FlightRecorderTest,
+    FlightRecorderTest,
+    testing::Values(
+        FlightRecorderTestParam("one_shard", "1", rk::config::log_shard_ordering::GLOBAL),
+        FlightRecorderTestParam("four_shards_global", "4", rk::config::log_shard_ordering::GLOBAL),
+        FlightRecorderTestParam("four_shards_per_thread", "4", rk::config::log_shard_ordering::PER_THREAD)
+    ),
+    [](const testing::TestParamInfo<FlightRecorderTestParam>& info) {
+        return info.param.description;
+    }
+);
+
+} // namespace flight_recorder_tests
+} // namespace rk_logger_tests
@@ -0,0 +1,106 @@
+#ifndef FLIGHT_RECORDER_TESTS_H
+#define FLIGHT_RECORDER_TESTS_H
+
+#include <algorithm>
+#include <fstream>
+
+#include <rk_logger/logger.h>
+#include <rk_logger/flight_recorder.h>
+#include <rk_logger_tests/test_base.h>
+
+namespace rk_logger_tests {
+namespace flight_recorder_tests {
+
+inline const std::string DUMP_FILE_PREFIX = "flight_recorder_" + TEST_LOGGER_NAME + "_";
+
+struct FlightRecorderTestParam : public BaseParam {
+    FlightRecorderTestParam(const std::string description, const std::string shardCount, const rk::config::ConfigValue ordering)
+        : BaseParam(description), shardCount(shardCount), ordering(ordering) {};
+
+    const std::string shardCount;
+    const rk::config::ConfigValue ordering;
+};
+
+class FlightRecorderTest : public Base, public ::testing::WithParamInterface<FlightRecorderTestParam> {
+protected:
+    void SetUp() override {
+        redirectStdCout();
+        // The dumps are written to the working directory, so each test gets one of its own, where tests that run in
+        // parallel in other processes can't see or remove its dumps
+        std::string testName = ::testing::UnitTest::GetInstance()->current_test_info()->test_suite_name() + std::string("_") +
+            ::testing::UnitTest::GetInstance()->current_test_info()->name();
+        std::replace(testName.begin(), testName.end(), '/', '_');
+        originalDirectory = std::filesystem::current_path();
+        dumpDirectory = std::filesystem::temp_directory_path()/("rk_" + testName);
+        std::filesystem::create_directories(dumpDirectory);
+        std::filesystem::current_path(dumpDirectory);
+        removeDumpFiles();
+        logger.getConfig().setConfigValue(rk::config::write_to_log_file::KEY, rk::config::write_to_log_file::DISABLE);
+        logger.getConfig().setConfigValue(rk::config::write_to_console::KEY, rk::config::write_to_console::DISABLE);
+        logger.getConfig().setConfigValue(rk::config::log_shards::KEY, GetParam().shardCount);
+        logger.getConfig().setConfigValue(rk::config::log_shard_ordering::KEY, GetParam().ordering);
+        logger.getConfig().setConfigValue(rk::config::flight_recorder_size_kb::KEY, "64");
+        logger.addSink(sink);
+    }
+
+    void TearDown() override {
+        if (logThread.joinable()) {
+            Base::stopLogger();
+        }
+        undoRedirectStdCout();
+        std::filesystem::current_path(originalDirectory);
+        std::filesystem::remove_all(dumpDirectory);
+    }
+
+    /**
+     * @brief Reads the dump files that the test logger wrote, in the order they were written, and removes them.
+     */
+    std::vector<std::string> takeDumps() {
+        std::vector<std::filesystem::path> paths = findDumpFiles();
+        std::sort(paths.begin(), paths.end(), [] (const std::filesystem::path& a, const std::filesystem::path& b) {
+            return dumpNumber(a) < dumpNumber(b);
+        });
+        std::vector<std::string> dumps;
+        for (const auto& path : paths) {
+            std::ifstream file(path, std::ios::binary);
+            dumps.emplace_back(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        }
+        removeDumpFiles();
+        return dumps;
+    }
+
+    static std::vector<std::filesystem::path> findDumpFiles() {
+        std::vector<std::filesystem::path> paths;
+        for (const auto& entry : std::filesystem::directory_iterator(std::filesystem::current_path())) {
+            if (entry.path().filename().string().rfind(DUMP_FILE_PREFIX, 0) == 0) {
+                paths.push_back(entry.path());
+            }
+        }
+        return paths;
+    }
+
+    std::shared_ptr<StringSink> sink = std::make_shared<StringSink>();
+
+private:
+    std::filesystem::path originalDirectory;
+    std::filesystem::path dumpDirectory;
+
+    static void removeDumpFiles() {
+        for (const auto& path : findDumpFiles()) {
+            std::filesystem::remove(path);
+        }
+    }
+
+    /**
+     * @brief Gets the number at the end of a dump file name, e.g., 1 for "flight_recorder_test_<timestamp>_1.txt".
+     */
+    static int dumpNumber(const std::filesystem::path& path) {
+        const std::string stem = path.stem().string();
+        return std::stoi(stem.substr(stem.find_last_of('_') + 1));
+    }
+};
+
+} // namespace flight_recorder_tests
+} // namespace rk_logger_tests
+
+#endif // #ifndef FLIGHT_RECORDER_TESTS_H
@@ -0,0 +1,221 @@
+#include <atomic>
+#include <fstream>
+#include <thread>
+
+#include <rk_logger/lz4.h>
+#include "fork_tests.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+
+namespace rk_logger_tests {
+namespace fork_tests {
+
+// Forking while other threads are logging must leave the child with unlocked queues and a working log thread
+TEST_F(ForkTest, ForkUnderLoad) {
+    constexpr int PRODUCER_COUNT = 4;
+    constexpr int FORK_COUNT = 20;
+    constexpr int BURST_SIZE = 100; /**< The producers pause briefly between bursts, so the queues don't grow without bound */
+    auto countingSink = std::make_shared<ProcessCountingSink>();
+    logger.addSink(countingSink);
+    logger.getConfig().setConfigValue(rk::config::log_shards::KEY, "2");
+    logger.startOwned(std::filesystem::path());
+
+    std::atomic<bool> isDone{false};
+    std::atomic<int> parentMessageCount{0};
+    std::vector<std::thread> producers;
+    for (int producer = 0; producer < PRODUCER_COUNT; producer++) {
+        producers.emplace_back([this, &isDone, &parentMessageCount, producer] () {
+            for (int i = 0; !isDone.load(std::memory_order_relaxed); i++) {
+                RK_LOG_TO(logger, "parent ", producer, " message ", i, "\n");
+                parentMessageCount.fetch_add(1, std::memory_order_relaxed);
+                if (i % BURST_SIZE == BURST_SIZE - 1) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(100));
+                }
+            }
+        });
+    }
+
+    // The producers have to be joined even if a child fails, so the failures don't end the test here
+    for (int i = 0; i < FORK_COUNT; i++) {
+        const pid_t pid = fork();
+        EXPECT_GE(pid, 0);
+        if (pid < 0) {
+            break;
+        }
+        if (pid == 0) {
+            runChild([this] () { logger.stop(); });
+        }
+        EXPECT_NO_FATAL_FAILURE(waitForChild(pid));
+    }
+
+    isDone = true;
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    logger.stop();
+
+    SCOPED_TRACE("The parent wrote every message of its own and none of the children's");
+    ASSERT_EQ(countingSink->parentCount.load(), static_cast<size_t>(parentMessageCount.load()));
+    ASSERT_EQ(countingSink->childCount.load(), 0);
+}
+
+// The thread from start() is the parent's, so stopping with it in the child stops the child's log thread instead
+TEST_F(ForkTest, StopWithThreadOfParent) {
+    logger.addSink(sink);
+    ASSERT_NO_FATAL_FAILURE(Base::startLogger(std::filesystem::path()));
+    RK_LOG_TO(logger, "before fork\n");
+
+    const pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        runChild([this] () { logger.stop(std::move(logThread)); });
+    }
+    ASSERT_NO_FATAL_FAILURE(waitForChild(pid));
+
+    RK_LOG_TO(logger, "after fork\n");
+    Base::stopLogger();
+    ASSERT_NE(sink->str().find("before fork\n"), std::string::npos);
+    ASSERT_NE(sink->str().find("after fork\n"), std::string::npos);
+}
+
+// Output to a pipe is held back until a block is full, so it has to be written before the fork or the child writes it too
+TEST_F(ForkTest, ConsoleToPipe) {
+    int fds[2] = { -1, -1 };
+    ASSERT_EQ(pipe(fds), 0);
+    std::string output;
+    std::thread reader([&output, readFd = fds[0]] () {
+        char chunk[4096];
+        ssize_t size = 0;
+        while ((size = read(readFd, chunk, sizeof(chunk))) > 0) {
+            output.append(chunk, static_cast<size_t>(size));
+        }
+    });
+    auto consoleSink = std::make_shared<rk::log::ConsoleSink>(fds[1]);
+    logger.addSink(consoleSink);
+    logger.addSink(sink); // Written after the console sink, so the message is in the console's buffer once it is here
+    logger.startOwned(std::filesystem::path());
+    RK_LOG_TO(logger, "before fork\n");
+    while (sink->str().find("before fork\n") == std::string::npos) {
+        std::this_thread::sleep_for(MAX_DELAY_FOR_ONE_MESSAGE);
+    }
+
+    const pid_t pid = fork();
+    EXPECT_GE(pid, 0);
+    if (pid == 0) {
+        // Writes out the child's buffer the same as destroying the sink at exit would
+        runChild([this, &consoleSink] () { logger.stop(); consoleSink->sync(); });
+    }
+    if (pid > 0) {
+        EXPECT_NO_FATAL_FAILURE(waitForChild(pid));
+    }
+    logger.stop();
+    consoleSink->sync();
+    close(fds[1]);
+    reader.join();
+    close(fds[0]);
+
+    SCOPED_TRACE("The message from before the fork was written once, by the parent");
+    ASSERT_GT(pid, 0);
+    ASSERT_EQ(countOccurrences(output, "before fork\n"), 1);
+    ASSERT_EQ(countOccurrences(output, "child " + std::to_string(pid) + " message "), CHILD_MESSAGE_COUNT);
+}
+
+TEST_F(ForkTest, LogFilePerProcess) {
+    logger.getConfig().setConfigValue(rk::config::write_to_log_file::KEY, rk::config::write_to_log_file::ENABLE);
+    logger.getConfig().setConfigValue(rk::config::fork_log_file::KEY, rk::config::fork_log_file::PER_PID);
+    logger.startOwned(std::filesystem::path());
+    RK_LOG_TO(logger, "before fork\n");
+
+    const pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        runChild([this] () { logger.stop(); });
+    }
+    ASSERT_NO_FATAL_FAILURE(waitForChild(pid));
+    RK_LOG_TO(logger, "after fork\n");
+    logger.stop();
+
+    std::string parentLog;
+    std::string childLog;
+    for (const auto& path : findLogFiles()) {
+        const std::string fileName = path.filename().string();
+        if (fileName.find("_pid" + std::to_string(pid) + ".txt") != std::string::npos) {
+            childLog = readFile(path);
+        }
+        else {
+            parentLog = readFile(path);
+        }
+    }
+
+    SCOPED_TRACE("Each process wrote its own messages to its own file");
+    ASSERT_EQ(findLogFiles().size(), 2);
+    ASSERT_NE(parentLog.find("before fork\n"), std::string::npos);
+    ASSERT_NE(parentLog.find("after fork\n"), std::string::npos);
+    ASSERT_EQ(parentLog.find("child "), std::string::npos);
+    ASSERT_EQ(countOccurrences(childLog, "child " + std::to_string(pid) + " message "), CHILD_MESSAGE_COUNT);
+    ASSERT_EQ(childLog.find("before fork\n"), std::string::npos);
+}
+
+TEST_F(ForkTest, LogFileShared) {
+    logger.getConfig().setConfigValue(rk::config::write_to_log_file::KEY, rk::config::write_to_log_file::ENABLE);
+    logger.startOwned(std::filesystem::path());
+    RK_LOG_TO(logger, "before fork\n");
+
+    const pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        runChild([this] () { logger.stop(); });
+    }
+    ASSERT_NO_FATAL_FAILURE(waitForChild(pid));
+    RK_LOG_TO(logger, "after fork\n");
+    logger.stop();
+
+    SCOPED_TRACE("Both processes wrote to the same file, and the message from before the fork was written once");
+    const std::vector<std::filesystem::path> logFiles = findLogFiles();
+    ASSERT_EQ(logFiles.size(), 1);
+    const std::string log = readFile(logFiles[0]);
+    ASSERT_EQ(countOccurrences(log, "before fork\n"), 1);
+    ASSERT_NE(log.find("after fork\n"), std::string::npos);
+    ASSERT_EQ(countOccurrences(log, "child " + std::to_string(pid) + " message "), CHILD_MESSAGE_COUNT);
+}
+
+// Compressed frames from two processes can't be interleaved in one file, so the child always gets its own file
+TEST_F(ForkTest, CompressedLogFilePerProcess) {
+    logger.getConfig().setConfigValue(rk::config::write_to_log_file::KEY, rk::config::write_to_log_file::ENABLE);
+    logger.getConfig().setConfigValue(rk::config::log_file_compression::KEY, rk::config::log_file_compression::LZ4);
+    logger.startOwned(std::filesystem::path());
+    RK_LOG_TO(logger, "before fork\n");
+
+    const pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        runChild([this] () { logger.stop(); });
+    }
+    ASSERT_NO_FATAL_FAILURE(waitForChild(pid));
+    RK_LOG_TO(logger, "after fork\n");
+    logger.stop();
+
+    std::string parentLog;
+    std::string childLog;
+    const std::vector<std::filesystem::path> logFiles = findLogFiles();
+    ASSERT_EQ(logFiles.size(), 2);
+    for (const auto& path : logFiles) {
+        const std::string compressed = readFile(path);
+        rk::lz4_internal::FrameDecoder decoder;
+        std::string& log = path.filename().string().find("_pid" + std::to_string(pid) + ".txt.lz4") != std::string::npos ? childLog : parentLog;
+        ASSERT_TRUE(decoder.decode(compressed.data(), compressed.size(), log)) << decoder.getError();
+        ASSERT_TRUE(decoder.isAtFrameBoundary());
+    }
+
+    SCOPED_TRACE("Each process wrote whole frames of its own messages to its own file");
+    ASSERT_EQ(countOccurrences(parentLog, "before fork\n"), 1);
+    ASSERT_NE(parentLog.find("after fork\n"), std::string::npos);
+    ASSERT_EQ(parentLog.find("child "), std::string::npos);
+    ASSERT_EQ(countOccurrences(childLog, "child " + std::to_string(pid) + " message "), CHILD_MESSAGE_COUNT);
+    ASSERT_EQ(childLog.find("before fork\n"), std::string::npos);
+}
+
+} // namespace fork_tests
+} // namespace rk_logger_tests
+
+#endif // #if defined(__unix__) || defined(__APPLE__)
@@ -0,0 +1,124 @@
+#ifndef FORK_TESTS_H
+#define FORK_TESTS_H
+
+#include <rk_logger/logger.h>
+#include <rk_logger_tests/test_base.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace rk_logger_tests {
+namespace fork_tests {
+
+inline const std::string LOG_FILE_PREFIX = "logs_" + TEST_LOGGER_NAME + "_";
+constexpr unsigned int CHILD_TIMEOUT_SECONDS = 10; /**< A child that deadlocks is killed instead of hanging the test */
+constexpr int CHILD_MESSAGE_COUNT = 1000;
+
+/**
+ * A sink that only counts the messages from the parent and the children, so logging under load doesn't keep
+ * everything in memory.
+ */
+class ProcessCountingSink : public rk::log::Sink {
+public:
+    void write(const std::string& message) override {
+        if (message.find("]parent ") != std::string::npos) {
+            parentCount.fetch_add(1, std::memory_order_relaxed);
+        }
+        else if (message.find("]child ") != std::string::npos) {
+            childCount.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    std::atomic<size_t> parentCount{0};
+    std::atomic<size_t> childCount{0};
+};
+
+class ForkTest : public Base {
+protected:
+    void SetUp() override {
+        redirectStdCout(); // Also quiets the children, which get a copy of the redirected stream
+        if (IS_THREAD_SANITIZER_ENABLED || IS_ADDRESS_SANITIZER_ENABLED) {
+            GTEST_SKIP() << "The sanitizers don't support starting threads in the child of a multi-threaded process";
+        }
+        removeLogFiles();
+        logger.getConfig().setConfigValue(rk::config::write_to_log_file::KEY, rk::config::write_to_log_file::DISABLE);
+        logger.getConfig().setConfigValue(rk::config::write_to_console::KEY, rk::config::write_to_console::DISABLE);
+    }
+
+    void TearDown() override {
+        if (logThread.joinable()) {
+            Base::stopLogger();
+        }
+        logger.stop();
+        undoRedirectStdCout();
+        removeLogFiles();
+    }
+
+    /**
+     * @brief Runs in the child process. Logs CHILD_MESSAGE_COUNT messages, stops the logger, and exits with 0 if they
+     * were all written, without returning to the test.
+     *
+     * @param stopLogger Stops the logger of the child.
+     */
+    template<typename StopFunc>
+    [[noreturn]] void runChild(StopFunc stopLogger) {
+        alarm(CHILD_TIMEOUT_SECONDS);
+        auto childSink = std::make_shared<StringSink>();
+        logger.addSink(childSink);
+        const std::string prefix = "child " + std::to_string(getpid()) + " message ";
+        for (int i = 0; i < CHILD_MESSAGE_COUNT; i++) {
+            RK_LOG_TO(logger, prefix, i, "\n");
+        }
+        stopLogger();
+        _exit(countOccurrences(childSink->str(), prefix) == CHILD_MESSAGE_COUNT ? 0 : 1);
+    }
+
+    /**
+     * @brief Waits for a child process and checks that it exited with 0.
+     */
+    static void waitForChild(const pid_t pid) {
+        int status = 0;
+        ASSERT_EQ(waitpid(pid, &status, 0), pid);
+        ASSERT_TRUE(WIFEXITED(status)) << "The child was killed by signal " << (WIFSIGNALED(status) ? WTERMSIG(status) : 0);
+        ASSERT_EQ(WEXITSTATUS(status), 0);
+    }
+
+    static std::vector<std::filesystem::path> findLogFiles() {
+        std::vector<std::filesystem::path> paths;
+        for (const auto& entry : std::filesystem::directory_iterator(std::filesystem::current_path())) {
+            if (entry.path().filename().string().rfind(LOG_FILE_PREFIX, 0) == 0) {
+                paths.push_back(entry.path());
+            }
+        }
+        return paths;
+    }
+
+    static void removeLogFiles() {
+        for (const auto& path : findLogFiles()) {
+            std::filesystem::remove(path);
+        }
+    }
+
+    static std::string readFile(const std::filesystem::path& path) {
+        std::ifstream file(path, std::ios::binary);
+        return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    }
+
+    static size_t countOccurrences(const std::string& text, const std::string& substring) {
+        size_t count = 0;
+        for (size_t pos = text.find(substring); pos != std::string::npos; pos = text.find(substring, pos + 1)) {
+            count++;
+        }
+        return count;
+    }
+
+    std::shared_ptr<StringSink> sink = std::make_shared<StringSink>();
+};
+
+} // namespace fork_tests
+} // namespace rk_logger_tests
+
+#endif // #if defined(__unix__) || defined(__APPLE__)
+
+#endif // #ifndef FORK_TESTS_H
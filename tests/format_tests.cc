@@ -0,0 +1,113 @@
+#include <climits>
+#include <cstdint>
+#include <limits>
+
+#include <rk_logger/format.h>
+#include "format_tests.h"
+
+namespace rk_logger_tests {
+namespace format_tests {
+
+// Writing arguments directly has to give the same output as writing them to a std::ostream did
+TEST(AppendArgTest, MatchesStreamOutput) {
+    const std::string str = "string";
+    const char* cStr = "c string";
+    const std::string_view strView = "string view";
+    const int8_t smallInt = 65;
+    const uint8_t smallUnsigned = 66;
+
+    auto check = [] (const std::string& expected, const std::string& actual) {
+        ASSERT_EQ(actual, expected);
+    };
+    check(formatWithStream(0, -1, 42, INT_MIN, LLONG_MAX, ULLONG_MAX), formatIntoRecord(0, -1, 42, INT_MIN, LLONG_MAX, ULLONG_MAX).message);
+    check(formatWithStream(static_cast<short>(-7), 7u, 7ul), formatIntoRecord(static_cast<short>(-7), 7u, 7ul).message);
+    check(formatWithStream(3.14159265, 1e20, 0.0001, -2.5f, 100.0, 1.0 / 3.0), formatIntoRecord(3.14159265, 1e20, 0.0001, -2.5f, 100.0, 1.0 / 3.0).message);
+    check(formatWithStream(std::numeric_limits<double>::infinity(), 123456789.0, 1e-10), formatIntoRecord(std::numeric_limits<double>::infinity(), 123456789.0, 1e-10).message);
+    check(formatWithStream(true, false, 'x', smallInt, smallUnsigned), formatIntoRecord(true, false, 'x', smallInt, smallUnsigned).message);
+    check(formatWithStream(str, cStr, strView, "literal"), formatIntoRecord(str, cStr, strView, "literal").message);
+    check(formatWithStream(SECOND_VALUE, StreamableType{5}), formatIntoRecord(SECOND_VALUE, StreamableType{5}).message);
+}
+
+TEST(AppendArgTest, NullCString) {
+    const char* nullStr = nullptr;
+    ASSERT_EQ(formatIntoRecord("before", nullStr, "after").message, "beforeafter");
+}
+
+TEST(AppendArgTest, RvalueStringIsMoved) {
+    std::string large(1000, 'x');
+    const char* data = large.data();
+    rk::log::Record record = formatIntoRecord(std::move(large));
+
+    SCOPED_TRACE("The message took over the buffer of the string instead of copying it");
+    ASSERT_EQ(record.message.size(), 1000);
+    ASSERT_EQ(record.message.data(), data);
+
+    SCOPED_TRACE("An lvalue string is copied and left alone");
+    std::string kept(1000, 'y');
+    rk::log::Record copied = formatIntoRecord(kept);
+    ASSERT_EQ(kept.size(), 1000);
+    ASSERT_EQ(copied.message, kept);
+}
+
+TEST(AppendArgTest, View) {
+    const char buffer[] = { 'a', 'b', 'c', 'd', 'e', 'f' }; // Not null terminated
+    ASSERT_EQ(formatIntoRecord("[", rk::log::view(buffer, 3), "]").message, "[abc]");
+    ASSERT_EQ(formatIntoRecord(rk::log::view(std::string_view("view"))).message, "view");
+}
+
+TEST(AppendArgTest, Hex) {
+    const uint8_t bytes[] = { 0xde, 0xad, 0xbe, 0xef, 0x00, 0x01 };
+    ASSERT_EQ(formatIntoRecord("payload: ", rk::log::hex(bytes, sizeof(bytes))).message, "payload: de ad be ef 00 01");
+    ASSERT_EQ(formatIntoRecord("empty: ", rk::log::hex(bytes, 0), "!").message, "empty: !");
+}
+
+TEST(AppendArgTest, OwnedIsMovedIntoRecord) {
+    std::string payload(1000, 'z');
+    const char* data = payload.data();
+    rk::log::Record record = formatIntoRecord("before ", rk::log::owned(std::move(payload)), " after");
+
+    SCOPED_TRACE("The string is kept as is instead of being copied into the message");
+    ASSERT_EQ(record.message, "before  after");
+    ASSERT_EQ(record.spliced.size(), 1);
+    ASSERT_EQ(record.spliced[0].offset, 7);
+    ASSERT_EQ(record.spliced[0].text.data(), data);
+}
+
+TEST(AppendArgTest, FormatterIsPreferredOverStream) {
+    ASSERT_EQ(formatWithStream(Price{ 123456 }), "Price(123456)");
+    const rk::log::Record record = formatIntoRecord("bid=", Price{ 123456 }, " ask=", Price{ 7 }, "\n");
+    ASSERT_EQ(record.message, "bid=1234.56 ask=0.07\n");
+    ASSERT_TRUE(record.spliced.empty());
+}
+
+TEST(AppendArgTest, DeferredFormatterCopiesBytes) {
+    const Ipv4Address address = { { 192, 168, 0, 1 } };
+    rk::log::Record record = formatIntoRecord("from ", address, " to ", Ipv4Address{ { 10, 0, 0, 255 } });
+
+    SCOPED_TRACE("The address is only copied, and is formatted when the record is");
+    ASSERT_EQ(record.message, "from  to ");
+    ASSERT_EQ(record.spliced.size(), 2);
+    ASSERT_EQ(record.spliced[0].offset, 5);
+    ASSERT_EQ(record.spliced[0].text.size(), sizeof(Ipv4Address));
+    ASSERT_NE(record.spliced[0].format, nullptr);
+
+    std::string out;
+    record.spliced[1].format(record.spliced[1].text, out);
+    ASSERT_EQ(out, "10.0.0.255");
+}
+
+TEST_F(FormatLoggerTest, WrappersInLogOutput) {
+    const uint8_t bytes[] = { 0xca, 0xfe };
+    RK_LOG_TO(logger, "owned=", rk::log::owned(std::string(5, 'o')), " hex=", rk::log::hex(bytes, sizeof(bytes)), " view=", rk::log::view("viewed", 4), "\n");
+    RK_LOG_TO(logger, std::string("moved string"), " ", 1.5, "\n");
+    RK_LOG_TO(logger, "price=", Price{ 995 }, " address=", Ipv4Address{ { 127, 0, 0, 1 } }, "\n");
+    Base::stopLogger();
+
+    const std::string output = sink->str();
+    ASSERT_NE(output.find("]price=9.95 address=127.0.0.1\n"), std::string::npos);
+    ASSERT_NE(output.find("]owned=ooooo hex=ca fe view=view\n"), std::string::npos);
+    ASSERT_NE(output.find("]moved string 1.5\n"), std::string::npos);
+}
+
+} // namespace format_tests
+} // namespace rk_logger_tests
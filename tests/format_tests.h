@@ -0,0 +1,113 @@
+#ifndef FORMAT_TESTS_H
+#define FORMAT_TESTS_H
+
+#include <rk_logger/logger.h>
+#include <rk_logger/format.h>
+#include <rk_logger_tests/test_base.h>
+
+namespace rk_logger_tests {
+namespace format_tests {
+
+/**
+ * @brief Writes arguments the way RK_LOG used to, for comparing against.
+ */
+template<typename... Args>
+std::string formatWithStream(const Args&... args) {
+    std::ostringstream oss;
+    (oss << ... << args);
+    return oss.str();
+}
+
+/**
+ * @brief Writes arguments into a record the way RK_LOG does.
+ */
+template<typename... Args>
+rk::log::Record formatIntoRecord(Args&&... args) {
+    rk::log::Record record;
+    (rk::log_internal::appendArg(record, std::forward<Args>(args)), ...);
+    return record;
+}
+
+enum UnscopedEnum { FIRST_VALUE, SECOND_VALUE };
+
+struct StreamableType {
+    int value;
+};
+
+inline std::ostream& operator<<(std::ostream& os, const StreamableType& streamable) {
+    return os << "StreamableType(" << streamable.value << ")";
+}
+
+/**
+ * A price in ticks of a cent, with both an operator<< and a formatter, which should be preferred.
+ */
+struct Price {
+    int64_t cents;
+};
+
+inline std::ostream& operator<<(std::ostream& os, const Price& price) {
+    return os << "Price(" << price.cents << ")";
+}
+
+struct Ipv4Address {
+    uint8_t octets[4];
+};
+
+} // namespace format_tests
+} // namespace rk_logger_tests
+
+template<>
+struct rk::log::formatter<rk_logger_tests::format_tests::Price> {
+    static constexpr size_t max_size = 24;
+    static size_t format_to(char* out, const rk_logger_tests::format_tests::Price& price) {
+        char* end = std::to_chars(out, out + max_size, price.cents / 100).ptr;
+        *end++ = '.';
+        *end++ = static_cast<char>('0' + price.cents % 100 / 10);
+        *end++ = static_cast<char>('0' + price.cents % 10);
+        return static_cast<size_t>(end - out);
+    }
+};
+
+template<>
+struct rk::log::formatter<rk_logger_tests::format_tests::Ipv4Address> {
+    static constexpr size_t max_size = 15;
+    static constexpr bool is_deferred = true;
+    static size_t format_to(char* out, const rk_logger_tests::format_tests::Ipv4Address& address) {
+        char* end = out;
+        for (size_t i = 0; i < 4; i++) {
+            if (i > 0) {
+                *end++ = '.';
+            }
+            end = std::to_chars(end, out + max_size, address.octets[i]).ptr;
+        }
+        return static_cast<size_t>(end - out);
+    }
+};
+
+namespace rk_logger_tests {
+namespace format_tests {
+
+class FormatLoggerTest : public Base {
+protected:
+    void SetUp() override {
+        redirectStdCout();
+        logger.getConfig().setConfigValue(rk::config::write_to_log_file::KEY, rk::config::write_to_log_file::DISABLE);
+        logger.getConfig().setConfigValue(rk::config::write_to_console::KEY, rk::config::write_to_console::DISABLE);
+        logger.addSink(sink);
+        ASSERT_NO_FATAL_FAILURE(Base::startLogger(std::filesystem::path()));
+    }
+
+    void TearDown() override {
+        if (logThread.joinable()) {
+            Base::stopLogger();
+        }
+        undoRedirectStdCout();
+    }
+
+    std::shared_ptr<StringSink> sink = std::make_shared<StringSink>();
+};
+
+} // namespace format_tests
+} // namespace rk_logger_tests
+
+#endif // #ifndef FORMAT_TESTS_H
@@ -6,20 +6,68 @@
 
 namespace rk_logger_tests {
 
+#if defined(__SANITIZE_THREAD__)
+constexpr bool IS_THREAD_SANITIZER_ENABLED = true;
+#elif defined(__has_feature)
+#if __has_feature(thread_sanitizer)
+constexpr bool IS_THREAD_SANITIZER_ENABLED = true;
+#else
+constexpr bool IS_THREAD_SANITIZER_ENABLED = false;
+#endif
+#else
+constexpr bool IS_THREAD_SANITIZER_ENABLED = false;
+#endif
+
+#if defined(__SANITIZE_ADDRESS__)
+constexpr bool IS_ADDRESS_SANITIZER_ENABLED = true;
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+constexpr bool IS_ADDRESS_SANITIZER_ENABLED = true;
+#else
+constexpr bool IS_ADDRESS_SANITIZER_ENABLED = false;
+#endif
+#else
+constexpr bool IS_ADDRESS_SANITIZER_ENABLED = false;
+#endif
+
 inline const std::chrono::milliseconds MAX_DELAY_FOR_ONE_MESSAGE = std::chrono::milliseconds(1);
+inline const std::string TEST_LOGGER_NAME = "test";
+
+/**
+ * A sink that keeps everything written to it, so tests can check the output of a logger.
+ */
+class StringSink : public rk::log::Sink {
+public:
+    void write(const std::string& message) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        output += message;
+    }
+
+    std::string str() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return output;
+    }
+private:
+    std::mutex mutex;
+    std::string output;
+};
 
+/**
+ * Each test gets its own logger, with its own config and queue, so tests don't affect each other through the
+ * default logger.
+ */
 class Base : public::testing::Test {
 protected:
-    void startLogger() {
+    void startLogger(const std::filesystem::path& configPath = std::filesystem::current_path()/rk::config::CONFIG_FILE_NAME) {
         ASSERT_NO_THROW({
-            logThread = rk::log::startLogger();
+            logThread = logger.start(configPath);
         });
         ASSERT_TRUE(logThread.joinable());
     }
 
     void stopLogger() {
         ASSERT_NO_THROW({
-            rk::log::stopLogger(std::move(logThread));
+            logger.stop(std::move(logThread));
         });
         ASSERT_FALSE(logThread.joinable());
     }
@@ -32,6 +80,7 @@ protected:
         std::cout.rdbuf(coutBufOriginal);
     }
 
+    rk::log::Logger logger{TEST_LOGGER_NAME};
     std::thread logThread;
     std::streambuf* coutBufOriginal;
     std::stringstream logOutput;
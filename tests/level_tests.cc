@@ -0,0 +1,246 @@
+#include <rk_logger/level.h>
+#include "level_tests.h"
+
+namespace rk_logger_tests {
+namespace level_tests {
+
+TEST_P(LevelNameTest, LevelToStringAndBack) {
+    auto param = GetParam();
+    ASSERT_EQ(std::string(rk::log::levelToString(param.level)), param.name);
+
+    rk::log::Level parsed = rk::log::Level::Off;
+    ASSERT_TRUE(rk::log::parseLevel(param.name, parsed));
+    ASSERT_EQ(parsed, param.level);
+
+    SCOPED_TRACE("Every level name is a valid config value");
+    ASSERT_TRUE(rk::config::getInstance().isKeyAndValueValid(rk::config::log_level::KEY, param.name));
+}
+
+INSTANTIATE_TEST_SUITE_P(LevelNameTest,
+    LevelNameTest,
+    testing::Values(
+        LevelNameTestParam("trace", rk::log::Level::Trace, "TRACE"),
+        LevelNameTestParam("debug", rk::log::Level::Debug, "DEBUG"),
+        LevelNameTestParam("info", rk::log::Level::Info, "INFO"),
+        LevelNameTestParam("warn", rk::log::Level::Warn, "WARN"),
+        LevelNameTestParam("error", rk::log::Level::Error, "ERROR"),
+        LevelNameTestParam("fatal", rk::log::Level::Fatal, "FATAL"),
+        LevelNameTestParam("off", rk::log::Level::Off, "OFF")
+    ),
+    [](const testing::TestParamInfo<LevelNameTestParam>& info) {
+        return info.param.description;
+    }
+);
+
+TEST(LevelParseTest, InvalidNames) {
+    rk::log::Level level = rk::log::Level::Info;
+    ASSERT_FALSE(rk::log::parseLevel("debug", level));
+    ASSERT_FALSE(rk::log::parseLevel("WARNING", level));
+    ASSERT_FALSE(rk::log::parseLevel("", level));
+    ASSERT_EQ(level, rk::log::Level::Info);
+}
+
+TEST_F(LevelFilterTest, LevelFromConfig) {
+    SCOPED_TRACE("The level comes from the config when the logger starts");
+    ASSERT_EQ(logger.getLevel(), rk::log::Level::Info);
+    Base::stopLogger();
+
+    logger.getConfig().setConfigValue(rk::config::log_level::KEY, "ERROR");
+    ASSERT_NO_FATAL_FAILURE(Base::startLogger(std::filesystem::path()));
+    ASSERT_EQ(logger.getLevel(), rk::log::Level::Error);
+    ASSERT_FALSE(logger.isEnabled(rk::log::Level::Warn));
+    ASSERT_TRUE(logger.isEnabled(rk::log::Level::Error));
+}
+
+TEST_F(LevelFilterTest, MessagesBelowLevelAreDroppedWithoutEvaluation) {
+    size_t evaluations = 0;
+    auto countEvaluation = [&evaluations] () {
+        evaluations++;
+        return "counted";
+    };
+
+    logger.setLevel(rk::log::Level::Warn);
+    RK_LOG_TO_AT(logger, rk::log::Level::Trace, "trace ", countEvaluation(), "\n");
+    RK_LOG_TO_AT(logger, rk::log::Level::Debug, "debug ", countEvaluation(), "\n");
+    RK_LOG_TO(logger, "info ", countEvaluation(), "\n");
+    RK_LOG_TO_AT(logger, rk::log::Level::Warn, "warn ", countEvaluation(), "\n");
+    RK_LOG_TO_AT(logger, rk::log::Level::Error, "error ", countEvaluation(), "\n");
+
+    SCOPED_TRACE("Only the messages at or above the level were evaluated and logged");
+    ASSERT_EQ(evaluations, 2);
+    const std::string output = stopAndGetOutput();
+    ASSERT_EQ(output.find("trace"), std::string::npos);
+    ASSERT_EQ(output.find("debug"), std::string::npos);
+    ASSERT_EQ(output.find("info"), std::string::npos);
+    ASSERT_NE(output.find("warn counted"), std::string::npos);
+    ASSERT_NE(output.find("error counted"), std::string::npos);
+}
+
+TEST_F(LevelFilterTest, KillSwitch) {
+    size_t evaluations = 0;
+    auto countEvaluation = [&evaluations] () {
+        evaluations++;
+        return "counted";
+    };
+
+    SCOPED_TRACE("Nothing is logged while logging is disabled, not even fatal messages");
+    logger.setEnabled(false);
+    RK_LOG_TO_AT(logger, rk::log::Level::Fatal, "while disabled ", countEvaluation(), "\n");
+    ASSERT_EQ(evaluations, 0);
+    ASSERT_EQ(logger.getLevel(), rk::log::Level::Info);
+
+    SCOPED_TRACE("Logging by level resumes once enabled again");
+    logger.setEnabled(true);
+    RK_LOG_TO(logger, "while enabled ", countEvaluation(), "\n");
+    ASSERT_EQ(evaluations, 1);
+
+    const std::string output = stopAndGetOutput();
+    ASSERT_EQ(output.find("while disabled"), std::string::npos);
+    ASSERT_NE(output.find("while enabled counted"), std::string::npos);
+}
+
+TEST_F(LevelFilterTest, LevelOffLogsNothing) {
+    logger.setLevel(rk::log::Level::Off);
+    for (const rk::log::Level level : { rk::log::Level::Trace, rk::log::Level::Fatal, rk::log::Level::Off }) {
+        ASSERT_FALSE(logger.isEnabled(level));
+    }
+}
+
+TEST_F(LevelFilterTest, DeferredArgumentsRunOnLogThread) {
+    const std::thread::id callerId = std::this_thread::get_id();
+    std::atomic<bool> ranOnCaller{false};
+    std::atomic<size_t> calls{0};
+
+    RK_LOG_TO(logger, "before ", rk::log::defer([callerId, &ranOnCaller, &calls] () {
+        ranOnCaller = std::this_thread::get_id() == callerId;
+        calls++;
+        return 42;
+    }), " after\n");
+    RK_LOG_TO(logger, rk::log::defer([] () { return std::string("first"); }), " middle ", rk::log::defer([] () { return "last"; }), "\n");
+
+    SCOPED_TRACE("Deferred arguments of dropped messages are never called");
+    logger.setLevel(rk::log::Level::Error);
+    RK_LOG_TO(logger, "dropped ", rk::log::defer([&calls] () { calls++; return 0; }), "\n");
+
+    SCOPED_TRACE("The output is written where the argument was");
+    const std::string output = stopAndGetOutput();
+    ASSERT_NE(output.find("before 42 after\n"), std::string::npos);
+    ASSERT_NE(output.find("]first middle last\n"), std::string::npos);
+    ASSERT_EQ(calls, 1);
+    ASSERT_FALSE(ranOnCaller);
+}
+
+TEST(ModuleLevelConfigTest, ModuleLevelKeys) {
+    rk::config::Config& config = rk::config::getInstance();
+    ASSERT_TRUE(config.isKeyAndValueValid("level.net", "DEBUG"));
+    ASSERT_TRUE(config.isKeyAndValueValid("level.order_book.cpp", "OFF"));
+    ASSERT_FALSE(config.isKeyAndValueValid("level.net", "LOUD"));
+    ASSERT_FALSE(config.isKeyValid("level."));
+    ASSERT_FALSE(config.isKeyValid("level.a/b"));
+    ASSERT_FALSE(config.isKeyValid("levels.net"));
+
+    SCOPED_TRACE("A module level that isn't set has no value");
+    ASSERT_EQ(config.getConfigValueByKey("level.not_set"), "");
+}
+
+TEST_F(LevelFilterTest, ModuleLevelsFromConfig) {
+    Base::stopLogger();
+    logger.getConfig().setConfigValue(rk::config::log_level::KEY, "WARN");
+    logger.getConfig().setConfigValue("level.net", "DEBUG");
+    logger.getConfig().setConfigValue("level.db", "ERROR");
+    ASSERT_NO_FATAL_FAILURE(Base::startLogger(std::filesystem::path()));
+
+#undef RK_LOG_MODULE
+#define RK_LOG_MODULE "net"
+    RK_LOG_TO_AT(logger, rk::log::Level::Debug, "net debug\n");
+    RK_LOG_TO_AT(logger, rk::log::Level::Trace, "net trace\n");
+#undef RK_LOG_MODULE
+#define RK_LOG_MODULE "db"
+    RK_LOG_TO_AT(logger, rk::log::Level::Warn, "db warn\n");
+    RK_LOG_TO_AT(logger, rk::log::Level::Error, "db error\n");
+#undef RK_LOG_MODULE
+#define RK_LOG_MODULE nullptr
+    RK_LOG_TO(logger, "untagged info\n");
+    RK_LOG_TO_AT(logger, rk::log::Level::Warn, "untagged warn\n");
+
+    const std::string output = stopAndGetOutput();
+    ASSERT_NE(output.find("net debug"), std::string::npos);
+    ASSERT_EQ(output.find("net trace"), std::string::npos);
+    ASSERT_EQ(output.find("db warn"), std::string::npos);
+    ASSERT_NE(output.find("db error"), std::string::npos);
+    ASSERT_EQ(output.find("untagged info"), std::string::npos);
+    ASSERT_NE(output.find("untagged warn"), std::string::npos);
+}
+
+// Statements without a module tag are matched by the name of their file
+TEST_F(LevelFilterTest, FileLevel) {
+    logger.setModuleLevel("level_tests.cc", rk::log::Level::Error);
+    RK_LOG_TO_AT(logger, rk::log::Level::Warn, "file warn\n");
+    RK_LOG_TO_AT(logger, rk::log::Level::Error, "file error\n");
+
+    const std::string output = stopAndGetOutput();
+    ASSERT_EQ(output.find("file warn"), std::string::npos);
+    ASSERT_NE(output.find("file error"), std::string::npos);
+}
+
+// A call site caches its level, so it has to pick up every change to the levels
+TEST_F(LevelFilterTest, CachedLevelFollowsChanges) {
+    size_t evaluations = 0;
+    auto logFromOneCallSite = [this, &evaluations] () {
+#undef RK_LOG_MODULE
+#define RK_LOG_MODULE "cache"
+        RK_LOG_TO_AT(logger, rk::log::Level::Debug, "debug ", ++evaluations, "\n");
+#undef RK_LOG_MODULE
+#define RK_LOG_MODULE nullptr
+    };
+
+    logFromOneCallSite(); // Dropped at the default INFO level
+    logFromOneCallSite();
+    ASSERT_EQ(evaluations, 0);
+
+    logger.setModuleLevel("cache", rk::log::Level::Debug);
+    logFromOneCallSite();
+    ASSERT_EQ(evaluations, 1);
+
+    logger.setEnabled(false);
+    logFromOneCallSite();
+    ASSERT_EQ(evaluations, 1);
+
+    logger.setEnabled(true);
+    logger.setModuleLevel("cache", rk::log::Level::Off);
+    logFromOneCallSite();
+    ASSERT_EQ(evaluations, 1);
+
+    logger.setModuleLevel("cache", rk::log::Level::Trace);
+    logFromOneCallSite();
+    ASSERT_EQ(evaluations, 2);
+
+    SCOPED_TRACE("Starting again takes the module levels from the config");
+    Base::stopLogger();
+    ASSERT_NO_FATAL_FAILURE(Base::startLogger(std::filesystem::path()));
+    logFromOneCallSite();
+    ASSERT_EQ(evaluations, 2);
+}
+
+// A call site that logs to two loggers is only cached for the first, but the other one still applies its own levels
+TEST_F(LevelFilterTest, CallSiteSharedByLoggers) {
+    rk::log::Logger otherLogger("other");
+    otherLogger.setModuleLevel("shared", rk::log::Level::Trace);
+    size_t evaluations = 0;
+    auto logFromOneCallSite = [&evaluations] (rk::log::Logger& target) {
+#undef RK_LOG_MODULE
+#define RK_LOG_MODULE "shared"
+        RK_LOG_TO_AT(target, rk::log::Level::Debug, "debug ", ++evaluations, "\n");
+#undef RK_LOG_MODULE
+#define RK_LOG_MODULE nullptr
+    };
+
+    logFromOneCallSite(logger);
+    logFromOneCallSite(otherLogger);
+    logFromOneCallSite(logger);
+    logFromOneCallSite(otherLogger);
+    ASSERT_EQ(evaluations, 2);
+}
+
+} // namespace level_tests
+} // namespace rk_logger_tests
@@ -0,0 +1,51 @@
+#ifndef LEVEL_TESTS_H
+#define LEVEL_TESTS_H
+
+#include <rk_logger/logger.h>
+#include <rk_logger_tests/test_base.h>
+
+namespace rk_logger_tests {
+namespace level_tests {
+
+struct LevelNameTestParam : public BaseParam {
+    LevelNameTestParam(const std::string description, const rk::log::Level level, const std::string name)
+        : BaseParam(description), level(level), name(name) {};
+
+    const rk::log::Level level;
+    const std::string name;
+};
+
+class LevelNameTest : public ::testing::TestWithParam<LevelNameTestParam> {};
+
+class LevelFilterTest : public Base {
+protected:
+    void SetUp() override {
+        redirectStdCout();
+        logger.getConfig().setConfigValue(rk::config::write_to_log_file::KEY, rk::config::write_to_log_file::DISABLE);
+        logger.getConfig().setConfigValue(rk::config::write_to_console::KEY, rk::config::write_to_console::DISABLE);
+        logger.addSink(sink);
+        ASSERT_NO_FATAL_FAILURE(Base::startLogger(std::filesystem::path()));
+    }
+
+    void TearDown() override {
+        if (logThread.joinable()) {
+            Base::stopLogger();
+        }
+        undoRedirectStdCout();
+    }
+
+    /**
+     * @brief Stops the logger and gets everything that was written.
+     */
+    std::string stopAndGetOutput() {
+        Base::stopLogger();
+        return sink->str();
+    }
+
+    std::shared_ptr<StringSink> sink = std::make_shared<StringSink>();
+};
+
+} // namespace level_tests
+} // namespace rk_logger_tests
+
+#endif // #ifndef LEVEL_TESTS_H
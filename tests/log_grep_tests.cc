@@ -0,0 +1,144 @@
+#include <regex>
+
+#include "log_grep_tests.h"
+
+namespace rk_logger_tests {
+namespace log_grep_tests {
+
+TEST_F(LogGrepTest, ParsesPrefix) {
+    const rk::grep_internal::LogGrep logGrep(formatter, {});
+    const std::string line = makeLine(FEB_4_2025_20_30_UTC_NS + 5 * SECOND_NS, "140213445566778", "handleRequest", "Request [42] done");
+    rk::grep_internal::MessagePrefix prefix;
+    ASSERT_TRUE(logGrep.parsePrefix(line, prefix));
+    ASSERT_EQ(prefix.timeNs, FEB_4_2025_20_30_UTC_NS + 5 * SECOND_NS);
+    ASSERT_EQ(prefix.threadId, "140213445566778");
+    ASSERT_EQ(prefix.funcName, "handleRequest");
+    ASSERT_EQ(line.substr(prefix.size), "Request [42] done\n");
+
+    SCOPED_TRACE("Lines that don't start a message");
+    ASSERT_FALSE(logGrep.parsePrefix("second line of a message\n", prefix));
+    ASSERT_FALSE(logGrep.parsePrefix("[1][main]no timestamp\n", prefix));
+    ASSERT_FALSE(logGrep.parsePrefix(line.substr(0, line.find("[handleRequest]")) + "\n[handleRequest]message\n", prefix));
+}
+
+TEST_F(LogGrepTest, FindsMessageStart) {
+    const std::string first = makeLine(FEB_4_2025_20_30_UTC_NS, "1", "main", "first\ncontinued\n[not a timestamp]");
+    const std::string second = makeLine(FEB_4_2025_20_30_UTC_NS, "1", "main", "second");
+    const std::string log = first + second;
+    const rk::grep_internal::LogGrep logGrep(formatter, {});
+    ASSERT_EQ(logGrep.findMessageStart(log, 0), 0);
+    ASSERT_EQ(logGrep.findMessageStart(log, 1), first.size());
+    ASSERT_EQ(logGrep.findMessageStart(log, first.find("continued")), first.size());
+    ASSERT_EQ(logGrep.findMessageStart(log, first.size()), first.size());
+    ASSERT_EQ(logGrep.findMessageStart(log, first.size() + 1), log.size());
+}
+
+TEST_F(LogGrepTest, FiltersByTimeRange) {
+    std::string log;
+    for (int64_t second = 0; second < 10; second++) {
+        log += makeLine(FEB_4_2025_20_30_UTC_NS + second * SECOND_NS, "1", "main", "message " + std::to_string(second));
+    }
+    rk::grep_internal::GrepFilter filter;
+    filter.fromNs = FEB_4_2025_20_30_UTC_NS + 3 * SECOND_NS;
+    filter.toNs = FEB_4_2025_20_30_UTC_NS + 5 * SECOND_NS;
+    size_t matchCount = 0;
+    const std::string out = grep(log, filter, 1, rk::grep_internal::DEFAULT_CHUNK_SIZE, &matchCount);
+    ASSERT_EQ(matchCount, 3);
+    ASSERT_EQ(out, makeLine(filter.fromNs, "1", "main", "message 3") + makeLine(filter.fromNs + SECOND_NS, "1", "main", "message 4") +
+        makeLine(filter.toNs, "1", "main", "message 5"));
+}
+
+TEST_F(LogGrepTest, FiltersByThreadAndFunction) {
+    const std::string a = makeLine(FEB_4_2025_20_30_UTC_NS, "11", "read", "a");
+    const std::string b = makeLine(FEB_4_2025_20_30_UTC_NS, "22", "read", "b");
+    const std::string c = makeLine(FEB_4_2025_20_30_UTC_NS, "11", "write", "c");
+    const std::string log = a + b + c;
+
+    rk::grep_internal::GrepFilter filter;
+    filter.threadId = "11";
+    ASSERT_EQ(grep(log, filter), a + c);
+    filter.funcName = "write";
+    ASSERT_EQ(grep(log, filter), c);
+    filter.threadId.clear();
+    filter.funcName = "read";
+    ASSERT_EQ(grep(log, filter), a + b);
+
+    SCOPED_TRACE("Ids only match whole");
+    filter.funcName = "rea";
+    ASSERT_EQ(grep(log, filter), "");
+}
+
+TEST_F(LogGrepTest, FiltersByTextAndPatternAfterPrefix) {
+    const std::string timeout = makeLine(FEB_4_2025_20_30_UTC_NS, "1", "connect", "Timed out after 30 ms");
+    const std::string retry = makeLine(FEB_4_2025_20_30_UTC_NS, "1", "retry", "Retrying connect in 250 ms");
+    const std::string log = timeout + retry;
+
+    rk::grep_internal::GrepFilter filter;
+    filter.text = "connect";
+    ASSERT_EQ(grep(log, filter), retry);
+
+    filter.text.clear();
+    filter.pattern = std::make_shared<const std::regex>("[0-9]{3} ms");
+    ASSERT_EQ(grep(log, filter), retry);
+    filter.pattern = std::make_shared<const std::regex>("^Timed");
+    ASSERT_EQ(grep(log, filter), timeout);
+
+    SCOPED_TRACE("Every filter that is set has to match");
+    filter.text = "connect";
+    ASSERT_EQ(grep(log, filter), "");
+}
+
+TEST_F(LogGrepTest, KeepsLinesOfMessageTogether) {
+    const std::string multiLine = makeLine(FEB_4_2025_20_30_UTC_NS, "1", "dump", "state:\n  queue: 3\n  [status] idle");
+    const std::string other = makeLine(FEB_4_2025_20_30_UTC_NS, "2", "main", "idle");
+    const std::string log = multiLine + other;
+
+    rk::grep_internal::GrepFilter filter;
+    filter.text = "idle";
+    ASSERT_EQ(grep(log, filter), log);
+    filter.threadId = "1";
+    ASSERT_EQ(grep(log, filter), multiLine);
+}
+
+TEST_F(LogGrepTest, LinesBeforeFirstMessageOnlyMatchText) {
+    const std::string head = "end of a message from before the log rotated\n";
+    const std::string message = makeLine(FEB_4_2025_20_30_UTC_NS, "1", "main", "rotated");
+    const std::string log = head + message;
+
+    rk::grep_internal::GrepFilter filter;
+    filter.text = "rotated";
+    ASSERT_EQ(grep(log, filter), log);
+    filter.threadId = "1";
+    ASSERT_EQ(grep(log, filter), message);
+}
+
+TEST_F(LogGrepTest, ParallelOutputIsInOrder) {
+    std::string log;
+    for (int64_t i = 0; i < 2000; i++) {
+        const std::string message = i % 7 == 0 ? "multi\nline " + std::to_string(i) : "message " + std::to_string(i);
+        log += makeLine(FEB_4_2025_20_30_UTC_NS + i * SECOND_NS, std::to_string(i % 5), "main", message);
+    }
+    rk::grep_internal::GrepFilter filter;
+    filter.threadId = "3";
+    filter.toNs = FEB_4_2025_20_30_UTC_NS + 1500 * SECOND_NS;
+    size_t expectedCount = 0;
+    const std::string expected = grep(log, filter, 1, log.size(), &expectedCount);
+    ASSERT_EQ(expectedCount, 300);
+
+    for (const size_t threadCount : { 1, 2, 4, 8 }) {
+        for (const size_t chunkSize : { 1, 100, 4096 }) {
+            size_t matchCount = 0;
+            ASSERT_EQ(grep(log, filter, threadCount, chunkSize, &matchCount), expected) << threadCount << " threads, chunks of " << chunkSize;
+            ASSERT_EQ(matchCount, expectedCount);
+        }
+    }
+}
+
+TEST_F(LogGrepTest, EmptyLogHasNoMatches) {
+    size_t matchCount = 1;
+    ASSERT_EQ(grep("", {}, 4, rk::grep_internal::DEFAULT_CHUNK_SIZE, &matchCount), "");
+    ASSERT_EQ(matchCount, 0);
+}
+
+} // namespace log_grep_tests
+} // namespace rk_logger_tests
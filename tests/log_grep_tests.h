@@ -0,0 +1,61 @@
+#ifndef LOG_GREP_TESTS_H
+#define LOG_GREP_TESTS_H
+
+#include <memory>
+
+#include <rk_logger/log_grep.h>
+#include <rk_logger_tests/test_base.h>
+
+namespace rk_logger_tests {
+namespace log_grep_tests {
+
+constexpr int64_t FEB_4_2025_20_30_UTC_NS = 1738701000LL * 1000000000LL; // Feb 4, 2025 at 8:30PM UTC
+constexpr int64_t SECOND_NS = 1000000000;
+
+/**
+ * Searches logs with timestamps in UTC, so the times don't depend on the time zone of the machine.
+ */
+class LogGrepTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        coutBufOriginal = std::cout.rdbuf(logOutput.rdbuf());
+        config->setConfigValue(rk::config::time_zone::KEY, rk::config::time_zone::UTC);
+        formatter.updateTimeStampFuncs(*config);
+    }
+
+    void TearDown() override {
+        std::cout.rdbuf(coutBufOriginal);
+    }
+
+    /**
+     * @brief Formats a line the way the logger writes it.
+     */
+    std::string makeLine(const int64_t epochNs, const std::string& threadId, const std::string& funcName, const std::string& message) const {
+        const rk::time_internal::time_point time(std::chrono::duration_cast<rk::time_internal::system_clock::duration>(std::chrono::nanoseconds(epochNs)));
+        return formatter.generateTimeStamp(time) + "[" + threadId + "][" + funcName + "]" + message + "\n";
+    }
+
+    /**
+     * @brief Searches a whole log and returns the matching messages.
+     */
+    std::string grep(const std::string& log, const rk::grep_internal::GrepFilter& filter, const size_t threadCount = 1,
+        const size_t chunkSize = rk::grep_internal::DEFAULT_CHUNK_SIZE, size_t* matchCount = nullptr) const {
+        const rk::grep_internal::LogGrep logGrep(formatter, filter);
+        std::string out;
+        const size_t count = logGrep.grep(log, threadCount, [&out] (const std::string_view messages) { out.append(messages); }, chunkSize);
+        if (matchCount != nullptr) {
+            *matchCount = count;
+        }
+        return out;
+    }
+
+    std::unique_ptr<rk::config::Config> config = rk::config::createInstance();
+    rk::time_internal::TimeStampFormatter formatter;
+    std::streambuf* coutBufOriginal;
+    std::stringstream logOutput;
+};
+
+} // namespace log_grep_tests
+} // namespace rk_logger_tests
+
+#endif // #ifndef LOG_GREP_TESTS_H
@@ -0,0 +1,288 @@
+#include <thread>
+
+#include <rk_logger/time_zone.h>
+
+#include "log_index_tests.h"
+
+namespace rk_logger_tests {
+namespace log_index_tests {
+
+namespace {
+
+constexpr int64_t OCT_19_2026_10_42_UTC_NS = 1792406520000000000;
+const uint64_t THREAD_A_BIT = rk::index_internal::getThreadBit("140213445566778");
+const uint64_t THREAD_B_BIT = rk::index_internal::getThreadBit("140213445566779");
+
+/**
+ * Three entries of 100 bytes each, with 50 bytes after them that aren't indexed yet. Thread B only logged in the
+ * second one.
+ */
+const std::vector<rk::index_internal::IndexEntry> ENTRIES = {
+    makeEntry(100, 0, 10, THREAD_A_BIT),
+    makeEntry(200, 20, 30, THREAD_B_BIT),
+    makeEntry(300, 40, 50, THREAD_A_BIT),
+};
+constexpr uint64_t LOG_SIZE = 350;
+
+std::vector<rk::index_internal::ByteRange> findRanges(const int64_t fromNs, const int64_t toNs, const uint64_t threadBit = 0, const uint64_t logSize = LOG_SIZE) {
+    return rk::index_internal::findRanges(ENTRIES.data(), ENTRIES.size(), logSize, fromNs, toNs, threadBit);
+}
+
+void expectRanges(const std::vector<rk::index_internal::ByteRange>& ranges, const std::vector<std::pair<uint64_t, uint64_t>>& expected) {
+    ASSERT_EQ(ranges.size(), expected.size());
+    for (size_t i = 0; i < ranges.size(); i++) {
+        EXPECT_EQ(ranges[i].begin, expected[i].first) << "Range " << i;
+        EXPECT_EQ(ranges[i].end, expected[i].second) << "Range " << i;
+    }
+}
+
+std::string getText(const std::string& log, const std::vector<rk::index_internal::ByteRange>& ranges) {
+    std::string text;
+    for (const auto& range : ranges) {
+        text.append(log, range.begin, range.end - range.begin);
+    }
+    return text;
+}
+
+} // namespace
+
+TEST_F(LogIndexTest, FindsEntriesThatOverlapRange) {
+    SCOPED_TRACE("Starts at the entry that reaches the start, and skips the entries that start after the end");
+    expectRanges(findRanges(25, 45), { { 100, 300 } });
+    expectRanges(findRanges(0, 5), { { 0, 100 } });
+}
+
+// A shard that fell behind wrote older messages after newer ones, so an entry can start before the one in front of it
+TEST_F(LogIndexTest, FindsEntriesAfterOneThatStartsAfterRange) {
+    const std::vector<rk::index_internal::IndexEntry> entries = {
+        makeEntry(100, 0, 10, THREAD_A_BIT),
+        makeEntry(200, 40, 50, THREAD_A_BIT),
+        makeEntry(300, 15, 50, THREAD_B_BIT),
+        makeEntry(400, 60, 70, THREAD_A_BIT),
+    };
+    const auto findLaggingRanges = [&entries] (const int64_t fromNs, const int64_t toNs, const uint64_t threadBit) {
+        return rk::index_internal::findRanges(entries.data(), entries.size(), 400, fromNs, toNs, threadBit);
+    };
+    expectRanges(findLaggingRanges(5, 20, 0), { { 0, 100 }, { 200, 300 } });
+    expectRanges(findLaggingRanges(12, 20, THREAD_B_BIT), { { 200, 300 } });
+    expectRanges(findLaggingRanges(12, 20, THREAD_A_BIT), {});
+}
+
+TEST_F(LogIndexTest, WholeRangeIsWholeFile) {
+    expectRanges(findRanges(INT64_MIN, INT64_MAX), { { 0, LOG_SIZE } });
+}
+
+TEST_F(LogIndexTest, RangeAfterIndexIsUnindexedTail) {
+    expectRanges(findRanges(60, 70), { { 300, LOG_SIZE } });
+}
+
+TEST_F(LogIndexTest, SkipsEntriesWithoutThread) {
+    expectRanges(findRanges(INT64_MIN, INT64_MAX, THREAD_A_BIT), { { 0, 100 }, { 200, LOG_SIZE } });
+    expectRanges(findRanges(INT64_MIN, 45, THREAD_B_BIT), { { 100, 200 } });
+}
+
+TEST_F(LogIndexTest, CutsOffEntriesPastEndOfLog) {
+    SCOPED_TRACE("E.g., the index was flushed but the log wasn't");
+    expectRanges(findRanges(INT64_MIN, INT64_MAX, 0, 250), { { 0, 250 } });
+}
+
+TEST_F(LogIndexTest, EmptyIndexIsWholeFile) {
+    const auto ranges = rk::index_internal::findRanges(nullptr, 0, LOG_SIZE, 0, 100, 0);
+    expectRanges(ranges, { { 0, LOG_SIZE } });
+}
+
+TEST_F(LogIndexTest, RejectsFilesThatArentIndexes) {
+    const rk::index_internal::IndexEntry* entries = nullptr;
+    size_t count = 0;
+    const std::string notIndex = "[10/19/2026|10:42:00.000 AM][1][main]message\n";
+    ASSERT_FALSE(rk::index_internal::readIndex(notIndex.data(), notIndex.size(), entries, count));
+    ASSERT_FALSE(rk::index_internal::readIndex(notIndex.data(), 4, entries, count));
+}
+
+TEST_F(LogIndexTest, GetsThreadIdOfLine) {
+    ASSERT_EQ(rk::index_internal::getLineThreadId("[10/19/2026|10:42:00.000 AM][140213445566778][main]message\n"), "140213445566778");
+    ASSERT_EQ(rk::index_internal::getLineThreadId("[1792406520000000000][7][main]message\n"), "7");
+
+    SCOPED_TRACE("Lines that don't start a message");
+    ASSERT_EQ(rk::index_internal::getLineThreadId("second line of a message\n"), "");
+    ASSERT_EQ(rk::index_internal::getLineThreadId("[not a message]\n"), "");
+    ASSERT_EQ(rk::index_internal::getLineThreadId("[time][unfinished\n"), "");
+    ASSERT_EQ(rk::index_internal::getLineThreadId(""), "");
+}
+
+TEST_F(LogIndexTest, ParsesQueryTimes) {
+    int64_t timeNs = 0;
+    ASSERT_TRUE(rk::index_internal::parseQueryTime("1792406520000000000", timeNs));
+    ASSERT_EQ(timeNs, OCT_19_2026_10_42_UTC_NS);
+    ASSERT_TRUE(rk::index_internal::parseQueryTime("2026-10-19T10:42:00Z", timeNs));
+    ASSERT_EQ(timeNs, OCT_19_2026_10_42_UTC_NS);
+    ASSERT_TRUE(rk::index_internal::parseQueryTime("2026-10-19 10:42Z", timeNs));
+    ASSERT_EQ(timeNs, OCT_19_2026_10_42_UTC_NS);
+    ASSERT_TRUE(rk::index_internal::parseQueryTime("2026-10-19 10:42:05.25Z", timeNs));
+    ASSERT_EQ(timeNs, OCT_19_2026_10_42_UTC_NS + 5250000000);
+    ASSERT_TRUE(rk::index_internal::parseQueryTime("2026-10-19 10:42:05.123456789Z", timeNs));
+    ASSERT_EQ(timeNs, OCT_19_2026_10_42_UTC_NS + 5123456789);
+}
+
+TEST_F(LogIndexTest, ParsesLocalQueryTimes) {
+    int64_t timeNs = 0;
+    ASSERT_TRUE(rk::index_internal::parseQueryTime("2026-10-19 10:42:00", timeNs));
+    const int64_t seconds = timeNs / 1000000000;
+    const rk::time_internal::CivilTime local = rk::time_internal::toCivilTime(seconds + rk::time_internal::computeUtcOffset(seconds));
+    ASSERT_EQ(local.year, 2026);
+    ASSERT_EQ(local.month, 10);
+    ASSERT_EQ(local.day, 19);
+    ASSERT_EQ(local.hour, 10);
+    ASSERT_EQ(local.minute, 42);
+    ASSERT_EQ(local.second, 0);
+}
+
+TEST_F(LogIndexTest, RejectsInvalidQueryTimes) {
+    int64_t timeNs = 0;
+    for (const char* time : { "", "yesterday", "2026-10-19", "2026-10-19 10", "2026-02-30 10:42Z", "2026-10-19 24:00Z",
+        "2026-10-19 10:60Z", "2026-10-19 10:42:00.Z", "2026-10-19 10:42:00 PM", "99999999999999999999", "-5" }) {
+        ASSERT_FALSE(rk::index_internal::parseQueryTime(time, timeNs)) << time;
+    }
+}
+
+TEST_F(IndexedFileSinkTest, WritesEntryEveryRecordInterval) {
+    const std::vector<std::pair<int64_t, std::string>> messages = {
+        { 10, "140213445566778" }, { 30, "140213445566778" }, { 20, "140213445566779" }, { 40, "140213445566778" }, { 50, "140213445566778" },
+    };
+    std::vector<uint64_t> lineEnds;
+    {
+        rk::log::FileSink sink(path, 2, 1024 * 1024);
+        ASSERT_TRUE(sink.isOpen());
+        uint64_t size = 0;
+        for (const auto& message : messages) {
+            const std::string line = "[" + std::to_string(message.first) + "][" + message.second + "][main]message\n";
+            rk::log::MessageInfo info;
+            info.timeNs = message.first;
+            info.threadId = message.second;
+            sink.writeWithInfo(line, info);
+            size += line.size();
+            lineEnds.push_back(size);
+        }
+        sink.sync();
+    }
+
+    const std::vector<rk::index_internal::IndexEntry> entries = readEntries(path.string() + rk::index_internal::INDEX_FILE_SUFFIX);
+    ASSERT_EQ(entries.size(), 3);
+    EXPECT_EQ(entries[0].endOffset, lineEnds[1]);
+    EXPECT_EQ(entries[0].minTimeNs, 10);
+    EXPECT_EQ(entries[0].maxTimeNs, 30);
+    EXPECT_EQ(entries[0].threadMask, THREAD_A_BIT);
+    EXPECT_EQ(entries[1].endOffset, lineEnds[3]);
+    EXPECT_EQ(entries[1].minTimeNs, 20);
+    EXPECT_EQ(entries[1].maxTimeNs, 40);
+    EXPECT_EQ(entries[1].threadMask, THREAD_A_BIT | THREAD_B_BIT);
+    SCOPED_TRACE("The last entry is written by sync()");
+    EXPECT_EQ(entries[2].endOffset, lineEnds[4]);
+    EXPECT_EQ(entries[2].minTimeNs, 50);
+    EXPECT_EQ(entries[2].maxTimeNs, 50);
+    EXPECT_EQ(readFile(path).size(), lineEnds[4]);
+}
+
+TEST_F(IndexedFileSinkTest, WritesEntryEveryByteInterval) {
+    constexpr size_t BYTE_INTERVAL = 100;
+    const std::string line(40, 'x');
+    {
+        rk::log::FileSink sink(path, 1000, BYTE_INTERVAL);
+        for (int i = 0; i < 10; i++) {
+            sink.writeWithInfo(line, rk::log::MessageInfo());
+        }
+    }
+
+    SCOPED_TRACE("An entry ends with the message that reaches the interval, and the destructor writes the last one");
+    const std::vector<rk::index_internal::IndexEntry> entries = readEntries(path.string() + rk::index_internal::INDEX_FILE_SUFFIX);
+    ASSERT_EQ(entries.size(), 4);
+    EXPECT_EQ(entries[0].endOffset, 120);
+    EXPECT_EQ(entries[1].endOffset, 240);
+    EXPECT_EQ(entries[2].endOffset, 360);
+    EXPECT_EQ(entries[3].endOffset, 400);
+}
+
+TEST_F(IndexedFileSinkTest, CreatesSinkFromConfig) {
+    {
+        std::shared_ptr<rk::log::Sink> sink = rk::log::createLogFileSink(path, logger.getConfig());
+        ASSERT_TRUE(sink);
+        sink->writeWithInfo("message\n", rk::log::MessageInfo());
+    }
+    ASSERT_TRUE(std::filesystem::exists(path.string() + rk::index_internal::INDEX_FILE_SUFFIX));
+    ASSERT_EQ(readEntries(path.string() + rk::index_internal::INDEX_FILE_SUFFIX).size(), 1);
+}
+
+TEST_F(IndexedFileSinkTest, LoggerWritesIndex) {
+    constexpr int MESSAGE_COUNT = 100;
+    logger.getConfig().setConfigValue(rk::config::log_file_index_records::KEY, "10");
+    logger.startOwned(std::filesystem::path());
+    for (int i = 0; i < MESSAGE_COUNT; i++) {
+        RK_LOG_TO(logger, "message ", i, "\n");
+    }
+    logger.stop();
+
+    const std::vector<std::filesystem::path> logFiles = findLogFiles();
+    ASSERT_EQ(logFiles.size(), 1);
+    const std::string log = readFile(logFiles[0]);
+    const std::vector<rk::index_internal::IndexEntry> entries = readEntries(logFiles[0].string() + rk::index_internal::INDEX_FILE_SUFFIX);
+    ASSERT_GE(entries.size(), MESSAGE_COUNT / 10);
+    ASSERT_EQ(entries.back().endOffset, log.size());
+
+    SCOPED_TRACE("Every entry ends at the end of a message and knows the thread that logged it");
+    std::ostringstream threadId;
+    threadId << std::this_thread::get_id();
+    for (const auto& entry : entries) {
+        ASSERT_EQ(log[entry.endOffset - 1], '\n');
+        ASSERT_NE(entry.threadMask & rk::index_internal::getThreadBit(threadId.str()), 0);
+        ASSERT_LE(entry.minTimeNs, entry.maxTimeNs);
+    }
+}
+
+TEST_F(IndexedFileSinkTest, FindsMessagesOfTimeRange) {
+    constexpr int MESSAGE_COUNT = 20;
+    constexpr std::chrono::milliseconds GAP(20);
+    logger.getConfig().setConfigValue(rk::config::log_file_index_records::KEY, "1");
+    logger.startOwned(std::filesystem::path());
+    for (int i = 0; i < MESSAGE_COUNT; i++) {
+        RK_LOG_TO(logger, "before ", i, "\n");
+    }
+    std::this_thread::sleep_for(GAP);
+    const int64_t middleNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    std::this_thread::sleep_for(GAP);
+    for (int i = 0; i < MESSAGE_COUNT; i++) {
+        RK_LOG_TO(logger, "after ", i, "\n");
+    }
+    logger.stop();
+
+    const std::vector<std::filesystem::path> logFiles = findLogFiles();
+    ASSERT_EQ(logFiles.size(), 1);
+    const std::string log = readFile(logFiles[0]);
+    const std::vector<rk::index_internal::IndexEntry> entries = readEntries(logFiles[0].string() + rk::index_internal::INDEX_FILE_SUFFIX);
+
+    const std::string after = getText(log, rk::index_internal::findRanges(entries.data(), entries.size(), log.size(), middleNs, INT64_MAX, 0));
+    const std::string before = getText(log, rk::index_internal::findRanges(entries.data(), entries.size(), log.size(), INT64_MIN, middleNs, 0));
+    for (int i = 0; i < MESSAGE_COUNT; i++) {
+        ASSERT_NE(after.find("]after " + std::to_string(i) + "\n"), std::string::npos);
+        ASSERT_EQ(after.find("]before " + std::to_string(i) + "\n"), std::string::npos);
+        ASSERT_NE(before.find("]before " + std::to_string(i) + "\n"), std::string::npos);
+        ASSERT_EQ(before.find("]after " + std::to_string(i) + "\n"), std::string::npos);
+    }
+}
+
+TEST_F(IndexedFileSinkTest, CompressedLogFileIsNotIndexed) {
+    logger.getConfig().setConfigValue(rk::config::log_file_compression::KEY, rk::config::log_file_compression::LZ4);
+    logger.startOwned(std::filesystem::path());
+    RK_LOG_TO(logger, "message\n");
+    logger.stop();
+
+    for (const auto& entry : std::filesystem::directory_iterator(std::filesystem::current_path())) {
+        const std::string fileName = entry.path().filename().string();
+        if (fileName.rfind(LOG_FILE_PREFIX, 0) == 0) {
+            ASSERT_EQ(fileName.find(rk::index_internal::INDEX_FILE_SUFFIX), std::string::npos);
+            std::filesystem::remove(entry.path());
+        }
+    }
+}
+
+} // namespace log_index_tests
+} // namespace rk_logger_tests
@@ -0,0 +1,108 @@
+#ifndef LOG_INDEX_TESTS_H
+#define LOG_INDEX_TESTS_H
+
+#include <fstream>
+
+#include <rk_logger/log_index.h>
+#include <rk_logger/sink.h>
+#include <rk_logger_tests/test_base.h>
+
+namespace rk_logger_tests {
+namespace log_index_tests {
+
+inline const std::string LOG_FILE_PREFIX = "logs_" + TEST_LOGGER_NAME + "_";
+inline const std::string LOG_FILE_SUFFIX = ".txt";
+
+inline std::string readFile(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+/**
+ * @brief Reads the entries of an index file.
+ */
+inline std::vector<rk::index_internal::IndexEntry> readEntries(const std::filesystem::path& path) {
+    const std::string contents = readFile(path);
+    const rk::index_internal::IndexEntry* entries = nullptr;
+    size_t count = 0;
+    if (!rk::index_internal::readIndex(contents.data(), contents.size(), entries, count)) {
+        return {};
+    }
+    return std::vector<rk::index_internal::IndexEntry>(entries, entries + count);
+}
+
+inline rk::index_internal::IndexEntry makeEntry(const uint64_t endOffset, const int64_t minTimeNs, const int64_t maxTimeNs, const uint64_t threadMask) {
+    rk::index_internal::IndexEntry entry;
+    entry.endOffset = endOffset;
+    entry.minTimeNs = minTimeNs;
+    entry.maxTimeNs = maxTimeNs;
+    entry.threadMask = threadMask;
+    return entry;
+}
+
+class LogIndexTest : public ::testing::Test {};
+
+/**
+ * Writes indexed log files to a temporary directory, or through a logger to a working directory of the test's own.
+ */
+class IndexedFileSinkTest : public Base {
+protected:
+    void SetUp() override {
+        redirectStdCout();
+        // The logger writes to the working directory, so each test gets one of its own, where tests that run in
+        // parallel in other processes can't see or remove its log files
+        originalDirectory = std::filesystem::current_path();
+        logDirectory = std::filesystem::temp_directory_path()/("rk_IndexedFileSinkTest_" +
+            std::string(::testing::UnitTest::GetInstance()->current_test_info()->name()));
+        std::filesystem::create_directories(logDirectory);
+        std::filesystem::current_path(logDirectory);
+        removeLogFiles();
+        removeFiles(path);
+        logger.getConfig().setConfigValue(rk::config::write_to_console::KEY, rk::config::write_to_console::DISABLE);
+        logger.getConfig().setConfigValue(rk::config::write_to_log_file::KEY, rk::config::write_to_log_file::ENABLE);
+        logger.getConfig().setConfigValue(rk::config::log_file_index::KEY, rk::config::log_file_index::ENABLE);
+    }
+
+    void TearDown() override {
+        logger.stop();
+        undoRedirectStdCout();
+        removeFiles(path);
+        std::filesystem::current_path(originalDirectory);
+        std::filesystem::remove_all(logDirectory);
+    }
+
+    /**
+     * @brief Finds the log files of the test logger, without their indexes.
+     */
+    static std::vector<std::filesystem::path> findLogFiles() {
+        std::vector<std::filesystem::path> paths;
+        for (const auto& entry : std::filesystem::directory_iterator(std::filesystem::current_path())) {
+            const std::string fileName = entry.path().filename().string();
+            if (fileName.rfind(LOG_FILE_PREFIX, 0) == 0 && fileName.size() > LOG_FILE_SUFFIX.size() &&
+                fileName.compare(fileName.size() - LOG_FILE_SUFFIX.size(), LOG_FILE_SUFFIX.size(), LOG_FILE_SUFFIX) == 0) {
+                paths.push_back(entry.path());
+            }
+        }
+        return paths;
+    }
+
+    static void removeFiles(const std::filesystem::path& logFile) {
+        std::filesystem::remove(logFile);
+        std::filesystem::remove(logFile.string() + rk::index_internal::INDEX_FILE_SUFFIX);
+    }
+
+    static void removeLogFiles() {
+        for (const auto& logFile : findLogFiles()) {
+            removeFiles(logFile);
+        }
+    }
+
+    const std::filesystem::path path = std::filesystem::temp_directory_path()/("rk_index_test_" + std::string(::testing::UnitTest::GetInstance()->current_test_info()->name()) + LOG_FILE_SUFFIX);
+    std::filesystem::path originalDirectory;
+    std::filesystem::path logDirectory;
+};
+
+} // namespace log_index_tests
+} // namespace rk_logger_tests
+
+#endif // #ifndef LOG_INDEX_TESTS_H
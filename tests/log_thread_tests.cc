@@ -0,0 +1,94 @@
+#include <rk_logger/log_thread.h>
+#include "log_thread_tests.h"
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace rk_logger_tests {
+namespace log_thread_tests {
+
+TEST_P(CpuListTest, ParseCpuList) {
+    auto param = GetParam();
+    std::vector<int> cpus;
+    SCOPED_TRACE("Parsing the CPU list");
+    ASSERT_EQ(rk::config_internal::parseCpuList(param.value, cpus), param.isValid);
+    if (param.isValid) {
+        ASSERT_EQ(cpus, param.cpus);
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(CpuListTest,
+    CpuListTest,
+    testing::Values(
+        CpuListTestParam("single_cpu", "3", true, { 3 }),
+        CpuListTestParam("multiple_cpus", "0,2", true, { 0, 2 }),
+        CpuListTestParam("range", "2-4", true, { 2, 3, 4 }),
+        CpuListTestParam("cpus_and_ranges", "0,2-3,7", true, { 0, 2, 3, 7 }),
+        CpuListTestParam("empty", "", false, {}),
+        CpuListTestParam("trailing_comma", "1,", false, {}),
+        CpuListTestParam("leading_comma", ",1", false, {}),
+        CpuListTestParam("reversed_range", "3-1", false, {}),
+        CpuListTestParam("negative_cpu", "-1", false, {}),
+        CpuListTestParam("with_spaces", "1, 2", false, {}),
+        CpuListTestParam("not_a_number", "NONE", false, {})
+    ),
+    [](const testing::TestParamInfo<CpuListTestParam>& info) {
+        return info.param.description;
+    }
+);
+
+TEST_F(ApplyThreadSettingsTest, DefaultSettingsDoNothing) {
+    rk::thread_internal::ThreadSettings settings;
+    settings.schedPolicy = rk::config::log_thread_sched_policy::DEFAULT;
+
+    SCOPED_TRACE("Applying default settings");
+    std::thread thread([&settings] () {
+        rk::thread_internal::applyThreadSettings(settings);
+    });
+    thread.join();
+    ASSERT_TRUE(logOutput.str().empty());
+}
+
+#if defined(__linux__)
+TEST_F(ApplyThreadSettingsTest, NameAndAffinityAreApplied) {
+    SCOPED_TRACE("Picking a CPU that this process is allowed to run on");
+    cpu_set_t allowedCpus;
+    CPU_ZERO(&allowedCpus);
+    ASSERT_EQ(pthread_getaffinity_np(pthread_self(), sizeof(allowedCpus), &allowedCpus), 0);
+    int allowedCpu = 0;
+    while (!CPU_ISSET(allowedCpu, &allowedCpus)) {
+        allowedCpu++;
+    }
+
+    rk::thread_internal::ThreadSettings settings;
+    settings.name = "rk_test";
+    settings.cpus = { allowedCpu };
+    settings.schedPolicy = rk::config::log_thread_sched_policy::DEFAULT;
+
+    std::string name;
+    bool isPinnedToAllowedCpu = false;
+    int cpuCount = 0;
+    SCOPED_TRACE("Applying settings from a new thread");
+    std::thread thread([&] () {
+        rk::thread_internal::applyThreadSettings(settings, "_1");
+        char buffer[16] = {};
+        pthread_getname_np(pthread_self(), buffer, sizeof(buffer));
+        name = buffer;
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        pthread_getaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+        isPinnedToAllowedCpu = CPU_ISSET(allowedCpu, &cpuSet);
+        cpuCount = CPU_COUNT(&cpuSet);
+    });
+    thread.join();
+
+    ASSERT_EQ(name, "rk_test_1");
+    ASSERT_TRUE(isPinnedToAllowedCpu);
+    ASSERT_EQ(cpuCount, 1);
+}
+#endif // #if defined(__linux__)
+
+} // namespace log_thread_tests
+} // namespace rk_logger_tests
@@ -0,0 +1,35 @@
+#ifndef LOG_THREAD_TESTS_H
+#define LOG_THREAD_TESTS_H
+
+#include <rk_logger/log_thread.h>
+#include <rk_logger_tests/test_base.h>
+
+namespace rk_logger_tests {
+namespace log_thread_tests {
+
+struct CpuListTestParam : public rk_logger_tests::BaseParam {
+    CpuListTestParam(const std::string description, const rk::config::ConfigValue value, const bool isValid, const std::vector<int> cpus)
+        : BaseParam(description), value(value), isValid(isValid), cpus(cpus) {};
+
+    const rk::config::ConfigValue value;
+    const bool isValid;
+    const std::vector<int> cpus;
+};
+
+class CpuListTest : public ::testing::TestWithParam<CpuListTestParam> {};
+
+class ApplyThreadSettingsTest : public Base {
+protected:
+    void SetUp() override {
+        redirectStdCout();
+    }
+
+    void TearDown() override {
+        undoRedirectStdCout();
+    }
+};
+
+} // namespace log_thread_tests
+} // namespace rk_logger_tests
+
+#endif // #ifndef LOG_THREAD_TESTS_H
@@ -0,0 +1,236 @@
+#include <vector>
+
+#include <rk_logger/log_time.h>
+#include "log_time_tests.h"
+
+namespace rk_logger_tests {
+namespace log_time_tests {
+
+namespace {
+
+constexpr int64_t FEB_4_2025_20_30_UTC_NS = 1738701000LL * 1000000000LL; // Feb 4, 2025 at 8:30PM UTC
+constexpr int64_t FRACTION_NS = 123456789;
+constexpr int64_t HOUR_NS = 3600LL * 1000000000LL;
+constexpr int64_t DST_START_2025 = 1741503600; // Mar 9, 2025 at 2:00AM EST, i.e., 7:00AM UTC
+constexpr int64_t DST_END_2025 = 1762063200; // Nov 2, 2025 at 2:00AM EDT, i.e., 6:00AM UTC
+constexpr int64_t EST_OFFSET = -5 * 3600;
+constexpr int64_t EDT_OFFSET = -4 * 3600;
+
+std::string formatLocal(rk::time_internal::TimeStampFormatter& formatter, const int64_t epochSeconds) {
+    return formatter.generateTimeStamp(rk::time_internal::system_clock::from_time_t(static_cast<std::time_t>(epochSeconds)));
+}
+
+} // namespace
+
+TEST_P(TimeStampTest, GenerateTimeStamp) {
+    auto param = GetParam();
+    std::unique_ptr<rk::config::Config> config = rk::config::createInstance();
+    config->setConfigValue(rk::config::date_format::KEY, param.dateFormat);
+    config->setConfigValue(rk::config::month_format::KEY, param.monthFormat);
+    config->setConfigValue(rk::config::hour_format::KEY, param.hourFormat);
+    config->setConfigValue(rk::config::timestamp_precision::KEY, param.precision);
+    rk::time_internal::TimeStampFormatter formatter;
+    formatter.updateTimeStampFuncs(*config);
+
+    const rk::time_internal::time_point time(std::chrono::duration_cast<rk::time_internal::system_clock::duration>(std::chrono::nanoseconds(param.epochNs)));
+    ASSERT_EQ(formatter.generateTimeStamp(time), param.expected);
+
+    SCOPED_TRACE("Appending gives the same timestamp after what is already in the string");
+    std::string out = "prefix";
+    formatter.appendTimeStamp(time, out);
+    ASSERT_EQ(out, "prefix" + param.expected);
+}
+
+INSTANTIATE_TEST_SUITE_P(TimeStampTest,
+    TimeStampTest,
+    testing::Values(
+        TimeStampTestParam("default_format", rk::config::date_format::MM_DD_YYYY, rk::config::month_format::MONTH_NUM, rk::config::hour_format::TWELVE_HOUR,
+            rk::config::timestamp_precision::MS, FEB_4_2025_20_30_UTC_NS + FRACTION_NS, "[02-04-2025|08:30:00.123 PM]"),
+        TimeStampTestParam("microseconds", rk::config::date_format::DD_MM_YYYY, rk::config::month_format::MONTH_NAME, rk::config::hour_format::TWENTY_FOUR_HOUR,
+            rk::config::timestamp_precision::US, FEB_4_2025_20_30_UTC_NS + FRACTION_NS, "[04-Feb-2025|20:30:00.123456]"),
+        TimeStampTestParam("nanoseconds", rk::config::date_format::YYYY_MM_DD, rk::config::month_format::MONTH_NUM, rk::config::hour_format::TWENTY_FOUR_HOUR,
+            rk::config::timestamp_precision::NS, FEB_4_2025_20_30_UTC_NS + FRACTION_NS, "[2025-02-04|20:30:00.123456789]"),
+        TimeStampTestParam("nanoseconds_leading_zeros", rk::config::date_format::YYYY_MM_DD, rk::config::month_format::MONTH_NUM, rk::config::hour_format::TWENTY_FOUR_HOUR,
+            rk::config::timestamp_precision::NS, FEB_4_2025_20_30_UTC_NS + 1000, "[2025-02-04|20:30:00.000001000]"),
+        TimeStampTestParam("epoch_nanoseconds", rk::config::date_format::MM_DD_YYYY, rk::config::month_format::MONTH_NUM, rk::config::hour_format::TWELVE_HOUR,
+            rk::config::timestamp_precision::EPOCH_NS, FEB_4_2025_20_30_UTC_NS + FRACTION_NS, "[1738701000123456789]"),
+        TimeStampTestParam("twelve_hour_noon", rk::config::date_format::MM_DD_YYYY, rk::config::month_format::MONTH_NUM, rk::config::hour_format::TWELVE_HOUR,
+            rk::config::timestamp_precision::MS, FEB_4_2025_20_30_UTC_NS - 8 * HOUR_NS, "[02-04-2025|12:30:00.000 PM]"),
+        TimeStampTestParam("twelve_hour_midnight", rk::config::date_format::MM_DD_YYYY, rk::config::month_format::MONTH_NUM, rk::config::hour_format::TWELVE_HOUR,
+            rk::config::timestamp_precision::MS, FEB_4_2025_20_30_UTC_NS - 20 * HOUR_NS, "[02-04-2025|00:30:00.000 AM]")
+    ),
+    [](const testing::TestParamInfo<TimeStampTestParam>& info) {
+        return info.param.description;
+    }
+);
+
+TEST(ConvertTimeStampForFileNameTest, RemovesCharactersNotAllowedInFileNames) {
+    ASSERT_EQ(rk::time_internal::convertTimeStampForFileName("[02-04-2025|08:30:00.123456 PM]"), "02-04-2025_08-30-00.123456PM");
+    ASSERT_EQ(rk::time_internal::convertTimeStampForFileName("[1738701000123456789]"), "1738701000123456789");
+}
+
+TEST(PadWithZerosTest, PadsToTargetSize) {
+    auto pad = [] (std::string number, const int targetSize) {
+        rk::time_internal::padWithZeros(number, targetSize);
+        return number;
+    };
+    ASSERT_EQ(pad("7", 3), "007");
+    ASSERT_EQ(pad("123", 3), "123");
+    ASSERT_EQ(pad("12345", 3), "12345");
+    ASSERT_EQ(pad("", 3), "");
+}
+
+TEST(CivilTimeTest, BreaksDownSecondsSinceEpoch) {
+    auto check = [] (const int64_t seconds, const int year, const int month, const int day, const int hour, const int minute, const int second) {
+        const rk::time_internal::CivilTime civil = rk::time_internal::toCivilTime(seconds);
+        ASSERT_EQ(civil.year, year);
+        ASSERT_EQ(civil.month, month);
+        ASSERT_EQ(civil.day, day);
+        ASSERT_EQ(civil.hour, hour);
+        ASSERT_EQ(civil.minute, minute);
+        ASSERT_EQ(civil.second, second);
+    };
+    check(0, 1970, 1, 1, 0, 0, 0);
+    check(-1, 1969, 12, 31, 23, 59, 59);
+    check(951782400, 2000, 2, 29, 0, 0, 0); // Leap day in a year divisible by 400
+    check(4107542400, 2100, 3, 1, 0, 0, 0); // 2100 isn't a leap year
+    check(FEB_4_2025_20_30_UTC_NS / 1000000000, 2025, 2, 4, 20, 30, 0);
+}
+
+TEST_P(DstBoundaryTest, OffsetAndTimeStampAroundTransition) {
+    auto param = GetParam();
+    SCOPED_TRACE("Checking the uncached offset");
+    ASSERT_EQ(rk::time_internal::computeUtcOffset(param.epochSeconds), param.offsetSeconds);
+
+    SCOPED_TRACE("Checking the cached offset");
+    rk::time_internal::TimeZoneCache cache;
+    ASSERT_EQ(cache.getOffsetSeconds(param.epochSeconds), param.offsetSeconds);
+
+    SCOPED_TRACE("Checking the timestamp");
+    std::unique_ptr<rk::config::Config> config = rk::config::createInstance();
+    rk::time_internal::TimeStampFormatter formatter;
+    formatter.updateTimeStampFuncs(*config);
+    ASSERT_EQ(formatLocal(formatter, param.epochSeconds), param.expected);
+}
+
+INSTANTIATE_TEST_SUITE_P(DstBoundaryTest,
+    DstBoundaryTest,
+    testing::Values(
+        DstBoundaryTestParam("before_dst_start", DST_START_2025 - 1, EST_OFFSET, "[03-09-2025|01:59:59.000 AM]"),
+        DstBoundaryTestParam("at_dst_start", DST_START_2025, EDT_OFFSET, "[03-09-2025|03:00:00.000 AM]"),
+        DstBoundaryTestParam("before_dst_end", DST_END_2025 - 1, EDT_OFFSET, "[11-02-2025|01:59:59.000 AM]"),
+        DstBoundaryTestParam("at_dst_end", DST_END_2025, EST_OFFSET, "[11-02-2025|01:00:00.000 AM]"),
+        DstBoundaryTestParam("winter", FEB_4_2025_20_30_UTC_NS / 1000000000, EST_OFFSET, "[02-04-2025|03:30:00.000 PM]")
+    ),
+    [](const testing::TestParamInfo<DstBoundaryTestParam>& info) {
+        return info.param.description;
+    }
+);
+
+// One cache that is carried across the transitions has to notice that its period ended
+TEST_F(TimeZoneEnvTest, CacheFollowsTransitions) {
+    rk::time_internal::TimeZoneCache cache;
+    constexpr int64_t STEP = 15 * 60;
+    for (const int64_t transition : { DST_START_2025, DST_END_2025 }) {
+        for (int64_t time = transition - 2 * 86400; time <= transition + 2 * 86400; time += STEP) {
+            ASSERT_EQ(cache.getOffsetSeconds(time), rk::time_internal::computeUtcOffset(time)) << "at " << time;
+        }
+    }
+
+    SCOPED_TRACE("Going back in time also works");
+    ASSERT_EQ(cache.getOffsetSeconds(DST_START_2025 - 1), EST_OFFSET);
+    ASSERT_EQ(cache.getOffsetSeconds(DST_START_2025), EDT_OFFSET);
+}
+
+TEST_F(TimeZoneEnvTest, CacheIsConsistentAcrossThreads) {
+    rk::time_internal::TimeZoneCache cache;
+    std::atomic<size_t> mismatches{0};
+    std::vector<std::thread> threads;
+    for (size_t thread = 0; thread < 4; thread++) {
+        threads.emplace_back([&cache, &mismatches, thread] () {
+            for (int64_t i = 0; i < 2000; i++) {
+                // Alternate sides of the transition, so the threads keep replacing each other's period
+                const int64_t time = DST_START_2025 + ((i + thread) % 2 == 0 ? -1 - i : i);
+                const int64_t expected = time < DST_START_2025 ? EST_OFFSET : EDT_OFFSET;
+                if (cache.getOffsetSeconds(time) != expected) {
+                    mismatches++;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQ(mismatches, 0);
+}
+
+TEST_F(TimeZoneEnvTest, UtcModeIgnoresLocalTimeZone) {
+    std::unique_ptr<rk::config::Config> config = rk::config::createInstance();
+    config->setConfigValue(rk::config::time_zone::KEY, rk::config::time_zone::UTC);
+    config->setConfigValue(rk::config::hour_format::KEY, rk::config::hour_format::TWENTY_FOUR_HOUR);
+    rk::time_internal::TimeStampFormatter formatter;
+    formatter.updateTimeStampFuncs(*config);
+    ASSERT_EQ(formatLocal(formatter, DST_START_2025), "[03-09-2025|07:00:00.000]");
+    ASSERT_EQ(formatLocal(formatter, DST_END_2025), "[11-02-2025|06:00:00.000]");
+}
+
+// Every combination of the formats has to read back the time it wrote, cut off at its precision
+TEST_F(TimeZoneEnvTest, ParsesEveryTimeStampFormat) {
+    constexpr int64_t LOCAL_NOON_NS = FEB_4_2025_20_30_UTC_NS - 3 * HOUR_NS - 30 * 60 * 1000000000LL; // 12:00PM EST
+    const std::vector<int64_t> times = {
+        FEB_4_2025_20_30_UTC_NS + FRACTION_NS,
+        LOCAL_NOON_NS + FRACTION_NS,
+        LOCAL_NOON_NS - 12 * HOUR_NS + 1, // Midnight, which is "00 AM"
+        LOCAL_NOON_NS - HOUR_NS - 1, // 11:59:59.999999999 AM
+        (DST_START_2025 + 86400) * 1000000000LL + FRACTION_NS, // During DST
+        1767243599LL * 1000000000LL + 999999999, // Dec 31, 2025 at 11:59:59.999999999PM EST
+    };
+    const std::vector<std::pair<rk::config::ConfigValue, int64_t>> precisions = {
+        { rk::config::timestamp_precision::MS, 1000000 },
+        { rk::config::timestamp_precision::US, 1000 },
+        { rk::config::timestamp_precision::NS, 1 },
+        { rk::config::timestamp_precision::EPOCH_NS, 1 },
+    };
+    std::unique_ptr<rk::config::Config> config = rk::config::createInstance();
+    for (const auto& timeZone : { rk::config::time_zone::LOCAL, rk::config::time_zone::UTC }) {
+        for (const auto& dateFormat : { rk::config::date_format::MM_DD_YYYY, rk::config::date_format::DD_MM_YYYY, rk::config::date_format::YYYY_MM_DD }) {
+            for (const auto& monthFormat : { rk::config::month_format::MONTH_NUM, rk::config::month_format::MONTH_NAME }) {
+                for (const auto& hourFormat : { rk::config::hour_format::TWELVE_HOUR, rk::config::hour_format::TWENTY_FOUR_HOUR }) {
+                    for (const auto& [precision, unitNs] : precisions) {
+                        config->setConfigValue(rk::config::time_zone::KEY, timeZone);
+                        config->setConfigValue(rk::config::date_format::KEY, dateFormat);
+                        config->setConfigValue(rk::config::month_format::KEY, monthFormat);
+                        config->setConfigValue(rk::config::hour_format::KEY, hourFormat);
+                        config->setConfigValue(rk::config::timestamp_precision::KEY, precision);
+                        rk::time_internal::TimeStampFormatter formatter;
+                        formatter.updateTimeStampFuncs(*config);
+                        for (const int64_t epochNs : times) {
+                            const rk::time_internal::time_point time(std::chrono::duration_cast<rk::time_internal::system_clock::duration>(std::chrono::nanoseconds(epochNs)));
+                            const std::string timeStamp = formatter.generateTimeStamp(time);
+                            int64_t parsedNs = 0;
+                            ASSERT_EQ(formatter.parseTimeStamp(timeStamp + "[1][main]message", parsedNs), timeStamp.size()) << timeStamp;
+                            ASSERT_EQ(parsedNs, epochNs - epochNs % unitNs) << timeStamp;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST_F(TimeZoneEnvTest, RejectsMalformedTimeStamps) {
+    std::unique_ptr<rk::config::Config> config = rk::config::createInstance();
+    rk::time_internal::TimeStampFormatter formatter;
+    formatter.updateTimeStampFuncs(*config);
+    int64_t epochNs = 0;
+    ASSERT_GT(formatter.parseTimeStamp("[02-04-2025|03:30:00.123 PM]", epochNs), 0);
+
+    for (const std::string text : { "", "[", "second line of a message", "[02-04-2025|03:30:00.123 PM", "[02-04-2025|03:30:00.123]",
+        "[02-04-2025|03:30:00.1234 PM]", "[02-04-2025|13:30:00.123 PM]", "[02-30-2025|03:30:00.123 PM]", "[13-04-2025|03:30:00.123 PM]",
+        "[02-04-2025|03:60:00.123 PM]", "[Feb-04-2025|03:30:00.123 PM]", "[2025-02-04|03:30:00.123 PM]", "[1738701000123456789]" }) {
+        ASSERT_EQ(formatter.parseTimeStamp(text, epochNs), 0) << text;
+    }
+}
+
+} // namespace log_time_tests
+} // namespace rk_logger_tests
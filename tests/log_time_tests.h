@@ -0,0 +1,111 @@
+#ifndef LOG_TIME_TESTS_H
+#define LOG_TIME_TESTS_H
+
+#include <cstdlib>
+#include <ctime>
+
+#include <rk_logger/log_time.h>
+#include <rk_logger/time_zone.h>
+#include <rk_logger_tests/test_base.h>
+
+namespace rk_logger_tests {
+namespace log_time_tests {
+
+/**
+ * @brief Sets the TZ environment variable and makes the C library reload it.
+ * 
+ * @param value The new value. Empty unsets it.
+ */
+inline void setTimeZoneEnv(const std::string& value) {
+#if defined(_WIN32)
+    _putenv_s("TZ", value.c_str());
+    _tzset();
+#else
+    if (value.empty()) {
+        unsetenv("TZ");
+    }
+    else {
+        setenv("TZ", value.c_str(), 1);
+    }
+    tzset();
+#endif
+}
+
+struct TimeStampTestParam : public BaseParam {
+    TimeStampTestParam(const std::string description, const rk::config::ConfigValue dateFormat, const rk::config::ConfigValue monthFormat,
+        const rk::config::ConfigValue hourFormat, const rk::config::ConfigValue precision, const int64_t epochNs, const std::string expected)
+        : BaseParam(description), dateFormat(dateFormat), monthFormat(monthFormat), hourFormat(hourFormat), precision(precision), epochNs(epochNs), expected(expected) {};
+
+    const rk::config::ConfigValue dateFormat;
+    const rk::config::ConfigValue monthFormat;
+    const rk::config::ConfigValue hourFormat;
+    const rk::config::ConfigValue precision;
+    const int64_t epochNs;
+    const std::string expected;
+};
+
+/**
+ * Formats timestamps in UTC, so the expected strings don't depend on the time zone of the machine.
+ */
+class TimeStampTest : public ::testing::TestWithParam<TimeStampTestParam> {
+protected:
+    void SetUp() override {
+        const char* originalTz = std::getenv("TZ");
+        hadTz = originalTz != nullptr;
+        tzOriginal = hadTz ? originalTz : "";
+        setTimeZoneEnv("UTC0");
+        coutBufOriginal = std::cout.rdbuf(logOutput.rdbuf());
+    }
+
+    void TearDown() override {
+        std::cout.rdbuf(coutBufOriginal);
+        setTimeZoneEnv(hadTz ? tzOriginal : "");
+    }
+
+    bool hadTz = false;
+    std::string tzOriginal;
+    std::streambuf* coutBufOriginal;
+    std::stringstream logOutput;
+};
+
+/**
+ * Sets a time zone for the duration of a test and restores the original one afterwards.
+ */
+class TimeZoneEnvTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        const char* originalTz = std::getenv("TZ");
+        hadTz = originalTz != nullptr;
+        tzOriginal = hadTz ? originalTz : "";
+        setTimeZoneEnv(US_EASTERN_TZ);
+        coutBufOriginal = std::cout.rdbuf(logOutput.rdbuf());
+    }
+
+    void TearDown() override {
+        std::cout.rdbuf(coutBufOriginal);
+        setTimeZoneEnv(hadTz ? tzOriginal : "");
+    }
+
+    static constexpr const char* US_EASTERN_TZ = "EST5EDT,M3.2.0,M11.1.0"; /**< UTC-5, or UTC-4 from the 2nd Sunday of March to the 1st Sunday of November */
+
+    bool hadTz = false;
+    std::string tzOriginal;
+    std::streambuf* coutBufOriginal;
+    std::stringstream logOutput;
+};
+
+struct DstBoundaryTestParam : public BaseParam {
+    DstBoundaryTestParam(const std::string description, const int64_t epochSeconds, const int64_t offsetSeconds, const std::string expected)
+        : BaseParam(description), epochSeconds(epochSeconds), offsetSeconds(offsetSeconds), expected(expected) {};
+
+    const int64_t epochSeconds;
+    const int64_t offsetSeconds;
+    const std::string expected;
+};
+
+class DstBoundaryTest : public TimeZoneEnvTest, public ::testing::WithParamInterface<DstBoundaryTestParam> {};
+
+} // namespace log_time_tests
+} // namespace rk_logger_tests
+
+#endif // #ifndef LOG_TIME_TESTS_H
@@ -12,9 +12,70 @@ TEST_F(StartAndStopLoggerTest, StartAndStopLogger) {
     ASSERT_NO_FATAL_FAILURE(Base::stopLogger());
 }
 
+TEST_F(DefaultLoggerTest, StartAndStopDefaultLogger) {
+    SCOPED_TRACE("Starting the default logger");
+    std::thread defaultLogThread;
+    ASSERT_NO_THROW({
+        defaultLogThread = rk::log::startLogger();
+    });
+    ASSERT_TRUE(defaultLogThread.joinable());
+
+    SCOPED_TRACE("Logging a message to the default logger");
+    RK_LOG("Message for the default logger\n");
+
+    SCOPED_TRACE("Stopping the default logger");
+    ASSERT_NO_THROW({
+        rk::log::stopLogger(std::move(defaultLogThread));
+    });
+    ASSERT_FALSE(defaultLogThread.joinable());
+    ASSERT_NE(logOutput.str().find("Message for the default logger"), std::string::npos);
+}
+
+TEST_F(DefaultLoggerTest, GetLoggerByName) {
+    SCOPED_TRACE("Getting the default logger by name");
+    ASSERT_EQ(&rk::log::getLogger(rk::log::DEFAULT_LOGGER_NAME), &rk::log::getDefaultLogger());
+
+    SCOPED_TRACE("Getting a named logger twice");
+    rk::log::Logger& netLogger = rk::log::getLogger("net");
+    ASSERT_EQ(&rk::log::getLogger("net"), &netLogger);
+    ASSERT_NE(&netLogger, &rk::log::getDefaultLogger());
+    ASSERT_EQ(netLogger.getName(), "net");
+}
+
+TEST_F(MultipleLoggersTest, LoggersAreIndependent) {
+    rk::log::Logger otherLogger("other");
+    auto sink = std::make_shared<StringSink>();
+    auto otherSink = std::make_shared<StringSink>();
+    logger.addSink(sink);
+    otherLogger.addSink(otherSink);
+
+    SCOPED_TRACE("Giving each logger a different config");
+    logger.getConfig().setConfigValue(rk::config::write_to_log_file::KEY, rk::config::write_to_log_file::DISABLE);
+    otherLogger.getConfig().setConfigValue(rk::config::write_to_log_file::KEY, rk::config::write_to_log_file::DISABLE);
+    otherLogger.getConfig().setConfigValue(rk::config::date_format::KEY, rk::config::date_format::YYYY_MM_DD);
+    ASSERT_NE(logger.getConfig().getConfigValueByKey(rk::config::date_format::KEY), rk::config::date_format::YYYY_MM_DD);
+
+    SCOPED_TRACE("Starting both loggers");
+    ASSERT_NO_FATAL_FAILURE(Base::startLogger());
+    std::thread otherLogThread = otherLogger.start(std::filesystem::path());
+
+    SCOPED_TRACE("Logging a message to each logger");
+    RK_LOG_TO(logger, "Message for the test logger\n");
+    RK_LOG_TO(otherLogger, "Message for the other logger\n");
+
+    SCOPED_TRACE("Stopping both loggers");
+    otherLogger.stop(std::move(otherLogThread));
+    ASSERT_NO_FATAL_FAILURE(Base::stopLogger());
+
+    ASSERT_NE(sink->str().find("Message for the test logger"), std::string::npos);
+    ASSERT_EQ(sink->str().find("Message for the other logger"), std::string::npos);
+    ASSERT_NE(otherSink->str().find("Message for the other logger"), std::string::npos);
+    ASSERT_EQ(otherSink->str().find("Message for the test logger"), std::string::npos);
+}
+
 TEST_P(LogMessageTest, LogAMessage) {
     SCOPED_TRACE("Logging a message");
-    RK_LOG(GetParam());
+    RK_LOG_TO(logger, GetParam());
 
     SCOPED_TRACE("Waiting some time");
     std::this_thread::sleep_for(MAX_DELAY_FOR_ONE_MESSAGE);
@@ -23,6 +84,86 @@ TEST_P(LogMessageTest, LogAMessage) {
     ASSERT_NE(logOutput.str().find(GetParam()), std::string::npos);
 }
 
+// Every message from every thread must be written exactly once, and in order relative to the thread's other messages
+TEST_P(ShardedLoggerTest, NoMessagesLostAndPerThreadOrderKept) {
+    SCOPED_TRACE("Logging from several threads");
+    std::vector<std::thread> producers;
+    for (size_t producer = 0; producer < PRODUCER_COUNT; producer++) {
+        producers.emplace_back([this, producer] () {
+            for (size_t i = 0; i < MESSAGES_PER_PRODUCER; i++) {
+                RK_LOG_TO(logger, "producer=", producer, " seq=", i, "\n");
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    ASSERT_NO_FATAL_FAILURE(Base::stopLogger());
+
+    SCOPED_TRACE("Checking the output");
+    std::vector<size_t> nextSeq(PRODUCER_COUNT, 0);
+    std::istringstream output(sink->str());
+    std::string line;
+    size_t lineCount = 0;
+    while (std::getline(output, line)) {
+        size_t producer = 0;
+        size_t seq = 0;
+        ASSERT_EQ(std::sscanf(line.substr(line.find("producer=")).c_str(), "producer=%zu seq=%zu", &producer, &seq), 2);
+        ASSERT_LT(producer, PRODUCER_COUNT);
+        ASSERT_EQ(seq, nextSeq[producer]);
+        nextSeq[producer]++;
+        lineCount++;
+    }
+    ASSERT_EQ(lineCount, PRODUCER_COUNT * MESSAGES_PER_PRODUCER);
+}
+
+// With global ordering, messages are written in the order they were logged, even across threads
+TEST_P(ShardedLoggerTest, GlobalOrderKept) {
+    if (GetParam().ordering != rk::config::log_shard_ordering::GLOBAL) {
+        GTEST_SKIP() << "Only applies to global ordering";
+    }
+
+    SCOPED_TRACE("Logging from several threads in a known order");
+    std::mutex orderMutex;
+    size_t counter = 0;
+    std::vector<std::thread> producers;
+    for (size_t producer = 0; producer < PRODUCER_COUNT; producer++) {
+        producers.emplace_back([this, &orderMutex, &counter] () {
+            for (size_t i = 0; i < MESSAGES_PER_PRODUCER; i++) {
+                std::lock_guard<std::mutex> lock(orderMutex);
+                RK_LOG_TO(logger, "order=", counter++, "\n");
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    ASSERT_NO_FATAL_FAILURE(Base::stopLogger());
+
+    SCOPED_TRACE("Checking the output");
+    std::istringstream output(sink->str());
+    std::string line;
+    size_t expected = 0;
+    while (std::getline(output, line)) {
+        ASSERT_EQ(line.substr(line.find("order=")), "order=" + std::to_string(expected));
+        expected++;
+    }
+    ASSERT_EQ(expected, PRODUCER_COUNT * MESSAGES_PER_PRODUCER);
+}
+
+INSTANTIATE_TEST_SUITE_P(ShardedLoggerTest,
+    ShardedLoggerTest,
+    testing::Values(
+        ShardTestParam("one_shard", "1", rk::config::log_shard_ordering::GLOBAL),
+        ShardTestParam("four_shards_global", "4", rk::config::log_shard_ordering::GLOBAL),
+        ShardTestParam("four_shards_per_thread", "4", rk::config::log_shard_ordering::PER_THREAD),
+        ShardTestParam("eight_shards_global", "8", rk::config::log_shard_ordering::GLOBAL)
+    ),
+    [](const testing::TestParamInfo<ShardTestParam>& info) {
+        return info.param.description;
+    }
+);
+
 const std::vector<std::string> messages = {
     "Hello",
     "Hello\n",
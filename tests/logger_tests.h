@@ -3,8 +3,30 @@
 
 #include <rk_logger_tests/test_base.h>
 
+using rk_logger_tests::StringSink;
+
 class StartAndStopLoggerTest : public rk_logger_tests::Base {};
 
+class DefaultLoggerTest : public rk_logger_tests::Base {
+    void SetUp() override {
+        redirectStdCout();
+    }
+
+    void TearDown() override {
+        undoRedirectStdCout();
+    }
+};
+
+class MultipleLoggersTest : public rk_logger_tests::Base {
+    void SetUp() override {
+        redirectStdCout();
+    }
+
+    void TearDown() override {
+        undoRedirectStdCout();
+    }
+};
+
 class LogMessageTest : public rk_logger_tests::Base, public ::testing::WithParamInterface<std::string> {
     void SetUp() override {
         redirectStdCout();
@@ -17,4 +39,37 @@ class LogMessageTest : public rk_logger_tests::Base, public ::testing::WithParam
     }
 };
 
+struct ShardTestParam : public rk_logger_tests::BaseParam {
+    ShardTestParam(const std::string description, const std::string shardCount, const rk::config::ConfigValue ordering)
+        : BaseParam(description), shardCount(shardCount), ordering(ordering) {};
+
+    const std::string shardCount;
+    const rk::config::ConfigValue ordering;
+};
+
+class ShardedLoggerTest : public rk_logger_tests::Base, public ::testing::WithParamInterface<ShardTestParam> {
+protected:
+    static constexpr size_t PRODUCER_COUNT = 4;
+    static constexpr size_t MESSAGES_PER_PRODUCER = 500;
+
+    void SetUp() override {
+        redirectStdCout();
+        logger.getConfig().setConfigValue(rk::config::write_to_log_file::KEY, rk::config::write_to_log_file::DISABLE);
+        logger.getConfig().setConfigValue(rk::config::write_to_console::KEY, rk::config::write_to_console::DISABLE);
+        logger.getConfig().setConfigValue(rk::config::log_shards::KEY, GetParam().shardCount);
+        logger.getConfig().setConfigValue(rk::config::log_shard_ordering::KEY, GetParam().ordering);
+        logger.addSink(sink);
+        ASSERT_NO_FATAL_FAILURE(Base::startLogger(std::filesystem::path()));
+    }
+
+    void TearDown() override {
+        if (logThread.joinable()) {
+            Base::stopLogger();
+        }
+        undoRedirectStdCout();
+    }
+
+    std::shared_ptr<rk_logger_tests::StringSink> sink = std::make_shared<rk_logger_tests::StringSink>();
+};
+
 #endif // #ifndef LOGGER_TESTS_H
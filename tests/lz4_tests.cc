@@ -0,0 +1,394 @@
+#include <cstring>
+#include <thread>
+
+#include "lz4_tests.h"
+
+namespace rk_logger_tests {
+namespace lz4_tests {
+
+namespace {
+
+constexpr size_t LOG_LINE_COUNT = 5000;
+
+void appendLe32(std::string& out, const uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        out += static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+}
+
+/**
+ * @brief Builds a frame with block checksums, a content checksum, and the content size, which the logger doesn't
+ * write but other encoders do.
+ */
+std::string encodeCheckedFrame(const std::string& data) {
+    constexpr unsigned char FLAGS = 0x40 | 0x20 | 0x10 | 0x08 | 0x04;
+    constexpr unsigned char BLOCK_DESCRIPTOR = 0x40; // Blocks of up to 64 KB
+    constexpr size_t MAX_BLOCK_SIZE = 64 * 1024;
+    std::string frame;
+    appendLe32(frame, rk::lz4_internal::FRAME_MAGIC);
+    std::string descriptor;
+    descriptor += static_cast<char>(FLAGS);
+    descriptor += static_cast<char>(BLOCK_DESCRIPTOR);
+    appendLe32(descriptor, static_cast<uint32_t>(data.size()));
+    appendLe32(descriptor, 0);
+    frame += descriptor;
+    frame += static_cast<char>((rk::lz4_internal::xxh32(descriptor.data(), descriptor.size()) >> 8) & 0xFF);
+
+    rk::lz4_internal::BlockCompressor compressor;
+    for (size_t pos = 0; pos < data.size(); pos += MAX_BLOCK_SIZE) {
+        const size_t size = std::min(MAX_BLOCK_SIZE, data.size() - pos);
+        std::string block(rk::lz4_internal::getMaxCompressedSize(size), '\0');
+        block.resize(compressor.compress(data.data() + pos, size, block.data()));
+        appendLe32(frame, static_cast<uint32_t>(block.size()));
+        frame += block;
+        appendLe32(frame, rk::lz4_internal::xxh32(block.data(), block.size()));
+    }
+    appendLe32(frame, 0);
+    appendLe32(frame, rk::lz4_internal::xxh32(data.data(), data.size()));
+    return frame;
+}
+
+bool decompressBlock(const std::string& block, std::string& out) {
+    return rk::lz4_internal::decompressBlock(block.data(), block.size(), rk::lz4_internal::BLOCK_SIZE, out, 0);
+}
+
+} // namespace
+
+TEST_P(Lz4LevelTest, RoundTripsEmptyData) {
+    expectRoundTrip("");
+}
+
+// Blocks shorter than the last literals and the match limit can't have any matches
+TEST_P(Lz4LevelTest, RoundTripsShortData) {
+    for (size_t size = 1; size <= 20; size++) {
+        SCOPED_TRACE("Size " + std::to_string(size));
+        expectRoundTrip(std::string(size, 'a'));
+        expectRoundTrip(makeLogText(1).substr(0, size));
+    }
+}
+
+TEST_P(Lz4LevelTest, RoundTripsLogText) {
+    expectRoundTrip(makeLogText(LOG_LINE_COUNT));
+}
+
+TEST_P(Lz4LevelTest, RoundTripsRandomData) {
+    expectRoundTrip(makeRandomBytes(3 * rk::lz4_internal::BLOCK_SIZE / 2, 1));
+}
+
+// Long runs of one byte give matches that overlap what they copy, and lengths that continue over many bytes
+TEST_P(Lz4LevelTest, RoundTripsRepeatedData) {
+    std::string data(rk::lz4_internal::BLOCK_SIZE + 1000, 'x');
+    data += makeLogText(10);
+    data += std::string(5000, '\0');
+    expectRoundTrip(data);
+}
+
+TEST_P(Lz4LevelTest, LogTextGetsSmaller) {
+    const std::string text = makeLogText(LOG_LINE_COUNT);
+    const std::string encoded = encodeFrame(text, GetParam().level);
+    ASSERT_LT(encoded.size(), text.size() / 3);
+}
+
+// Random data doesn't compress, so its blocks are stored as they are instead of growing
+TEST_P(Lz4LevelTest, RandomDataBarelyGrows) {
+    const std::string data = makeRandomBytes(2 * rk::lz4_internal::BLOCK_SIZE, 2);
+    const std::string encoded = encodeFrame(data, GetParam().level);
+    ASSERT_LE(encoded.size(), data.size() + 64);
+}
+
+// A followed file arrives in pieces that end anywhere, e.g., in the middle of a block size
+TEST_P(Lz4LevelTest, DecodesInPiecesOfAnySize) {
+    const std::string text = makeLogText(LOG_LINE_COUNT / 10);
+    const std::string encoded = encodeFrame(text, GetParam().level) + encodeFrame(text, GetParam().level);
+    for (const size_t pieceSize : { size_t(1), size_t(3), size_t(4096) }) {
+        SCOPED_TRACE("Pieces of " + std::to_string(pieceSize));
+        std::string decoded;
+        ASSERT_TRUE(decodeInPieces(encoded, pieceSize, decoded));
+        ASSERT_TRUE(decoded == text + text);
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(Lz4LevelTestParameterized,
+    Lz4LevelTest,
+    testing::Values(
+        Lz4LevelTestParam("level_1", 1),
+        Lz4LevelTestParam("level_2", 2),
+        Lz4LevelTestParam("level_4", 4),
+        Lz4LevelTestParam("level_9", 9)
+    ),
+    [](const testing::TestParamInfo<Lz4LevelTestParam>& info) {
+        return info.param.description;
+    }
+);
+
+TEST_F(Lz4FrameTest, Xxh32MatchesReferenceValues) {
+    ASSERT_EQ(rk::lz4_internal::xxh32("", 0), 0x02CC5D05U);
+    ASSERT_EQ(rk::lz4_internal::xxh32("abc", 3), 0x32D153FFU);
+
+    SCOPED_TRACE("Hashing in pieces gives the same hash as hashing at once");
+    const std::string data = makeRandomBytes(1000, 3);
+    for (const size_t pieceSize : { size_t(1), size_t(7), size_t(16), size_t(100) }) {
+        rk::lz4_internal::Xxh32 hash(42);
+        for (size_t pos = 0; pos < data.size(); pos += pieceSize) {
+            hash.update(data.data() + pos, std::min(pieceSize, data.size() - pos));
+        }
+        ASSERT_EQ(hash.digest(), rk::lz4_internal::xxh32(data.data(), data.size(), 42));
+    }
+}
+
+TEST_F(Lz4FrameTest, HigherLevelsCompressSmaller) {
+    const std::string text = makeLogText(LOG_LINE_COUNT);
+    ASSERT_LT(encodeFrame(text, rk::lz4_internal::MAX_LEVEL).size(), encodeFrame(text, rk::lz4_internal::MIN_LEVEL).size());
+}
+
+// Each frame is decoded on its own, so a decoder can start at any frame of a file
+TEST_F(Lz4FrameTest, FramesDecodeOnTheirOwn) {
+    rk::lz4_internal::FrameEncoder encoder;
+    std::string first;
+    encoder.write("first frame\n", first);
+    encoder.finishFrame(first);
+    std::string second;
+    encoder.write("second frame\n", second);
+    encoder.finishFrame(second);
+
+    std::string decoded;
+    ASSERT_TRUE(decodeInPieces(second, second.size(), decoded));
+    ASSERT_EQ(decoded, "second frame\n");
+    decoded.clear();
+    ASSERT_TRUE(decodeInPieces(first + second, 5, decoded));
+    ASSERT_EQ(decoded, "first frame\nsecond frame\n");
+}
+
+TEST_F(Lz4FrameTest, FinishingWithoutFrameWritesNothing) {
+    rk::lz4_internal::FrameEncoder encoder;
+    std::string out;
+    encoder.finishFrame(out);
+    ASSERT_TRUE(out.empty());
+    ASSERT_FALSE(encoder.isFrameOpen());
+}
+
+// Full blocks can be decoded before their frame is finished
+TEST_F(Lz4FrameTest, DecodesFullBlocksOfOpenFrame) {
+    const std::string text = makeLogText(LOG_LINE_COUNT);
+    ASSERT_GT(text.size(), rk::lz4_internal::BLOCK_SIZE);
+    rk::lz4_internal::FrameEncoder encoder;
+    std::string encoded;
+    encoder.write(text, encoded);
+    ASSERT_TRUE(encoder.isFrameOpen());
+
+    rk::lz4_internal::FrameDecoder decoder;
+    std::string decoded;
+    ASSERT_TRUE(decoder.decode(encoded.data(), encoded.size(), decoded));
+    ASSERT_FALSE(decoder.isAtFrameBoundary());
+    ASSERT_EQ(decoded, text.substr(0, decoded.size()));
+    ASSERT_EQ(decoded.size() % rk::lz4_internal::BLOCK_SIZE, 0);
+    ASSERT_GT(decoded.size(), 0);
+}
+
+TEST_F(Lz4FrameTest, DecodesChecksumsAndContentSize) {
+    const std::string text = makeLogText(LOG_LINE_COUNT);
+    std::string frame = encodeCheckedFrame(text);
+    std::string decoded;
+    ASSERT_TRUE(decodeInPieces(frame, 1000, decoded));
+    ASSERT_TRUE(decoded == text);
+
+    SCOPED_TRACE("A changed content checksum is detected");
+    frame[frame.size() - 1] ^= 0x01;
+    decoded.clear();
+    ASSERT_FALSE(decodeInPieces(frame, frame.size(), decoded));
+}
+
+TEST_F(Lz4FrameTest, RejectsChangedBlockChecksum) {
+    std::string frame = encodeCheckedFrame(makeLogText(100));
+    const size_t firstBlockSizeAt = 4 + 2 + 8 + 1;
+    frame[firstBlockSizeAt + 4] ^= 0x01; // The first byte of the first block
+    rk::lz4_internal::FrameDecoder decoder;
+    std::string decoded;
+    ASSERT_FALSE(decoder.decode(frame.data(), frame.size(), decoded));
+    ASSERT_FALSE(decoder.getError().empty());
+}
+
+TEST_F(Lz4FrameTest, SkipsSkippableFrames) {
+    std::string stream;
+    appendLe32(stream, rk::lz4_internal::SKIPPABLE_FRAME_MAGIC + 3);
+    appendLe32(stream, 5);
+    stream += "extra";
+    stream += encodeFrame("message\n", rk::lz4_internal::MIN_LEVEL);
+    std::string decoded;
+    ASSERT_TRUE(decodeInPieces(stream, 2, decoded));
+    ASSERT_EQ(decoded, "message\n");
+}
+
+TEST_F(Lz4FrameTest, RejectsCorruptFrames) {
+    const std::string frame = encodeFrame(makeLogText(100), rk::lz4_internal::MIN_LEVEL);
+    std::string decoded;
+
+    SCOPED_TRACE("Not a frame");
+    ASSERT_FALSE(decodeInPieces("plain text, not a frame", 100, decoded));
+
+    SCOPED_TRACE("Header checksum");
+    std::string changed = frame;
+    changed[6] ^= 0x01;
+    ASSERT_FALSE(decodeInPieces(changed, changed.size(), decoded));
+
+    SCOPED_TRACE("Block larger than the frame allows");
+    changed = frame;
+    changed[7 + 3] = 0x7F;
+    ASSERT_FALSE(decodeInPieces(changed, changed.size(), decoded));
+
+    SCOPED_TRACE("Dictionary id");
+    changed = frame;
+    changed[4] |= 0x01;
+    ASSERT_FALSE(decodeInPieces(changed, changed.size(), decoded));
+
+    SCOPED_TRACE("A failed decoder stays failed");
+    rk::lz4_internal::FrameDecoder decoder;
+    ASSERT_FALSE(decoder.decode("xxxx", 4, decoded));
+    ASSERT_FALSE(decoder.decode(frame.data(), frame.size(), decoded));
+}
+
+TEST_F(Lz4FrameTest, TruncatedFrameIsNotAtBoundary) {
+    const std::string frame = encodeFrame(makeLogText(100), rk::lz4_internal::MIN_LEVEL);
+    rk::lz4_internal::FrameDecoder decoder;
+    std::string decoded;
+    ASSERT_TRUE(decoder.decode(frame.data(), frame.size() - 1, decoded));
+    ASSERT_FALSE(decoder.isAtFrameBoundary());
+    ASSERT_TRUE(decoder.decode(frame.data() + frame.size() - 1, 1, decoded));
+    ASSERT_TRUE(decoder.isAtFrameBoundary());
+}
+
+TEST_F(Lz4FrameTest, RejectsCorruptBlocks) {
+    std::string out = "kept";
+    SCOPED_TRACE("Offset of 0");
+    ASSERT_FALSE(decompressBlock(std::string("\x40" "abcd" "\x00\x00", 7), out));
+    SCOPED_TRACE("Offset before the start of the block");
+    ASSERT_FALSE(decompressBlock(std::string("\x40" "abcd" "\x05\x00" "\x00", 8), out));
+    SCOPED_TRACE("More literals than the block has");
+    ASSERT_FALSE(decompressBlock(std::string("\x50" "abc", 4), out));
+    SCOPED_TRACE("Length that runs past the end of the block");
+    ASSERT_FALSE(decompressBlock(std::string("\xF0" "\xFF", 2), out));
+    SCOPED_TRACE("Sequence that ends with a match");
+    ASSERT_FALSE(decompressBlock(std::string("\x10" "a" "\x01\x00", 4), out));
+    SCOPED_TRACE("Failures leave the output as it was");
+    ASSERT_EQ(out, "kept");
+
+    SCOPED_TRACE("A valid block with an overlapping match");
+    ASSERT_TRUE(decompressBlock(std::string("\x12" "a" "\x01\x00" "\x10" "b", 6), out));
+    ASSERT_EQ(out, "keptaaaaaaab");
+}
+
+// Changed bytes anywhere in a stream must be rejected or decoded without reading or writing out of bounds, which the
+// address sanitizer checks
+TEST_F(Lz4FrameTest, SurvivesChangedBytes) {
+    const std::string frame = encodeFrame(makeLogText(200), 2) + encodeCheckedFrame(makeLogText(50));
+    std::mt19937 generator(4);
+    for (int i = 0; i < 2000; i++) {
+        std::string changed = frame;
+        const int changeCount = 1 + static_cast<int>(generator() % 4);
+        for (int j = 0; j < changeCount; j++) {
+            changed[generator() % changed.size()] = static_cast<char>(generator() & 0xFF);
+        }
+        rk::lz4_internal::FrameDecoder decoder;
+        std::string decoded;
+        decoder.decode(changed.data(), changed.size(), decoded);
+        ASSERT_LE(decoded.size(), 2 * frame.size() + 2 * rk::lz4_internal::BLOCK_SIZE);
+    }
+}
+
+TEST_F(Lz4FileSinkTest, WritesDecodableFile) {
+    const std::string text = makeLogText(LOG_LINE_COUNT);
+    {
+        rk::log::Lz4FileSink fileSink(path, rk::lz4_internal::MIN_LEVEL, LONG_FRAME_TIME);
+        ASSERT_TRUE(fileSink.isOpen());
+        for (size_t pos = 0; pos < text.size();) {
+            const size_t lineEnd = text.find('\n', pos) + 1;
+            fileSink.write(text.substr(pos, lineEnd - pos));
+            pos = lineEnd;
+        }
+        fileSink.flush();
+    }
+    std::string decoded;
+    ASSERT_TRUE(decodeInPieces(readFile(path), rk::lz4_internal::BLOCK_SIZE, decoded));
+    ASSERT_TRUE(decoded == text);
+}
+
+// A frame is only finished once the frame time has passed, which is when a follower can decode it
+TEST_F(Lz4FileSinkTest, FinishesFrameAfterFrameTime) {
+    rk::log::Lz4FileSink fileSink(path, rk::lz4_internal::MIN_LEVEL, SHORT_FRAME_TIME);
+    fileSink.write("first\n");
+    fileSink.flush();
+    std::string decoded;
+    decodeInPieces(readFile(path), 100, decoded);
+    ASSERT_TRUE(decoded.empty());
+
+    std::this_thread::sleep_for(SHORT_FRAME_TIME);
+    fileSink.flush();
+    ASSERT_TRUE(decodeInPieces(readFile(path), 100, decoded));
+    ASSERT_EQ(decoded, "first\n");
+
+    fileSink.write("second\n");
+    fileSink.sync();
+    decoded.clear();
+    ASSERT_TRUE(decodeInPieces(readFile(path), 100, decoded));
+    ASSERT_EQ(decoded, "first\nsecond\n");
+}
+
+TEST_F(Lz4FileSinkTest, FrameTimeOfZeroFinishesEveryFlush) {
+    rk::log::Lz4FileSink fileSink(path, rk::lz4_internal::MIN_LEVEL, std::chrono::milliseconds(0));
+    for (int i = 0; i < 3; i++) {
+        fileSink.write("batch " + std::to_string(i) + "\n");
+        fileSink.flush();
+    }
+    std::string decoded;
+    ASSERT_TRUE(decodeInPieces(readFile(path), 1, decoded));
+    ASSERT_EQ(decoded, "batch 0\nbatch 1\nbatch 2\n");
+}
+
+TEST_F(Lz4FileSinkTest, CreatesSinkFromConfig) {
+    const rk::config::Config& config = logger.getConfig();
+    ASSERT_EQ(rk::log::getLogFileName("logs_x", config), "logs_x.txt.lz4");
+    ASSERT_NE(dynamic_cast<rk::log::Lz4FileSink*>(rk::log::createLogFileSink(path, config).get()), nullptr);
+
+    logger.getConfig().setConfigValue(rk::config::log_file_compression::KEY, rk::config::log_file_compression::NONE);
+    ASSERT_EQ(rk::log::getLogFileName("logs_x", config), "logs_x.txt");
+    ASSERT_NE(dynamic_cast<rk::log::FileSink*>(rk::log::createLogFileSink(path, config).get()), nullptr);
+
+    ASSERT_EQ(rk::log::createLogFileSink(path/"missing_directory"/"file.txt", config), nullptr);
+}
+
+TEST_F(Lz4FileSinkTest, LoggerWritesCompressedFile) {
+    logger.startOwned(std::filesystem::path());
+    for (int i = 0; i < 100; i++) {
+        RK_LOG_TO(logger, "message ", i, "\n");
+    }
+    logger.stop();
+
+    const std::vector<std::filesystem::path> logFiles = findLogFiles();
+    ASSERT_EQ(logFiles.size(), 1);
+    std::string decoded;
+    ASSERT_TRUE(decodeInPieces(readFile(logFiles[0]), 4096, decoded));
+    for (int i = 0; i < 100; i++) {
+        ASSERT_NE(decoded.find("]message " + std::to_string(i) + "\n"), std::string::npos);
+    }
+}
+
+// An idle log thread still finishes the frame, so the last messages can be read without stopping the logger
+TEST_F(Lz4FileSinkTest, LoggerFinishesFrameWhenIdle) {
+    constexpr std::chrono::milliseconds MAX_WAIT(5000);
+    logger.getConfig().setConfigValue(rk::config::log_file_frame_ms::KEY, std::to_string(SHORT_FRAME_TIME.count()));
+    logger.startOwned(std::filesystem::path());
+    RK_LOG_TO(logger, "only message\n");
+
+    const std::vector<std::filesystem::path> logFiles = findLogFiles();
+    ASSERT_EQ(logFiles.size(), 1);
+    std::string decoded;
+    const auto start = std::chrono::steady_clock::now();
+    while (!decodeInPieces(readFile(logFiles[0]), 4096, decoded) || decoded.find("]only message\n") == std::string::npos) {
+        ASSERT_LT(std::chrono::steady_clock::now() - start, MAX_WAIT) << "The frame was never finished";
+        std::this_thread::sleep_for(SHORT_FRAME_TIME);
+        decoded.clear();
+    }
+}
+
+} // namespace lz4_tests
+} // namespace rk_logger_tests
@@ -0,0 +1,133 @@
+#ifndef LZ4_TESTS_H
+#define LZ4_TESTS_H
+
+#include <fstream>
+#include <random>
+
+#include <rk_logger/lz4.h>
+#include <rk_logger/sink.h>
+#include <rk_logger_tests/test_base.h>
+
+namespace rk_logger_tests {
+namespace lz4_tests {
+
+inline const std::string LOG_FILE_PREFIX = "logs_" + TEST_LOGGER_NAME + "_";
+inline const std::string COMPRESSED_LOG_FILE_SUFFIX = ".txt.lz4";
+inline const std::chrono::milliseconds SHORT_FRAME_TIME = std::chrono::milliseconds(20);
+inline const std::chrono::milliseconds LONG_FRAME_TIME = std::chrono::hours(1);
+
+/**
+ * @brief Makes text that looks like a log, which is what the compressor is tuned for.
+ */
+inline std::string makeLogText(const size_t lineCount) {
+    std::string text;
+    for (size_t i = 0; i < lineCount; i++) {
+        text += "10/19/2026 10:42:" + std::to_string(10 + i % 50) + "." + std::to_string(100 + i % 900) + " [140213" +
+            std::to_string(i % 7) + "][handleRequest]Request " + std::to_string(i * 7919) + " served in " +
+            std::to_string(i * 37 % 1000) + " us with status " + (i % 13 == 0 ? "500" : "200") + "\n";
+    }
+    return text;
+}
+
+inline std::string makeRandomBytes(const size_t size, const uint32_t seed) {
+    std::mt19937 generator(seed);
+    std::string bytes(size, '\0');
+    for (char& byte : bytes) {
+        byte = static_cast<char>(generator() & 0xFF);
+    }
+    return bytes;
+}
+
+inline std::string encodeFrame(const std::string& data, const int level) {
+    rk::lz4_internal::FrameEncoder encoder(level);
+    std::string encoded;
+    encoder.write(data, encoded);
+    encoder.finishFrame(encoded);
+    return encoded;
+}
+
+/**
+ * @brief Decodes a stream in pieces of a fixed size, the way a file that is being followed arrives.
+ *
+ * @return True if the whole stream was valid and ended at the end of a frame.
+ */
+inline bool decodeInPieces(const std::string& encoded, const size_t pieceSize, std::string& decoded) {
+    rk::lz4_internal::FrameDecoder decoder;
+    for (size_t pos = 0; pos < encoded.size(); pos += pieceSize) {
+        if (!decoder.decode(encoded.data() + pos, std::min(pieceSize, encoded.size() - pos), decoded)) {
+            return false;
+        }
+    }
+    return decoder.isAtFrameBoundary();
+}
+
+inline std::string readFile(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+struct Lz4LevelTestParam : public BaseParam {
+    Lz4LevelTestParam(const std::string description, const int level) : BaseParam(description), level(level) {};
+
+    const int level;
+};
+
+class Lz4LevelTest : public ::testing::TestWithParam<Lz4LevelTestParam> {
+protected:
+    void expectRoundTrip(const std::string& data) {
+        const std::string encoded = encodeFrame(data, GetParam().level);
+        std::string decoded;
+        ASSERT_TRUE(decodeInPieces(encoded, encoded.size() + 1, decoded));
+        ASSERT_EQ(decoded.size(), data.size());
+        ASSERT_TRUE(decoded == data);
+    }
+};
+
+class Lz4FrameTest : public ::testing::Test {};
+
+/**
+ * Writes compressed log files to a temporary directory, or through a logger to the current directory.
+ */
+class Lz4FileSinkTest : public Base {
+protected:
+    void SetUp() override {
+        redirectStdCout();
+        removeLogFiles();
+        std::filesystem::remove(path);
+        logger.getConfig().setConfigValue(rk::config::write_to_console::KEY, rk::config::write_to_console::DISABLE);
+        logger.getConfig().setConfigValue(rk::config::write_to_log_file::KEY, rk::config::write_to_log_file::ENABLE);
+        logger.getConfig().setConfigValue(rk::config::log_file_compression::KEY, rk::config::log_file_compression::LZ4);
+    }
+
+    void TearDown() override {
+        logger.stop();
+        undoRedirectStdCout();
+        removeLogFiles();
+        std::filesystem::remove(path);
+    }
+
+    static std::vector<std::filesystem::path> findLogFiles() {
+        std::vector<std::filesystem::path> paths;
+        for (const auto& entry : std::filesystem::directory_iterator(std::filesystem::current_path())) {
+            const std::string fileName = entry.path().filename().string();
+            if (fileName.rfind(LOG_FILE_PREFIX, 0) == 0 && fileName.size() > COMPRESSED_LOG_FILE_SUFFIX.size() &&
+                fileName.compare(fileName.size() - COMPRESSED_LOG_FILE_SUFFIX.size(), COMPRESSED_LOG_FILE_SUFFIX.size(), COMPRESSED_LOG_FILE_SUFFIX) == 0) {
+                paths.push_back(entry.path());
+            }
+        }
+        return paths;
+    }
+
+    static void removeLogFiles() {
+        for (const auto& logFile : findLogFiles()) {
+            std::filesystem::remove(logFile);
+        }
+    }
+
+    const std::filesystem::path path = std::filesystem::temp_directory_path()/("rk_lz4_test_" + std::string(::testing::UnitTest::GetInstance()->current_test_info()->name()) + COMPRESSED_LOG_FILE_SUFFIX);
+};
+
+} // namespace lz4_tests
+} // namespace rk_logger_tests
+
+#endif // #ifndef LZ4_TESTS_H
@@ -0,0 +1,137 @@
+#include <rk_logger/sampling.h>
+#include "sampling_tests.h"
+
+namespace rk_logger_tests {
+namespace sampling_tests {
+
+TEST(SamplerTest, EveryN) {
+    rk::log_internal::EveryNSampler sampler;
+    size_t logged = 0;
+    for (size_t i = 0; i < 100; i++) {
+        if (sampler.shouldLog(10)) {
+            SCOPED_TRACE("Only every 10th message starting from the first should be logged");
+            ASSERT_EQ(i % 10, 0);
+            logged++;
+        }
+    }
+    ASSERT_EQ(logged, 10);
+}
+
+TEST(SamplerTest, FirstN) {
+    rk::log_internal::FirstNSampler sampler;
+    size_t logged = 0;
+    for (size_t i = 0; i < 100; i++) {
+        if (sampler.shouldLog(5)) {
+            ASSERT_LT(i, 5);
+            logged++;
+        }
+    }
+    ASSERT_EQ(logged, 5);
+}
+
+TEST(SamplerTest, EveryMs) {
+    rk::log_internal::EveryMsSampler sampler;
+    SCOPED_TRACE("The first message is logged and the ones right after it aren't");
+    ASSERT_TRUE(sampler.shouldLog(50));
+    ASSERT_FALSE(sampler.shouldLog(50));
+    ASSERT_FALSE(sampler.shouldLog(50));
+
+    SCOPED_TRACE("After the interval, a message is logged again");
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    ASSERT_TRUE(sampler.shouldLog(50));
+    ASSERT_FALSE(sampler.shouldLog(50));
+}
+
+TEST(SamplerTest, RateLimiterAllowsBurstThenLimits) {
+    rk::log_internal::RateLimiter limiter;
+    SCOPED_TRACE("A full bucket lets through a burst");
+    size_t logged = 0;
+    for (size_t i = 0; i < 100; i++) {
+        if (limiter.shouldLog(10, 5)) {
+            logged++;
+        }
+    }
+    ASSERT_EQ(logged, 5);
+
+    SCOPED_TRACE("The bucket refills at the configured rate");
+    std::this_thread::sleep_for(std::chrono::milliseconds(250));
+    logged = 0;
+    for (size_t i = 0; i < 100; i++) {
+        if (limiter.shouldLog(10, 5)) {
+            logged++;
+        }
+    }
+    ASSERT_GE(logged, 1);
+    ASSERT_LE(logged, 5);
+}
+
+TEST(SamplerTest, EveryNFromManyThreads) {
+    rk::log_internal::EveryNSampler sampler;
+    std::atomic<size_t> logged{0};
+    std::vector<std::thread> threads;
+    for (size_t thread = 0; thread < 4; thread++) {
+        threads.emplace_back([&sampler, &logged] () {
+            for (size_t i = 0; i < 1000; i++) {
+                if (sampler.shouldLog(100)) {
+                    logged++;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQ(logged, 40);
+}
+
+TEST_F(SamplingMacroTest, DroppedMessagesDontEvaluateArguments) {
+    size_t evaluations = 0;
+    auto countEvaluation = [&evaluations] () {
+        evaluations++;
+        return "counted";
+    };
+
+    SCOPED_TRACE("Logging through each sampling macro");
+    for (size_t i = 0; i < 100; i++) {
+        RK_LOG_TO_EVERY_N(logger, 10, "every_n ", countEvaluation(), "\n");
+    }
+    for (size_t i = 0; i < 100; i++) {
+        RK_LOG_TO_FIRST_N(logger, 3, "first_n ", countEvaluation(), "\n");
+    }
+    for (size_t i = 0; i < 100; i++) {
+        RK_LOG_TO_EVERY_MS(logger, 60000, "every_ms ", countEvaluation(), "\n");
+    }
+    for (size_t i = 0; i < 100; i++) {
+        RK_LOG_TO_RATE_LIMITED(logger, 1, 2, "rate_limited ", countEvaluation(), "\n");
+    }
+
+    SCOPED_TRACE("Checking that only the logged messages were evaluated");
+    const size_t expected = 10 + 3 + 1 + 2;
+    ASSERT_EQ(evaluations, expected);
+    ASSERT_EQ(stopAndCountLines(), expected);
+}
+
+// A message below the level doesn't count toward the N, so raising the level for a while doesn't shift the samples
+TEST_F(SamplingMacroTest, MessagesBelowTheLevelArentSampled) {
+    const auto logEveryNAndFirstN = [this] (const size_t times) {
+        for (size_t i = 0; i < times; i++) {
+            RK_LOG_TO_EVERY_N(logger, 4, "every_n\n");
+            RK_LOG_TO_FIRST_N(logger, 2, "first_n\n");
+        }
+    };
+
+    SCOPED_TRACE("Logging while the level is raised in between");
+    logEveryNAndFirstN(2);
+    logger.setLevel(rk::log::Level::Warn);
+    logEveryNAndFirstN(2);
+    logger.setLevel(rk::log::Level::Info);
+    logEveryNAndFirstN(2);
+
+    SCOPED_TRACE("Checking that only the calls at the INFO level were counted");
+    const size_t expectedEveryN = 1; // The 1st call. The 5th would be the next one
+    const size_t expectedFirstN = 2;
+    ASSERT_EQ(stopAndCountLines(), expectedEveryN + expectedFirstN);
+}
+
+} // namespace sampling_tests
+} // namespace rk_logger_tests
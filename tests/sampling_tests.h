@@ -0,0 +1,42 @@
+#ifndef SAMPLING_TESTS_H
+#define SAMPLING_TESTS_H
+
+#include <rk_logger/logger.h>
+#include <rk_logger_tests/test_base.h>
+
+namespace rk_logger_tests {
+namespace sampling_tests {
+
+class SamplingMacroTest : public Base {
+protected:
+    void SetUp() override {
+        redirectStdCout();
+        logger.getConfig().setConfigValue(rk::config::write_to_log_file::KEY, rk::config::write_to_log_file::DISABLE);
+        logger.getConfig().setConfigValue(rk::config::write_to_console::KEY, rk::config::write_to_console::DISABLE);
+        logger.addSink(sink);
+        ASSERT_NO_FATAL_FAILURE(Base::startLogger(std::filesystem::path()));
+    }
+
+    void TearDown() override {
+        if (logThread.joinable()) {
+            Base::stopLogger();
+        }
+        undoRedirectStdCout();
+    }
+
+    /**
+     * @brief Stops the logger and counts how many lines were written.
+     */
+    size_t stopAndCountLines() {
+        Base::stopLogger();
+        const std::string output = sink->str();
+        return static_cast<size_t>(std::count(output.begin(), output.end(), '\n'));
+    }
+
+    std::shared_ptr<StringSink> sink = std::make_shared<StringSink>();
+};
+
+} // namespace sampling_tests
+} // namespace rk_logger_tests
+
+#endif // #ifndef SAMPLING_TESTS_H
@@ -0,0 +1,58 @@
+#include <thread>
+
+#include "scope_tests.h"
+
+namespace rk_logger_tests {
+namespace scope_tests {
+
+TEST_F(ScopeTest, NestedScopesAddAndRemoveFields) {
+    const std::string& context = rk::log_internal::getThreadContext();
+    ASSERT_EQ(context, "");
+    {
+        rk::log::Scope request{ { "req", 42 }, { "user", std::string("ada") } };
+        ASSERT_EQ(context, "[req=42][user=ada]");
+        {
+            rk::log::Scope step{ { "step", "parse" } };
+            ASSERT_EQ(context, "[req=42][user=ada][step=parse]");
+        }
+        ASSERT_EQ(context, "[req=42][user=ada]");
+    }
+    ASSERT_EQ(context, "");
+}
+
+// A deferred formatter would only copy the value into the record, which a field doesn't keep, so it is formatted
+TEST_F(ScopeTest, FieldWithDeferredFormatter) {
+    rk::log::Scope scope{ { "shard", ShardId{ 12 } } };
+    ASSERT_EQ(rk::log_internal::getThreadContext(), "[shard=s12]");
+}
+
+TEST_F(ScopeTest, FieldsAreOnlyOnTheirThread) {
+    rk::log::Scope scope{ { "req", 1 } };
+    std::string otherContext = "not set";
+    std::thread other([&otherContext] () { otherContext = rk::log_internal::getThreadContext(); });
+    other.join();
+    ASSERT_EQ(otherContext, "");
+}
+
+TEST_F(ScopeLoggerTest, FieldsFollowFunctionName) {
+    RK_LOG_TO(logger, "before\n");
+    {
+        rk::log::Scope scope{ { "req", 7 }, { "session", "abc" } };
+        RK_LOG_TO(logger, std::string("handling"), " ", 1.5, "\n");
+        rk::log::Batch batch(logger);
+        RK_LOG_BATCH(batch, "batched\n");
+        batch.commit();
+    }
+    RK_LOG_TO(logger, "after\n");
+    Base::stopLogger();
+
+    const std::string output = sink->str();
+    const std::string prefix = "[" + std::string(__func__) + "]";
+    ASSERT_NE(output.find(prefix + "before\n"), std::string::npos);
+    ASSERT_NE(output.find(prefix + "[req=7][session=abc]handling 1.5\n"), std::string::npos);
+    ASSERT_NE(output.find(prefix + "[req=7][session=abc]batched\n"), std::string::npos);
+    ASSERT_NE(output.find(prefix + "after\n"), std::string::npos);
+}
+
+} // namespace scope_tests
+} // namespace rk_logger_tests
@@ -0,0 +1,59 @@
+#ifndef SCOPE_TESTS_H
+#define SCOPE_TESTS_H
+
+#include <charconv>
+
+#include <rk_logger/logger.h>
+#include <rk_logger/batch.h>
+#include <rk_logger/scope.h>
+#include <rk_logger_tests/test_base.h>
+
+namespace rk_logger_tests {
+namespace scope_tests {
+
+struct ShardId {
+    uint16_t value;
+};
+
+} // namespace scope_tests
+} // namespace rk_logger_tests
+
+template<>
+struct rk::log::formatter<rk_logger_tests::scope_tests::ShardId> {
+    static constexpr size_t max_size = 16;
+    static constexpr bool is_deferred = true;
+    static size_t format_to(char* out, const rk_logger_tests::scope_tests::ShardId& id) {
+        out[0] = 's';
+        return static_cast<size_t>(std::to_chars(out + 1, out + max_size, id.value).ptr - out);
+    }
+};
+
+namespace rk_logger_tests {
+namespace scope_tests {
+
+class ScopeTest : public ::testing::Test {};
+
+class ScopeLoggerTest : public Base {
+protected:
+    void SetUp() override {
+        redirectStdCout();
+        logger.getConfig().setConfigValue(rk::config::write_to_log_file::KEY, rk::config::write_to_log_file::DISABLE);
+        logger.getConfig().setConfigValue(rk::config::write_to_console::KEY, rk::config::write_to_console::DISABLE);
+        logger.addSink(sink);
+        ASSERT_NO_FATAL_FAILURE(Base::startLogger(std::filesystem::path()));
+    }
+
+    void TearDown() override {
+        if (logThread.joinable()) {
+            Base::stopLogger();
+        }
+        undoRedirectStdCout();
+    }
+
+    std::shared_ptr<StringSink> sink = std::make_shared<StringSink>();
+};
+
+} // namespace scope_tests
+} // namespace rk_logger_tests
+
+#endif // #ifndef SCOPE_TESTS_H
@@ -0,0 +1,309 @@
+#include "shm_transport_tests.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+
+namespace rk_logger_tests {
+namespace shm_transport_tests {
+
+TEST_F(ShmRingTest, ReadsRecordsInOrder) {
+    auto writer = rk::shm_internal::RingWriter::create(shmName, SMALL_RING_CAPACITY, APP_LOGGER_NAME, rk::time_internal::TickSource::System);
+    ASSERT_NE(writer, nullptr);
+    auto reader = rk::shm_internal::RingReader::open(shmName);
+    ASSERT_NE(reader, nullptr);
+    ASSERT_EQ(reader->getLoggerName(), APP_LOGGER_NAME);
+    ASSERT_EQ(reader->getTickSource(), rk::time_internal::TickSource::System);
+
+    const rk::log::Record first = createRecord("first\n");
+    ASSERT_TRUE(writer->write(first));
+    ASSERT_TRUE(writer->write(createRecord("second\n")));
+
+    rk::shm_internal::RecordView record;
+    ASSERT_TRUE(reader->read(record));
+    ASSERT_EQ(record.message, "first\n");
+    ASSERT_EQ(record.funcName, "testFunc");
+    ASSERT_EQ(record.level, rk::log::Level::Warn);
+    ASSERT_FALSE(record.isTicks);
+    ASSERT_EQ(record.stamp, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(first.time.time_since_epoch()).count()));
+    std::ostringstream threadId;
+    threadId << std::this_thread::get_id();
+    ASSERT_EQ(record.threadId, threadId.str());
+    ASSERT_TRUE(reader->read(record));
+    ASSERT_EQ(record.message, "second\n");
+    ASSERT_FALSE(reader->read(record));
+}
+
+// Records keep going around the end of the ring, with padding where a record doesn't fit before the end
+TEST_F(ShmRingTest, WrapsAround) {
+    auto writer = rk::shm_internal::RingWriter::create(shmName, SMALL_RING_CAPACITY, APP_LOGGER_NAME, rk::time_internal::TickSource::System);
+    ASSERT_NE(writer, nullptr);
+    auto reader = rk::shm_internal::RingReader::open(shmName);
+    ASSERT_NE(reader, nullptr);
+
+    rk::shm_internal::RecordView record;
+    for (int i = 0; i < 100; i++) {
+        const std::string message = std::string(static_cast<size_t>(i % 7) * 20, 'x') + std::to_string(i) + "\n";
+        ASSERT_TRUE(writer->write(createRecord(message))) << i;
+        ASSERT_TRUE(writer->write(createRecord(message))) << i;
+        ASSERT_TRUE(reader->read(record)) << i;
+        ASSERT_EQ(record.message, message);
+        ASSERT_TRUE(reader->read(record)) << i;
+        ASSERT_EQ(record.message, message);
+    }
+    ASSERT_FALSE(reader->read(record));
+    ASSERT_EQ(writer->getDroppedCount(), 0);
+}
+
+TEST_F(ShmRingTest, DropsWhenFull) {
+    auto writer = rk::shm_internal::RingWriter::create(shmName, SMALL_RING_CAPACITY, APP_LOGGER_NAME, rk::time_internal::TickSource::System);
+    ASSERT_NE(writer, nullptr);
+    auto reader = rk::shm_internal::RingReader::open(shmName);
+    ASSERT_NE(reader, nullptr);
+
+    int writtenCount = 0;
+    while (writer->write(createRecord("message " + std::to_string(writtenCount) + "\n"))) {
+        writtenCount++;
+    }
+    ASSERT_GT(writtenCount, 0);
+    ASSERT_EQ(writer->getDroppedCount(), 1);
+    ASSERT_FALSE(writer->write(createRecord(std::string(SMALL_RING_CAPACITY, 'x'))));
+    ASSERT_EQ(reader->getDroppedCount(), 2);
+
+    rk::shm_internal::RecordView record;
+    for (int i = 0; i < writtenCount; i++) {
+        ASSERT_TRUE(reader->read(record));
+        ASSERT_EQ(record.message, "message " + std::to_string(i) + "\n");
+    }
+    ASSERT_FALSE(reader->read(record));
+    ASSERT_TRUE(writer->write(createRecord("after\n")));
+    ASSERT_TRUE(reader->read(record));
+    ASSERT_EQ(record.message, "after\n");
+}
+
+TEST_F(ShmRingTest, SplicesOwnedAndDeferredArgs) {
+    auto writer = rk::shm_internal::RingWriter::create(shmName, SMALL_RING_CAPACITY, APP_LOGGER_NAME, rk::time_internal::TickSource::System);
+    ASSERT_NE(writer, nullptr);
+    auto reader = rk::shm_internal::RingReader::open(shmName);
+    ASSERT_NE(reader, nullptr);
+
+    rk::log::Record spliced = createRecord("");
+    rk::log_internal::appendArg(spliced, "a=");
+    rk::log_internal::appendArg(spliced, rk::log::owned(std::string("owned")));
+    rk::log_internal::appendArg(spliced, " b=");
+    rk::log_internal::appendArg(spliced, rk::log::defer([] () { return 42; }));
+    rk::log_internal::appendArg(spliced, "\n");
+    ASSERT_TRUE(writer->write(spliced));
+
+    rk::shm_internal::RecordView record;
+    ASSERT_TRUE(reader->read(record));
+    ASSERT_EQ(record.message, "a=owned b=42\n");
+}
+
+// Every record that a thread manages to write is read back, in the order that the thread wrote it
+TEST_F(ShmRingTest, ConcurrentWriters) {
+#if defined(__SANITIZE_THREAD__)
+    // The writer and reader map the ring at different addresses, so ThreadSanitizer can't match up their atomics
+    // within one process
+    GTEST_SKIP() << "Not supported with ThreadSanitizer";
+#endif
+    constexpr int THREAD_COUNT = 4;
+    constexpr int MESSAGES_PER_THREAD = 2000;
+    constexpr size_t RING_CAPACITY = 16 * 1024;
+    auto writer = rk::shm_internal::RingWriter::create(shmName, RING_CAPACITY, APP_LOGGER_NAME, rk::time_internal::TickSource::System);
+    ASSERT_NE(writer, nullptr);
+    auto reader = rk::shm_internal::RingReader::open(shmName);
+    ASSERT_NE(reader, nullptr);
+
+    std::atomic<int> writtenCount{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREAD_COUNT; t++) {
+        threads.emplace_back([&writer, &writtenCount, t] () {
+            for (int i = 0; i < MESSAGES_PER_THREAD; i++) {
+                if (writer->write(createRecord(std::to_string(t) + " " + std::to_string(i)))) {
+                    writtenCount++;
+                }
+            }
+        });
+    }
+
+    std::map<std::string, int> lastByThread;
+    int readCount = 0;
+    rk::shm_internal::RecordView record;
+    auto readAvailable = [&] () {
+        while (reader->read(record)) {
+            const std::string message(record.message);
+            const size_t separator = message.find(' ');
+            const int i = std::stoi(message.substr(separator + 1));
+            auto last = lastByThread.emplace(message.substr(0, separator), -1).first;
+            ASSERT_GT(i, last->second) << message;
+            last->second = i;
+            readCount++;
+        }
+    };
+    while (writtenCount + static_cast<int>(writer->getDroppedCount()) < THREAD_COUNT * MESSAGES_PER_THREAD) {
+        ASSERT_NO_FATAL_FAILURE(readAvailable());
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    ASSERT_NO_FATAL_FAILURE(readAvailable());
+    ASSERT_EQ(readCount, writtenCount);
+}
+
+TEST_F(ShmRingTest, ProducerDoneWhenClosed) {
+    auto writer = rk::shm_internal::RingWriter::create(shmName, SMALL_RING_CAPACITY, APP_LOGGER_NAME, rk::time_internal::TickSource::System);
+    ASSERT_NE(writer, nullptr);
+    auto reader = rk::shm_internal::RingReader::open(shmName);
+    ASSERT_NE(reader, nullptr);
+    ASSERT_FALSE(reader->isProducerDone());
+    writer->close();
+    ASSERT_TRUE(reader->isProducerDone());
+}
+
+// Each process that writes to the ring has to be done, not just the one that created it
+TEST_F(ShmRingTest, ProducerDoneWhenEveryProcessIsDone) {
+    auto writer = rk::shm_internal::RingWriter::create(shmName, SMALL_RING_CAPACITY, APP_LOGGER_NAME, rk::time_internal::TickSource::System);
+    ASSERT_NE(writer, nullptr);
+    auto reader = rk::shm_internal::RingReader::open(shmName);
+    ASSERT_NE(reader, nullptr);
+
+    writer->prepareForFork();
+    const pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        _exit(writer->restartAfterFork() ? 0 : 1);
+    }
+    int status = 0;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+
+    writer->close();
+    ASSERT_TRUE(reader->isProducerDone()) << "The child exited without closing the ring";
+    writer->prepareForFork(); // Reuses the slot of the child that exited
+    ASSERT_FALSE(reader->isProducerDone());
+}
+
+// An entry that was reserved but never committed only holds up the reader until the producer is done
+TEST_F(ShmRingTest, SkipsEntryOfDeadProducer) {
+    auto writer = rk::shm_internal::RingWriter::create(shmName, SMALL_RING_CAPACITY, APP_LOGGER_NAME, rk::time_internal::TickSource::System);
+    ASSERT_NE(writer, nullptr);
+    auto reader = rk::shm_internal::RingReader::open(shmName);
+    ASSERT_NE(reader, nullptr);
+    ASSERT_TRUE(writer->write(createRecord("first\n")));
+    ASSERT_TRUE(writer->write(createRecord("torn\n")));
+    ASSERT_TRUE(writer->write(createRecord("third\n")));
+
+    constexpr uint32_t COMMITTED_BIT = 0x80000000;
+    std::atomic<uint32_t>* firstState = mapEntryState(0);
+    ASSERT_NE(firstState, nullptr);
+    std::atomic<uint32_t>* tornState = mapEntryState(firstState->load() & ~COMMITTED_BIT);
+    tornState->store(tornState->load() & ~COMMITTED_BIT); // As if the producer died before committing it
+
+    rk::shm_internal::RecordView record;
+    ASSERT_TRUE(reader->read(record));
+    ASSERT_EQ(record.message, "first\n");
+    ASSERT_FALSE(reader->read(record, reader->isProducerDone()));
+    writer->close();
+    ASSERT_TRUE(reader->read(record, reader->isProducerDone()));
+    ASSERT_EQ(record.message, "third\n");
+    ASSERT_FALSE(reader->read(record, true));
+    ASSERT_EQ(reader->getLostCount(), 1);
+}
+
+// Without the size of the entry, everything that was reserved after it is skipped too
+TEST_F(ShmRingTest, SkipsRestOfRingWithoutEntrySize) {
+    auto writer = rk::shm_internal::RingWriter::create(shmName, SMALL_RING_CAPACITY, APP_LOGGER_NAME, rk::time_internal::TickSource::System);
+    ASSERT_NE(writer, nullptr);
+    auto reader = rk::shm_internal::RingReader::open(shmName);
+    ASSERT_NE(reader, nullptr);
+    ASSERT_TRUE(writer->write(createRecord("torn\n")));
+    ASSERT_TRUE(writer->write(createRecord("second\n")));
+    std::atomic<uint32_t>* tornState = mapEntryState(0);
+    ASSERT_NE(tornState, nullptr);
+    tornState->store(0); // As if the producer died right after reserving it
+    writer->close();
+
+    rk::shm_internal::RecordView record;
+    ASSERT_FALSE(reader->read(record, true));
+    ASSERT_EQ(reader->getLostCount(), 1);
+    ASSERT_TRUE(writer->write(createRecord("after\n")));
+    ASSERT_TRUE(reader->read(record, true));
+    ASSERT_EQ(record.message, "after\n");
+}
+
+TEST_F(ShmRingTest, OpenFailsWithoutRing) {
+    ASSERT_EQ(rk::shm_internal::RingReader::open(shmName), nullptr);
+}
+
+TEST_F(ShmTransportTest, AgentWritesApplicationLog) {
+    constexpr int MESSAGE_COUNT = 1000;
+    ASSERT_NO_FATAL_FAILURE(runApplicationAndAgent(MESSAGE_COUNT, true));
+    ASSERT_NO_FATAL_FAILURE(checkMessages(MESSAGE_COUNT));
+}
+
+// Records that were committed to the ring are written even if the application exits without stopping its logger
+TEST_F(ShmTransportTest, AgentWritesLogOfCrashedApplication) {
+    constexpr int MESSAGE_COUNT = 1000;
+    ASSERT_NO_FATAL_FAILURE(runApplicationAndAgent(MESSAGE_COUNT, false));
+    ASSERT_NO_FATAL_FAILURE(checkMessages(MESSAGE_COUNT));
+}
+
+// The application stops its logger before its child has logged anything, so the agent has to keep going for the child
+TEST_F(ShmTransportTest, AgentWritesLogOfForkedChild) {
+    if (IS_THREAD_SANITIZER_ENABLED || IS_ADDRESS_SANITIZER_ENABLED) {
+        GTEST_SKIP() << "The sanitizers don't support starting threads in the child of a multi-threaded process";
+    }
+    constexpr int MESSAGE_COUNT = 100;
+    const pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        rk::log::Logger appLogger(APP_LOGGER_NAME);
+        appLogger.getConfig().setConfigValue(rk::config::log_transport::KEY, rk::config::log_transport::SHARED_MEMORY);
+        appLogger.getConfig().setConfigValue(rk::config::shm_name::KEY, shmName);
+        appLogger.startOwned(std::filesystem::path());
+        for (int i = 0; i < MESSAGE_COUNT; i++) {
+            RK_LOG_TO(appLogger, "parent message ", i, "\n");
+        }
+        const pid_t childPid = fork();
+        if (childPid == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            for (int i = 0; i < MESSAGE_COUNT; i++) {
+                RK_LOG_TO(appLogger, "child message ", i, "\n");
+            }
+            appLogger.stop();
+            _exit(0);
+        }
+        appLogger.stop();
+        int childStatus = 0;
+        _exit(childPid > 0 && waitpid(childPid, &childStatus, 0) == childPid && WIFEXITED(childStatus) ? 0 : 1);
+    }
+
+    rk::log::LogAgent agent(shmName, *agentConfig);
+    agent.addSink(output);
+    const bool isAttached = agent.attach(std::chrono::seconds(10));
+    std::thread agentThread([&agent] () {
+        agent.run();
+    });
+    int status = 0;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    agentThread.join();
+    ASSERT_TRUE(isAttached);
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+
+    SCOPED_TRACE("The agent wrote the messages of both processes");
+    ASSERT_EQ(agent.getWrittenCount(), static_cast<uint64_t>(2 * MESSAGE_COUNT));
+    const std::string log = output->str();
+    ASSERT_NE(log.find("]parent message " + std::to_string(MESSAGE_COUNT - 1) + "\n"), std::string::npos);
+    ASSERT_NE(log.find("]child message " + std::to_string(MESSAGE_COUNT - 1) + "\n"), std::string::npos);
+}
+
+TEST_F(ShmTransportTest, AgentRemovesRing) {
+    ASSERT_NO_FATAL_FAILURE(runApplicationAndAgent(1, true));
+    ASSERT_EQ(rk::shm_internal::RingReader::open(shmName), nullptr);
+}
+
+} // namespace shm_transport_tests
+} // namespace rk_logger_tests
+
+#endif // #if defined(__unix__) || defined(__APPLE__)
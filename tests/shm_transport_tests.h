@@ -0,0 +1,171 @@
+#ifndef SHM_TRANSPORT_TESTS_H
+#define SHM_TRANSPORT_TESTS_H
+
+#include <rk_logger/logger.h>
+#include <rk_logger/log_agent.h>
+#include <rk_logger/shm_ring.h>
+#include <rk_logger_tests/test_base.h>
+
+#include <map>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace rk_logger_tests {
+namespace shm_transport_tests {
+
+inline const std::string APP_LOGGER_NAME = "shm_app";
+constexpr size_t SMALL_RING_CAPACITY = 1024;
+
+/**
+ * @brief Creates a record like RK_LOG would.
+ */
+inline rk::log::Record createRecord(const std::string& message) {
+    rk::log::Record record;
+    record.time = rk::time_internal::system_clock::now();
+    record.threadId = std::this_thread::get_id();
+    record.funcName = "testFunc";
+    record.level = rk::log::Level::Warn;
+    record.message = message;
+    return record;
+}
+
+class ShmRingTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        rk::shm_internal::removeRing(shmName);
+    }
+
+    void TearDown() override {
+        if (mapping != MAP_FAILED) {
+            munmap(mapping, mappingSize);
+        }
+        rk::shm_internal::removeRing(shmName);
+    }
+
+    /**
+     * @brief Maps the ring again, so a test can change an entry as if its producer had died while writing it.
+     *
+     * @return The state of the entry at an offset in the data area, which holds its size and the committed bit.
+     */
+    std::atomic<uint32_t>* mapEntryState(const size_t offset) {
+        if (mapping == MAP_FAILED) {
+            const int fd = shm_open(shmName.c_str(), O_RDWR, 0);
+            struct stat info{};
+            if (fd < 0 || fstat(fd, &info) != 0) {
+                return nullptr;
+            }
+            mappingSize = static_cast<size_t>(info.st_size);
+            mapping = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            close(fd);
+            if (mapping == MAP_FAILED) {
+                return nullptr;
+            }
+        }
+        const size_t dataOffset = (sizeof(rk::shm_internal::RingHeader) + 63) / 64 * 64;
+        return reinterpret_cast<std::atomic<uint32_t>*>(static_cast<char*>(mapping) + dataOffset + offset);
+    }
+
+    const std::string shmName = "/rk_shm_ring_test_" + std::to_string(getpid());
+    void* mapping = MAP_FAILED;
+    size_t mappingSize = 0;
+};
+
+/**
+ * Runs an application with a logger on the shared-memory transport in a child process, and an agent for it in this one.
+ */
+class ShmTransportTest : public Base {
+protected:
+    void SetUp() override {
+        rk::shm_internal::removeRing(shmName);
+        agentConfig = rk::config::createInstance();
+        agentConfig->setConfigValue(rk::config::write_to_log_file::KEY, rk::config::write_to_log_file::DISABLE);
+        agentConfig->setConfigValue(rk::config::write_to_console::KEY, rk::config::write_to_console::DISABLE);
+        redirectStdCout(); // Also quiets the child, which gets a copy of the redirected stream
+    }
+
+    void TearDown() override {
+        undoRedirectStdCout();
+        rk::shm_internal::removeRing(shmName);
+    }
+
+    /**
+     * @brief Runs in the child process. Logs messageCount messages and exits without returning to the test.
+     *
+     * @param messageCount The number of messages.
+     * @param isStopped Whether the logger is stopped before the process exits. If not, the process exits as if it crashed.
+     */
+    [[noreturn]] void runApplication(const int messageCount, const bool isStopped) {
+        rk::log::Logger appLogger(APP_LOGGER_NAME);
+        appLogger.getConfig().setConfigValue(rk::config::log_transport::KEY, rk::config::log_transport::SHARED_MEMORY);
+        appLogger.getConfig().setConfigValue(rk::config::shm_name::KEY, shmName);
+        std::thread appLogThread = appLogger.start(std::filesystem::path());
+        for (int i = 0; i < messageCount; i++) {
+            RK_LOG_TO(appLogger, "message ", i, "\n");
+        }
+        if (isStopped) {
+            appLogger.stop(std::move(appLogThread));
+        }
+        _exit(0);
+    }
+
+    /**
+     * @brief Forks the application and writes its log with an agent until it is done.
+     *
+     * @param messageCount The number of messages that the application logs.
+     * @param isStopped Whether the application stops its logger before it exits.
+     */
+    void runApplicationAndAgent(const int messageCount, const bool isStopped) {
+        const pid_t pid = fork();
+        ASSERT_GE(pid, 0);
+        if (pid == 0) {
+            runApplication(messageCount, isStopped);
+        }
+
+        rk::log::LogAgent agent(shmName, *agentConfig);
+        agent.addSink(output);
+        const bool isAttached = agent.attach(std::chrono::seconds(10));
+        // The agent runs on its own thread because it only sees that the application exited once it has been reaped
+        std::thread agentThread([&agent] () {
+            agent.run();
+        });
+        int status = 0;
+        ASSERT_EQ(waitpid(pid, &status, 0), pid);
+        agentThread.join();
+        ASSERT_TRUE(isAttached);
+        ASSERT_TRUE(WIFEXITED(status));
+        ASSERT_EQ(agent.getWrittenCount(), static_cast<uint64_t>(messageCount));
+    }
+
+    /**
+     * @brief Checks that the output has the messages from 0 to messageCount - 1 in order, one per line.
+     */
+    void checkMessages(const int messageCount) {
+        std::istringstream lines(output->str());
+        std::string line;
+        int i = 0;
+        while (std::getline(lines, line)) {
+            ASSERT_LT(i, messageCount);
+            const std::string expectedEnd = "][runApplication]message " + std::to_string(i);
+            ASSERT_GE(line.size(), expectedEnd.size());
+            ASSERT_EQ(line.substr(line.size() - expectedEnd.size()), expectedEnd) << line;
+            i++;
+        }
+        ASSERT_EQ(i, messageCount);
+    }
+
+    const std::string shmName = "/rk_shm_transport_test_" + std::to_string(getpid());
+    std::unique_ptr<rk::config::Config> agentConfig;
+    std::shared_ptr<StringSink> output = std::make_shared<StringSink>();
+};
+
+} // namespace shm_transport_tests
+} // namespace rk_logger_tests
+
+#endif // #if defined(__unix__) || defined(__APPLE__)
+
+#endif // #ifndef SHM_TRANSPORT_TESTS_H
@@ -0,0 +1,139 @@
+#include "shutdown_tests.h"
+
+namespace rk_logger_tests {
+namespace shutdown_tests {
+
+TEST_F(ShutdownTest, StartOwnedAndStop) {
+    logger.startOwned(std::filesystem::path());
+    ASSERT_TRUE(logger.isRunning());
+    for (int i = 0; i < 100; i++) {
+        RK_LOG_TO(logger, "message ", i, "\n");
+    }
+    logger.stop();
+
+    ASSERT_FALSE(logger.isRunning());
+    const std::string output = sink->str();
+    ASSERT_EQ(countOccurrences(output, "message "), 100);
+    ASSERT_NE(output.find("message 99\n"), std::string::npos);
+
+    SCOPED_TRACE("Stopping again does nothing");
+    logger.stop();
+    ASSERT_FALSE(logger.isRunning());
+}
+
+TEST_F(ShutdownTest, StartOwnedTwice) {
+    logger.startOwned(std::filesystem::path());
+    logger.startOwned(std::filesystem::path());
+    ASSERT_TRUE(logger.isRunning());
+    logger.stop();
+    ASSERT_FALSE(logger.isRunning());
+}
+
+// Starting a running logger again leaves its config, sinks, and log thread alone
+TEST_F(ShutdownTest, StartTwice) {
+    std::thread firstLogThread = logger.start(std::filesystem::path());
+    RK_LOG_TO(logger, "first\n");
+    std::thread secondLogThread = logger.start(std::filesystem::path());
+    ASSERT_FALSE(secondLogThread.joinable());
+    ASSERT_TRUE(logger.isRunning());
+    RK_LOG_TO(logger, "second\n");
+    logger.stop(std::move(firstLogThread));
+
+    ASSERT_FALSE(logger.isRunning());
+    const std::string output = sink->str();
+    ASSERT_EQ(countOccurrences(output, "first\n"), 1);
+    ASSERT_EQ(countOccurrences(output, "second\n"), 1);
+}
+
+TEST_F(ShutdownTest, ScopedLogger) {
+    {
+        rk::log::ScopedLogger scopedLogger(logger, std::filesystem::path());
+        ASSERT_TRUE(logger.isRunning());
+        RK_LOG_TO(logger, "scoped\n");
+    }
+    ASSERT_FALSE(logger.isRunning());
+    ASSERT_NE(sink->str().find("scoped\n"), std::string::npos);
+}
+
+TEST_F(ShutdownTest, DestructorStopsLogger) {
+    {
+        rk::log::Logger scopedLogger(TEST_LOGGER_NAME);
+        configure(scopedLogger);
+        scopedLogger.addSink(sink);
+        scopedLogger.startOwned(std::filesystem::path());
+        RK_LOG_TO(scopedLogger, "destroyed while running\n");
+    }
+    ASSERT_NE(sink->str().find("destroyed while running\n"), std::string::npos);
+}
+
+// stop() can't join a thread that the caller owns, so it waits for it to finish instead
+TEST_F(ShutdownTest, StopWithoutThread) {
+    ASSERT_NO_FATAL_FAILURE(Base::startLogger(std::filesystem::path()));
+    RK_LOG_TO(logger, "legacy\n");
+    logger.stop();
+
+    ASSERT_FALSE(logger.isRunning());
+    ASSERT_NE(sink->str().find("legacy\n"), std::string::npos);
+    logThread.join();
+}
+
+TEST_F(ShutdownTest, StopAllLoggers) {
+    rk::log::Logger otherLogger("other");
+    configure(otherLogger);
+    auto otherSink = std::make_shared<StringSink>();
+    otherLogger.addSink(otherSink);
+
+    logger.startOwned(std::filesystem::path());
+    otherLogger.startOwned(std::filesystem::path());
+    RK_LOG_TO(logger, "first logger\n");
+    RK_LOG_TO(otherLogger, "second logger\n");
+    rk::log::stopAllLoggers();
+
+    ASSERT_FALSE(logger.isRunning());
+    ASSERT_FALSE(otherLogger.isRunning());
+    ASSERT_NE(sink->str().find("first logger\n"), std::string::npos);
+    ASSERT_NE(otherSink->str().find("second logger\n"), std::string::npos);
+}
+
+TEST_F(ShutdownTest, UnlimitedDrainWritesEverything) {
+    logger.startOwned(std::filesystem::path());
+    buildBacklog();
+    stopWithBacklog();
+
+    ASSERT_EQ(countOccurrences(sink->str(), "backlog "), BACKLOG_SIZE);
+    ASSERT_EQ(sink->str().find("dropped"), std::string::npos);
+}
+
+TEST_F(ShutdownTest, DrainTimeUpDropsLeftovers) {
+    logger.getConfig().setConfigValue(rk::config::shutdown_drain_ms::KEY, "0");
+    logger.startOwned(std::filesystem::path());
+    buildBacklog();
+    stopWithBacklog();
+
+    const std::string output = sink->str();
+    ASSERT_NE(output.find("first\n"), std::string::npos);
+    ASSERT_EQ(countOccurrences(output, "backlog "), 0);
+    ASSERT_NE(output.find(std::to_string(BACKLOG_SIZE) + " messages were dropped"), std::string::npos);
+    ASSERT_TRUE(findSpillFiles().empty());
+}
+
+TEST_F(ShutdownTest, DrainTimeUpSpillsLeftovers) {
+    logger.getConfig().setConfigValue(rk::config::shutdown_drain_ms::KEY, "0");
+    logger.getConfig().setConfigValue(rk::config::shutdown_leftovers::KEY, rk::config::shutdown_leftovers::SPILL);
+    logger.startOwned(std::filesystem::path());
+    buildBacklog();
+    stopWithBacklog();
+
+    ASSERT_EQ(countOccurrences(sink->str(), "backlog "), 0);
+    ASSERT_EQ(sink->str().find("dropped"), std::string::npos);
+    const std::vector<std::filesystem::path> spillFiles = findSpillFiles();
+    ASSERT_EQ(spillFiles.size(), 1);
+    std::ifstream file(spillFiles[0], std::ios::binary);
+    const std::string spilled((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    ASSERT_EQ(countOccurrences(spilled, "backlog "), BACKLOG_SIZE);
+    ASSERT_NE(spilled.find("backlog 0\n"), std::string::npos);
+    ASSERT_NE(spilled.find("backlog " + std::to_string(BACKLOG_SIZE - 1) + "\n"), std::string::npos);
+}
+
+} // namespace shutdown_tests
+} // namespace rk_logger_tests
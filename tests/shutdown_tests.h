@@ -0,0 +1,130 @@
+#ifndef SHUTDOWN_TESTS_H
+#define SHUTDOWN_TESTS_H
+
+#include <condition_variable>
+#include <fstream>
+
+#include <rk_logger/logger.h>
+#include <rk_logger_tests/test_base.h>
+
+namespace rk_logger_tests {
+namespace shutdown_tests {
+
+inline const std::string SPILL_FILE_PREFIX = "logs_" + TEST_LOGGER_NAME + "_";
+inline const std::string SPILL_FILE_SUFFIX = "_unwritten.txt";
+inline const std::chrono::milliseconds TIME_FOR_STOP_TO_BEGIN = std::chrono::milliseconds(200);
+inline constexpr int BACKLOG_SIZE = 1000;
+
+/**
+ * A sink that blocks its first write until it is opened, so tests can build up a backlog in the queue.
+ */
+class GateSink : public StringSink {
+public:
+    void write(const std::string& message) override {
+        {
+            std::unique_lock<std::mutex> lock(gateMutex);
+            isEntered = true;
+            gateCv.notify_all();
+            gateCv.wait(lock, [this] () { return isOpen; });
+        }
+        StringSink::write(message);
+    }
+
+    void waitUntilEntered() {
+        std::unique_lock<std::mutex> lock(gateMutex);
+        gateCv.wait(lock, [this] () { return isEntered; });
+    }
+
+    void open() {
+        std::lock_guard<std::mutex> lock(gateMutex);
+        isOpen = true;
+        gateCv.notify_all();
+    }
+private:
+    std::mutex gateMutex;
+    std::condition_variable gateCv;
+    bool isEntered = false;
+    bool isOpen = false;
+};
+
+class ShutdownTest : public Base {
+protected:
+    void SetUp() override {
+        redirectStdCout();
+        removeSpillFiles();
+        configure(logger);
+        logger.addSink(sink);
+    }
+
+    void TearDown() override {
+        if (logThread.joinable()) {
+            Base::stopLogger();
+        }
+        logger.stop();
+        undoRedirectStdCout();
+        removeSpillFiles();
+    }
+
+    static void configure(rk::log::Logger& toConfigure) {
+        toConfigure.getConfig().setConfigValue(rk::config::write_to_log_file::KEY, rk::config::write_to_log_file::DISABLE);
+        toConfigure.getConfig().setConfigValue(rk::config::write_to_console::KEY, rk::config::write_to_console::DISABLE);
+    }
+
+    /**
+     * @brief Logs one message and waits until the log thread is stuck writing it to the gate sink, then logs a
+     * backlog of messages behind it.
+     */
+    void buildBacklog() {
+        logger.addSink(gate);
+        RK_LOG_TO(logger, "first\n");
+        gate->waitUntilEntered();
+        for (int i = 0; i < BACKLOG_SIZE; i++) {
+            RK_LOG_TO(logger, "backlog ", i, "\n");
+        }
+    }
+
+    /**
+     * @brief Stops the logger while the gate sink is still closed, so the drain time starts before the backlog can
+     * be written.
+     */
+    void stopWithBacklog() {
+        std::thread stopper([this] () { logger.stop(); });
+        std::this_thread::sleep_for(TIME_FOR_STOP_TO_BEGIN);
+        gate->open();
+        stopper.join();
+    }
+
+    static std::vector<std::filesystem::path> findSpillFiles() {
+        std::vector<std::filesystem::path> paths;
+        for (const auto& entry : std::filesystem::directory_iterator(std::filesystem::current_path())) {
+            const std::string fileName = entry.path().filename().string();
+            if (fileName.rfind(SPILL_FILE_PREFIX, 0) == 0 && fileName.size() > SPILL_FILE_SUFFIX.size() &&
+                fileName.compare(fileName.size() - SPILL_FILE_SUFFIX.size(), SPILL_FILE_SUFFIX.size(), SPILL_FILE_SUFFIX) == 0) {
+                paths.push_back(entry.path());
+            }
+        }
+        return paths;
+    }
+
+    static void removeSpillFiles() {
+        for (const auto& path : findSpillFiles()) {
+            std::filesystem::remove(path);
+        }
+    }
+
+    static size_t countOccurrences(const std::string& text, const std::string& substring) {
+        size_t count = 0;
+        for (size_t pos = text.find(substring); pos != std::string::npos; pos = text.find(substring, pos + 1)) {
+            count++;
+        }
+        return count;
+    }
+
+    std::shared_ptr<StringSink> sink = std::make_shared<StringSink>();
+    std::shared_ptr<GateSink> gate = std::make_shared<GateSink>();
+};
+
+} // namespace shutdown_tests
+} // namespace rk_logger_tests
+
+#endif // #ifndef SHUTDOWN_TESTS_H
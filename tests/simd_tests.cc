@@ -0,0 +1,173 @@
+#include <charconv>
+#include <climits>
+#include <cstdint>
+#include <limits>
+
+#include <rk_logger/log_time.h>
+#include <rk_logger/simd.h>
+#include "simd_tests.h"
+
+namespace rk_logger_tests {
+namespace simd_tests {
+
+namespace {
+
+constexpr int64_t FEB_4_2025_20_30_UTC_NS = 1738701000LL * 1000000000LL; // Feb 4, 2025 at 8:30PM UTC
+constexpr int64_t FRACTION_NS = 123456789;
+
+template<typename T>
+std::string toCharsString(const T value) {
+    char digits[24];
+    const std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+    return std::string(digits, result.ptr);
+}
+
+template<typename T>
+std::string appendIntegerString(const T value) {
+    std::string out;
+    rk::simd_internal::appendInteger(out, value);
+    return out;
+}
+
+} // namespace
+
+TEST_P(SimdTest, RendersEveryDigitPair) {
+    for (uint16_t first = 0; first < 100; first += rk::simd_internal::DIGIT_PAIR_BATCH) {
+        uint16_t values[rk::simd_internal::DIGIT_PAIR_BATCH] = {};
+        size_t count = 0;
+        for (; count < rk::simd_internal::DIGIT_PAIR_BATCH && first + count < 100; count++) {
+            values[count] = static_cast<uint16_t>(first + count);
+        }
+        char out[2 * rk::simd_internal::DIGIT_PAIR_BATCH];
+        rk::simd_internal::renderDigitPairs(values, count, out);
+        for (size_t i = 0; i < count; i++) {
+            const char expected[2] = { static_cast<char>('0' + values[i] / 10), static_cast<char>('0' + values[i] % 10) };
+            ASSERT_EQ(std::string(out + 2 * i, 2), std::string(expected, 2)) << "Value " << values[i];
+        }
+    }
+}
+
+// Every number of digits, and the numbers around each power of ten, have to give the same output as std::to_chars
+TEST_P(SimdTest, RenderUnsignedMatchesToChars) {
+    auto check = [] (const uint64_t value) {
+        char out[rk::simd_internal::MAX_UNSIGNED_DIGITS];
+        const size_t size = rk::simd_internal::renderUnsigned(value, out);
+        ASSERT_EQ(std::string(out, size), toCharsString(value));
+    };
+    check(0);
+    check(std::numeric_limits<uint64_t>::max());
+    uint64_t powerOfTen = 1;
+    for (int digits = 1; digits < 20; digits++) {
+        check(powerOfTen - 1);
+        check(powerOfTen);
+        check(powerOfTen + 1);
+        check(powerOfTen * 10 - 1);
+        powerOfTen *= 10;
+    }
+    check(powerOfTen);
+    uint64_t value = 0x9e3779b97f4a7c15;
+    for (int i = 0; i < 10000; i++) {
+        value = value * 6364136223846793005ULL + 1442695040888963407ULL;
+        check(value);
+        check(value >> (i % 64));
+    }
+}
+
+TEST_P(SimdTest, AppendIntegerMatchesToChars) {
+    ASSERT_EQ(appendIntegerString(std::numeric_limits<int64_t>::min()), toCharsString(std::numeric_limits<int64_t>::min()));
+    ASSERT_EQ(appendIntegerString(std::numeric_limits<int64_t>::max()), toCharsString(std::numeric_limits<int64_t>::max()));
+    ASSERT_EQ(appendIntegerString(std::numeric_limits<int32_t>::min()), toCharsString(std::numeric_limits<int32_t>::min()));
+    ASSERT_EQ(appendIntegerString(static_cast<int16_t>(SHRT_MIN)), toCharsString(static_cast<int16_t>(SHRT_MIN)));
+    ASSERT_EQ(appendIntegerString(static_cast<uint16_t>(USHRT_MAX)), toCharsString(static_cast<uint16_t>(USHRT_MAX)));
+    ASSERT_EQ(appendIntegerString(-1), "-1");
+    ASSERT_EQ(appendIntegerString(-10), "-10");
+    ASSERT_EQ(appendIntegerString(0), "0");
+    ASSERT_EQ(appendIntegerString(7u), "7");
+    ASSERT_EQ(appendIntegerString(ULLONG_MAX), toCharsString(ULLONG_MAX));
+}
+
+// A match has to be found at every position, whether it is in a vector-sized block or in the tail after the blocks
+TEST_P(SimdTest, FindAnyOfFindsFirstMatch) {
+    const std::string_view chars = "[]|: ";
+    for (size_t size = 0; size <= 100; size++) {
+        const std::string noMatch(size, 'x');
+        ASSERT_EQ(rk::simd_internal::findAnyOf(noMatch, chars), size);
+        for (size_t pos = 0; pos < size; pos++) {
+            std::string text = noMatch;
+            text[pos] = chars[pos % chars.size()];
+            if (pos + 1 < size) {
+                text[size - 1] = ':'; // A later match must not be reported instead
+            }
+            ASSERT_EQ(rk::simd_internal::findAnyOf(text, chars), pos) << "Size " << size;
+        }
+    }
+}
+
+// Every size up to a full mask, so the blocks, the overlapping tail, and the copied tail are all covered
+TEST_P(SimdTest, MatchAnyOfMarksEveryMatch) {
+    const std::string_view chars = "[]|: ";
+    for (size_t size = 0; size <= rk::simd_internal::MAX_MATCH_SIZE; size++) {
+        std::string text(size + 1, 'x');
+        text[size] = ':'; // Past the end, so it must not be marked
+        uint64_t expected = 0;
+        for (size_t pos = 0; pos < size; pos += 1 + size % 5) {
+            text[pos] = chars[pos % chars.size()];
+            expected |= uint64_t(1) << pos;
+        }
+        ASSERT_EQ(rk::simd_internal::matchAnyOf(text.data(), size, chars), expected) << "Size " << size;
+    }
+    const std::string longText(100, ' ');
+    ASSERT_EQ(rk::simd_internal::matchAnyOf(longText.data(), longText.size(), chars), ~uint64_t(0));
+}
+
+TEST_P(SimdTest, FindAnyOfManyChars) {
+    ASSERT_EQ(rk::simd_internal::findAnyOf("abcdefghijklmnopqrstuvwxyz0123456789", "0123456789"), 26);
+    ASSERT_EQ(rk::simd_internal::findAnyOf("abc", ""), 3);
+}
+
+// Each level has to give the same timestamps, including the digits that are dropped from the scaled fractions
+TEST_P(SimdTest, TimeStampsMatchAcrossLevels) {
+    std::unique_ptr<rk::config::Config> config = rk::config::createInstance();
+    config->setConfigValue(rk::config::time_zone::KEY, rk::config::time_zone::UTC);
+    config->setConfigValue(rk::config::date_format::KEY, rk::config::date_format::YYYY_MM_DD);
+    config->setConfigValue(rk::config::hour_format::KEY, rk::config::hour_format::TWENTY_FOUR_HOUR);
+    rk::time_internal::TimeStampFormatter formatter;
+    const rk::time_internal::time_point time{std::chrono::duration_cast<rk::time_internal::system_clock::duration>(
+        std::chrono::nanoseconds(FEB_4_2025_20_30_UTC_NS + FRACTION_NS))};
+
+    auto check = [&] (const rk::config::ConfigValue& precision, const std::string& expected) {
+        config->setConfigValue(rk::config::timestamp_precision::KEY, precision);
+        formatter.updateTimeStampFuncs(*config);
+        ASSERT_EQ(formatter.generateTimeStamp(time), expected);
+    };
+    check(rk::config::timestamp_precision::MS, "[2025-02-04|20:30:00.123]");
+    check(rk::config::timestamp_precision::US, "[2025-02-04|20:30:00.123456]");
+    check(rk::config::timestamp_precision::NS, "[2025-02-04|20:30:00.123456789]");
+    check(rk::config::timestamp_precision::EPOCH_NS, "[1738701000123456789]");
+
+    config->setConfigValue(rk::config::month_format::KEY, rk::config::month_format::MONTH_NAME);
+    config->setConfigValue(rk::config::date_format::KEY, rk::config::date_format::DD_MM_YYYY);
+    config->setConfigValue(rk::config::hour_format::KEY, rk::config::hour_format::TWELVE_HOUR);
+    check(rk::config::timestamp_precision::MS, "[04-Feb-2025|08:30:00.123 PM]");
+}
+
+TEST_P(SimdTest, ConvertTimeStampForFileName) {
+    ASSERT_EQ(rk::time_internal::convertTimeStampForFileName("[02-04-2025|08:30:00.123456789 PM]"), "02-04-2025_08-30-00.123456789PM");
+    ASSERT_EQ(rk::time_internal::convertTimeStampForFileName("[[]]||::  "), "__--");
+    ASSERT_EQ(rk::time_internal::convertTimeStampForFileName(""), "");
+}
+
+INSTANTIATE_TEST_SUITE_P(SimdTest,
+    SimdTest,
+    testing::Values(
+        SimdTestParam("scalar", rk::simd_internal::SimdLevel::Scalar),
+        SimdTestParam("sse2", rk::simd_internal::SimdLevel::Sse2),
+        SimdTestParam("avx2", rk::simd_internal::SimdLevel::Avx2)
+    ),
+    [](const testing::TestParamInfo<SimdTestParam>& info) {
+        return info.param.description;
+    }
+);
+
+} // namespace simd_tests
+} // namespace rk_logger_tests
@@ -0,0 +1,40 @@
+#ifndef SIMD_TESTS_H
+#define SIMD_TESTS_H
+
+#include <rk_logger/simd.h>
+#include <rk_logger_tests/test_base.h>
+
+namespace rk_logger_tests {
+namespace simd_tests {
+
+struct SimdTestParam : public BaseParam {
+    SimdTestParam(const std::string description, const rk::simd_internal::SimdLevel level)
+        : BaseParam(description), level(level) {};
+
+    const rk::simd_internal::SimdLevel level;
+};
+
+/**
+ * Runs a test with the kernels of one level. Levels that the CPU doesn't support are skipped.
+ */
+class SimdTest : public ::testing::TestWithParam<SimdTestParam> {
+protected:
+    void SetUp() override {
+        originalLevel = rk::simd_internal::getSimdLevel();
+        if (GetParam().level > rk::simd_internal::getSupportedSimdLevel()) {
+            GTEST_SKIP() << rk::simd_internal::simdLevelToString(GetParam().level) << " isn't supported by this CPU";
+        }
+        rk::simd_internal::setSimdLevel(GetParam().level);
+    }
+
+    void TearDown() override {
+        rk::simd_internal::setSimdLevel(originalLevel);
+    }
+
+    rk::simd_internal::SimdLevel originalLevel;
+};
+
+} // namespace simd_tests
+} // namespace rk_logger_tests
+
+#endif // #ifndef SIMD_TESTS_H
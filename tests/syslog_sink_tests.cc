@@ -0,0 +1,172 @@
+#include <thread>
+
+#include "syslog_sink_tests.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+
+namespace rk_logger_tests {
+namespace syslog_sink_tests {
+
+TEST_F(SyslogSinkTest, Rfc5424Format) {
+    rk::log::SyslogSink sink(rk::log::SyslogSink::Format::Rfc5424, server.path, TEST_IDENTIFIER);
+    ASSERT_TRUE(sink.isConnected());
+    sink.writeWithLevel("[time][thread][func]hello\n", rk::log::Level::Info);
+    sink.flush();
+
+    const std::string datagram = server.receive();
+    ASSERT_EQ(datagram.rfind("<14>1 - ", 0), 0) << datagram; // Facility user (1) * 8 + severity info (6)
+    const std::string end = " " + TEST_IDENTIFIER + " " + pid + " - - [time][thread][func]hello";
+    ASSERT_GE(datagram.size(), end.size());
+    ASSERT_EQ(datagram.substr(datagram.size() - end.size()), end) << datagram;
+}
+
+TEST_F(SyslogSinkTest, SeverityMapping) {
+    constexpr int FACILITY_LOCAL0 = 16;
+    const std::vector<std::pair<rk::log::Level, int>> expected = {
+        { rk::log::Level::Trace, 7 },
+        { rk::log::Level::Debug, 7 },
+        { rk::log::Level::Info, 6 },
+        { rk::log::Level::Warn, 4 },
+        { rk::log::Level::Error, 3 },
+        { rk::log::Level::Fatal, 2 },
+    };
+    rk::log::SyslogSink sink(rk::log::SyslogSink::Format::Rfc5424, server.path, TEST_IDENTIFIER, FACILITY_LOCAL0);
+    for (const auto& levelAndSeverity : expected) {
+        sink.writeWithLevel("message\n", levelAndSeverity.first);
+    }
+    sink.flush();
+
+    for (const auto& levelAndSeverity : expected) {
+        SCOPED_TRACE(rk::log::levelToString(levelAndSeverity.first));
+        ASSERT_EQ(rk::log::SyslogSink::toSeverity(levelAndSeverity.first), levelAndSeverity.second);
+        const std::string priority = "<" + std::to_string(FACILITY_LOCAL0 * 8 + levelAndSeverity.second) + ">";
+        ASSERT_EQ(server.receive().rfind(priority, 0), 0);
+    }
+}
+
+TEST_F(SyslogSinkTest, JournaldFormat) {
+    rk::log::SyslogSink sink(rk::log::SyslogSink::Format::Journald, server.path, TEST_IDENTIFIER);
+    sink.writeWithLevel("[time][thread][func]hello\n", rk::log::Level::Error);
+    sink.flush();
+
+    ASSERT_EQ(server.receive(), "PRIORITY=3\nSYSLOG_FACILITY=1\nSYSLOG_IDENTIFIER=" + TEST_IDENTIFIER + "\nMESSAGE=[time][thread][func]hello\n");
+}
+
+// A message with a newline in it is sent with journald's binary field format
+TEST_F(SyslogSinkTest, JournaldMultilineMessage) {
+    rk::log::SyslogSink sink(rk::log::SyslogSink::Format::Journald, server.path, TEST_IDENTIFIER);
+    sink.writeWithLevel("line 1\nline 2\n", rk::log::Level::Info);
+    sink.flush();
+
+    const std::string size("\x0d\0\0\0\0\0\0\0", 8); // 13 bytes as a 64-bit little-endian integer
+    ASSERT_EQ(server.receive(), "PRIORITY=6\nSYSLOG_FACILITY=1\nSYSLOG_IDENTIFIER=" + TEST_IDENTIFIER + "\nMESSAGE\n" + size + "line 1\nline 2\n");
+}
+
+// More messages than fit in one sendmmsg() call, or in the receiver's queue, arrive in order
+TEST_F(SyslogSinkTest, LargeBatch) {
+    constexpr int MESSAGE_COUNT = 200;
+    std::vector<std::string> received;
+    std::thread receiver([this, &received] () {
+        for (int i = 0; i < MESSAGE_COUNT; i++) {
+            received.push_back(server.receive());
+        }
+    });
+    rk::log::SyslogSink sink(rk::log::SyslogSink::Format::Journald, server.path, TEST_IDENTIFIER);
+    for (int i = 0; i < MESSAGE_COUNT; i++) {
+        sink.write("message " + std::to_string(i) + "\n");
+    }
+    sink.flush();
+    receiver.join();
+
+    ASSERT_EQ(sink.getDroppedCount(), 0);
+    for (int i = 0; i < MESSAGE_COUNT; i++) {
+        ASSERT_NE(received[i].find("\nMESSAGE=message " + std::to_string(i) + "\n"), std::string::npos) << received[i];
+    }
+}
+
+// When nothing reads from the socket, the messages that don't fit are dropped instead of blocking
+TEST_F(SyslogSinkTest, FullQueueDropsMessages) {
+    constexpr int MESSAGE_COUNT = 2000;
+    rk::log::SyslogSink sink(rk::log::SyslogSink::Format::Rfc5424, server.path, TEST_IDENTIFIER);
+    for (int i = 0; i < MESSAGE_COUNT; i++) {
+        sink.write("message\n");
+    }
+    sink.flush();
+
+    ASSERT_GT(sink.getDroppedCount(), 0);
+    ASSERT_LT(sink.getDroppedCount(), MESSAGE_COUNT);
+    ASSERT_TRUE(sink.isConnected());
+}
+
+TEST_F(SyslogSinkTest, MissingSocket) {
+    server.stop();
+    rk::log::SyslogSink sink(rk::log::SyslogSink::Format::Rfc5424, server.path, TEST_IDENTIFIER);
+    ASSERT_FALSE(sink.isConnected());
+    sink.write("dropped 1\n");
+    sink.write("dropped 2\n");
+    ASSERT_NO_THROW(sink.flush());
+    ASSERT_EQ(sink.getDroppedCount(), 2);
+}
+
+// The sink connects once the socket is there, e.g., after the syslog daemon has started
+TEST_F(SyslogSinkTest, ConnectsWhenSocketAppears) {
+    server.stop();
+    rk::log::SyslogSink sink(rk::log::SyslogSink::Format::Rfc5424, server.path, TEST_IDENTIFIER);
+    ASSERT_FALSE(sink.isConnected());
+    ASSERT_NO_FATAL_FAILURE(server.start());
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100)); // Connecting is retried at most once per second
+
+    sink.write("hello\n");
+    sink.flush();
+    ASSERT_TRUE(sink.isConnected());
+    ASSERT_NE(server.receive().find(" - - hello"), std::string::npos);
+}
+
+// A forked child tags its messages with its own process id, not the one that the sink was created with
+TEST_F(SyslogSinkTest, ForkedChildProcessId) {
+    rk::log::SyslogSink sink(rk::log::SyslogSink::Format::Rfc5424, server.path, TEST_IDENTIFIER);
+    sink.write("parent\n");
+    sink.flush();
+
+    const pid_t childPid = fork();
+    ASSERT_GE(childPid, 0);
+    if (childPid == 0) {
+        sink.write("child\n");
+        sink.flush();
+        _exit(0);
+    }
+    int status = 0;
+    ASSERT_EQ(waitpid(childPid, &status, 0), childPid);
+
+    ASSERT_NE(server.receive().find(" " + TEST_IDENTIFIER + " " + pid + " - - parent"), std::string::npos);
+    const std::string datagram = server.receive();
+    ASSERT_NE(datagram.find(" " + TEST_IDENTIFIER + " " + std::to_string(childPid) + " - - child"), std::string::npos) << datagram;
+}
+
+TEST_F(SyslogLoggerTest, LoggerSendsToSyslog) {
+    logger.getConfig().setConfigValue(rk::config::write_to_syslog::KEY, rk::config::write_to_syslog::RFC5424);
+    ASSERT_NO_FATAL_FAILURE(Base::startLogger(std::filesystem::path()));
+    RK_LOG_TO(logger, "info message\n");
+    RK_LOG_TO_AT(logger, rk::log::Level::Error, "error message\n");
+    ASSERT_NO_FATAL_FAILURE(Base::stopLogger());
+
+    const std::string info = server.receive();
+    ASSERT_EQ(info.rfind("<14>1 - ", 0), 0) << info;
+    ASSERT_NE(info.find("]info message"), std::string::npos) << info;
+    const std::string error = server.receive();
+    ASSERT_EQ(error.rfind("<11>1 - ", 0), 0) << error;
+    ASSERT_NE(error.find("]error message"), std::string::npos) << error;
+}
+
+TEST_F(SyslogLoggerTest, DisabledByDefault) {
+    ASSERT_NO_FATAL_FAILURE(Base::startLogger(std::filesystem::path()));
+    RK_LOG_TO(logger, "info message\n");
+    ASSERT_NO_FATAL_FAILURE(Base::stopLogger());
+
+    ASSERT_EQ(server.receive(), "");
+}
+
+} // namespace syslog_sink_tests
+} // namespace rk_logger_tests
+
+#endif // #if defined(__unix__) || defined(__APPLE__)
@@ -0,0 +1,105 @@
+#ifndef SYSLOG_SINK_TESTS_H
+#define SYSLOG_SINK_TESTS_H
+
+#include <rk_logger/logger.h>
+#include <rk_logger/syslog_sink.h>
+#include <rk_logger_tests/test_base.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <cstring>
+
+namespace rk_logger_tests {
+namespace syslog_sink_tests {
+
+inline const std::string TEST_IDENTIFIER = "rk_test";
+
+/**
+ * A Unix datagram socket that stands in for /dev/log or the journald socket.
+ */
+class StandInSyslogServer {
+public:
+    StandInSyslogServer() : path(std::filesystem::temp_directory_path()/("rk_syslog_test_" + std::to_string(getpid()) + ".sock")) {}
+
+    ~StandInSyslogServer() {
+        stop();
+    }
+
+    void start() {
+        std::filesystem::remove(path);
+        fd = socket(AF_UNIX, SOCK_DGRAM, 0);
+        ASSERT_GE(fd, 0);
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+        ASSERT_EQ(bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)), 0) << std::strerror(errno);
+        timeval timeout{};
+        timeout.tv_sec = 1;
+        ASSERT_EQ(setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)), 0);
+    }
+
+    void stop() {
+        if (fd >= 0) {
+            close(fd);
+            fd = -1;
+        }
+        std::filesystem::remove(path);
+    }
+
+    /**
+     * @brief Receives one datagram, waiting up to a second for it.
+     * 
+     * @return The datagram, or an empty string if none arrived.
+     */
+    std::string receive() {
+        std::string datagram(64 * 1024, '\0');
+        const ssize_t size = recv(fd, datagram.data(), datagram.size(), 0);
+        datagram.resize(size > 0 ? static_cast<size_t>(size) : 0);
+        return datagram;
+    }
+
+    const std::filesystem::path path;
+private:
+    int fd = -1;
+};
+
+class SyslogSinkTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_NO_FATAL_FAILURE(server.start());
+    }
+
+    StandInSyslogServer server;
+    const std::string pid = std::to_string(getpid());
+};
+
+class SyslogLoggerTest : public Base {
+protected:
+    void SetUp() override {
+        redirectStdCout();
+        ASSERT_NO_FATAL_FAILURE(server.start());
+        logger.getConfig().setConfigValue(rk::config::write_to_log_file::KEY, rk::config::write_to_log_file::DISABLE);
+        logger.getConfig().setConfigValue(rk::config::write_to_console::KEY, rk::config::write_to_console::DISABLE);
+        logger.getConfig().setConfigValue(rk::config::syslog_socket_path::KEY, server.path.string());
+    }
+
+    void TearDown() override {
+        if (logThread.joinable()) {
+            Base::stopLogger();
+        }
+        undoRedirectStdCout();
+    }
+
+    StandInSyslogServer server;
+};
+
+} // namespace syslog_sink_tests
+} // namespace rk_logger_tests
+
+#endif // #if defined(__unix__) || defined(__APPLE__)
+
+#endif // #ifndef SYSLOG_SINK_TESTS_H
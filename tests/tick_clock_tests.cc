@@ -0,0 +1,93 @@
+#include <rk_logger/tick_clock.h>
+#include "tick_clock_tests.h"
+
+namespace rk_logger_tests {
+namespace tick_clock_tests {
+
+namespace {
+
+constexpr std::chrono::milliseconds MAX_CONVERSION_ERROR(50);
+
+} // namespace
+
+TEST(TickCalibrationTest, ConvertsTicksAroundTheBase) {
+    rk::time_internal::TickCalibration calibration;
+    calibration.baseTicks = 1000000;
+    calibration.baseNs = 5000000000;
+    calibration.nsPerTick = 0.5;
+
+    using std::chrono::nanoseconds;
+    auto toNs = [&calibration] (const uint64_t ticks) {
+        return std::chrono::duration_cast<nanoseconds>(calibration.toTimePoint(ticks).time_since_epoch()).count();
+    };
+    SCOPED_TRACE("Ticks at, after, and before the base");
+    ASSERT_EQ(toNs(1000000), 5000000000);
+    ASSERT_EQ(toNs(1002000), 5000001000);
+    ASSERT_EQ(toNs(998000), 4999999000);
+}
+
+TEST_P(TickClockTest, ConvertedTicksMatchSystemClock) {
+    clock.configure(*config);
+    const rk::config::ConfigValue clockSource = GetParam().clockSource;
+
+    SCOPED_TRACE("Checking the tick source that was picked");
+    if (clockSource == rk::config::clock_source::SYSTEM) {
+        ASSERT_EQ(clock.getSource(), rk::time_internal::TickSource::System);
+        return;
+    }
+    if (clockSource == rk::config::clock_source::TSC && rk::time_internal::isInvariantTscAvailable()) {
+        ASSERT_EQ(clock.getSource(), rk::time_internal::TickSource::Tsc);
+    }
+    else {
+        ASSERT_EQ(clock.getSource(), rk::time_internal::TickSource::Steady);
+    }
+
+    SCOPED_TRACE("Converting ticks to wall time");
+    for (int i = 0; i < 3; i++) {
+        const auto before = rk::time_internal::system_clock::now();
+        const uint64_t ticks = clock.now();
+        const auto after = rk::time_internal::system_clock::now();
+        const auto converted = clock.getCalibration().toTimePoint(ticks);
+        ASSERT_GE(converted, before - MAX_CONVERSION_ERROR);
+        ASSERT_LE(converted, after + MAX_CONVERSION_ERROR);
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(TickClockTest,
+    TickClockTest,
+    testing::Values(
+        TickClockTestParam("system", rk::config::clock_source::SYSTEM),
+        TickClockTestParam("tsc", rk::config::clock_source::TSC),
+        TickClockTestParam("steady", rk::config::clock_source::STEADY)
+    ),
+    [](const testing::TestParamInfo<TickClockTestParam>& info) {
+        return info.param.description;
+    }
+);
+
+TEST_P(TickClockLoggerTest, TimeStampIsConverted) {
+    const std::string expectedDate = rk::time_internal::generateTimeStamp(rk::time_internal::system_clock::now()).substr(0, 11);
+    RK_LOG_TO(logger, "Message with a converted timestamp\n");
+    Base::stopLogger();
+
+    SCOPED_TRACE("The message is prefixed with today's date");
+    const std::string output = sink->str();
+    ASSERT_NE(output.find("Message with a converted timestamp"), std::string::npos);
+    ASSERT_EQ(output.substr(0, 11), expectedDate);
+}
+
+INSTANTIATE_TEST_SUITE_P(TickClockLoggerTest,
+    TickClockLoggerTest,
+    testing::Values(
+        TickClockTestParam("system", rk::config::clock_source::SYSTEM),
+        TickClockTestParam("tsc", rk::config::clock_source::TSC),
+        TickClockTestParam("steady", rk::config::clock_source::STEADY)
+    ),
+    [](const testing::TestParamInfo<TickClockTestParam>& info) {
+        return info.param.description;
+    }
+);
+
+} // namespace tick_clock_tests
+} // namespace rk_logger_tests
@@ -0,0 +1,60 @@
+#ifndef TICK_CLOCK_TESTS_H
+#define TICK_CLOCK_TESTS_H
+
+#include <rk_logger/logger.h>
+#include <rk_logger/tick_clock.h>
+#include <rk_logger_tests/test_base.h>
+
+namespace rk_logger_tests {
+namespace tick_clock_tests {
+
+struct TickClockTestParam : public BaseParam {
+    TickClockTestParam(const std::string description, const rk::config::ConfigValue clockSource)
+        : BaseParam(description), clockSource(clockSource) {};
+
+    const rk::config::ConfigValue clockSource;
+};
+
+class TickClockTest : public ::testing::TestWithParam<TickClockTestParam> {
+protected:
+    void SetUp() override {
+        config = rk::config::createInstance();
+        config->setConfigValue(rk::config::clock_source::KEY, GetParam().clockSource);
+        coutBufOriginal = std::cout.rdbuf(logOutput.rdbuf());
+    }
+
+    void TearDown() override {
+        std::cout.rdbuf(coutBufOriginal);
+    }
+
+    std::unique_ptr<rk::config::Config> config;
+    rk::time_internal::TickClock clock;
+    std::streambuf* coutBufOriginal;
+    std::stringstream logOutput;
+};
+
+class TickClockLoggerTest : public Base, public ::testing::WithParamInterface<TickClockTestParam> {
+protected:
+    void SetUp() override {
+        redirectStdCout();
+        logger.getConfig().setConfigValue(rk::config::write_to_log_file::KEY, rk::config::write_to_log_file::DISABLE);
+        logger.getConfig().setConfigValue(rk::config::write_to_console::KEY, rk::config::write_to_console::DISABLE);
+        logger.getConfig().setConfigValue(rk::config::clock_source::KEY, GetParam().clockSource);
+        logger.addSink(sink);
+        ASSERT_NO_FATAL_FAILURE(Base::startLogger(std::filesystem::path()));
+    }
+
+    void TearDown() override {
+        if (logThread.joinable()) {
+            Base::stopLogger();
+        }
+        undoRedirectStdCout();
+    }
+
+    std::shared_ptr<StringSink> sink = std::make_shared<StringSink>();
+};
+
+} // namespace tick_clock_tests
+} // namespace rk_logger_tests
+
+#endif // #ifndef TICK_CLOCK_TESTS_H